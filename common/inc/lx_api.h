@@ -169,8 +169,8 @@ typedef unsigned long long                      ULONG64;
 #define LX_MEMCPY(a,b,c)                        memcpy((a),(b),(c))
 #endif
 
-/* Disable usage of ThreadX mutex in standalone mode */
-#ifdef LX_THREAD_SAFE_ENABLE
+/* Disable thread safe operation in standalone mode, unless a pthread lock backend is selected.  */
+#if defined(LX_THREAD_SAFE_ENABLE) && !defined(LX_LOCK_BACKEND)
 #undef LX_THREAD_SAFE_ENABLE
 #endif
 
@@ -193,6 +193,93 @@ typedef unsigned long long                      ULONG64;
 #endif
 
 
+/* Shared reads release the thread safe mutex while data is transferred, so they are only 
+   available when the thread safe mutex is used.  */
+#ifndef LX_THREAD_SAFE_ENABLE
+#ifdef LX_NOR_ENABLE_SHARED_READ
+#undef LX_NOR_ENABLE_SHARED_READ
+#endif
+#ifdef LX_NAND_ENABLE_SHARED_READ
+#undef LX_NAND_ENABLE_SHARED_READ
+#endif
+#endif
+
+
+/* Define the lock backends used for thread safe operation. The ThreadX backend is the default 
+   when ThreadX is used, the pthread backends allow thread safe operation of standalone builds on 
+   POSIX hosts. The pthread read/write lock backend also uses a read/write lock to coordinate 
+   shared reads with block erases.  */
+#define LX_LOCK_BACKEND_NONE                    0
+#define LX_LOCK_BACKEND_THREADX                 1
+#define LX_LOCK_BACKEND_PTHREAD_MUTEX           2
+#define LX_LOCK_BACKEND_PTHREAD_RWLOCK          3
+
+#ifndef LX_LOCK_BACKEND
+#ifdef LX_STANDALONE_ENABLE
+#define LX_LOCK_BACKEND                         LX_LOCK_BACKEND_NONE
+#else
+#define LX_LOCK_BACKEND                         LX_LOCK_BACKEND_THREADX
+#endif
+#endif
+
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_THREADX)
+
+/* Define the lock services in terms of ThreadX mutexes and semaphores.  */
+#ifdef LX_STANDALONE_ENABLE
+#error "The ThreadX lock backend is not available in standalone mode"
+#endif
+#define LX_LOCK_MUTEX_TYPE                      TX_MUTEX
+#define LX_LOCK_MUTEX_CREATE(m,n)               tx_mutex_create((m), (n), TX_NO_INHERIT)
+#define LX_LOCK_MUTEX_DELETE(m)                 tx_mutex_delete(m)
+#define LX_LOCK_MUTEX_GET(m)                    tx_mutex_get((m), TX_WAIT_FOREVER)
+#define LX_LOCK_MUTEX_PUT(m)                    tx_mutex_put(m)
+#define LX_LOCK_SEMAPHORE_TYPE                  TX_SEMAPHORE
+#define LX_LOCK_SEMAPHORE_CREATE(s,n)           tx_semaphore_create((s), (n), 0)
+#define LX_LOCK_SEMAPHORE_DELETE(s)             tx_semaphore_delete(s)
+#define LX_LOCK_SEMAPHORE_GET(s)                tx_semaphore_get((s), TX_WAIT_FOREVER)
+#define LX_LOCK_SEMAPHORE_PUT(s)                tx_semaphore_put(s)
+
+#elif (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_MUTEX) || (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+/* Define the lock services in terms of pthread mutexes, POSIX semaphores and read/write locks. 
+   The LevelX APIs call each other with the mutex held, so the mutex is created recursive.  */
+#include <pthread.h>
+#include <semaphore.h>
+#define LX_LOCK_MUTEX_TYPE                      pthread_mutex_t
+#define LX_LOCK_MUTEX_CREATE(m,n)               _lx_lock_mutex_create(m)
+#define LX_LOCK_MUTEX_DELETE(m)                 pthread_mutex_destroy(m)
+#define LX_LOCK_MUTEX_GET(m)                    pthread_mutex_lock(m)
+#define LX_LOCK_MUTEX_PUT(m)                    pthread_mutex_unlock(m)
+#define LX_LOCK_SEMAPHORE_TYPE                  sem_t
+#define LX_LOCK_SEMAPHORE_CREATE(s,n)           ((UINT) sem_init((s), 0, 0))
+#define LX_LOCK_SEMAPHORE_DELETE(s)             sem_destroy(s)
+#define LX_LOCK_SEMAPHORE_GET(s)                do { } while (sem_wait(s) != 0)
+#define LX_LOCK_SEMAPHORE_PUT(s)                sem_post(s)
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+#define LX_LOCK_RWLOCK_TYPE                     pthread_rwlock_t
+#define LX_LOCK_RWLOCK_CREATE(l,n)              ((UINT) pthread_rwlock_init((l), NULL))
+#define LX_LOCK_RWLOCK_DELETE(l)                pthread_rwlock_destroy(l)
+#define LX_LOCK_RWLOCK_READ_GET(l)              pthread_rwlock_rdlock(l)
+#define LX_LOCK_RWLOCK_WRITE_GET(l)             pthread_rwlock_wrlock(l)
+#define LX_LOCK_RWLOCK_PUT(l)                   pthread_rwlock_unlock(l)
+#endif
+
+#else
+
+/* Define the lock services as no operations, for single threaded use.  */
+#define LX_LOCK_MUTEX_TYPE                      UINT
+#define LX_LOCK_MUTEX_CREATE(m,n)               (*(m) =  0)
+#define LX_LOCK_MUTEX_DELETE(m)                 ((void)(m))
+#define LX_LOCK_MUTEX_GET(m)                    ((void)(m))
+#define LX_LOCK_MUTEX_PUT(m)                    ((void)(m))
+#define LX_LOCK_SEMAPHORE_TYPE                  UINT
+#define LX_LOCK_SEMAPHORE_CREATE(s,n)           (*(s) =  0)
+#define LX_LOCK_SEMAPHORE_DELETE(s)             ((void)(s))
+#define LX_LOCK_SEMAPHORE_GET(s)                ((void)(s))
+#define LX_LOCK_SEMAPHORE_PUT(s)                ((void)(s))
+#endif
+
+
 /* Disable warning of parameter not used. */
 #ifndef LX_PARAMETER_NOT_USED
 #define LX_PARAMETER_NOT_USED(p) ((void)(p))
@@ -247,43 +334,202 @@ typedef unsigned long long                      ULONG64;
 #ifndef LX_NOR_SECTOR_SIZE
 #define LX_NOR_SECTOR_SIZE                          (512/sizeof(ULONG))
 #endif
+#ifndef LX_NOR_SECTOR_SIZE_MIN
+#define LX_NOR_SECTOR_SIZE_MIN                      (512/sizeof(ULONG))
+#endif
+#ifndef LX_NOR_SECTOR_SIZE_MAX
+#define LX_NOR_SECTOR_SIZE_MAX                      (4096/sizeof(ULONG))
+#endif
 #define LX_NOR_FLASH_MIN_LOGICAL_SECTOR_OFFSET      1
 #define LX_NOR_FLASH_MAX_LOGICAL_SECTOR_OFFSET      2
 #ifndef LX_NOR_FLASH_MAX_ERASE_COUNT_DELTA
 #define LX_NOR_FLASH_MAX_ERASE_COUNT_DELTA          4
 #endif
-#define LX_NOR_SECTOR_MAPPING_CACHE_DEPTH           4
+#ifndef LX_NOR_SECTOR_MAPPING_CACHE_DEPTH
+#define LX_NOR_SECTOR_MAPPING_CACHE_DEPTH           4           /* Number of ways in each set, maximum value of 64.     */
+#endif
 #ifndef LX_NOR_SECTOR_MAPPING_CACHE_SIZE
 #define LX_NOR_SECTOR_MAPPING_CACHE_SIZE            16          /* Minimum value of 8, all sizes must be a power of 2.  */
 #endif
-#ifndef LX_NOR_EXTENDED_CACHE_SIZE
-#define LX_NOR_EXTENDED_CACHE_SIZE                  8           /* Maximum number of extended cache sectors.            */
+#define LX_NOR_SECTOR_MAPPING_CACHE_POLICY_LRU      0
+#define LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK    1
+#define LX_NOR_SECTOR_MAPPING_CACHE_POLICY_2Q       2
+#ifndef LX_NOR_SECTOR_MAPPING_CACHE_POLICY
+#define LX_NOR_SECTOR_MAPPING_CACHE_POLICY          LX_NOR_SECTOR_MAPPING_CACHE_POLICY_LRU
+#endif
+#ifndef LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED_WAYS
+#define LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED_WAYS  ((LX_NOR_SECTOR_MAPPING_CACHE_DEPTH + 1) / 2)
+#endif
+#ifndef LX_NOR_EXTENDED_CACHE_MAX_ACCESS_COUNT
+#define LX_NOR_EXTENDED_CACHE_MAX_ACCESS_COUNT      15          /* Access count saturation, each pass of the clock hand halves it.  */
+#endif
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+#ifndef LX_NOR_DATA_CACHE_WAYS
+#define LX_NOR_DATA_CACHE_WAYS                      4           /* Number of ways in each set of the data cache.        */
+#endif
+#endif
+#ifndef LX_NOR_FLASH_LOW_WATERMARK_BLOCKS
+#define LX_NOR_FLASH_LOW_WATERMARK_BLOCKS           1           /* Default low free sector watermark, in blocks.        */
+#endif
+#ifndef LX_NOR_FLASH_HIGH_WATERMARK_BLOCKS
+#define LX_NOR_FLASH_HIGH_WATERMARK_BLOCKS          2           /* Default high free sector watermark, in blocks.       */
+#endif
+#ifndef LX_NOR_FLASH_FOREGROUND_RECLAIM_BLOCKS
+#define LX_NOR_FLASH_FOREGROUND_RECLAIM_BLOCKS      1           /* Maximum blocks reclaimed by one write above reserve. */
+#endif
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+#ifndef LX_NOR_WRITE_STREAMS
+#define LX_NOR_WRITE_STREAMS                        2           /* Number of allocation frontiers, minimum value of 2.  */
+#endif
 #endif
 #ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
 #ifndef LX_NOR_OBSOLETE_COUNT_CACHE_TYPE
 #define LX_NOR_OBSOLETE_COUNT_CACHE_TYPE            UCHAR
 #endif
 #endif
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+#ifndef LX_NOR_LOGICAL_SECTOR_INDEX_TYPE
+#define LX_NOR_LOGICAL_SECTOR_INDEX_TYPE            ULONG
+#endif
+#define LX_NOR_LOGICAL_SECTOR_INDEX_UNMAPPED        ((LX_NOR_LOGICAL_SECTOR_INDEX_TYPE) LX_ALL_ONES)
+#endif
 
 
 /* Define the mask for the hash index into the sector mapping cache table.  The sector mapping cache is divided 
-   into 4 entry pieces that are indexed by the formula:  
+   into sets of LX_NOR_SECTOR_MAPPING_CACHE_DEPTH ways that are indexed by the formula:  
    
             index =  (sector & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) * LX_NOR_SECTOR_MAPPING_CACHE_DEPTH
 
-   The LX_NOR_SECTOR_MAPPING_CACHE_DEPTH define must not be changed unless the related source code is also changed.  */
+   The tags of a set are kept in their own array so a lookup only compares consecutive words, and entries are 
+   never moved on a hit. The replacement state of each way is a single byte. For LRU it is the rank of the way 
+   in the set, 0 being the most recently used. For CLOCK it is the reference bit, with a clock hand for each set. 
+   For 2Q it is the rank, with the protected flag set once the sector has been found in the cache again. New 
+   sectors replace the least recently used probationary way, and at most LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED_WAYS
+   ways of a set are protected.  */
 
-#define LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK       ((LX_NOR_SECTOR_MAPPING_CACHE_SIZE/LX_NOR_SECTOR_MAPPING_CACHE_DEPTH)-1)
+#define LX_NOR_SECTOR_MAPPING_CACHE_SETS            (LX_NOR_SECTOR_MAPPING_CACHE_SIZE/LX_NOR_SECTOR_MAPPING_CACHE_DEPTH)
+#define LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK       (LX_NOR_SECTOR_MAPPING_CACHE_SETS-1)
 #define LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_MASK      0x7FFFFFFF
 #define LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID     0x80000000
+#define LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK       0x7F
+#define LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED       0x80
+
+/* Define the hash of the NOR extended cache. The word offset of the sector in the flash is multiplied by a 
+   Fibonacci constant so the header sectors of consecutive blocks, which are a fixed stride apart, are spread 
+   over the hash table. The mask selects at most 16 bits of the product.  */
+
+#define LX_NOR_EXTENDED_CACHE_HASH_MULTIPLIER       0x9E3779B1
+#define LX_NOR_EXTENDED_CACHE_HASH_MAX_BUCKETS      0x10000
+#define LX_NOR_EXTENDED_CACHE_HASH(offset, mask)    ((((offset) * LX_NOR_EXTENDED_CACHE_HASH_MULTIPLIER) >> 16) & (mask))
+
+/* Define the states of the NOR block reclaim. A block is reclaimed one step at a time, each step being one or 
+   a few driver operations, so lx_nor_flash_gc_step can spread the reclaim of a block, including the relocation
+   of a single valid sector, over several calls.  */
+
+#define LX_NOR_GC_STATE_IDLE                        0
+#define LX_NOR_GC_STATE_SCAN                        1
+#define LX_NOR_GC_STATE_COPY                        2
+#define LX_NOR_GC_STATE_SUPERCEDE                   3
+#define LX_NOR_GC_STATE_COMMIT                      4
+#define LX_NOR_GC_STATE_ERASE                       5
+#define LX_NOR_GC_STATE_HEADER                      6
 
 #define LX_NOR_PHYSICAL_SECTOR_VALID                0x80000000
 #define LX_NOR_PHYSICAL_SECTOR_SUPERCEDED           0x40000000
 #define LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID    0x20000000
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+#define LX_NOR_PHYSICAL_SECTOR_FILL                 0x10000000
+#define LX_NOR_LOGICAL_SECTOR_MASK                  0x0FFFFFFF
+#else
 #define LX_NOR_LOGICAL_SECTOR_MASK                  0x1FFFFFFF
+#endif
 #define LX_NOR_PHYSICAL_SECTOR_FREE                 0xFFFFFFFF
 
 
+/* Define the bit scan used to find the first free sector in a non-zero word of the free sector bit map, 
+   i.e. the number of trailing zero bits. Ports can define LX_NOR_FLASH_FIRST_SET_BIT to use their own 
+   count trailing zeros instruction, otherwise a portable search is used.  */
+
+#ifndef LX_NOR_FLASH_FIRST_SET_BIT
+#if defined(__GNUC__) || defined(__clang__)
+#define LX_NOR_FLASH_FIRST_SET_BIT(word)            ((ULONG) __builtin_ctz((unsigned int) (word)))
+#endif
+#endif
+
+
+/* Define the number of bytes of memory required by the logical sector index for a NOR flash of the 
+   specified geometry. Each logical sector, up to the number of physical sectors, needs one entry. The 
+   sector size is the instance's lx_nor_flash_words_per_sector, LX_NOR_SECTOR_SIZE by default.  */
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+#define LX_NOR_LOGICAL_SECTOR_INDEX_MEMORY_SIZE(total_blocks, words_per_block, words_per_sector) \
+            ((total_blocks) * (((words_per_block) / (words_per_sector)) - 1) * sizeof(LX_NOR_LOGICAL_SECTOR_INDEX_TYPE))
+#endif
+
+
+/* Define the number of bytes of memory required by the block summary for a NOR flash with the specified 
+   number of blocks. Every block must be covered for the block summary to be used. When the erase queue 
+   is enabled, the queue nodes follow the block summary entries in the same memory.  */
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+#define LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(total_blocks)  ((total_blocks) * (sizeof(LX_NOR_FLASH_BLOCK_SUMMARY) + sizeof(LX_NOR_FLASH_ERASE_QUEUE_NODE)))
+#else
+#define LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(total_blocks)  ((total_blocks) * sizeof(LX_NOR_FLASH_BLOCK_SUMMARY))
+#endif
+#endif
+
+
+/* Define the number of bytes of memory required by the data cache for the specified number of sectors 
+   of the specified sector size in words. The sectors are divided into sets of LX_NOR_DATA_CACHE_WAYS
+   sectors, and the number of sets is rounded down to a power of 2.  */
+
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+#define LX_NOR_DATA_CACHE_MEMORY_SIZE(sectors, words_per_sector) \
+            ((sectors) * (((words_per_sector) * sizeof(ULONG)) + sizeof(LX_NOR_FLASH_DATA_CACHE_ENTRY)))
+#endif
+#define LX_NOR_DATA_CACHE_ENTRY_VALID               0x80000000
+
+
+/* Define the NOR erase queue constants.  */
+
+#define LX_NOR_ERASE_QUEUE_NONE                     LX_ALL_ONES
+#define LX_NOR_ERASE_QUEUE_REBUILD                  LX_ALL_ONES
+
+
+/* Define the NOR checkpoint constants.  */
+
+#define LX_NOR_CHECKPOINT_MAGIC                     ((ULONG) 0x4C58434B)
+#define LX_NOR_CHECKPOINT_BLOCK_SUMMARY             0x00000001
+#define LX_NOR_CHECKPOINT_LOGICAL_SECTOR_INDEX      0x00000002
+#define LX_NOR_CHECKPOINT_CRC_POLYNOMIAL            ((ULONG) 0xEDB88320)
+
+
+/* Define the NOR write stream constants. Cold data, including the sectors relocated by a block reclaim, 
+   is written to stream 0 and hot data to the last stream.  */
+
+#define LX_NOR_WRITE_STREAM_COLD                    0
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+#define LX_NOR_WRITE_STREAM_HOT                     (LX_NOR_WRITE_STREAMS - 1)
+#endif
+#define LX_NOR_WRITE_STREAM_AUTO                    LX_ALL_ONES
+#define LX_NOR_HOT_SECTORS_MEMORY_SIZE(entries)     ((entries) * sizeof(ULONG))
+#define LX_NOR_HOT_SECTOR_REFERENCED                0x80000000
+
+
+/* Check sector mapping cache configurations.  */
+#if (LX_NOR_SECTOR_MAPPING_CACHE_DEPTH < 1) || (LX_NOR_SECTOR_MAPPING_CACHE_DEPTH > 64)
+#error "LX_NOR_SECTOR_MAPPING_CACHE_DEPTH must be between 1 and 64."
+#endif
+#if ((LX_NOR_SECTOR_MAPPING_CACHE_SIZE % LX_NOR_SECTOR_MAPPING_CACHE_DEPTH) != 0) || ((LX_NOR_SECTOR_MAPPING_CACHE_SETS & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) != 0)
+#error "LX_NOR_SECTOR_MAPPING_CACHE_SIZE divided by LX_NOR_SECTOR_MAPPING_CACHE_DEPTH must be a power of 2."
+#endif
+#if (LX_NOR_SECTOR_MAPPING_CACHE_POLICY != LX_NOR_SECTOR_MAPPING_CACHE_POLICY_LRU) && (LX_NOR_SECTOR_MAPPING_CACHE_POLICY != LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK) && \
+    (LX_NOR_SECTOR_MAPPING_CACHE_POLICY != LX_NOR_SECTOR_MAPPING_CACHE_POLICY_2Q)
+#error "LX_NOR_SECTOR_MAPPING_CACHE_POLICY must be LRU, CLOCK or 2Q."
+#endif
+
+
 /* Check extended cache configurations.  */
 #ifdef LX_NOR_DISABLE_EXTENDED_CACHE
 
@@ -297,6 +543,20 @@ typedef unsigned long long                      ULONG64;
 
 #endif
 
+/* Check write stream configuration.  */
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+#if LX_NOR_WRITE_STREAMS < 2
+#error "LX_NOR_WRITE_STREAMS must be at least 2."
+#endif
+#endif
+
+/* Check erase queue configuration.  */
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+#ifndef LX_NOR_ENABLE_BLOCK_SUMMARY
+#error "To enable erase queue, you need to define LX_NOR_ENABLE_BLOCK_SUMMARY."
+#endif
+#endif
+
 /* Define NAND flash constants.  */
 
 #define LX_NAND_GOOD_BLOCK                          0xFF
@@ -326,6 +586,85 @@ typedef unsigned long long                      ULONG64;
 #define LX_NAND_FLASH_MAX_METADATA_BLOCKS           4
 #endif 
 
+/* Define the number of NAND sector reads that can transfer data at the same time when shared reads
+   are enabled. Each reader uses its own spare buffer, the maximum is 32.  */
+#ifndef LX_NAND_SHARED_READERS
+#define LX_NAND_SHARED_READERS                      4
+#endif
+
+/* Define the clock used to time the LevelX APIs when statistics are enabled. The clock must count up and 
+   may wrap, its unit is the unit of the latency histograms. Without ThreadX, latencies are only measured 
+   when the application supplies the clock.  */
+#ifndef LX_STATS_CLOCK_GET
+#ifndef LX_STANDALONE_ENABLE
+#define LX_STATS_CLOCK_GET()                        tx_time_get()
+#else
+#define LX_STATS_CLOCK_GET()                        ((ULONG) 0)
+#endif
+#endif
+
+/* Define the number of log2 buckets of the latency histograms. Bucket 0 counts latencies of 0, bucket n 
+   counts latencies from 2^(n-1) to 2^n - 1 and the last bucket also counts all longer latencies.  */
+#define LX_STATS_HISTOGRAM_BUCKETS                  32
+
+/* Define the APIs that are timed by the statistics.  */
+#define LX_STATS_SECTOR_READ                        0
+#define LX_STATS_SECTOR_WRITE                       1
+#define LX_STATS_SECTOR_RELEASE                     2
+#define LX_STATS_DEFRAGMENT                         3
+#define LX_STATS_SECTORS_READ                       4
+#define LX_STATS_SECTORS_WRITE                      5
+#define LX_STATS_SECTORS_RELEASE                    6
+#define LX_STATS_APIS                               7
+
+/* Define the driver operations that are counted by the statistics. NAND reads, writes and copies count 
+   pages.  */
+#define LX_STATS_DRIVER_READ                        0
+#define LX_STATS_DRIVER_WRITE                       1
+#define LX_STATS_DRIVER_BLOCK_ERASE                 2
+#define LX_STATS_DRIVER_BLOCK_ERASED_VERIFY         3
+#define LX_STATS_DRIVER_PAGE_ERASED_VERIFY          4
+#define LX_STATS_DRIVER_PAGE_COPY                   5
+#define LX_STATS_DRIVER_BLOCK_STATUS_GET            6
+#define LX_STATS_DRIVER_BLOCK_STATUS_SET            7
+#define LX_STATS_DRIVER_OPERATIONS                  8
+
+/* Define the trace buffer identification, "LXTR" in little endian memory, and the devices the trace is
+   recorded for.  */
+#define LX_TRACE_ID                                 0x5254584C
+#define LX_TRACE_NOR                                1
+#define LX_TRACE_NAND                               2
+
+/* Define the trace events. The time stamp of every event is taken with LX_STATS_CLOCK_GET.  */
+#define LX_TRACE_API_ENTRY                          1           /* info1: LX_STATS_ API, info2: logical sector          */
+#define LX_TRACE_API_EXIT                           2           /* info1: LX_STATS_ API, info2: status                  */
+#define LX_TRACE_RECLAIM                            3           /* info1: reclaimed block, info2: NOR sectors to move,  */
+                                                                /*        NAND new block                                */
+#define LX_TRACE_RELOCATE                           4           /* info1: NOR logical sector, NAND source block,        */
+                                                                /*        info2: new block                              */
+#define LX_TRACE_BLOCK_ERASE                        5           /* info1: block, info2: new erase count                 */
+#define LX_TRACE_METADATA_WRITE                     6           /* info1: metadata block, info2: page type              */
+#define LX_TRACE_METADATA_ALLOCATE                  7           /* info1: metadata block, info2: backup metadata block  */
+#define LX_TRACE_CACHE_MISS                         8           /* info1: LX_TRACE_CACHE_ cache, info2: logical sector  */
+
+/* Define the caches of the cache miss events.  */
+#define LX_TRACE_CACHE_SECTOR_MAPPING               0
+#define LX_TRACE_CACHE_DATA                         1
+
+/* Define the trace insert macros, which compile to nothing when the trace isn't enabled.  */
+#ifdef LX_NOR_ENABLE_TRACE
+#define LX_NOR_TRACE_INSERT(nor_flash, event, info1, info2) \
+                                                    _lx_trace_event_insert((nor_flash) -> lx_nor_flash_trace, (ULONG) (event), (ULONG) (info1), (ULONG) (info2))
+#else
+#define LX_NOR_TRACE_INSERT(nor_flash, event, info1, info2)
+#endif
+#ifdef LX_NAND_ENABLE_TRACE
+#define LX_NAND_TRACE_INSERT(nand_flash, event, info1, info2) \
+                                                    _lx_trace_event_insert((nand_flash) -> lx_nand_flash_trace, (ULONG) (event), (ULONG) (info1), (ULONG) (info2))
+#else
+#define LX_NAND_TRACE_INSERT(nand_flash, event, info1, info2)
+#endif
+
 #ifndef LX_UTILITY_SHORT_SET
 #define LX_UTILITY_SHORT_SET(address, value)        *((USHORT*)(address)) = (USHORT)(value)
 #endif
@@ -419,6 +758,46 @@ typedef struct LX_NAND_DEVICE_INFO_STRUCT
 } LX_NAND_DEVICE_INFO;
 
 
+/* Define the flash statistics structure, which is used by NOR and NAND flash instances.  */
+
+typedef struct LX_FLASH_STATS_STRUCT
+{
+    ULONG                           lx_flash_stats_api_calls[LX_STATS_APIS];
+    ULONG                           lx_flash_stats_api_latency_max[LX_STATS_APIS];
+    ULONG64                         lx_flash_stats_api_latency_total[LX_STATS_APIS];
+    ULONG                           lx_flash_stats_api_latency_histogram[LX_STATS_APIS][LX_STATS_HISTOGRAM_BUCKETS];
+    ULONG                           lx_flash_stats_driver_calls[LX_STATS_DRIVER_OPERATIONS];
+    ULONG64                         lx_flash_stats_bytes_requested;
+    ULONG64                         lx_flash_stats_bytes_programmed;
+} LX_FLASH_STATS;
+
+
+/* Define the trace buffer header, which is at the start of the memory supplied for the trace. The events
+   follow the header, lx_trace_header_next is the event written next and the oldest event once the buffer
+   has wrapped.  */
+
+typedef struct LX_TRACE_HEADER_STRUCT
+{
+    ULONG                           lx_trace_header_id;
+    ULONG                           lx_trace_header_event_size;
+    ULONG                           lx_trace_header_device;
+    ULONG                           lx_trace_header_events;
+    ULONG                           lx_trace_header_next;
+    ULONG                           lx_trace_header_total;
+} LX_TRACE_HEADER;
+
+
+/* Define the trace event.  */
+
+typedef struct LX_TRACE_EVENT_STRUCT
+{
+    ULONG                           lx_trace_event_time;
+    ULONG                           lx_trace_event_id;
+    ULONG                           lx_trace_event_info1;
+    ULONG                           lx_trace_event_info2;
+} LX_TRACE_EVENT;
+
+
 /* Determine if the flash control block has an extension defined. If not, 
    define the extension to whitespace.  */
 
@@ -494,6 +873,21 @@ typedef struct LX_NAND_FLASH_STRUCT
     ULONG                           lx_nand_flash_diagnostic_moved_pages;
     ULONG                           lx_nand_flash_diagnostic_block_erased_verifies;
     ULONG                           lx_nand_flash_diagnostic_page_erased_verifies;
+#ifdef LX_NAND_ENABLE_WRITE_IF_CHANGED
+    ULONG                           lx_nand_flash_diagnostic_elided_writes;
+#endif
+
+#ifdef LX_NAND_ENABLE_STATS
+
+    /* The driver counts of the statistics are taken from the diagnostic counters, relative to 
+       their values at the last statistics reset.  */
+    LX_FLASH_STATS                  lx_nand_flash_stats;
+    ULONG                           lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_OPERATIONS];
+#endif
+
+#ifdef LX_NAND_ENABLE_TRACE
+    LX_TRACE_HEADER                 *lx_nand_flash_trace;
+#endif
 
 #ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
     UINT                            (*lx_nand_flash_driver_read)(struct LX_NAND_FLASH_STRUCT *nand_flash, ULONG block, ULONG page, ULONG *destination, ULONG words);
@@ -531,10 +925,26 @@ typedef struct LX_NAND_FLASH_STRUCT
 
 #ifdef LX_THREAD_SAFE_ENABLE
 
-    /* When this conditional is used, the LevelX code utilizes a ThreadX mutex for thread
+    /* When this conditional is used, the LevelX code utilizes a mutex of the lock backend for thread
        safe operation. Generally, this is not required since FileX ensures thread safe operation at
        a higher layer.  */
-    TX_MUTEX                        lx_nand_flash_mutex;
+    LX_LOCK_MUTEX_TYPE              lx_nand_flash_mutex;
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+    /* Shared reads transfer page data with the NAND flash mutex released. Block erases wait 
+       until no shared read is in progress.  */
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+    LX_LOCK_RWLOCK_TYPE             lx_nand_flash_shared_read_lock;
+#else
+    LX_LOCK_MUTEX_TYPE              lx_nand_flash_shared_read_mutex;
+    LX_LOCK_SEMAPHORE_TYPE          lx_nand_flash_shared_read_semaphore;
+    UINT                            lx_nand_flash_shared_read_waiting;
+#endif
+    ULONG                           lx_nand_flash_shared_readers;
+    ULONG                           lx_nand_flash_shared_reads;
+    ULONG                           lx_nand_flash_shared_read_buffers_used;
+    UCHAR                           *lx_nand_flash_shared_read_buffers;
+#endif
 #endif
     
     /* Define the NAND flash control block open next/previous pointers.  */
@@ -553,7 +963,6 @@ typedef struct LX_NAND_FLASH_STRUCT
 
 typedef struct LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_STRUCT
 {
-    ULONG                           lx_nor_sector_mapping_cache_logical_sector;
     ULONG                           *lx_nor_sector_mapping_cache_physical_sector_map_entry; 
     ULONG                           *lx_nor_sector_mapping_cache_physical_sector_address;
 } LX_NOR_SECTOR_MAPPING_CACHE_ENTRY;
@@ -566,9 +975,45 @@ typedef struct LX_NOR_FLASH_EXTENDED_CACHE_ENTRY_STRUCT
     ULONG                           *lx_nor_flash_extended_cache_entry_sector_address; 
     ULONG                           *lx_nor_flash_extended_cache_entry_sector_memory;
     ULONG                           lx_nor_flash_extended_cache_entry_access_count;
+    struct LX_NOR_FLASH_EXTENDED_CACHE_ENTRY_STRUCT
+                                    *lx_nor_flash_extended_cache_entry_next;
 } LX_NOR_FLASH_EXTENDED_CACHE_ENTRY;
 
 
+/* Define the NOR flash data cache entry structure.  */
+
+typedef struct LX_NOR_FLASH_DATA_CACHE_ENTRY_STRUCT
+{
+    ULONG                           lx_nor_flash_data_cache_entry_logical_sector;
+    ULONG                           *lx_nor_flash_data_cache_entry_sector_memory;
+} LX_NOR_FLASH_DATA_CACHE_ENTRY;
+
+
+/* Define the NOR flash block summary structure. One entry is kept in RAM for each block. Free sectors are 
+   allocated in order, so the next free sector is also the number of sectors allocated in the block.  */
+
+typedef struct LX_NOR_FLASH_BLOCK_SUMMARY_STRUCT
+{
+    ULONG                           lx_nor_flash_block_summary_erase_count;
+    USHORT                          lx_nor_flash_block_summary_mapped_sectors;
+    USHORT                          lx_nor_flash_block_summary_obsolete_sectors;
+    USHORT                          lx_nor_flash_block_summary_free_sectors;
+    USHORT                          lx_nor_flash_block_summary_next_free_sector;
+} LX_NOR_FLASH_BLOCK_SUMMARY;
+
+
+/* Define the NOR flash erase queue node structure. The erase queue is a tournament tree over the 
+   block summary, each node holds the winners of the blocks below it.  */
+
+typedef struct LX_NOR_FLASH_ERASE_QUEUE_NODE_STRUCT
+{
+    ULONG                           lx_nor_flash_erase_queue_node_obsolete_block;
+    ULONG                           lx_nor_flash_erase_queue_node_eligible_block;
+    ULONG                           lx_nor_flash_erase_queue_node_erase_block;
+    ULONG                           lx_nor_flash_erase_queue_node_erase_blocks;
+} LX_NOR_FLASH_ERASE_QUEUE_NODE;
+
+
 /* Determine if the flash control block has an extension defined. If not, 
    define the extension to whitespace.  */
 
@@ -583,6 +1028,7 @@ typedef struct LX_NOR_FLASH_STRUCT
     ULONG                           lx_nor_flash_state;
     ULONG                           lx_nor_flash_total_blocks;
     ULONG                           lx_nor_flash_words_per_block;
+    ULONG                           lx_nor_flash_words_per_sector;
     ULONG                           lx_nor_flash_total_physical_sectors;
     ULONG                           lx_nor_flash_physical_sectors_per_block;
 
@@ -599,6 +1045,8 @@ typedef struct LX_NOR_FLASH_STRUCT
     ULONG                           lx_nor_flash_minimum_erase_count;
     ULONG                           lx_nor_flash_minimum_erased_blocks;
     ULONG                           lx_nor_flash_maximum_erase_count;
+    ULONG                           lx_nor_flash_free_sectors_low_watermark;
+    ULONG                           lx_nor_flash_free_sectors_high_watermark;
 
     ULONG                           lx_nor_flash_free_block_search;
     ULONG                           lx_nor_flash_found_block_search;
@@ -621,6 +1069,22 @@ typedef struct LX_NOR_FLASH_STRUCT
     ULONG                           lx_nor_flash_diagnostic_mapping_write_interrupted;
     ULONG                           lx_nor_flash_diagnostic_sector_not_free;
     ULONG                           lx_nor_flash_diagnostic_sector_data_not_free;
+    ULONG                           lx_nor_flash_foreground_reclaims;
+    ULONG                           lx_nor_flash_gc_operations;
+    ULONG                           lx_nor_flash_host_sector_writes;
+    ULONG                           lx_nor_flash_relocated_sector_writes;
+    ULONG                           lx_nor_flash_obsolete_block_erases;
+
+    UINT                            lx_nor_flash_gc_state;
+    UINT                            lx_nor_flash_gc_resumed;
+    ULONG                           lx_nor_flash_gc_block;
+    ULONG                           lx_nor_flash_gc_erase_count;
+    ULONG                           lx_nor_flash_gc_free_sectors;
+    ULONG                           lx_nor_flash_gc_mapped_sectors;
+    ULONG                           lx_nor_flash_gc_sector;
+    ULONG                           lx_nor_flash_gc_mapping_entry;
+    ULONG                           *lx_nor_flash_gc_new_mapping_address;
+    ULONG                           *lx_nor_flash_gc_new_sector_address;
 
 #ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
     UINT                            (*lx_nor_flash_driver_read)(struct LX_NOR_FLASH_STRUCT *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
@@ -638,14 +1102,23 @@ typedef struct LX_NOR_FLASH_STRUCT
 
     ULONG                           *lx_nor_flash_sector_buffer;
     UINT                            lx_nor_flash_sector_mapping_cache_enabled;
+    ULONG                           lx_nor_flash_sector_mapping_cache_tags[LX_NOR_SECTOR_MAPPING_CACHE_SIZE];
     LX_NOR_SECTOR_MAPPING_CACHE_ENTRY   
                                     lx_nor_flash_sector_mapping_cache[LX_NOR_SECTOR_MAPPING_CACHE_SIZE];
+    UCHAR                           lx_nor_flash_sector_mapping_cache_state[LX_NOR_SECTOR_MAPPING_CACHE_SIZE];
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY == LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK
+    UCHAR                           lx_nor_flash_sector_mapping_cache_clock_hand[LX_NOR_SECTOR_MAPPING_CACHE_SETS];
+#endif
 
 #ifndef LX_NOR_DISABLE_EXTENDED_CACHE
 
     UINT                            lx_nor_flash_extended_cache_entries;
     LX_NOR_FLASH_EXTENDED_CACHE_ENTRY
-                                    lx_nor_flash_extended_cache[LX_NOR_EXTENDED_CACHE_SIZE];
+                                    *lx_nor_flash_extended_cache;
+    LX_NOR_FLASH_EXTENDED_CACHE_ENTRY
+                                    **lx_nor_flash_extended_cache_hash_table;
+    ULONG                           lx_nor_flash_extended_cache_hash_mask;
+    UINT                            lx_nor_flash_extended_cache_clock_hand;
     ULONG                           lx_nor_flash_extended_cache_hits;
     ULONG                           lx_nor_flash_extended_cache_misses;
 #ifdef LX_NOR_ENABLE_MAPPING_BITMAP
@@ -659,12 +1132,90 @@ typedef struct LX_NOR_FLASH_STRUCT
 #endif      
 #endif
 
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+    LX_NOR_LOGICAL_SECTOR_INDEX_TYPE
+                                    *lx_nor_flash_logical_sector_index;
+    ULONG                           lx_nor_flash_logical_sector_index_size;
+    ULONG                           lx_nor_flash_logical_sector_index_max_logical_sector;
+    ULONG                           lx_nor_flash_logical_sector_index_hits;
+#endif
+
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+    LX_NOR_FLASH_DATA_CACHE_ENTRY   *lx_nor_flash_data_cache;
+    ULONG                           lx_nor_flash_data_cache_set_mask;
+    ULONG                           lx_nor_flash_data_cache_hits;
+    ULONG                           lx_nor_flash_data_cache_misses;
+    ULONG                           lx_nor_flash_data_cache_invalidations;
+#endif
+
+#ifdef LX_NOR_ENABLE_STATS
+    LX_FLASH_STATS                  lx_nor_flash_stats;
+#endif
+
+#ifdef LX_NOR_ENABLE_TRACE
+    LX_TRACE_HEADER                 *lx_nor_flash_trace;
+#endif
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+    LX_NOR_FLASH_BLOCK_SUMMARY      *lx_nor_flash_block_summary;
+    ULONG                           lx_nor_flash_block_summary_size;
+    UINT                            lx_nor_flash_block_summary_enabled;
+#endif
+
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+    LX_NOR_FLASH_ERASE_QUEUE_NODE   *lx_nor_flash_erase_queue;
+    ULONG                           lx_nor_flash_erase_queue_erase_count_threshold;
+#endif
+
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+    ULONG                           lx_nor_flash_checkpoint_blocks;
+    ULONG                           lx_nor_flash_checkpoint_sequence;
+    UINT                            lx_nor_flash_checkpoint_valid;
+    UINT                            lx_nor_flash_checkpoint_restored;
+#endif
+
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+    ULONG                           lx_nor_flash_write_stream;
+    ULONG                           lx_nor_flash_write_stream_hint;
+    ULONG                           lx_nor_flash_write_stream_block[LX_NOR_WRITE_STREAMS];
+    ULONG                           lx_nor_flash_write_stream_sectors[LX_NOR_WRITE_STREAMS];
+    ULONG                           *lx_nor_flash_hot_sectors;
+    ULONG                           lx_nor_flash_hot_sector_entries;
+    ULONG                           lx_nor_flash_hot_sector_next;
+#endif
+
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+    ULONG                           lx_nor_flash_in_place_overwrites;
+#endif
+
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
+    ULONG                           lx_nor_flash_elided_writes;
+#endif
+
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+    ULONG                           lx_nor_flash_fill_sector_writes;
+#endif
+
 #ifdef LX_THREAD_SAFE_ENABLE
 
-    /* When this conditional is used, the LevelX code utilizes a ThreadX mutex for thread
+    /* When this conditional is used, the LevelX code utilizes a mutex of the lock backend for thread
        safe operation. Generally, this is not required since FileX ensures thread safe operation at
        a higher layer.  */
-    TX_MUTEX                        lx_nor_flash_mutex;
+    LX_LOCK_MUTEX_TYPE              lx_nor_flash_mutex;
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+    /* Shared reads transfer sector data with the NOR flash mutex released. Block erases and 
+       in-place overwrites wait until no shared read is in progress.  */
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+    LX_LOCK_RWLOCK_TYPE             lx_nor_flash_shared_read_lock;
+#else
+    LX_LOCK_MUTEX_TYPE              lx_nor_flash_shared_read_mutex;
+    LX_LOCK_SEMAPHORE_TYPE          lx_nor_flash_shared_read_semaphore;
+    UINT                            lx_nor_flash_shared_read_waiting;
+#endif
+    ULONG                           lx_nor_flash_shared_readers;
+    ULONG                           lx_nor_flash_shared_reads;
+#endif
 #endif
     
     /* Define the NOR flash control block open next/previous pointers.  */
@@ -697,7 +1248,7 @@ typedef struct LX_NOR_FLASH_STRUCT
                         30                  If 0, entry is being superceded
                         31                  If 1, entry is valid
                           
-             Array of physical sectors, with each of size LX_NOR_SECTOR_SIZE
+             Array of physical sectors, with each of size lx_nor_flash_words_per_sector
 */    
 
 
@@ -709,6 +1260,34 @@ typedef struct LX_NOR_FLASH_BLOCK_HEADER_STRUCT
 } LX_NOR_FLASH_BLOCK_HEADER;
 
 
+/* The NOR checkpoint is kept in the lx_nor_flash_checkpoint_blocks blocks that follow the last block 
+   managed by LevelX. It starts with the following header, which is followed by 3 words for each block 
+   when the block summary is included, one word for each logical sector index entry when the index is 
+   included, and a CRC of the words from the sequence number on. The magic number is written last. The 
+   valid word is cleared before the flash is first changed after the checkpoint is written or restored, 
+   so a checkpoint that no longer matches the flash is never trusted.  */
+
+typedef struct LX_NOR_FLASH_CHECKPOINT_HEADER_STRUCT
+{
+    ULONG                           lx_nor_flash_checkpoint_magic;
+    ULONG                           lx_nor_flash_checkpoint_valid;
+    ULONG                           lx_nor_flash_checkpoint_sequence;
+    ULONG                           lx_nor_flash_checkpoint_words;
+    ULONG                           lx_nor_flash_checkpoint_total_blocks;
+    ULONG                           lx_nor_flash_checkpoint_words_per_block;
+    ULONG                           lx_nor_flash_checkpoint_words_per_sector;
+    ULONG                           lx_nor_flash_checkpoint_contents;
+    ULONG                           lx_nor_flash_checkpoint_index_entries;
+    ULONG                           lx_nor_flash_checkpoint_free_physical_sectors;
+    ULONG                           lx_nor_flash_checkpoint_mapped_physical_sectors;
+    ULONG                           lx_nor_flash_checkpoint_obsolete_physical_sectors;
+    ULONG                           lx_nor_flash_checkpoint_minimum_erase_count;
+    ULONG                           lx_nor_flash_checkpoint_minimum_erased_blocks;
+    ULONG                           lx_nor_flash_checkpoint_maximum_erase_count;
+    ULONG                           lx_nor_flash_checkpoint_free_block_search;
+} LX_NOR_FLASH_CHECKPOINT_HEADER;
+
+
 /* Define external structure references.   */
 
 extern LX_NAND_FLASH                                    *_lx_nand_flash_opened_ptr;
@@ -735,18 +1314,37 @@ extern ULONG                                            _lx_nor_flash_opened_cou
 #define lx_nand_flash_sectors_read                      _lx_nand_flash_sectors_read
 #define lx_nand_flash_sectors_release                   _lx_nand_flash_sectors_release
 #define lx_nand_flash_sectors_write                     _lx_nand_flash_sectors_write
+#define lx_nand_flash_stats_get                         _lx_nand_flash_stats_get
+#define lx_nand_flash_stats_reset                       _lx_nand_flash_stats_reset
+#define lx_nand_flash_trace_enable                      _lx_nand_flash_trace_enable
 #define lx_nand_flash_256byte_ecc_check                 _lx_nand_flash_256byte_ecc_check
 #define lx_nand_flash_256byte_ecc_compute               _lx_nand_flash_256byte_ecc_compute
 
 #define lx_nor_flash_close                              _lx_nor_flash_close
+#define lx_nor_flash_block_summary_enable               _lx_nor_flash_block_summary_enable
+#define lx_nor_flash_checkpoint_write                   _lx_nor_flash_checkpoint_write
+#define lx_nor_flash_data_cache_enable                  _lx_nor_flash_data_cache_enable
 #define lx_nor_flash_defragment                         _lx_nor_flash_defragment
 #define lx_nor_flash_partial_defragment                 _lx_nor_flash_partial_defragment
 #define lx_nor_flash_extended_cache_enable              _lx_nor_flash_extended_cache_enable
+#define lx_nor_flash_gc_step                            _lx_nor_flash_gc_step
+#define lx_nor_flash_hot_sectors_enable                 _lx_nor_flash_hot_sectors_enable
 #define lx_nor_flash_initialize                         _lx_nor_flash_initialize
+#define lx_nor_flash_logical_sector_index_enable        _lx_nor_flash_logical_sector_index_enable
 #define lx_nor_flash_open                               _lx_nor_flash_open
 #define lx_nor_flash_sector_read                        _lx_nor_flash_sector_read
 #define lx_nor_flash_sector_release                     _lx_nor_flash_sector_release
 #define lx_nor_flash_sector_write                       _lx_nor_flash_sector_write
+#define lx_nor_flash_sector_write_stream                _lx_nor_flash_sector_write_stream
+#define lx_nor_flash_sectors_read                       _lx_nor_flash_sectors_read
+#define lx_nor_flash_sectors_release                    _lx_nor_flash_sectors_release
+#define lx_nor_flash_sectors_write                      _lx_nor_flash_sectors_write
+#define lx_nor_flash_stats_get                          _lx_nor_flash_stats_get
+#define lx_nor_flash_stats_reset                        _lx_nor_flash_stats_reset
+#define lx_nor_flash_trace_enable                       _lx_nor_flash_trace_enable
+#define lx_nor_flash_watermarks_set                     _lx_nor_flash_watermarks_set
+
+#define lx_stats_latency_percentile                     _lx_stats_latency_percentile
 #endif
 
 
@@ -769,16 +1367,35 @@ UINT    _lx_nand_flash_sector_write(LX_NAND_FLASH *nand_flash, ULONG logical_sec
 UINT    _lx_nand_flash_sectors_read(LX_NAND_FLASH* nand_flash, ULONG logical_sector, VOID* buffer, ULONG sector_count);
 UINT    _lx_nand_flash_sectors_release(LX_NAND_FLASH* nand_flash, ULONG logical_sector, ULONG sector_count);
 UINT    _lx_nand_flash_sectors_write(LX_NAND_FLASH* nand_flash, ULONG logical_sector, VOID* buffer, ULONG sector_count);
+UINT    _lx_nand_flash_stats_get(LX_NAND_FLASH *nand_flash, LX_FLASH_STATS *stats);
+UINT    _lx_nand_flash_stats_reset(LX_NAND_FLASH *nand_flash);
+UINT    _lx_nand_flash_trace_enable(LX_NAND_FLASH *nand_flash, VOID *memory, ULONG size);
 
+UINT    _lx_nor_flash_block_summary_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size);
+UINT    _lx_nor_flash_checkpoint_write(LX_NOR_FLASH *nor_flash);
 UINT    _lx_nor_flash_close(LX_NOR_FLASH *nor_flash);
+UINT    _lx_nor_flash_data_cache_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size);
 UINT    _lx_nor_flash_defragment(LX_NOR_FLASH *nor_flash);
 UINT    _lx_nor_flash_extended_cache_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size);
+UINT    _lx_nor_flash_gc_step(LX_NOR_FLASH *nor_flash, ULONG budget);
+UINT    _lx_nor_flash_hot_sectors_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size);
 UINT    _lx_nor_flash_initialize(void);
+UINT    _lx_nor_flash_logical_sector_index_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size);
 UINT    _lx_nor_flash_open(LX_NOR_FLASH  *nor_flash, CHAR *name, UINT (*nor_driver_initialize)(LX_NOR_FLASH *));
 UINT    _lx_nor_flash_partial_defragment(LX_NOR_FLASH *nor_flash, UINT max_blocks);
 UINT    _lx_nor_flash_sector_read(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer);
 UINT    _lx_nor_flash_sector_release(LX_NOR_FLASH *nor_flash, ULONG logical_sector);
 UINT    _lx_nor_flash_sector_write(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer);
+UINT    _lx_nor_flash_sector_write_stream(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer, ULONG stream);
+UINT    _lx_nor_flash_sectors_read(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer, ULONG sector_count);
+UINT    _lx_nor_flash_sectors_release(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG sector_count);
+UINT    _lx_nor_flash_sectors_write(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer, ULONG sector_count);
+UINT    _lx_nor_flash_stats_get(LX_NOR_FLASH *nor_flash, LX_FLASH_STATS *stats);
+UINT    _lx_nor_flash_stats_reset(LX_NOR_FLASH *nor_flash);
+UINT    _lx_nor_flash_trace_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size);
+UINT    _lx_nor_flash_watermarks_set(LX_NOR_FLASH *nor_flash, ULONG low_free_sectors, ULONG high_free_sectors);
+
+ULONG   _lx_stats_latency_percentile(LX_FLASH_STATS *stats, UINT api, UINT percent);
 
 
 /* Internal LevelX prototypes.  */
@@ -806,20 +1423,54 @@ UINT    _lx_nand_flash_memory_initialize(LX_NAND_FLASH* nand_flash, ULONG* memor
 UINT    _lx_nand_flash_metadata_allocate(LX_NAND_FLASH* nand_flash);
 UINT    _lx_nand_flash_metadata_build(LX_NAND_FLASH* nand_flash);
 UINT    _lx_nand_flash_metadata_write(LX_NAND_FLASH *nand_flash, UCHAR* main_buffer, ULONG spare_value);
+UINT    _lx_nand_flash_sector_compare(LX_NAND_FLASH *nand_flash, ULONG logical_sector, VOID *buffer);
+UINT    _lx_nand_flash_shared_read_begin(LX_NAND_FLASH *nand_flash, UCHAR **spare_buffer);
+VOID    _lx_nand_flash_shared_read_end(LX_NAND_FLASH *nand_flash, UCHAR *spare_buffer);
+VOID    _lx_nand_flash_shared_read_wait(LX_NAND_FLASH *nand_flash);
 VOID    _lx_nand_flash_system_error(LX_NAND_FLASH *nand_flash, UINT error_code, ULONG block, ULONG page);
 UINT    _lx_nand_flash_256byte_ecc_check(UCHAR *page_buffer, UCHAR *ecc_buffer);
 UINT    _lx_nand_flash_256byte_ecc_compute(UCHAR *page_buffer, UCHAR *ecc_buffer);
 
 UINT    _lx_nor_flash_block_reclaim(LX_NOR_FLASH *nor_flash);
+UINT    _lx_nor_flash_block_reclaim_step(LX_NOR_FLASH *nor_flash, ULONG *operations);
+VOID    _lx_nor_flash_block_summary_update(LX_NOR_FLASH *nor_flash, ULONG *physical_sector_map_entry, UINT sector_obsoleted);
+ULONG   _lx_nor_flash_checkpoint_crc_update(ULONG crc, ULONG word);
+UINT    _lx_nor_flash_checkpoint_invalidate(LX_NOR_FLASH *nor_flash);
+UINT    _lx_nor_flash_checkpoint_read(LX_NOR_FLASH *nor_flash);
+VOID    _lx_nor_flash_data_cache_invalidate(LX_NOR_FLASH *nor_flash, ULONG logical_sector);
+UINT    _lx_nor_flash_data_cache_read(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer);
+VOID    _lx_nor_flash_data_cache_write(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer, UINT sector_written);
 UINT    _lx_nor_flash_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
 UINT    _lx_nor_flash_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
 UINT    _lx_nor_flash_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
+VOID    _lx_nor_flash_erase_queue_update(LX_NOR_FLASH *nor_flash, ULONG block);
+VOID    _lx_nor_flash_extended_cache_entry_assign(LX_NOR_FLASH *nor_flash, LX_NOR_FLASH_EXTENDED_CACHE_ENTRY *cache_entry, ULONG *sector_address);
+LX_NOR_FLASH_EXTENDED_CACHE_ENTRY
+        *_lx_nor_flash_extended_cache_entry_find(LX_NOR_FLASH *nor_flash, ULONG *flash_address);
+UINT    _lx_nor_flash_fill_sector_check(LX_NOR_FLASH *nor_flash, VOID *buffer);
+UINT    _lx_nor_flash_fill_sector_expand(LX_NOR_FLASH *nor_flash, ULONG *physical_sector_map_entry, VOID *buffer);
+VOID    _lx_nor_flash_free_sectors_reclaim(LX_NOR_FLASH *nor_flash, ULONG sectors);
 VOID    _lx_nor_flash_internal_error(LX_NOR_FLASH *nor_flash, ULONG error_code);
 UINT    _lx_nor_flash_logical_sector_find(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG superceded_check, ULONG **physical_sector_map_entry, ULONG **physical_sector_address);
+VOID    _lx_nor_flash_logical_sector_index_update(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG *physical_sector_map_entry);
 UINT    _lx_nor_flash_next_block_to_erase_find(LX_NOR_FLASH *nor_flash, ULONG *return_erase_block, ULONG *return_erase_count, ULONG *return_mapped_sectors, ULONG *return_obsolete_sectors);
 UINT    _lx_nor_flash_physical_sector_allocate(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG **physical_sector_map_entry, ULONG **physical_sector_address);
+UINT    _lx_nor_flash_sector_compare(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer);
+UINT    _lx_nor_flash_sector_map(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG *old_mapping_address, ULONG *new_mapping_address, ULONG *new_sector_address, ULONG new_mapping_entry, VOID *buffer);
+UINT    _lx_nor_flash_sector_mapping_cache_find(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG **physical_sector_map_entry, ULONG **physical_sector_address);
+VOID    _lx_nor_flash_sector_mapping_cache_insert(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG *physical_sector_map_entry, ULONG *physical_sector_address);
 VOID    _lx_nor_flash_sector_mapping_cache_invalidate(LX_NOR_FLASH *nor_flash, ULONG logical_sector);
+UINT    _lx_nor_flash_sector_overwrite(LX_NOR_FLASH *nor_flash, ULONG *physical_sector_map_entry, ULONG *physical_sector_address, VOID *buffer);
+VOID    _lx_nor_flash_sector_mapping_cache_update(LX_NOR_FLASH *nor_flash, ULONG index, ULONG way, UINT cache_hit);
+VOID    _lx_nor_flash_shared_read_begin(LX_NOR_FLASH *nor_flash);
+VOID    _lx_nor_flash_shared_read_end(LX_NOR_FLASH *nor_flash);
+VOID    _lx_nor_flash_shared_read_wait(LX_NOR_FLASH *nor_flash);
 VOID    _lx_nor_flash_system_error(LX_NOR_FLASH *nor_flash, UINT error_code);
+VOID    _lx_nor_flash_write_stream_select(LX_NOR_FLASH *nor_flash, ULONG logical_sector);
+
+UINT    _lx_lock_mutex_create(LX_LOCK_MUTEX_TYPE *mutex);
+VOID    _lx_stats_api_record(LX_FLASH_STATS *stats, UINT api, ULONG start_time);
+VOID    _lx_trace_event_insert(LX_TRACE_HEADER *trace, ULONG event, ULONG info1, ULONG info2);
 
 
 #ifdef __cplusplus
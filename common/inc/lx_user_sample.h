@@ -25,7 +25,7 @@
 /*  PORT SPECIFIC C INFORMATION                            RELEASE        */
 /*                                                                        */
 /*    lx_user.h                                           PORTABLE C      */
-/*                                                           6.3.0        */
+/*                                                           6.x          */
 /*                                                                        */
 /*  AUTHOR                                                                */
 /*                                                                        */
@@ -55,6 +55,16 @@
 /*                                            bitmap cache and obsolete   */
 /*                                            count cache,                */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added logical sector index, */
+/*                                            block summary and erase     */
+/*                                            queue options, documented   */
+/*                                            runtime sector size,        */
+/*                                            added mapping cache depth   */
+/*                                            and policy options, removed */
+/*                                            extended cache size default,*/
+/*                                            added data cache options,   */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 
@@ -90,8 +100,9 @@
 #define LX_NOR_DISABLE_EXTENDED_CACHE
 */
 
-/* By default this value is 8, which represents a maximum of 8 sectors that 
-   can be cached in a NOR instance.
+/* By default the number of sectors cached in a NOR instance is only limited by the 
+   memory supplied to lx_nor_flash_extended_cache_enable. Defining this value limits 
+   the number of cached sectors.
 */
 /*
 #define LX_NOR_EXTENDED_CACHE_SIZE   8 
@@ -106,17 +117,97 @@
 #define LX_NOR_SECTOR_MAPPING_CACHE_SIZE   16
 */
 
-/* Defined, this makes LevelX thread-safe by using a ThreadX mutex object 
-   throughout the API.
+/* By default this value is 4 and defines the number of ways in each set of the logical sector 
+   mapping cache. The maximum depth is 64 and the cache size divided by the depth must be a power of 2.
+*/
+/*
+#define LX_NOR_SECTOR_MAPPING_CACHE_DEPTH   4
+*/
+
+/* Defines the replacement policy of the logical sector mapping cache. LX_NOR_SECTOR_MAPPING_CACHE_POLICY_LRU
+   (the default) replaces the least recently used way of a set. LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK 
+   replaces the first way without its reference bit set, which is cheaper to maintain for deep sets. 
+   LX_NOR_SECTOR_MAPPING_CACHE_POLICY_2Q keeps sectors that are found in the cache again, such as FAT 
+   sectors, in up to LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED_WAYS protected ways of each set, so sectors 
+   that are only used once don't evict them. By default half the ways of a set can be protected.
+*/
+/*
+#define LX_NOR_SECTOR_MAPPING_CACHE_POLICY          LX_NOR_SECTOR_MAPPING_CACHE_POLICY_LRU
+#define LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED_WAYS  2
+*/
+
+/* Defined, this makes LevelX thread-safe by using a mutex object of the lock backend 
+   (LX_LOCK_BACKEND, ThreadX by default) throughout the API.
 */
 /*
 #define LX_THREAD_SAFE_ENABLE
 */
 
+/* Defines shared reads for NOR and NAND flash, which require LX_THREAD_SAFE_ENABLE. When enabled, a
+   sector read finds the sector with the mutex held, but releases the mutex while the sector data is
+   transferred from flash, so reads of several threads overlap. Block erases, and NOR sectors that are
+   overwritten in place, wait until no shared read is in progress. The driver read function must be
+   safe to call while another thread programs or erases a different part of the flash, e.g. on parts
+   with read-while-write or with a lock in the driver. Each concurrent NAND reader uses its own spare
+   buffer, LX_NAND_SHARED_READERS (at most 32) of them are taken from the NAND memory, reads beyond that
+   hold the mutex. Shared reads are counted in lx_nor_flash_shared_reads and lx_nand_flash_shared_reads.  */
+/*
+#define LX_NOR_ENABLE_SHARED_READ
+#define LX_NAND_ENABLE_SHARED_READ
+#define LX_NAND_SHARED_READERS                      4
+*/
+
 /* Defined, LevelX will be used in standalone mode (without Azure RTOS ThreadX) */
 
 /* #define LX_STANDALONE_ENABLE */
 
+/* Defines the lock backend of LX_THREAD_SAFE_ENABLE. LX_LOCK_BACKEND_THREADX, the default with ThreadX, 
+   uses ThreadX mutexes and semaphores. In standalone mode, thread safe operation is disabled unless 
+   LX_LOCK_BACKEND_PTHREAD_MUTEX or LX_LOCK_BACKEND_PTHREAD_RWLOCK is selected, which use recursive 
+   pthread mutexes, and for shared reads POSIX semaphores or a pthread read/write lock respectively. 
+   These need the POSIX declarations, e.g. _XOPEN_SOURCE=600 with -std=c99, and linking with -pthread. 
+   LX_LOCK_BACKEND_NONE compiles the thread safe code without any locking, for single threaded use.  */
+/*
+#define LX_LOCK_BACKEND                             LX_LOCK_BACKEND_PTHREAD_MUTEX
+*/
+
+/* Defines the latency and throughput statistics. When enabled, every NOR (NAND) instance keeps a
+   LX_FLASH_STATS record of the sector read, write, release and defragment calls, and of the NOR multiple
+   sector read, write and release calls, with a log2 latency histogram per API, the number of driver calls
+   per operation and the bytes written by the application against the bytes programmed, which
+   lx_nor_flash_stats_get (lx_nand_flash_stats_get) returns and lx_nor_flash_stats_reset
+   (lx_nand_flash_stats_reset) clears. LX_STATS_CLOCK_GET supplies the time stamps, tx_time_get by default
+   with ThreadX. In standalone mode it must be defined for the latency to be measured. NAND driver counts
+   are in pages. With shared reads, the driver counts of reads done outside the mutex are approximate.  */
+/*
+#define LX_NOR_ENABLE_STATS
+#define LX_NAND_ENABLE_STATS
+#define LX_STATS_CLOCK_GET()                        tx_time_get()
+*/
+
+/* Defines the event trace. When enabled, lx_nor_flash_trace_enable (lx_nand_flash_trace_enable) starts
+   recording time stamped events into a ring buffer in memory supplied by the application: the start and
+   end of the APIs, block reclaims, sector relocations, block erases, NAND metadata writes and allocations
+   and NOR cache misses. The oldest events are overwritten once the buffer is full. Time stamps come from
+   LX_STATS_CLOCK_GET. A dump of the buffer is turned into a timeline by utility/trace/lx_trace_decode.c.  */
+/*
+#define LX_NOR_ENABLE_TRACE
+#define LX_NAND_ENABLE_TRACE
+*/
+
+/* Defines the device image files of the NOR and NAND flash simulators. The simulators start with the
+   geometry compiled into lx_nor_flash_simulator.c (lx_nand_flash_simulator.c) in a static memory area,
+   _lx_nor_flash_simulator_geometry_set (_lx_nand_flash_simulator_geometry_set) selects another number of
+   blocks, sectors (pages) per block and memory before the flash is opened. When enabled,
+   _lx_nor_flash_simulator_file_open (_lx_nand_flash_simulator_file_open) maps a device image file as the
+   memory, so the flash persists between runs and can be larger than the static area. A new image is
+   erased, an existing image must match the geometry. These need the POSIX declarations, e.g.
+   _XOPEN_SOURCE=600 with -std=c99.  */
+/*
+#define LX_NOR_SIMULATOR_ENABLE_FILE
+#define LX_NAND_SIMULATOR_ENABLE_FILE
+*/
+
 /* Define user extension for NOR flash control block. User extension is placed at the end of flash control block and it is not cleared on opening flash. */
 /* 
 #define LX_NOR_FLASH_USER_EXTENSION    ????
@@ -145,10 +236,137 @@
 #define LX_NOR_OBSOLETE_COUNT_CACHE_TYPE            UCHAR
 */
 
+/* Determine if the RAM logical sector index should be enabled for NOR flash. The index holds the physical 
+   sector of each logical sector, so finding a mapped sector no longer requires searching the mapping lists. 
+   Index memory is supplied with lx_nor_flash_logical_sector_index_enable, either from the driver 
+   initialization or after the NOR flash is opened.  */
+/*
+#define LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+*/
+
+/* Defines logical sector index element size. If the total number of physical sectors is less than 65535, 
+   USHORT may be used instead of ULONG to halve the index memory.  */
+/*
+#define LX_NOR_LOGICAL_SECTOR_INDEX_TYPE            ULONG
+*/
+
+/* Defines the NOR block summary. When enabled, the erase count and the number of free, mapped and 
+   obsolete sectors of each block are kept in RAM so the next block to erase can be selected without 
+   reading the flash. The next free sector of each block is also kept, so free physical sectors are 
+   allocated without reading the free sector bit map. The memory is supplied with lx_nor_flash_block_summary_enable and must hold 
+   LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(total_blocks) bytes.  */
+/*
+#define LX_NOR_ENABLE_BLOCK_SUMMARY
+*/
+
+/* Defines the NOR erase queue. When enabled with the block summary, the next block to erase is kept in a 
+   tree over the block summary that is updated as sector counts and erase counts change, so selecting 
+   the next block to erase no longer examines every block. The queue nodes are part of the block summary 
+   memory given by LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE.  */
+/*
+#define LX_NOR_ENABLE_ERASE_QUEUE
+*/
+
+/* Defines the NOR data cache. When enabled, lx_nor_flash_data_cache_enable supplies RAM that holds 
+   whole logical sectors, so single sector reads of sectors that were recently read or written, such as 
+   FAT and configuration sectors, are served without accessing the flash. The memory needed for a number 
+   of sectors of a sector size is given by LX_NOR_DATA_CACHE_MEMORY_SIZE.  */
+/*
+#define LX_NOR_ENABLE_DATA_CACHE
+*/
+
+/* Defines the number of sectors in each set of the NOR data cache. The default is 4.  */
+/*
+#define LX_NOR_DATA_CACHE_WAYS                  4
+*/
+
+/* Defines the default free sector watermarks of a NOR flash instance, in blocks worth of sectors. A 
+   sector write that would leave fewer free sectors than the low watermark reclaims blocks until the 
+   low watermark is reached, and lx_nor_flash_gc_step reclaims blocks ahead of the writes up to the
+   high watermark. A driver can set lx_nor_flash_free_sectors_low_watermark and 
+   lx_nor_flash_free_sectors_high_watermark in its initialization function, or the application can 
+   call lx_nor_flash_watermarks_set. The low watermark must be at least 1 block. The defaults are 
+   1 and 2.  */
+/*
+#define LX_NOR_FLASH_LOW_WATERMARK_BLOCKS       1
+#define LX_NOR_FLASH_HIGH_WATERMARK_BLOCKS      2
+*/
+
+/* Defines the maximum number of blocks a NOR sector write reclaims to reach the low watermark, which
+   bounds the time of a write. The bound does not apply while fewer than a block's worth of sectors are
+   free, since those are needed to reclaim a block. The default is 1.  */
+/*
+#define LX_NOR_FLASH_FOREGROUND_RECLAIM_BLOCKS  1
+*/
+
+/* Defines NOR write streams. When enabled, each write stream fills its own block, so sectors rewritten 
+   often, such as FAT and directory sectors, are not mixed with file data in the same blocks and their 
+   blocks mostly become fully obsolete before they are reclaimed. The stream of a write can be given with 
+   lx_nor_flash_sector_write_stream. Otherwise, if lx_nor_flash_hot_sectors_enable supplied memory for 
+   LX_NOR_HOT_SECTORS_MEMORY_SIZE(entries) bytes, a write is hot if its logical sector is among the most 
+   recently written sectors. Sectors relocated by a block reclaim are cold. The write amplification is 
+   (lx_nor_flash_host_sector_writes + lx_nor_flash_relocated_sector_writes) divided by 
+   lx_nor_flash_host_sector_writes.  */
+/*
+#define LX_NOR_ENABLE_WRITE_STREAMS
+*/
+
+/* Defines the number of NOR write streams. The default is 2, a cold and a hot stream.  */
+/*
+#define LX_NOR_WRITE_STREAMS                    2
+*/
+
+/* Defines NOR in-place overwrite. When enabled, lx_nor_flash_sector_write and lx_nor_flash_sectors_write
+   compare the new data with the data of the mapped physical sector. If the write only clears bits, such as
+   appending records to a log sector or decrementing a bit-mask counter, the words that change are
+   programmed in place and the sector mapping isn't changed. Otherwise, the sector is written to a new
+   physical sector as usual. A power loss during an in-place overwrite can leave each word of the sector
+   with either its old or its new value, so this should only be used when the application can detect or
+   tolerate that.  */
+/*
+#define LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+*/
+
+/* Defines write if changed for NOR and NAND flash. When enabled, a sector write compares the new data 
+   with the data of the mapped sector and returns success without changing the flash if they match, 
+   which is common for FAT and directory sectors. NOR data is compared directly with LX_DIRECT_READ, 
+   and otherwise taken from the data cache or read into the internal sector buffer. Skipped writes are 
+   counted in lx_nor_flash_elided_writes and lx_nand_flash_diagnostic_elided_writes.  */
+/*
+#define LX_NOR_ENABLE_WRITE_IF_CHANGED
+#define LX_NAND_ENABLE_WRITE_IF_CHANGED
+*/
+
+/* Defines the NOR fill program skip. When enabled, a sector write whose words all hold the same value, 
+   such as a zeroed or erased sector, programs only the first data word and marks the mapping entry as a 
+   fill sector; reads expand that word over the sector. Only the data program is skipped: the write still 
+   allocates a physical sector, updates the mapping and later reclaims the block like any other write, so 
+   it saves program time, not capacity, erases or mapping work. Logical sectors are limited to 0x0FFFFFFF, 
+   since bit 28 of the mapping entry marks the fill sector. Skipped programs are counted in 
+   lx_nor_flash_fill_sector_writes.  */
+/*
+#define LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+*/
+
+/* Defines the NOR mount checkpoint. When enabled, lx_nor_flash_close and lx_nor_flash_checkpoint_write 
+   save the sector counts, erase counts, block summary and logical sector index in blocks the driver 
+   reserves after the last LevelX block, so the next lx_nor_flash_open restores them instead of walking 
+   every block. The driver sets lx_nor_flash_checkpoint_blocks to the number of reserved blocks in its 
+   initialization function. The first flash change after the checkpoint is written invalidates it, so 
+   a NOR flash that isn't closed is opened by walking the blocks as usual.  */
+/*
+#define LX_NOR_ENABLE_CHECKPOINT
+*/
+
 /* Define the logical sector size for NOR flash. The sector size is in units of 32-bit words. 
-   This sector size should match the sector size used in file system.  */
+   This sector size should match the sector size used in file system. This is the default sector size,
+   a driver can select a different sector size for its NOR flash instance by setting 
+   lx_nor_flash_words_per_sector in its initialization function. The sector size must be a power of 2,
+   no smaller than LX_NOR_SECTOR_SIZE_MIN and no larger than LX_NOR_SECTOR_SIZE_MAX.  */
 /*
 #define LX_NOR_SECTOR_SIZE                          (512/sizeof(ULONG))
+#define LX_NOR_SECTOR_SIZE_MIN                      (512/sizeof(ULONG))
+#define LX_NOR_SECTOR_SIZE_MAX                      (4096/sizeof(ULONG))
 */
 
 #endif
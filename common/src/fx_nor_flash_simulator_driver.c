@@ -63,7 +63,7 @@ VOID  _fx_nor_flash_simulator_driver(FX_MEDIA *media_ptr);
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _fx_nor_flash_simulator_driver                      PORTABLE C      */ 
-/*                                                           6.1.7        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -102,8 +102,9 @@ VOID  _fx_nor_flash_simulator_driver(FX_MEDIA *media_ptr);
 /*    lx_nor_flash_close                    Close NOR flash manager       */ 
 /*    lx_nor_flash_open                     Open NOR flash manager        */ 
 /*    lx_nor_flash_sector_read              Read a NOR sector             */ 
-/*    lx_nor_flash_sector_release           Release a NOR sector          */ 
-/*    lx_nor_flash_sector_write             Write a NOR sector            */ 
+/*    lx_nor_flash_sectors_read             Read NOR sectors              */
+/*    lx_nor_flash_sectors_release          Release NOR sectors           */
+/*    lx_nor_flash_sectors_write            Write NOR sectors             */
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -118,6 +119,10 @@ VOID  _fx_nor_flash_simulator_driver(FX_MEDIA *media_ptr);
 /*                                            resulting in version 6.1    */
 /*  06-02-2021     Bhupendra Naphade        Modified comment(s),          */
 /*                                            resulting in version 6.1.7  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            used multi-sector APIs,     */
+/*                                            added runtime sector size,  */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 VOID  _fx_nor_flash_simulator_driver(FX_MEDIA *media_ptr)
@@ -126,7 +131,6 @@ VOID  _fx_nor_flash_simulator_driver(FX_MEDIA *media_ptr)
 UCHAR       *source_buffer;
 UCHAR       *destination_buffer;
 ULONG       logical_sector;
-ULONG       i;
 UINT        status;
 
 
@@ -211,27 +215,18 @@ UINT        status;
             logical_sector =      media_ptr -> fx_media_driver_logical_sector;
             destination_buffer =  (UCHAR *) media_ptr -> fx_media_driver_buffer;
 
-            /* Loop to read sectors from flash.  */
-            for (i = 0; i < media_ptr -> fx_media_driver_sectors; i++)
-            {
-            
-                /* Read a sector from NOR flash.  */
-                status =  lx_nor_flash_sector_read(&nor_flash, logical_sector, destination_buffer);
+            /* Read the sectors from NOR flash.  */
+            status =  lx_nor_flash_sectors_read(&nor_flash, logical_sector, destination_buffer, media_ptr -> fx_media_driver_sectors);
 
-                /* Determine if the read was successful.  */
-                if (status != LX_SUCCESS)
-                {
+            /* Determine if the read was successful.  */
+            if (status != LX_SUCCESS)
+            {
                 
-                    /* Return an I/O error to FileX.  */
-                    media_ptr -> fx_media_driver_status =  FX_IO_ERROR;
+                /* Return an I/O error to FileX.  */
+                media_ptr -> fx_media_driver_status =  FX_IO_ERROR;
                     
-                    return;
-                } 
-
-                /* Move to the next entries.  */
-                logical_sector++;
-                destination_buffer =  destination_buffer + media_ptr -> fx_media_bytes_per_sector;
-            }
+                return;
+            } 
 
             /* Successful driver request.  */
             media_ptr -> fx_media_driver_status =  FX_SUCCESS;
@@ -245,27 +240,18 @@ UINT        status;
             logical_sector =      media_ptr -> fx_media_driver_logical_sector;
             source_buffer =       (UCHAR *) media_ptr -> fx_media_driver_buffer;
 
-            /* Loop to write sectors to flash.  */
-            for (i = 0; i < media_ptr -> fx_media_driver_sectors; i++)
-            {
-            
-                /* Write a sector to NOR flash.  */
-                status =  lx_nor_flash_sector_write(&nor_flash, logical_sector, source_buffer);
+            /* Write the sectors to NOR flash.  */
+            status =  lx_nor_flash_sectors_write(&nor_flash, logical_sector, source_buffer, media_ptr -> fx_media_driver_sectors);
 
-                /* Determine if the write was successful.  */
-                if (status != LX_SUCCESS)
-                {
+            /* Determine if the write was successful.  */
+            if (status != LX_SUCCESS)
+            {
                 
-                    /* Return an I/O error to FileX.  */
-                    media_ptr -> fx_media_driver_status =  FX_IO_ERROR;
+                /* Return an I/O error to FileX.  */
+                media_ptr -> fx_media_driver_status =  FX_IO_ERROR;
                     
-                    return;
-                } 
-
-                /* Move to the next entries.  */
-                logical_sector++;
-                source_buffer =  source_buffer + media_ptr -> fx_media_bytes_per_sector;
-            }
+                return;
+            } 
 
             /* Successful driver request.  */
             media_ptr -> fx_media_driver_status =  FX_SUCCESS;
@@ -278,26 +264,18 @@ UINT        status;
             /* Setup the logical sector.  */
             logical_sector =  media_ptr -> fx_media_driver_logical_sector;
 
-            /* Release sectors.  */
-            for (i = 0; i < media_ptr -> fx_media_driver_sectors; i++)
-            {
-            
-                /* Release NOR flash sector.  */
-                status =  lx_nor_flash_sector_release(&nor_flash, logical_sector);
+            /* Release the sectors.  */
+            status =  lx_nor_flash_sectors_release(&nor_flash, logical_sector, media_ptr -> fx_media_driver_sectors);
 
-                /* Determine if the sector release was successful.  */
-                if (status != LX_SUCCESS)
-                {
+            /* Determine if the sector release was successful.  */
+            if (status != LX_SUCCESS)
+            {
                 
-                    /* Return an I/O error to FileX.  */
-                    media_ptr -> fx_media_driver_status =  FX_IO_ERROR;
+                /* Return an I/O error to FileX.  */
+                media_ptr -> fx_media_driver_status =  FX_IO_ERROR;
                     
-                    return;
-                } 
-
-                /* Move to the next entries.  */
-                logical_sector++;
-            }
+                return;
+            } 
 
             /* Successful driver request.  */
             media_ptr -> fx_media_driver_status =  FX_SUCCESS;
@@ -428,7 +406,7 @@ UINT        status;
         {
 
             /* Make sure the media bytes per sector equals to the LevelX logical sector size.  */
-            if (media_ptr -> fx_media_bytes_per_sector != (LX_NOR_SECTOR_SIZE) * sizeof(ULONG))
+            if (media_ptr -> fx_media_bytes_per_sector != (nor_flash.lx_nor_flash_words_per_sector) * sizeof(ULONG))
             {
 
                 /* Sector size mismatch, return error.  */
@@ -0,0 +1,122 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   Lock                                                                */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_lock_mutex_create                               PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function creates the mutex of a pthread lock backend. The      */ 
+/*    mutex is recursive, since the LevelX APIs call each other with      */ 
+/*    the mutex held. For the other backends the mutex is created by      */ 
+/*    the LX_LOCK_MUTEX_CREATE macro directly.                            */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    mutex                                 Pointer to mutex              */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    pthread_mutexattr_init                Initialize mutex attributes   */ 
+/*    pthread_mutexattr_settype             Set recursive mutex type      */ 
+/*    pthread_mutex_init                    Initialize mutex              */ 
+/*    pthread_mutexattr_destroy             Delete mutex attributes       */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_open                                                 */ 
+/*    _lx_nor_flash_open                                                  */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_lock_mutex_create(LX_LOCK_MUTEX_TYPE *mutex)
+{
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_MUTEX) || (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+pthread_mutexattr_t     attributes;
+UINT                    status;
+
+
+    /* Initialize the mutex attributes.  */
+    status =  (UINT) pthread_mutexattr_init(&attributes);
+
+    /* Determine if the attributes are initialized.  */
+    if (status == LX_SUCCESS)
+    {
+
+        /* Make the mutex recursive.  */
+        status =  (UINT) pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+
+        /* Determine if the type is set.  */
+        if (status == LX_SUCCESS)
+        {
+
+            /* Create the mutex.  */
+            status =  (UINT) pthread_mutex_init(mutex, &attributes);
+        }
+
+        /* The attributes are no longer needed.  */
+        pthread_mutexattr_destroy(&attributes);
+    }
+
+    /* Return status.  */
+    return(status);
+#else
+
+    LX_PARAMETER_NOT_USED(mutex);
+
+    /* Return not supported, the mutex is created by LX_LOCK_MUTEX_CREATE.  */
+    return(LX_NOT_SUPPORTED);
+#endif
+}
@@ -71,8 +71,8 @@
 /*    _lx_nand_flash_erase_count_set        Set erase count               */
 /*    _lx_nand_flash_free_block_list_add    Add free block to list        */
 /*    _lx_nand_flash_system_error           Internal system error handler */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -83,6 +83,10 @@
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  03-08-2023     Xiuwen Cai               Initial Version 6.2.1        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added lock backend support, */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_block_data_move(LX_NAND_FLASH *nand_flash, ULONG new_block)
@@ -116,6 +120,9 @@ ULONG       block_mapping_index;
         return(LX_ERROR);
     }
 
+    /* Trace the block being reclaimed.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_RECLAIM, block, new_block);
+
     /* Set new block status to allocated for now.  */
     new_block_status = LX_NAND_BLOCK_STATUS_ALLOCATED;
 
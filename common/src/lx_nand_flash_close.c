@@ -58,7 +58,9 @@
 /*                                                                        */ 
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
-/*    tx_mutex_delete                       Delete thread-safe mutex      */ 
+/*    LX_LOCK_MUTEX_DELETE                  Delete thread-safe mutex      */ 
+/*    LX_LOCK_SEMAPHORE_DELETE              Delete shared read semaphore  */ 
+/*    LX_LOCK_RWLOCK_DELETE                 Delete shared read lock       */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -73,6 +75,10 @@
 /*                                            resulting in version 6.1    */
 /*  06-02-2021     Bhupendra Naphade        Modified comment(s),          */
 /*                                            resulting in version 6.1.7  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added shared reads,         */
+/*                                            added lock backend support, */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_close(LX_NAND_FLASH *nand_flash)
@@ -123,7 +129,20 @@ LX_INTERRUPT_SAVE_AREA
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Delete the thread safe mutex.  */
-    tx_mutex_delete(&nand_flash -> lx_nand_flash_mutex);
+    LX_LOCK_MUTEX_DELETE(&nand_flash -> lx_nand_flash_mutex);
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Delete the shared read lock.  */
+    LX_LOCK_RWLOCK_DELETE(&nand_flash -> lx_nand_flash_shared_read_lock);
+#else
+
+    /* Delete the shared read mutex and semaphore.  */
+    LX_LOCK_MUTEX_DELETE(&nand_flash -> lx_nand_flash_shared_read_mutex);
+    LX_LOCK_SEMAPHORE_DELETE(&nand_flash -> lx_nand_flash_shared_read_semaphore);
+#endif
+#endif
 #endif
     /* Return success.  */
     return(LX_SUCCESS);
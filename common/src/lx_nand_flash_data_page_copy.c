@@ -82,6 +82,10 @@
 /*                                            fixed sequential checking   */
 /*                                            logic,                      */
 /*                                            resulting in version 6.4.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_data_page_copy(LX_NAND_FLASH* nand_flash, ULONG logical_sector, ULONG source_block, USHORT src_block_status,
@@ -99,6 +103,9 @@ ULONG   dest_block_status;
 ULONG   number_of_pages;
 
 
+    /* Trace the pages moved to the destination block.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_RELOCATE, source_block, destination_block);
+
     /* Get the destination block status.  */
     dest_block_status = *dest_block_status_ptr;
 
@@ -130,6 +137,9 @@ ULONG   number_of_pages;
                 status = (nand_flash -> lx_nand_flash_driver_pages_read)(source_block, (ULONG)source_page, LX_NULL, spare_buffer_ptr, 1);
 #endif
 
+                /* Increment the number of pages read.  */
+                nand_flash -> lx_nand_flash_diagnostic_page_reads++;
+
                 /* Check for an error from flash driver.   */
                 if (status)
                 {
@@ -159,6 +169,9 @@ ULONG   number_of_pages;
                         status = (nand_flash -> lx_nand_flash_driver_pages_copy)(source_block, (ULONG)source_page, destination_block, destination_page, 1, nand_flash -> lx_nand_flash_page_buffer);
 #endif
 
+                        /* Increment the number of pages moved.  */
+                        nand_flash -> lx_nand_flash_diagnostic_moved_pages++;
+
                         /* Check for an error from flash driver.   */
                         if (status)
                         {
@@ -214,6 +227,9 @@ ULONG   number_of_pages;
             status = (nand_flash -> lx_nand_flash_driver_pages_copy)(source_block, (ULONG)source_page, destination_block, destination_page, number_of_pages, nand_flash -> lx_nand_flash_page_buffer);
 #endif
 
+            /* Increment the number of pages moved.  */
+            nand_flash -> lx_nand_flash_diagnostic_moved_pages +=  number_of_pages;
+
             /* Check for an error from flash driver.   */
             if (status)
             {
@@ -59,8 +59,8 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    _lx_nand_flash_block_reclaim          Reclaim a NAND flash block    */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -79,6 +79,9 @@
 /*  03-08-2023     Xiuwen Cai               Modified comment(s),          */
 /*                                            deprecated this API,        */
 /*                                            resulting in version 6.2.1 */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added lock backend support, */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_defragment(LX_NAND_FLASH *nand_flash)
@@ -61,6 +61,7 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    (lx_nand_flash_driver_block_erase)    Driver erase block            */ 
+/*    _lx_nand_flash_shared_read_wait       Wait for shared reads         */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -79,6 +80,10 @@
 /*                                            removed cache support,      */
 /*                                            added new driver interface, */
 /*                                            resulting in version 6.2.1 */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added shared reads,         */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_driver_block_erase(LX_NAND_FLASH *nand_flash, ULONG block, ULONG erase_count)
@@ -90,6 +95,12 @@ UINT    status;
     /* Increment the block erases count.  */
     nand_flash -> lx_nand_flash_diagnostic_block_erases++;
 
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+    /* Wait for shared reads, they may be reading pages of this block.  */
+    _lx_nand_flash_shared_read_wait(nand_flash);
+#endif
+
     /* Call driver erase block function.  */
 #ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
     status =  (nand_flash -> lx_nand_flash_driver_block_erase)(nand_flash, block, erase_count);
@@ -97,6 +108,9 @@ UINT    status;
     status =  (nand_flash -> lx_nand_flash_driver_block_erase)(block, erase_count);
 #endif
 
+    /* Trace the block erase.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_BLOCK_ERASE, block, erase_count);
+
     /* Return status.  */
     return(status);
 }
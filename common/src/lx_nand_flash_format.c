@@ -76,7 +76,7 @@
 /*    _lx_nand_flash_metadata_write         Write metadata                */
 /*    _lx_nand_flash_driver_block_erase     Driver block erase            */ 
 /*    _lx_nand_flash_system_error           System error handler          */ 
-/*    tx_mutex_create                       Create thread-safe mutex      */ 
+/*    LX_LOCK_MUTEX_CREATE                  Create thread-safe mutex      */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -92,6 +92,9 @@
 /*                                            extension in flash control  */
 /*                                            block,                      */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added lock backend support, */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_format(LX_NAND_FLASH* nand_flash, CHAR* name,
@@ -72,6 +72,9 @@
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  03-08-2023     Xiuwen Cai               Initial Version 6.2.1        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added shared reads,         */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_memory_initialize(LX_NAND_FLASH  *nand_flash, ULONG* memory_ptr, UINT memory_size)
@@ -186,6 +189,24 @@ UINT    buffer_size;
         return(LX_NO_MEMORY);
     }
 
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+    /* Assign memory for the spare buffers of shared reads.  */
+    nand_flash -> lx_nand_flash_shared_read_buffers = ((UCHAR*)memory_ptr) + memory_offset;
+    nand_flash -> lx_nand_flash_shared_read_buffers_used = 0;
+
+    /* Update memory offset, keeping the page buffer word aligned.  */
+    memory_offset += ((LX_NAND_SHARED_READERS * nand_flash -> lx_nand_flash_spare_total_length) + sizeof(ULONG) - 1) & ~((UINT)sizeof(ULONG) - 1);
+
+    /* Check if there is enough memory.  */
+    if (memory_offset > memory_size)
+    {
+
+        /* No enough memory, return error.  */
+        return(LX_NO_MEMORY);
+    }
+#endif
+
     /* Assign memory for page buffer.  */
     nand_flash -> lx_nand_flash_page_buffer = ((UCHAR*)memory_ptr) + memory_offset;
 
@@ -78,6 +78,10 @@
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  03-08-2023     Xiuwen Cai               Initial Version 6.2.1        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added lock backend support, */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_metadata_allocate(LX_NAND_FLASH *nand_flash)
@@ -213,7 +217,7 @@ UCHAR   min_erase_count;
 #ifdef LX_THREAD_SAFE_ENABLE
 
                 /* Release the thread safe mutex.  */
-                tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                 /* Return an error.  */
@@ -249,7 +253,7 @@ UCHAR   min_erase_count;
 #ifdef LX_THREAD_SAFE_ENABLE
 
                 /* Release the thread safe mutex.  */
-                tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                 /* Return an error.  */
@@ -349,6 +353,10 @@ UCHAR   min_erase_count;
         return (status);
     }
 
+    /* Trace the new metadata blocks.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_METADATA_ALLOCATE, nand_flash -> lx_nand_flash_metadata_block_number_next,
+                         nand_flash -> lx_nand_flash_backup_metadata_block_number_next);
+
     /* Setup page buffer.  */
     page_buffer_ptr = nand_flash -> lx_nand_flash_page_buffer;
 
@@ -74,6 +74,10 @@
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  03-08-2023     Xiuwen Cai               Initial Version 6.2.1        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_metadata_write(LX_NAND_FLASH *nand_flash, UCHAR* main_buffer, ULONG spare_value)
@@ -108,6 +112,9 @@ UCHAR   *spare_buffer_ptr;
     /* Get current metadata page number. */
     page = nand_flash -> lx_nand_flash_metadata_block_current_page;
 
+    /* Trace the metadata page write.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_METADATA_WRITE, block, spare_value);
+
     /* Write the page.  */
 #ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
     status = (nand_flash -> lx_nand_flash_driver_pages_write)(nand_flash, block, page, main_buffer, spare_buffer_ptr, 1);
@@ -115,6 +122,9 @@ UCHAR   *spare_buffer_ptr;
     status = (nand_flash -> lx_nand_flash_driver_pages_write)(block, page, main_buffer, spare_buffer_ptr, 1);
 #endif
 
+    /* Increment the number of pages written.  */
+    nand_flash -> lx_nand_flash_diagnostic_page_writes++;
+
     /* Check for an error from flash driver.   */    
     if (status)
     {
@@ -142,6 +152,9 @@ UCHAR   *spare_buffer_ptr;
     status = (nand_flash -> lx_nand_flash_driver_pages_write)(block, page, main_buffer, spare_buffer_ptr, 1);
 #endif
 
+    /* Increment the number of pages written.  */
+    nand_flash -> lx_nand_flash_diagnostic_page_writes++;
+
     /* Check for an error from flash driver.   */
     if (status)
     {
@@ -74,7 +74,9 @@
 /*    _lx_nand_flash_free_block_list_add    Add free block to list        */
 /*    _lx_nand_flash_mapped_block_list_add  Add mapped block to list      */
 /*    _lx_nand_flash_system_error           System error handler          */ 
-/*    tx_mutex_create                       Create thread-safe mutex      */ 
+/*    LX_LOCK_MUTEX_CREATE                  Create thread-safe mutex      */ 
+/*    LX_LOCK_SEMAPHORE_CREATE              Create shared read semaphore  */ 
+/*    LX_LOCK_RWLOCK_CREATE                 Create shared read lock       */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -90,6 +92,11 @@
 /*                                            extension in flash control  */
 /*                                            block,                      */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added shared reads,         */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_open(LX_NAND_FLASH  *nand_flash, CHAR *name, UINT (*nand_driver_initialize)(LX_NAND_FLASH *),
@@ -204,6 +211,9 @@ LX_INTERRUPT_SAVE_AREA
         status = (nand_flash -> lx_nand_flash_driver_pages_read)(block, 0, page_buffer_ptr, spare_buffer_ptr, 1);
 #endif
 
+        /* Increment the number of pages read.  */
+        nand_flash -> lx_nand_flash_diagnostic_page_reads++;
+
         /* Check for an error from flash driver.   */
         if (status)
         {
@@ -283,6 +293,9 @@ LX_INTERRUPT_SAVE_AREA
             status = (nand_flash -> lx_nand_flash_driver_pages_read)(block, page, page_buffer_ptr, spare_buffer_ptr, 1);
 #endif
 
+            /* Increment the number of pages read.  */
+            nand_flash -> lx_nand_flash_diagnostic_page_reads++;
+
             /* Check for an error from flash driver.   */
             if (status)
             {
@@ -468,9 +481,9 @@ LX_INTERRUPT_SAVE_AREA
 
 #ifdef LX_THREAD_SAFE_ENABLE
 
-    /* If the thread safe option is enabled, create a ThreadX mutex that will be used in all external APIs 
+    /* If the thread safe option is enabled, create a mutex that will be used in all external APIs 
        in order to provide thread-safe operation.  */
-    status =  tx_mutex_create(&nand_flash -> lx_nand_flash_mutex, "NAND Flash Mutex", TX_NO_INHERIT);
+    status =  LX_LOCK_MUTEX_CREATE(&nand_flash -> lx_nand_flash_mutex, "NAND Flash Mutex");
 
     /* Determine if the mutex creation encountered an error.  */
     if (status != LX_SUCCESS)
@@ -482,6 +495,33 @@ LX_INTERRUPT_SAVE_AREA
         /* Return error to caller.  */
         return(LX_ERROR);
     }
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Create the read/write lock that coordinates shared reads with block erases.  */
+    status =  LX_LOCK_RWLOCK_CREATE(&nand_flash -> lx_nand_flash_shared_read_lock, "NAND Flash Shared Read Lock");
+#else
+
+    /* Create the mutex and semaphore that coordinate shared reads with block erases.  */
+    status =  LX_LOCK_MUTEX_CREATE(&nand_flash -> lx_nand_flash_shared_read_mutex, "NAND Flash Shared Read Mutex");
+    if (status == LX_SUCCESS)
+    {
+        status =  LX_LOCK_SEMAPHORE_CREATE(&nand_flash -> lx_nand_flash_shared_read_semaphore, "NAND Flash Shared Read Semaphore");
+    }
+#endif
+
+    /* Determine if the creation encountered an error.  */
+    if (status != LX_SUCCESS)
+    {
+    
+        /* Call system error handler, since this should not happen.  */
+        _lx_nand_flash_system_error(nand_flash, LX_SYSTEM_MUTEX_CREATE_FAILED, 0, 0);
+    
+        /* Return error to caller.  */
+        return(LX_ERROR);
+    }
+#endif
 #endif
 
     /* Lockout interrupts.  */
@@ -0,0 +1,224 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation 
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ * 
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */ 
+/** LevelX Component                                                      */ 
+/**                                                                       */
+/**   NAND Flash                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_sector_compare                       PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function compares the data of a logical sector with the        */ 
+/*    buffer, so a write of the same data can be skipped. The page of the */ 
+/*    sector is read into the internal page buffer.                       */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nand_flash                            NAND flash instance           */ 
+/*    logical_sector                        Logical sector number         */ 
+/*    buffer                                Pointer to new sector data    */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                         LX_SUCCESS if the sector is   */ 
+/*                                            mapped with the same data   */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_block_find             Find the mapped block         */ 
+/*    lx_nand_flash_driver_pages_read       Read pages                    */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_sector_write                                         */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nand_flash_sector_compare(LX_NAND_FLASH *nand_flash, ULONG logical_sector, VOID *buffer)
+{
+#ifdef LX_NAND_ENABLE_WRITE_IF_CHANGED
+
+UINT        status;
+ULONG       block;
+USHORT      block_status;
+UCHAR       *page_buffer_ptr;
+UCHAR       *spare_buffer_ptr;
+UCHAR       *source_ptr;
+ULONG       available_pages;
+LONG        page;
+ULONG       i;
+
+
+    /* See if we can find the sector in the current mapping.  */
+    status = _lx_nand_flash_block_find(nand_flash, logical_sector, &block, &block_status);
+
+    /* Check return status.   */
+    if (status != LX_SUCCESS)
+    {
+
+        /* Return the error, the sector must be written.  */
+        return(status);
+    }
+
+    /* Determine if the block is mapped.  */
+    if (block == LX_NAND_BLOCK_UNMAPPED)
+    {
+
+        /* No, the sector must be written.  */
+        return(LX_SECTOR_NOT_FOUND);
+    }
+
+    /* Setup the page and spare buffer pointers.  */
+    page_buffer_ptr =  nand_flash -> lx_nand_flash_page_buffer;
+    spare_buffer_ptr = page_buffer_ptr + nand_flash -> lx_nand_flash_bytes_per_page;
+
+    /* Get available pages in this block.  */
+    available_pages = block_status & LX_NAND_BLOCK_STATUS_FULL ? nand_flash -> lx_nand_flash_pages_per_block : block_status & LX_NAND_BLOCK_STATUS_PAGE_NUMBER_MASK;
+
+    /* Determine if the pages are recorded sequentially.  */
+    if (block_status & LX_NAND_BLOCK_STATUS_NON_SEQUENTIAL)
+    {
+
+        /* Loop to search the logical page, the last page written is the current one.  */
+        for (page = (LONG)available_pages - 1; page >= 0; page--)
+        {
+
+            /* Read the spare bytes of the page.  */
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+            status = (nand_flash -> lx_nand_flash_driver_pages_read)(nand_flash, block, (ULONG)page, LX_NULL, spare_buffer_ptr, 1);
+#else
+            status = (nand_flash -> lx_nand_flash_driver_pages_read)(block, (ULONG)page, LX_NULL, spare_buffer_ptr, 1);
+#endif
+
+            /* Increment the number of pages read.  */
+            nand_flash -> lx_nand_flash_diagnostic_page_reads++;
+
+            /* Check for an error from flash driver.   */
+            if (status)
+            {
+
+                /* Return the error, the sector must be written.  */
+                return(status);
+            }
+                
+            /* Get the logical sector number from spare bytes, and check if it matches the addressed sector number.  */
+            if ((LX_UTILITY_LONG_GET(&spare_buffer_ptr[nand_flash -> lx_nand_flash_spare_data1_offset]) & LX_NAND_PAGE_TYPE_USER_DATA_MASK) == logical_sector)
+            {
+
+                /* Determine if the sector is released.  */
+                if ((LX_UTILITY_LONG_GET(&spare_buffer_ptr[nand_flash -> lx_nand_flash_spare_data1_offset]) & (~LX_NAND_PAGE_TYPE_USER_DATA_MASK)) != (LX_NAND_PAGE_TYPE_USER_DATA))
+                {
+
+                    /* Yes, the sector must be written.  */
+                    return(LX_SECTOR_NOT_FOUND);
+                }
+
+                /* Found the page of the sector.  */
+                break;
+            }
+        }
+    }
+    else
+    {
+
+        /* Check if the logical sector is available.  */
+        page =  (LONG) (logical_sector % nand_flash -> lx_nand_flash_pages_per_block);
+        if ((ULONG) page >= available_pages)
+            page =  -1;
+    }
+
+    /* Determine if the sector was found.  */
+    if (page < 0)
+    {
+
+        /* No, the sector must be written.  */
+        return(LX_SECTOR_NOT_FOUND);
+    }
+
+    /* Read the page of the sector.  */
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    status = (nand_flash -> lx_nand_flash_driver_pages_read)(nand_flash, block, (ULONG)page, page_buffer_ptr, spare_buffer_ptr, 1);
+#else
+    status = (nand_flash -> lx_nand_flash_driver_pages_read)(block, (ULONG)page, page_buffer_ptr, spare_buffer_ptr, 1);
+#endif
+
+    /* Increment the number of pages read.  */
+    nand_flash -> lx_nand_flash_diagnostic_page_reads++;
+
+    /* Check for an error from flash driver. A corrected error also has the page written again.  */
+    if (status)
+    {
+
+        /* Return the error, the sector must be written.  */
+        return(status);
+    }
+
+    /* Loop to compare the sector data.  */
+    source_ptr =  (UCHAR *) buffer;
+    for (i = 0; i < nand_flash -> lx_nand_flash_bytes_per_page; i++)
+    {
+
+        /* Determine if this byte is different.  */
+        if (source_ptr[i] != page_buffer_ptr[i])
+        {
+
+            /* Yes, the sector must be written.  */
+            return(LX_ERROR);
+        }
+    }
+
+    /* Return success, the sector already holds the data.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nand_flash);
+    LX_PARAMETER_NOT_USED(logical_sector);
+    LX_PARAMETER_NOT_USED(buffer);
+
+    /* Return an error, the sector must be written.  */
+    return(LX_ERROR);
+#endif
+}
@@ -64,9 +64,11 @@
 /*                                                                        */ 
 /*    _lx_nand_flash_block_find             Find the mapped block         */ 
 /*    lx_nand_flash_driver_pages_read       Read pages                    */ 
+/*    _lx_nand_flash_shared_read_begin      Start a shared read           */ 
+/*    _lx_nand_flash_shared_read_end        End a shared read             */ 
 /*    _lx_nand_flash_system_error           Internal system error handler */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -77,6 +79,12 @@
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  03-08-2023     Xiuwen Cai               Initial Version 6.2.1        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added shared reads,         */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_sector_read(LX_NAND_FLASH *nand_flash, ULONG logical_sector, VOID *buffer)
@@ -90,13 +98,27 @@ USHORT      block_status;
 UCHAR       *spare_buffer_ptr;
 ULONG       available_pages;
 LONG        page;
+#ifdef LX_NAND_ENABLE_SHARED_READ
+UINT        shared_read;
+#endif
+#ifdef LX_NAND_ENABLE_STATS
+ULONG       start_time;
+#endif
 
+#ifdef LX_NAND_ENABLE_STATS
+
+    /* Remember when this sector read started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Obtain the thread safe mutex.  */
-    tx_mutex_get(&nand_flash -> lx_nand_flash_mutex, TX_WAIT_FOREVER);
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
+    /* Trace the start of the sector read.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTOR_READ, logical_sector);
+
     /* Increment the number of read requests.  */
     nand_flash -> lx_nand_flash_diagnostic_sector_read_requests++;
 
@@ -113,10 +135,13 @@ LONG        page;
         /* Determine if the error is fatal.  */
         if (status != LX_NAND_ERROR_CORRECTED)
         {
+
+            /* Trace the end of the sector read.  */
+            LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
             /* Return an error.  */
             return(LX_ERROR);
@@ -129,6 +154,12 @@ LONG        page;
         
         /* Setup spare buffer pointer.  */
         spare_buffer_ptr = (UCHAR*)nand_flash -> lx_nand_flash_page_buffer;
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+        /* Release the NAND flash mutex while the pages are read, if a spare buffer of its own is available
+           for this read.  */
+        shared_read = _lx_nand_flash_shared_read_begin(nand_flash, &spare_buffer_ptr);
+#endif
 
         /* Get available pages in this block.  */
         available_pages = block_status & LX_NAND_BLOCK_STATUS_FULL ? nand_flash -> lx_nand_flash_pages_per_block : block_status & LX_NAND_BLOCK_STATUS_PAGE_NUMBER_MASK;
@@ -148,16 +179,28 @@ LONG        page;
                 status = (nand_flash -> lx_nand_flash_driver_pages_read)(block, (ULONG)page, (UCHAR*)buffer, spare_buffer_ptr, 1);
 #endif
 
+                /* Increment the number of pages read.  */
+                nand_flash -> lx_nand_flash_diagnostic_page_reads++;
+
                 /* Check for an error from flash driver.   */
                 if (status)
                 {
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+                    /* Obtain the NAND flash mutex again.  */
+                    if (shared_read == LX_SUCCESS)
+                        _lx_nand_flash_shared_read_end(nand_flash, spare_buffer_ptr);
+#endif
 
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                    /* Trace the end of the sector read.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
                     /* Return an error.  */
                     return(LX_ERROR);
@@ -166,10 +209,24 @@ LONG        page;
                 /* Get the logical sector number from spare bytes, and check if it matches the addressed sector number.  */
                 if ((LX_UTILITY_LONG_GET(&spare_buffer_ptr[nand_flash -> lx_nand_flash_spare_data1_offset]) & LX_NAND_PAGE_TYPE_USER_DATA_MASK) == logical_sector)
                 {
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+                    /* Obtain the NAND flash mutex again.  */
+                    if (shared_read == LX_SUCCESS)
+                        _lx_nand_flash_shared_read_end(nand_flash, spare_buffer_ptr);
+#endif
+#ifdef LX_NAND_ENABLE_STATS
+
+                    /* Record the latency of this sector read.  */
+                    _lx_stats_api_record(&nand_flash -> lx_nand_flash_stats, LX_STATS_SECTOR_READ, start_time);
+#endif
+
+                    /* Trace the end of the sector read.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, LX_SUCCESS);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
                     /* Return successful completion.  */
                     return(LX_SUCCESS);
@@ -190,30 +247,61 @@ LONG        page;
                 status = (nand_flash -> lx_nand_flash_driver_pages_read)(block, logical_sector % nand_flash -> lx_nand_flash_pages_per_block, (UCHAR*)buffer, spare_buffer_ptr, 1);
 #endif
 
+                /* Increment the number of pages read.  */
+                nand_flash -> lx_nand_flash_diagnostic_page_reads++;
+
                 /* Check for an error from flash driver.   */
                 if (status)
                 {
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+                    /* Obtain the NAND flash mutex again.  */
+                    if (shared_read == LX_SUCCESS)
+                        _lx_nand_flash_shared_read_end(nand_flash, spare_buffer_ptr);
+#endif
 
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, block, 0);
 
+                    /* Trace the end of the sector read.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
                     /* Return an error.  */
                     return(LX_ERROR);
                 }
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+                /* Obtain the NAND flash mutex again.  */
+                if (shared_read == LX_SUCCESS)
+                    _lx_nand_flash_shared_read_end(nand_flash, spare_buffer_ptr);
+#endif
+#ifdef LX_NAND_ENABLE_STATS
+
+                /* Record the latency of this sector read.  */
+                _lx_stats_api_record(&nand_flash -> lx_nand_flash_stats, LX_STATS_SECTOR_READ, start_time);
+#endif
+
+                /* Trace the end of the sector read.  */
+                LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, LX_SUCCESS);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                 /* Release the thread safe mutex.  */
-                tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
                 /* Return successful completion.  */
                 return(LX_SUCCESS);
             }
         }
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+        /* Obtain the NAND flash mutex again.  */
+        if (shared_read == LX_SUCCESS)
+            _lx_nand_flash_shared_read_end(nand_flash, spare_buffer_ptr);
+#endif
     }
 
     /* Sector hasn't been written. Simply fill the destination buffer with ones and return success.  */
@@ -232,10 +320,18 @@ LONG        page;
     /* Set the status to success.  */
     status =  LX_SUCCESS;
 
+#ifdef LX_NAND_ENABLE_STATS
+
+    /* Record the latency of this sector read.  */
+    _lx_stats_api_record(&nand_flash -> lx_nand_flash_stats, LX_STATS_SECTOR_READ, start_time);
+#endif
+
+    /* Trace the end of the sector read.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, status);
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Release the thread safe mutex.  */
-    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
     /* Return status.  */
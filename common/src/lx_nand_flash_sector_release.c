@@ -74,8 +74,8 @@
 /*    _lx_nand_flash_block_status_set       Set block status              */ 
 /*    _lx_nand_flash_mapped_block_list_add  Add mapped block to list      */
 /*    _lx_nand_flash_system_error           Internal system error handler */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -86,6 +86,11 @@
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  03-08-2023     Xiuwen Cai               Initial Version 6.2.1        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_sector_release(LX_NAND_FLASH *nand_flash, ULONG logical_sector)
@@ -100,13 +105,24 @@ LONG        page;
 UINT        release_sector = LX_FALSE;
 ULONG       new_block;
 USHORT      new_block_status;
+#ifdef LX_NAND_ENABLE_STATS
+ULONG       start_time;
+#endif
+
+#ifdef LX_NAND_ENABLE_STATS
 
+    /* Remember when this sector release started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Obtain the thread safe mutex.  */
-    tx_mutex_get(&nand_flash -> lx_nand_flash_mutex, TX_WAIT_FOREVER);
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
+    /* Trace the start of the sector release.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTOR_RELEASE, logical_sector);
+
     /* Increment the number of release requests.  */
     nand_flash -> lx_nand_flash_diagnostic_sector_release_requests++;
 
@@ -124,10 +140,13 @@ USHORT      new_block_status;
         /* Determine if the error is fatal.  */
         if (status != LX_NAND_ERROR_CORRECTED)
         {
+
+            /* Trace the end of the sector release.  */
+            LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
             /* Return an error.  */
@@ -160,16 +179,22 @@ USHORT      new_block_status;
                 status = (nand_flash -> lx_nand_flash_driver_pages_read)(block, (ULONG)page, LX_NULL, spare_buffer_ptr, 1);
 #endif
 
+                /* Increment the number of pages read.  */
+                nand_flash -> lx_nand_flash_diagnostic_page_reads++;
+
                 /* Check for an error from flash driver.   */
                 if (status)
                 {
 
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                    /* Trace the end of the sector release.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                     /* Return an error.  */
@@ -218,10 +243,13 @@ USHORT      new_block_status;
                 {
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, new_block, 0);
+
+                    /* Trace the end of the sector release.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                     /* Return an error.  */
@@ -244,10 +272,13 @@ USHORT      new_block_status;
 
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, new_block, 0);
+
+                    /* Trace the end of the sector release.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                     /* Return an error.  */
@@ -267,10 +298,13 @@ USHORT      new_block_status;
 
                         /* Call system error handler.  */
                         _lx_nand_flash_system_error(nand_flash, status, new_block, 0);
+
+                        /* Trace the end of the sector release.  */
+                        LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                         /* Release the thread safe mutex.  */
-                        tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                        LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                         /* Return an error.  */
@@ -300,10 +334,13 @@ USHORT      new_block_status;
 
                         /* Call system error handler.  */
                         _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                        /* Trace the end of the sector release.  */
+                        LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                         /* Release the thread safe mutex.  */
-                        tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                        LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                         /* Return an error.  */
@@ -323,10 +360,13 @@ USHORT      new_block_status;
 
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                    /* Trace the end of the sector release.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                     /* Return an error.  */
@@ -342,10 +382,13 @@ USHORT      new_block_status;
 
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                    /* Trace the end of the sector release.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                     /* Return an error.  */
@@ -371,10 +414,13 @@ USHORT      new_block_status;
 
                         /* Call system error handler.  */
                         _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                        /* Trace the end of the sector release.  */
+                        LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                         /* Release the thread safe mutex.  */
-                        tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                        LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                         /* Return an error.  */
@@ -420,16 +466,22 @@ USHORT      new_block_status;
                 status = (nand_flash -> lx_nand_flash_driver_pages_write)(block, available_pages, (UCHAR*)nand_flash -> lx_nand_flash_page_buffer, spare_buffer_ptr, 1);
 #endif
 
+                /* Increment the number of pages written.  */
+                nand_flash -> lx_nand_flash_diagnostic_page_writes++;
+
                 /* Check for an error from flash driver.   */
                 if (status)
                 {
 
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                    /* Trace the end of the sector release.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                     /* Return an error.  */
@@ -462,10 +514,13 @@ USHORT      new_block_status;
 
                     /* Call system error handler.  */
                     _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                    /* Trace the end of the sector release.  */
+                    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                     /* Release the thread safe mutex.  */
-                    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                     /* Return an error.  */
@@ -474,10 +529,18 @@ USHORT      new_block_status;
             }
         }
     }
+#ifdef LX_NAND_ENABLE_STATS
+
+    /* Record the latency of this sector release.  */
+    _lx_stats_api_record(&nand_flash -> lx_nand_flash_stats, LX_STATS_SECTOR_RELEASE, start_time);
+#endif
+
+    /* Trace the end of the sector release.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, status);
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Release the thread safe mutex.  */
-    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
     /* Return status.  */
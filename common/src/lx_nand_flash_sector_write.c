@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nand_flash_sector_write                         PORTABLE C      */ 
-/*                                                           6.2.1       */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    Xiuwen Cai, Microsoft Corporation                                   */
@@ -62,6 +62,7 @@
 /*                                                                        */ 
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
+/*    _lx_nand_flash_sector_compare         Compare sector data           */
 /*    _lx_nand_flash_block_find             Find the mapped block         */ 
 /*    _lx_nand_flash_block_allocate         Allocate block                */ 
 /*    _lx_nand_flash_mapped_block_list_remove                             */
@@ -76,8 +77,8 @@
 /*    _lx_nand_flash_block_data_move        Move block data               */
 /*    _lx_nand_flash_mapped_block_list_add  Add mapped block to list      */
 /*    _lx_nand_flash_system_error           Internal system error handler */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -88,6 +89,12 @@
 /*    DATE              NAME                      DESCRIPTION             */
 /*                                                                        */
 /*  03-08-2023     Xiuwen Cai               Initial Version 6.2.1        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added write if changed,     */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nand_flash_sector_write(LX_NAND_FLASH *nand_flash, ULONG logical_sector, VOID *buffer)
@@ -102,15 +109,57 @@ USHORT                              new_block_status = LX_NAND_BLOCK_STATUS_ALLO
 UCHAR                               *spare_buffer_ptr;
 UINT                                update_mapping = LX_FALSE;
 UINT                                copy_block = LX_FALSE;
+#ifdef LX_NAND_ENABLE_STATS
+ULONG                               start_time;
+#endif
+
+#ifdef LX_NAND_ENABLE_STATS
 
+    /* Remember when this sector write started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Obtain the thread safe mutex.  */
-    tx_mutex_get(&nand_flash -> lx_nand_flash_mutex, TX_WAIT_FOREVER);
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
+    /* Trace the start of the sector write.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTOR_WRITE, logical_sector);
+
     /* Increment the number of write requests.  */
     nand_flash -> lx_nand_flash_diagnostic_sector_write_requests++;
+#ifdef LX_NAND_ENABLE_STATS
+
+    /* Count the bytes written by the application.  */
+    nand_flash -> lx_nand_flash_stats.lx_flash_stats_bytes_requested +=  nand_flash -> lx_nand_flash_bytes_per_page;
+#endif
+#ifdef LX_NAND_ENABLE_WRITE_IF_CHANGED
+
+    /* Determine if the sector is already mapped with the same data.  */
+    if (_lx_nand_flash_sector_compare(nand_flash, logical_sector, buffer) == LX_SUCCESS)
+    {
+
+        /* Yes, the flash doesn't need to be changed.  */
+        nand_flash -> lx_nand_flash_diagnostic_elided_writes++;
+#ifdef LX_NAND_ENABLE_STATS
+
+        /* Record the latency of this sector write.  */
+        _lx_stats_api_record(&nand_flash -> lx_nand_flash_stats, LX_STATS_SECTOR_WRITE, start_time);
+#endif
+
+        /* Trace the end of the sector write.  */
+        LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_SUCCESS);
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
+#endif
+
+        /* Return success.  */
+        return(LX_SUCCESS);
+    }
+#endif
 
     /* See if we can find the logical sector in the current mapping.  */
     status = _lx_nand_flash_block_find(nand_flash, logical_sector, &block, &block_status);
@@ -125,10 +174,13 @@ UINT                                copy_block = LX_FALSE;
         /* Determine if the error is fatal.  */
         if (status != LX_NAND_ERROR_CORRECTED)
         {
+
+            /* Trace the end of the sector write.  */
+            LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
             /* Return an error.  */
@@ -146,10 +198,18 @@ UINT                                copy_block = LX_FALSE;
         /* Check if there is no blocks.  */
         if (status == LX_NO_BLOCKS)
         {
+#ifdef LX_NAND_ENABLE_STATS
+
+            /* Record the latency of this sector write.  */
+            _lx_stats_api_record(&nand_flash -> lx_nand_flash_stats, LX_STATS_SECTOR_WRITE, start_time);
+#endif
+
+            /* Trace the end of the sector write.  */
+            LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, status);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
             /* Return error.  */
@@ -166,10 +226,13 @@ UINT                                copy_block = LX_FALSE;
             /* Determine if the error is fatal.  */
             if (status != LX_NAND_ERROR_CORRECTED)
             {
+
+                /* Trace the end of the sector write.  */
+                LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                 /* Release the thread safe mutex.  */
-                tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                 /* Return an error.  */
@@ -212,10 +275,13 @@ UINT                                copy_block = LX_FALSE;
 
             /* Call system error handler.  */
             _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+            /* Trace the end of the sector write.  */
+            LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
             /* Return an error.  */
@@ -258,16 +324,22 @@ UINT                                copy_block = LX_FALSE;
     status = (nand_flash -> lx_nand_flash_driver_pages_write)(new_block, page, (UCHAR*)buffer, spare_buffer_ptr, 1);
 #endif
 
+    /* Increment the number of pages written.  */
+    nand_flash -> lx_nand_flash_diagnostic_page_writes++;
+
     /* Check for an error from flash driver.   */
     if (status)
     {
 
         /* Call system error handler.  */
         _lx_nand_flash_system_error(nand_flash, status, new_block, 0);
+
+        /* Trace the end of the sector write.  */
+        LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
         /* Release the thread safe mutex.  */
-        tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+        LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
         /* Return an error.  */
@@ -309,10 +381,13 @@ UINT                                copy_block = LX_FALSE;
 
             /* Call system error handler.  */
             _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+            /* Trace the end of the sector write.  */
+            LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
             /* Return an error.  */
@@ -329,10 +404,13 @@ UINT                                copy_block = LX_FALSE;
 
         /* Call system error handler.  */
         _lx_nand_flash_system_error(nand_flash, status, new_block, 0);
+
+        /* Trace the end of the sector write.  */
+        LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
         /* Release the thread safe mutex.  */
-        tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+        LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
         /* Return an error.  */
@@ -352,10 +430,13 @@ UINT                                copy_block = LX_FALSE;
 
             /* Call system error handler.  */
             _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+            /* Trace the end of the sector write.  */
+            LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
             /* Return an error.  */
@@ -371,10 +452,13 @@ UINT                                copy_block = LX_FALSE;
 
             /* Call system error handler.  */
             _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+            /* Trace the end of the sector write.  */
+            LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
             /* Return an error.  */
@@ -400,10 +484,13 @@ UINT                                copy_block = LX_FALSE;
 
                 /* Call system error handler.  */
                 _lx_nand_flash_system_error(nand_flash, status, block, 0);
+
+                /* Trace the end of the sector write.  */
+                LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                 /* Release the thread safe mutex.  */
-                tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+                LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
                 /* Return an error.  */
@@ -423,10 +510,18 @@ UINT                                copy_block = LX_FALSE;
         _lx_nand_flash_mapped_block_list_add(nand_flash, logical_sector / nand_flash -> lx_nand_flash_pages_per_block);
     }
 
+#ifdef LX_NAND_ENABLE_STATS
+
+    /* Record the latency of this sector write.  */
+    _lx_stats_api_record(&nand_flash -> lx_nand_flash_stats, LX_STATS_SECTOR_WRITE, start_time);
+#endif
+
+    /* Trace the end of the sector write.  */
+    LX_NAND_TRACE_INSERT(nand_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, status);
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Release the thread safe mutex.  */
-    tx_mutex_put(&nand_flash -> lx_nand_flash_mutex);
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
 #endif
 
     /* Return the completion status.  */
@@ -0,0 +1,153 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation 
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ * 
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */ 
+/** LevelX Component                                                      */ 
+/**                                                                       */
+/**   NAND Flash                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_shared_read_begin                    PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function starts a shared read. The caller holds the NAND flash */ 
+/*    mutex and has found the block to read. If a spare buffer for shared */ 
+/*    reads is available, it is assigned to the reader, the reader is     */ 
+/*    counted and the NAND flash mutex is released, so other reads can    */ 
+/*    run while the pages are read. Block erases wait until the count of  */ 
+/*    readers drops to zero. Otherwise the read is done with the NAND     */ 
+/*    flash mutex held.                                                   */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nand_flash                            NAND flash instance           */ 
+/*    spare_buffer                          Pointer to the spare buffer   */ 
+/*                                            pointer of the reader       */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*    LX_LOCK_RWLOCK_READ_GET               Get shared read lock          */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_sector_read                                          */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nand_flash_shared_read_begin(LX_NAND_FLASH *nand_flash, UCHAR **spare_buffer)
+{
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+ULONG       i;
+
+#if (LX_LOCK_BACKEND != LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Obtain the shared read mutex.  */
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_shared_read_mutex);
+#endif
+
+    /* Loop to find a spare buffer that is not used.  */
+    for (i = 0; i < LX_NAND_SHARED_READERS; i++)
+    {
+
+        /* Determine if this spare buffer is used.  */
+        if ((nand_flash -> lx_nand_flash_shared_read_buffers_used & ((ULONG) 1 << i)) == 0)
+        {
+
+            /* No, get out of the loop.  */
+            break;
+        }
+    }
+
+    /* Determine if all the spare buffers are used.  */
+    if (i == LX_NAND_SHARED_READERS)
+    {
+#if (LX_LOCK_BACKEND != LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+        /* Release the shared read mutex.  */
+        LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_shared_read_mutex);
+#endif
+
+        /* Return an error, the read is done with the NAND flash mutex held.  */
+        return(LX_NO_MEMORY);
+    }
+
+    /* Assign the spare buffer to this reader and count the reader.  */
+    nand_flash -> lx_nand_flash_shared_read_buffers_used |=  ((ULONG) 1 << i);
+    nand_flash -> lx_nand_flash_shared_readers++;
+    nand_flash -> lx_nand_flash_shared_reads++;
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Obtain the shared read lock for reading. This does not block, since block erases only 
+       obtain it for writing with the NAND flash mutex held.  */
+    LX_LOCK_RWLOCK_READ_GET(&nand_flash -> lx_nand_flash_shared_read_lock);
+#else
+
+    /* Release the shared read mutex.  */
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_shared_read_mutex);
+#endif
+
+    /* Return the spare buffer.  */
+    *spare_buffer =  nand_flash -> lx_nand_flash_shared_read_buffers + (i * nand_flash -> lx_nand_flash_spare_total_length);
+
+    /* Release the thread safe mutex, the pages are read without it.  */
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
+
+    /* Return success.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nand_flash);
+    LX_PARAMETER_NOT_USED(spare_buffer);
+
+    /* Return an error, the read is done with the NAND flash mutex held.  */
+    return(LX_NOT_SUPPORTED);
+#endif
+}
@@ -0,0 +1,132 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation 
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ * 
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */ 
+/** LevelX Component                                                      */ 
+/**                                                                       */
+/**   NAND Flash                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_shared_read_end                      PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function ends a shared read. The spare buffer of the reader is */ 
+/*    released and the reader is removed from the count. A waiting block  */ 
+/*    erase is resumed when the last reader is done, and the NAND flash   */ 
+/*    mutex is obtained again for the caller.                             */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nand_flash                            NAND flash instance           */ 
+/*    spare_buffer                          Spare buffer of the reader    */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*    LX_LOCK_SEMAPHORE_PUT                 Resume waiting block erase    */ 
+/*    LX_LOCK_RWLOCK_PUT                    Release shared read lock      */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_sector_read                                          */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nand_flash_shared_read_end(LX_NAND_FLASH *nand_flash, UCHAR *spare_buffer)
+{
+#ifdef LX_NAND_ENABLE_SHARED_READ
+
+ULONG       i;
+
+
+    /* Calculate the index of the spare buffer.  */
+    i =  (ULONG) (spare_buffer - nand_flash -> lx_nand_flash_shared_read_buffers) / nand_flash -> lx_nand_flash_spare_total_length;
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Release the shared read lock, a waiting block erase can now obtain it.  */
+    LX_LOCK_RWLOCK_PUT(&nand_flash -> lx_nand_flash_shared_read_lock);
+
+    /* Obtain the thread safe mutex again.  */
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_mutex);
+
+    /* This reader is done, release its spare buffer. With the read/write lock, the spare 
+       buffers and the count only change with the NAND flash mutex held.  */
+    nand_flash -> lx_nand_flash_shared_read_buffers_used &=  ~((ULONG) 1 << i);
+    nand_flash -> lx_nand_flash_shared_readers--;
+#else
+
+    /* Obtain the shared read mutex.  */
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_shared_read_mutex);
+
+    /* This reader is done, release its spare buffer.  */
+    nand_flash -> lx_nand_flash_shared_read_buffers_used &=  ~((ULONG) 1 << i);
+    nand_flash -> lx_nand_flash_shared_readers--;
+
+    /* Determine if this was the last reader and a block erase is waiting for it.  */
+    if ((nand_flash -> lx_nand_flash_shared_readers == 0) && (nand_flash -> lx_nand_flash_shared_read_waiting))
+    {
+
+        /* Yes, resume the block erase.  */
+        nand_flash -> lx_nand_flash_shared_read_waiting =  LX_FALSE;
+        LX_LOCK_SEMAPHORE_PUT(&nand_flash -> lx_nand_flash_shared_read_semaphore);
+    }
+
+    /* Release the shared read mutex.  */
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_shared_read_mutex);
+
+    /* Obtain the thread safe mutex again. The reader count is already decremented, so a block 
+       erase that holds the thread safe mutex never waits for this thread.  */
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_mutex);
+#endif
+#else
+
+    LX_PARAMETER_NOT_USED(nand_flash);
+    LX_PARAMETER_NOT_USED(spare_buffer);
+#endif
+}
@@ -23,8 +23,16 @@
 /* Include necessary files.  */
 
 #include "lx_api.h"
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-/* Define constants for the NAND flash simulation. */
+/* Define constants for the NAND flash simulation. TOTAL_BLOCKS and PHYSICAL_PAGES_PER_BLOCK are the default
+   geometry, they can be changed at run time with _lx_nand_flash_simulator_geometry_set or
+   _lx_nand_flash_simulator_file_open. The diagnostic counts cover the blocks and pages of the default geometry. */
 
 #define TOTAL_BLOCKS                        1024
 #define PHYSICAL_PAGES_PER_BLOCK            256         /* Min value of 2                                               */
@@ -41,6 +49,27 @@
 #define SPARE_DATA2_LENGTH                  2
 
 
+/* Define the default timing of the simulated NAND flash, in nanoseconds. Every driver operation adds its
+   time to the simulated device time, which _lx_nand_flash_simulator_time_get returns. The times can be
+   changed at run time with _lx_nand_flash_simulator_timing_set.  */
+
+#ifndef LX_NAND_SIMULATOR_PAGE_READ_TIME
+#define LX_NAND_SIMULATOR_PAGE_READ_TIME    25000       /* Read of a page into the page register.       */
+#endif
+#ifndef LX_NAND_SIMULATOR_PAGE_PROGRAM_TIME
+#define LX_NAND_SIMULATOR_PAGE_PROGRAM_TIME 200000      /* Program of a page from the page register.    */
+#endif
+#ifndef LX_NAND_SIMULATOR_BLOCK_ERASE_TIME
+#define LX_NAND_SIMULATOR_BLOCK_ERASE_TIME  2000000     /* Erase of one block.                          */
+#endif
+#ifndef LX_NAND_SIMULATOR_COPYBACK_TIME
+#define LX_NAND_SIMULATOR_COPYBACK_TIME     225000      /* Copy of a page inside the device.            */
+#endif
+#ifndef LX_NAND_SIMULATOR_BUS_BYTE_TIME
+#define LX_NAND_SIMULATOR_BUS_BYTE_TIME     25          /* Transfer of one byte to or from the device.  */
+#endif
+
+
 
 /* Definition of the spare area is relative to the block size of the NAND part and perhaps manufactures of the NAND part. 
    Here are some common definitions:
@@ -96,15 +125,66 @@ NAND_FLASH_BLOCK   nand_memory_area[TOTAL_BLOCKS];
 
 NAND_BLOCK_DIAG    nand_block_diag[TOTAL_BLOCKS];
 
+/* Define the geometry and the memory of the simulated NAND flash, the default geometry in nand_memory_area
+   unless another one is selected at run time.  */
+
+ULONG              nand_simulator_total_blocks =      TOTAL_BLOCKS;
+ULONG              nand_simulator_pages_per_block =   PHYSICAL_PAGES_PER_BLOCK;
+PHYSICAL_PAGE      *nand_simulator_pages =            &nand_memory_area[0].physical_pages[0];
+
+#define NAND_SIMULATOR_PAGE(block, page)    (&nand_simulator_pages[((block) * nand_simulator_pages_per_block) + (page)])
+#define NAND_SIMULATOR_DIAG(block, page)    (((block) < TOTAL_BLOCKS) && ((page) < PHYSICAL_PAGES_PER_BLOCK))
+
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+
+/* Define the device image file and its mapping.  */
+
+int                nand_simulator_file =              -1;
+void               *nand_simulator_file_memory;
+size_t             nand_simulator_file_size;
+#endif
+
 
 /* Define NAND flash buffer for LevelX.  */
 
 ULONG  nand_flash_simulator_buffer[WORDS_PER_PHYSICAL_PAGE];
 ULONG  *nand_flash_memory;
 
+/* Define the timing of the simulated NAND flash and the simulated device time. The multiple page
+   operations add the time of their pages themselves, the simulator functions they call don't add
+   their time again while nand_simulator_time_nested is set.  */
+
+ULONG   nand_simulator_page_read_time =     LX_NAND_SIMULATOR_PAGE_READ_TIME;
+ULONG   nand_simulator_page_program_time =  LX_NAND_SIMULATOR_PAGE_PROGRAM_TIME;
+ULONG   nand_simulator_block_erase_time =   LX_NAND_SIMULATOR_BLOCK_ERASE_TIME;
+ULONG   nand_simulator_copyback_time =      LX_NAND_SIMULATOR_COPYBACK_TIME;
+ULONG   nand_simulator_bus_byte_time =      LX_NAND_SIMULATOR_BUS_BYTE_TIME;
+ULONG64 nand_simulator_time;
+UINT    nand_simulator_time_nested;
+
+/* Define the fast forward mode, which follows the wear of long workloads quickly. The ECC of the pages
+   is neither computed nor checked. The pages of the metadata are read and programmed as usual. Of the
+   pages that hold user data, as their spare bytes tell, only the first word of the data, its token, is
+   read and programmed, the other words are skipped and keep their erased value in flash.  */
+
+UINT    nand_simulator_fast_forward;
+
+#define NAND_SIMULATOR_PAGE_TYPE(block, page)   (LX_UTILITY_LONG_GET(&NAND_SIMULATOR_PAGE(block, page) -> spare[SPARE_DATA1_OFFSET]) & ~LX_NAND_PAGE_TYPE_USER_DATA_MASK)
+#define NAND_SIMULATOR_TOKEN_PAGE(block, page)  (nand_simulator_fast_forward && ((NAND_SIMULATOR_PAGE_TYPE(block, page) == LX_NAND_PAGE_TYPE_USER_DATA) || \
+                                                                                 (NAND_SIMULATOR_PAGE_TYPE(block, page) == LX_NAND_PAGE_TYPE_USER_DATA_RELEASED)))
+
 
 UINT  _lx_nand_flash_simulator_initialize(LX_NAND_FLASH *nand_flash);
 UINT  _lx_nand_flash_simulator_erase_all(VOID);
+UINT  _lx_nand_flash_simulator_timing_set(ULONG page_read_time, ULONG page_program_time, ULONG block_erase_time, ULONG copyback_time, ULONG bus_byte_time);
+UINT  _lx_nand_flash_simulator_time_get(ULONG64 *time);
+UINT  _lx_nand_flash_simulator_time_reset(VOID);
+UINT  _lx_nand_flash_simulator_geometry_set(ULONG total_blocks, ULONG pages_per_block, ULONG *memory, ULONG64 memory_size);
+UINT  _lx_nand_flash_simulator_fast_forward_set(UINT enable);
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+UINT  _lx_nand_flash_simulator_file_open(CHAR *file_name, ULONG total_blocks, ULONG pages_per_block);
+UINT  _lx_nand_flash_simulator_file_close(VOID);
+#endif
 
 #ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
 UINT  _lx_nand_flash_simulator_read(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, ULONG *destination, ULONG words);
@@ -143,11 +223,11 @@ UINT  _lx_nand_flash_simulator_initialize(LX_NAND_FLASH *nand_flash)
 {
 
     /* Setup the buffer pointer.  */
-    nand_flash_memory = (ULONG *) &nand_memory_area[0];
+    nand_flash_memory = (ULONG *) nand_simulator_pages;
 
     /* Setup geometry of the NAND flash.  */
-    nand_flash -> lx_nand_flash_total_blocks =                  TOTAL_BLOCKS;
-    nand_flash -> lx_nand_flash_pages_per_block =               PHYSICAL_PAGES_PER_BLOCK;
+    nand_flash -> lx_nand_flash_total_blocks =                  nand_simulator_total_blocks;
+    nand_flash -> lx_nand_flash_pages_per_block =               nand_simulator_pages_per_block;
     nand_flash -> lx_nand_flash_bytes_per_page =                BYTES_PER_PHYSICAL_PAGE;
 
     /* Setup function pointers for the NAND flash services.  */
@@ -188,8 +268,8 @@ UINT    status;
 
     for (i = 0; i < BYTES_PER_PHYSICAL_PAGE; i += 256)
     {
-        status = lx_nand_flash_256byte_ecc_check((UCHAR*)&nand_memory_area[block].physical_pages[page].memory[i / sizeof(ULONG)],
-            &nand_memory_area[block].physical_pages[page].spare[ECC_BYTE_POSITION + ecc_pos]);
+        status = lx_nand_flash_256byte_ecc_check((UCHAR*)&NAND_SIMULATOR_PAGE(block, page) -> memory[i / sizeof(ULONG)],
+            &NAND_SIMULATOR_PAGE(block, page) -> spare[ECC_BYTE_POSITION + ecc_pos]);
 
         if (status == LX_NAND_ERROR_NOT_CORRECTED)
         {
@@ -231,10 +311,26 @@ UINT    status;
     LX_PARAMETER_NOT_USED(nand_flash);
 #endif
 
-    status = _lx_nand_flash_simulator_page_ecc_check(block, page);
+    /* Add the time of the read.  */
+    if (nand_simulator_time_nested == 0)
+        nand_simulator_time +=  nand_simulator_page_read_time + (words * sizeof(ULONG) * nand_simulator_bus_byte_time);
+
+    /* In fast forward mode only the token of a user data page is read.  */
+    if (NAND_SIMULATOR_TOKEN_PAGE(block, page))
+    {
+        if (words)
+            *destination =  NAND_SIMULATOR_PAGE(block, page) -> memory[0];
+        return(LX_SUCCESS);
+    }
+
+    /* The ECC isn't checked in fast forward mode.  */
+    if (nand_simulator_fast_forward)
+        status =  LX_SUCCESS;
+    else
+        status =  _lx_nand_flash_simulator_page_ecc_check(block, page);
 
     /* Pickup the flash address.  */
-    flash_address =  &(nand_memory_area[block].physical_pages[page].memory[0]);
+    flash_address =  &(NAND_SIMULATOR_PAGE(block, page) -> memory[0]);
 
     /* Loop to read flash.  */
     while (words--)
@@ -258,6 +354,12 @@ UINT    status;
 UINT    ecc_status = LX_SUCCESS;
 
 
+    /* Add the time of reading the pages, the reads below don't add their time again.  */
+    if (nand_simulator_time_nested == 0)
+        nand_simulator_time +=  (ULONG64) pages * (nand_simulator_page_read_time +
+                                                   (((main_buffer) ? (ULONG) (BYTES_PER_PHYSICAL_PAGE + SPARE_BYTES_PER_PAGE) : (ULONG) SPARE_BYTES_PER_PAGE) * nand_simulator_bus_byte_time));
+    nand_simulator_time_nested++;
+
     for (i = 0; i < pages; i++)
     {
         if (main_buffer)
@@ -284,6 +386,7 @@ UINT    ecc_status = LX_SUCCESS;
         status = _lx_nand_flash_simulator_extra_bytes_get(block, page + i, spare_buffer + i * SPARE_BYTES_PER_PAGE, SPARE_BYTES_PER_PAGE);
 #endif
     }    
+    nand_simulator_time_nested--;
     return (ecc_status);
 }
 
@@ -301,19 +404,38 @@ UINT    ecc_bytes =0;
 UCHAR   new_ecc_buffer[24];
 UCHAR   *new_ecc_buffer_ptr = new_ecc_buffer;
 UCHAR   *ecc_buffer_ptr = new_ecc_buffer_ptr;
-ULONG   *page_ptr = &(nand_memory_area[block].physical_pages[page].memory[0]);
+ULONG   *page_ptr = &(NAND_SIMULATOR_PAGE(block, page) -> memory[0]);
 
 #ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
     LX_PARAMETER_NOT_USED(nand_flash);
 #endif
 
+    /* Add the time of the program.  */
+    if (nand_simulator_time_nested == 0)
+        nand_simulator_time +=  nand_simulator_page_program_time + (words * sizeof(ULONG) * nand_simulator_bus_byte_time);
+
     /* Increment the diag info.  */
-    nand_block_diag[block].page_writes[page]++;
-    if (nand_block_diag[block].page_writes[page] > nand_block_diag[block].max_page_writes[page])
-        nand_block_diag[block].max_page_writes[page] =  nand_block_diag[block].page_writes[page];
+    if (NAND_SIMULATOR_DIAG(block, page))
+    {
+        nand_block_diag[block].page_writes[page]++;
+        if (nand_block_diag[block].page_writes[page] > nand_block_diag[block].max_page_writes[page])
+            nand_block_diag[block].max_page_writes[page] =  nand_block_diag[block].page_writes[page];
+    }
 
     /* Pickup the flash address.  */
-    flash_address =  &(nand_memory_area[block].physical_pages[page].memory[0]);
+    flash_address =  &(NAND_SIMULATOR_PAGE(block, page) -> memory[0]);
+
+    /* In fast forward mode only the token of a user data page is programmed.  */
+    if (NAND_SIMULATOR_TOKEN_PAGE(block, page))
+    {
+        if (words)
+        {
+            if ((*source & *flash_address) != *source)
+               return(LX_INVALID_WRITE);
+            *flash_address =  *source;
+        }
+        return(LX_SUCCESS);
+    }
 
     /* Loop to write flash.  */
     while (words--)
@@ -328,6 +450,10 @@ ULONG   *page_ptr = &(nand_memory_area[block].physical_pages[page].memory[0]);
         *flash_address++ =  *source++;
     }
 
+    /* The ECC isn't computed in fast forward mode.  */
+    if (nand_simulator_fast_forward)
+        return(LX_SUCCESS);
+
     /* Loop to compute the ECC over the entire NAND flash page.  */
     bytes_computed =  0;
     
@@ -350,7 +476,7 @@ ULONG   *page_ptr = &(nand_memory_area[block].physical_pages[page].memory[0]);
     }
     
     /* Setup destination pointer in the spare area.  */
-    flash_spare_address =  (UCHAR *) &(nand_memory_area[block].physical_pages[page].spare[ECC_BYTE_POSITION]);
+    flash_spare_address =  (UCHAR *) &(NAND_SIMULATOR_PAGE(block, page) -> spare[ECC_BYTE_POSITION]);
     while(ecc_bytes--)
     {
 
@@ -377,6 +503,12 @@ UINT    i;
 UINT    status = LX_SUCCESS;
 
 
+    /* Add the time of programming the pages, the writes below don't add their time again.  */
+    if (nand_simulator_time_nested == 0)
+        nand_simulator_time +=  (ULONG64) pages * (nand_simulator_page_program_time +
+                                                   ((BYTES_PER_PHYSICAL_PAGE + SPARE_BYTES_PER_PAGE) * nand_simulator_bus_byte_time));
+    nand_simulator_time_nested++;
+
     for (i = 0; i < pages; i++)
     {
 #ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
@@ -392,6 +524,7 @@ UINT    status = LX_SUCCESS;
         }
 
     }
+    nand_simulator_time_nested--;
     return (status);
 }
 
@@ -405,6 +538,11 @@ UINT  _lx_nand_flash_simulator_pages_copy(ULONG source_block, ULONG source_page,
     UINT    status = LX_SUCCESS;
 
 
+    /* Add the time of copying the pages inside the device, the reads and writes below don't add their time.  */
+    if (nand_simulator_time_nested == 0)
+        nand_simulator_time +=  (ULONG64) pages * nand_simulator_copyback_time;
+    nand_simulator_time_nested++;
+
     for (i = 0; i < pages; i++)
     {
 #ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
@@ -427,6 +565,7 @@ UINT  _lx_nand_flash_simulator_pages_copy(ULONG source_block, ULONG source_page,
         }
 
     }
+    nand_simulator_time_nested--;
     return (status);
 
 }
@@ -447,16 +586,41 @@ UINT    i;
     LX_PARAMETER_NOT_USED(nand_flash);
 #endif
 
+    /* Add the time of the erase.  */
+    nand_simulator_time +=  nand_simulator_block_erase_time;
+
     /* Increment the diag info.  */
-    nand_block_diag[block].erases++;
-    for (i = 0; i < PHYSICAL_PAGES_PER_BLOCK;i++)
-        nand_block_diag[block].page_writes[i] = 0;
+    if (NAND_SIMULATOR_DIAG(block, 0))
+    {
+        nand_block_diag[block].erases++;
+        for (i = 0; i < PHYSICAL_PAGES_PER_BLOCK;i++)
+            nand_block_diag[block].page_writes[i] = 0;
+    }
+
+    /* In fast forward mode only the token and the spare bytes of a user data page are erased.  */
+    if (nand_simulator_fast_forward)
+    {
+        for (i = 0; i < nand_simulator_pages_per_block; i++)
+        {
+            pointer =  (ULONG *) NAND_SIMULATOR_PAGE(block, i);
+            words =    sizeof(PHYSICAL_PAGE)/sizeof(ULONG);
+            if (NAND_SIMULATOR_TOKEN_PAGE(block, i))
+            {
+                *pointer =  (ULONG) 0xFFFFFFFF;
+                pointer =   pointer + (WORDS_PER_PHYSICAL_PAGE);
+                words =     words - (WORDS_PER_PHYSICAL_PAGE);
+            }
+            while (words--)
+                *pointer++ =  (ULONG) 0xFFFFFFFF;
+        }
+        return(LX_SUCCESS);
+    }
 
     /* Setup pointer.  */
-    pointer =  (ULONG *) &nand_memory_area[block];
+    pointer =  (ULONG *) NAND_SIMULATOR_PAGE(block, 0);
 
     /* Loop to erase block.  */
-    words =  sizeof(NAND_FLASH_BLOCK)/sizeof(ULONG);
+    words =  nand_simulator_pages_per_block * (sizeof(PHYSICAL_PAGE)/sizeof(ULONG));
     while (words--)
     {
         
@@ -485,10 +649,10 @@ UINT    i, j;
     }
     
     /* Setup pointer.  */
-    pointer =  (ULONG *) &nand_memory_area[0];
+    pointer =  (ULONG *) nand_simulator_pages;
 
     /* Loop to erase block.  */
-    words =  sizeof(nand_memory_area)/(sizeof(ULONG));
+    words =  nand_simulator_total_blocks * nand_simulator_pages_per_block * (sizeof(PHYSICAL_PAGE)/sizeof(ULONG));
     while (words--)
     {
         
@@ -517,10 +681,14 @@ ULONG   words;
     /* Determine if the block is completely erased.  */
     
     /* Pickup the pointer to the first word of the block.  */
-    word_ptr =  (ULONG *) &nand_memory_area[block];
+    word_ptr =  (ULONG *) NAND_SIMULATOR_PAGE(block, 0);
     
     /* Calculate the number of words in a block.  */
-    words =  sizeof(NAND_FLASH_BLOCK)/sizeof(ULONG);
+    words =  nand_simulator_pages_per_block * (sizeof(PHYSICAL_PAGE)/sizeof(ULONG));
+
+    /* Add the time of reading every page of the block.  */
+    nand_simulator_time +=  (ULONG64) nand_simulator_pages_per_block * (nand_simulator_page_read_time +
+                                                                        ((BYTES_PER_PHYSICAL_PAGE + SPARE_BYTES_PER_PAGE) * nand_simulator_bus_byte_time));
     
     /* Loop to check if the block is erased.  */
     while (words--)
@@ -552,10 +720,13 @@ ULONG   words;
     /* Determine if the block is completely erased.  */
     
     /* Pickup the pointer to the first word of the block's page.  */
-    word_ptr =  (ULONG *) &nand_memory_area[block].physical_pages[page];
+    word_ptr =  (ULONG *) NAND_SIMULATOR_PAGE(block, page);
     
     /* Calculate the number of words in a block.  */
     words =  WORDS_PER_PHYSICAL_PAGE;
+
+    /* Add the time of reading the page.  */
+    nand_simulator_time +=  nand_simulator_page_read_time + (BYTES_PER_PHYSICAL_PAGE * nand_simulator_bus_byte_time);
     
     /* Loop to check if the page is erased.  */
     while (words--)
@@ -581,8 +752,11 @@ UINT  _lx_nand_flash_simulator_block_status_get(ULONG block, UCHAR *bad_block_by
     LX_PARAMETER_NOT_USED(nand_flash);
 #endif
 
+    /* Add the time of reading the bad block byte.  */
+    nand_simulator_time +=  nand_simulator_page_read_time + nand_simulator_bus_byte_time;
+
     /* Pickup the bad block byte and return it.  */
-    *bad_block_byte =  nand_memory_area[block].physical_pages[0].spare[BAD_BLOCK_POSITION];
+    *bad_block_byte =  NAND_SIMULATOR_PAGE(block, 0) -> spare[BAD_BLOCK_POSITION];
     
     /* Return success.  */
     return(LX_SUCCESS);
@@ -599,8 +773,11 @@ UINT  _lx_nand_flash_simulator_block_status_set(ULONG block, UCHAR bad_block_byt
     LX_PARAMETER_NOT_USED(nand_flash);
 #endif
 
+    /* Add the time of programming the bad block byte.  */
+    nand_simulator_time +=  nand_simulator_page_program_time + nand_simulator_bus_byte_time;
+
     /* Set the bad block byte.  */
-    nand_memory_area[block].physical_pages[0].spare[BAD_BLOCK_POSITION] =  bad_block_byte;
+    NAND_SIMULATOR_PAGE(block, 0) -> spare[BAD_BLOCK_POSITION] =  bad_block_byte;
     
     /* Return success.  */
     return(LX_SUCCESS);
@@ -620,8 +797,12 @@ UCHAR   *source;
     LX_PARAMETER_NOT_USED(nand_flash);
 #endif
     
+    /* Add the time of reading the extra bytes.  */
+    if (nand_simulator_time_nested == 0)
+        nand_simulator_time +=  nand_simulator_page_read_time + (size * nand_simulator_bus_byte_time);
+
     /* Setup source pointer in the spare area.  */
-    source =  (UCHAR *) &(nand_memory_area[block].physical_pages[page].spare[EXTRA_BYTE_POSITION]);
+    source =  (UCHAR *) &(NAND_SIMULATOR_PAGE(block, page) -> spare[EXTRA_BYTE_POSITION]);
     
     /* Loop to return the extra bytes requested.  */
     while (size--)
@@ -648,13 +829,20 @@ UCHAR   *destination;
     LX_PARAMETER_NOT_USED(nand_flash);
 #endif
     
+    /* Add the time of programming the extra bytes.  */
+    if (nand_simulator_time_nested == 0)
+        nand_simulator_time +=  nand_simulator_page_program_time + (size * nand_simulator_bus_byte_time);
+
     /* Increment the diag info.  */
-    nand_block_diag[block].page_writes[page]++;
-    if (nand_block_diag[block].page_writes[page] > nand_block_diag[block].max_page_writes[page])
-        nand_block_diag[block].max_page_writes[page] =  nand_block_diag[block].page_writes[page];
+    if (NAND_SIMULATOR_DIAG(block, page))
+    {
+        nand_block_diag[block].page_writes[page]++;
+        if (nand_block_diag[block].page_writes[page] > nand_block_diag[block].max_page_writes[page])
+            nand_block_diag[block].max_page_writes[page] =  nand_block_diag[block].page_writes[page];
+    }
     
     /* Setup destination pointer in the spare area.  */
-    destination =  (UCHAR *) &(nand_memory_area[block].physical_pages[page].spare[EXTRA_BYTE_POSITION]);
+    destination =  (UCHAR *) &(NAND_SIMULATOR_PAGE(block, page) -> spare[EXTRA_BYTE_POSITION]);
     
     /* Loop to set the extra bytes.  */
     while (size--)
@@ -686,4 +874,162 @@ UINT  _lx_nand_flash_simulator_system_error(UINT error_code, ULONG block, ULONG
 }
 
 
+UINT  _lx_nand_flash_simulator_timing_set(ULONG page_read_time, ULONG page_program_time, ULONG block_erase_time, ULONG copyback_time, ULONG bus_byte_time)
+{
+
+    /* Setup the time of each operation, in nanoseconds.  */
+    nand_simulator_page_read_time =     page_read_time;
+    nand_simulator_page_program_time =  page_program_time;
+    nand_simulator_block_erase_time =   block_erase_time;
+    nand_simulator_copyback_time =      copyback_time;
+    nand_simulator_bus_byte_time =      bus_byte_time;
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nand_flash_simulator_time_get(ULONG64 *time)
+{
+
+    /* Return the simulated device time, in nanoseconds.  */
+    *time =  nand_simulator_time;
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nand_flash_simulator_time_reset(VOID)
+{
+
+    /* Start the simulated device time again from zero.  */
+    nand_simulator_time =  0;
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nand_flash_simulator_geometry_set(ULONG total_blocks, ULONG pages_per_block, ULONG *memory, ULONG64 memory_size)
+{
+
+    /* A null memory selects nand_memory_area.  */
+    if (memory == LX_NULL)
+    {
+        memory =       (ULONG *) &nand_memory_area[0];
+        memory_size =  sizeof(nand_memory_area);
+    }
+
+    /* Check the geometry, the flash must fit in the memory.  */
+    if ((total_blocks < 2) || (pages_per_block < 2) ||
+        (((ULONG64) total_blocks * pages_per_block * sizeof(PHYSICAL_PAGE)) > memory_size))
+        return(LX_ERROR);
+
+    /* Setup the geometry and the memory, which take effect when the flash is opened next.  */
+    nand_simulator_total_blocks =     total_blocks;
+    nand_simulator_pages_per_block =  pages_per_block;
+    nand_simulator_pages =            (PHYSICAL_PAGE *) memory;
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nand_flash_simulator_fast_forward_set(UINT enable)
+{
+
+    /* Select the mode, flash written in one mode can't be used in the other, so the flash is erased.  */
+    nand_simulator_fast_forward =  enable;
+    _lx_nand_flash_simulator_erase_all();
+
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+UINT  _lx_nand_flash_simulator_file_open(CHAR *file_name, ULONG total_blocks, ULONG pages_per_block)
+{
+
+struct stat file_status;
+ULONG64     size;
+void        *memory;
+UINT        new_image;
+UINT        status;
+
+
+    /* Close the device image that is still open.  */
+    _lx_nand_flash_simulator_file_close();
+
+    /* Open the device image, it is created if it doesn't exist.  */
+    nand_simulator_file =  open(file_name, O_RDWR | O_CREAT, 0644);
+    if (nand_simulator_file < 0)
+        return(LX_ERROR);
+
+    /* A new image is extended to the size of the flash and erased, an existing image must already have
+       the size of the flash. The pages are stored with their spare bytes.  */
+    size =  (ULONG64) total_blocks * pages_per_block * sizeof(PHYSICAL_PAGE);
+    new_image =  LX_FALSE;
+    status =  LX_ERROR;
+    if (fstat(nand_simulator_file, &file_status) == 0)
+    {
+        if (file_status.st_size == 0)
+        {
+            new_image =  LX_TRUE;
+            if ((size > 0) && (ftruncate(nand_simulator_file, (off_t) size) == 0))
+                status =  LX_SUCCESS;
+        }
+        else if ((ULONG64) file_status.st_size == size)
+            status =  LX_SUCCESS;
+    }
+
+    /* Map the image and make it the memory of the flash.  */
+    if (status == LX_SUCCESS)
+    {
+        memory =  mmap(NULL, (size_t) size, PROT_READ | PROT_WRITE, MAP_SHARED, nand_simulator_file, 0);
+        if (memory != MAP_FAILED)
+        {
+            nand_simulator_file_memory =  memory;
+            nand_simulator_file_size =    (size_t) size;
+            status =  _lx_nand_flash_simulator_geometry_set(total_blocks, pages_per_block, (ULONG *) memory, size);
+        }
+        else
+            status =  LX_ERROR;
+    }
+    if (status != LX_SUCCESS)
+    {
+        _lx_nand_flash_simulator_file_close();
+        return(LX_ERROR);
+    }
+
+    /* Erase a new image.  */
+    if (new_image)
+        _lx_nand_flash_simulator_erase_all();
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nand_flash_simulator_file_close(VOID)
+{
+
+UINT    status =  LX_SUCCESS;
+
+
+    /* Write the mapped image back to the file and return to the default geometry in nand_memory_area.  */
+    if (nand_simulator_file_memory != NULL)
+    {
+        if (msync(nand_simulator_file_memory, nand_simulator_file_size, MS_SYNC) != 0)
+            status =  LX_ERROR;
+        munmap(nand_simulator_file_memory, nand_simulator_file_size);
+        nand_simulator_file_memory =  NULL;
+        _lx_nand_flash_simulator_geometry_set(TOTAL_BLOCKS, PHYSICAL_PAGES_PER_BLOCK, LX_NULL, 0);
+    }
+
+    /* Close the file.  */
+    if (nand_simulator_file >= 0)
+    {
+        close(nand_simulator_file);
+        nand_simulator_file =  -1;
+    }
+
+    return(status);
+}
+#endif
 
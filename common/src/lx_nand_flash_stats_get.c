@@ -0,0 +1,125 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation 
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ * 
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */ 
+/** LevelX Component                                                      */ 
+/**                                                                       */
+/**   NAND Flash                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_stats_get                            PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function returns the statistics of the NAND flash instance,    */ 
+/*    which are collected since the NAND flash was opened or the          */ 
+/*    statistics were last reset: the latency histograms of the timed     */ 
+/*    APIs, the number of driver calls and the bytes written by the       */ 
+/*    application versus the bytes programmed to the flash. The driver    */ 
+/*    calls are taken from the diagnostic counters.                       */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nand_flash                            NAND flash instance           */ 
+/*    stats                                 Destination for statistics    */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application Code                                                    */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+
+UINT  _lx_nand_flash_stats_get(LX_NAND_FLASH *nand_flash, LX_FLASH_STATS *stats)
+{
+#ifdef LX_NAND_ENABLE_STATS
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_mutex);
+#endif
+
+    /* Copy the statistics.  */
+    LX_MEMCPY(stats, &nand_flash -> lx_nand_flash_stats, sizeof(LX_FLASH_STATS)); /* Use case of memcpy is verified. */
+
+    /* Calculate the driver calls since the last reset from the diagnostic counters.  */
+    stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_READ] =                 nand_flash -> lx_nand_flash_diagnostic_page_reads - nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_READ];
+    stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_WRITE] =                nand_flash -> lx_nand_flash_diagnostic_page_writes - nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_WRITE];
+    stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_BLOCK_ERASE] =          nand_flash -> lx_nand_flash_diagnostic_block_erases - nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_BLOCK_ERASE];
+    stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_BLOCK_ERASED_VERIFY] =  nand_flash -> lx_nand_flash_diagnostic_block_erased_verifies - nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_BLOCK_ERASED_VERIFY];
+    stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_PAGE_ERASED_VERIFY] =   nand_flash -> lx_nand_flash_diagnostic_page_erased_verifies - nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_PAGE_ERASED_VERIFY];
+    stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_PAGE_COPY] =            nand_flash -> lx_nand_flash_diagnostic_moved_pages - nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_PAGE_COPY];
+    stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_BLOCK_STATUS_GET] =     nand_flash -> lx_nand_flash_diagnostic_block_status_gets - nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_BLOCK_STATUS_GET];
+    stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_BLOCK_STATUS_SET] =     nand_flash -> lx_nand_flash_diagnostic_block_status_sets - nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_BLOCK_STATUS_SET];
+
+    /* Pages written by the application and pages moved by block reclaims are programmed.  */
+    stats -> lx_flash_stats_bytes_programmed =  (ULONG64) (stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_WRITE] + stats -> lx_flash_stats_driver_calls[LX_STATS_DRIVER_PAGE_COPY]) * 
+                                                nand_flash -> lx_nand_flash_bytes_per_page;
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
+#endif
+
+    /* Return successful completion.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nand_flash);
+    LX_PARAMETER_NOT_USED(stats);
+
+    /* Return disabled error message.  */
+    return(LX_DISABLED);
+#endif
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation 
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ * 
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */ 
+/** LevelX Component                                                      */ 
+/**                                                                       */
+/**   NAND Flash                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_stats_reset                          PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function clears the statistics of the NAND flash instance.     */ 
+/*    The diagnostic counters are not changed, the current values are     */ 
+/*    remembered as the base of the driver calls.                         */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nand_flash                            NAND flash instance           */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application Code                                                    */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+
+UINT  _lx_nand_flash_stats_reset(LX_NAND_FLASH *nand_flash)
+{
+#ifdef LX_NAND_ENABLE_STATS
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_mutex);
+#endif
+
+    /* Clear the statistics.  */
+    LX_MEMSET(&nand_flash -> lx_nand_flash_stats, 0, sizeof(LX_FLASH_STATS));
+
+    /* Remember the diagnostic counters as the base of the driver calls.  */
+    nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_READ] =                 nand_flash -> lx_nand_flash_diagnostic_page_reads;
+    nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_WRITE] =                nand_flash -> lx_nand_flash_diagnostic_page_writes;
+    nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_BLOCK_ERASE] =          nand_flash -> lx_nand_flash_diagnostic_block_erases;
+    nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_BLOCK_ERASED_VERIFY] =  nand_flash -> lx_nand_flash_diagnostic_block_erased_verifies;
+    nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_PAGE_ERASED_VERIFY] =   nand_flash -> lx_nand_flash_diagnostic_page_erased_verifies;
+    nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_PAGE_COPY] =            nand_flash -> lx_nand_flash_diagnostic_moved_pages;
+    nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_BLOCK_STATUS_GET] =     nand_flash -> lx_nand_flash_diagnostic_block_status_gets;
+    nand_flash -> lx_nand_flash_stats_driver_base[LX_STATS_DRIVER_BLOCK_STATUS_SET] =     nand_flash -> lx_nand_flash_diagnostic_block_status_sets;
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
+#endif
+
+    /* Return successful completion.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nand_flash);
+
+    /* Return disabled error message.  */
+    return(LX_DISABLED);
+#endif
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation 
+ * 
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ * 
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */ 
+/** LevelX Component                                                      */ 
+/**                                                                       */
+/**   NAND Flash                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_trace_enable                         PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function enables or disables the event trace of the NAND       */ 
+/*    flash. A LX_NULL memory disables the trace.                         */ 
+/*                                                                        */ 
+/*    The trace header is placed at the start of the memory and the       */ 
+/*    rest of it holds the events, so the memory must be aligned for      */ 
+/*    ULONGs. The memory can be dumped at any time and decoded on a host. */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nand_flash                            NAND flash instance           */ 
+/*    memory                                Trace memory                  */ 
+/*    size                                  Size of the trace memory      */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application Code                                                    */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+
+UINT  _lx_nand_flash_trace_enable(LX_NAND_FLASH *nand_flash, VOID *memory, ULONG size)
+{
+#ifdef LX_NAND_ENABLE_TRACE
+
+LX_TRACE_HEADER *trace;
+
+
+    /* Determine if memory was specified but with room for less than one event.  */
+    if ((memory) && (size < (sizeof(LX_TRACE_HEADER) + sizeof(LX_TRACE_EVENT))))
+    {
+
+        /* Error in memory size supplied.  */
+        return(LX_ERROR);
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nand_flash -> lx_nand_flash_mutex);
+#endif
+
+    /* Setup the trace header.  */
+    trace =  (LX_TRACE_HEADER *) memory;
+    if (trace)
+    {
+
+        /* Initialize the header, no events are recorded yet.  */
+        trace -> lx_trace_header_id =          LX_TRACE_ID;
+        trace -> lx_trace_header_event_size =  sizeof(LX_TRACE_EVENT);
+        trace -> lx_trace_header_device =      LX_TRACE_NAND;
+        trace -> lx_trace_header_events =      (size - sizeof(LX_TRACE_HEADER)) / sizeof(LX_TRACE_EVENT);
+        trace -> lx_trace_header_next =        0;
+        trace -> lx_trace_header_total =       0;
+    }
+
+    /* Start or stop recording events.  */
+    nand_flash -> lx_nand_flash_trace =  trace;
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nand_flash -> lx_nand_flash_mutex);
+#endif
+
+    /* Return successful completion.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nand_flash);
+    LX_PARAMETER_NOT_USED(memory);
+    LX_PARAMETER_NOT_USED(size);
+
+    /* Return disabled error message.  */
+    return(LX_DISABLED);
+#endif
+}
+
@@ -0,0 +1,726 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_block_reclaim_step                    PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function performs the next step of reclaiming a NOR flash      */
+/*    block. The first step selects the block, the following steps scan   */
+/*    its mapping list and relocate each valid sector in a copy, a        */
+/*    superceded and a commit step before the block is erased and its     */
+/*    header is written. The state is kept in the NOR flash instance, so  */
+/*    other LevelX requests can run between the steps. A relocation is    */
+/*    abandoned if its logical sector was written or released in the      */
+/*    meantime.                                                           */
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    operations                            Returned number of driver     */
+/*                                            operations of this step     */
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_driver_block_erase      Driver erase block            */ 
+/*    _lx_nor_flash_driver_write            Driver flash sector write     */ 
+/*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
+/*    _lx_nor_flash_next_block_to_erase_find                              */ 
+/*                                          Find next block to erase      */ 
+/*    _lx_nor_flash_physical_sector_allocate                              */ 
+/*                                          Allocate new logical sector   */ 
+/*    _lx_nor_flash_sector_mapping_cache_invalidate                       */ 
+/*                                          Invalidate cache entry        */ 
+/*    _lx_nor_flash_logical_sector_index_update                           */
+/*                                          Update logical sector index   */
+/*    _lx_nor_flash_block_summary_update    Update block summary          */
+/*    _lx_nor_flash_erase_queue_update      Update erase queue            */
+/*    _lx_nor_flash_system_error            Internal system error handler */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Internal LevelX                                                     */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_block_reclaim_step(LX_NOR_FLASH *nor_flash, ULONG *operations)
+{
+
+ULONG   *block_word_ptr;
+ULONG   *list_word_ptr;
+ULONG   list_word;
+ULONG   erase_block;
+ULONG   erase_count;
+ULONG   temp_erase_count;
+ULONG   erase_started_value;
+ULONG   mapped_sectors;
+ULONG   obsolete_sectors;
+ULONG   free_sectors;
+ULONG   logical_sector;
+ULONG   new_mapping_entry;
+UINT    status;
+
+
+    /* Default to one driver operation for this step.  */
+    *operations =  1;
+
+    /* Determine if a block needs to be selected.  */
+    if (nor_flash -> lx_nor_flash_gc_state == LX_NOR_GC_STATE_IDLE)
+    {
+
+        /* Determine the next block to erase.  */
+        _lx_nor_flash_next_block_to_erase_find(nor_flash, &erase_block, &erase_count, &mapped_sectors, &obsolete_sectors);
+
+        /* Calculate the number of free sectors in this block.  */
+        free_sectors =  nor_flash -> lx_nor_flash_physical_sectors_per_block - (obsolete_sectors + mapped_sectors);
+
+        /* Determine if there are enough free sectors outside of this block to reclaim this block.  */
+        if (mapped_sectors > (nor_flash -> lx_nor_flash_free_physical_sectors - free_sectors))
+        {
+
+            /* No, this block can't be reclaimed now.  */
+            return(LX_NO_SECTORS);
+        }
+
+        /* Determine if the search pointer is set for this block.  */
+        if (nor_flash -> lx_nor_flash_free_block_search == erase_block)
+        {
+    
+            /* Ensure the search block is not the block we are trying to free.  */
+            nor_flash -> lx_nor_flash_free_block_search =  erase_block + 1;
+     
+            /* Check for wrap condition.  */
+            if (nor_flash -> lx_nor_flash_free_block_search >= nor_flash -> lx_nor_flash_total_blocks)
+                nor_flash -> lx_nor_flash_free_block_search =  0;
+        }
+
+        /* Remember the block being reclaimed. No sectors are allocated from this block until it is erased, 
+           so its free sectors stay free.  */
+        nor_flash -> lx_nor_flash_gc_block =           erase_block;
+        nor_flash -> lx_nor_flash_gc_erase_count =     erase_count;
+        nor_flash -> lx_nor_flash_gc_free_sectors =    free_sectors;
+        nor_flash -> lx_nor_flash_gc_mapped_sectors =  mapped_sectors;
+        nor_flash -> lx_nor_flash_gc_sector =          0;
+
+        /* Determine if there are mapped sectors to move out of this block.  */
+        if (mapped_sectors)
+        {
+
+            /* Yes, scan the mapping list of the block.  */
+            nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_SCAN;
+        }
+        else
+        {
+
+            /* No, the block can be erased right away.  */
+            nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_ERASE;
+
+            /* Increment the number of blocks erased without relocating any sector.  */
+            nor_flash -> lx_nor_flash_obsolete_block_erases++;
+        }
+
+        /* Trace the block being reclaimed.  */
+        LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_RECLAIM, erase_block, mapped_sectors);
+
+        /* Return success.  */
+        return(LX_SUCCESS);
+    }
+
+    /* Setup the block word pointer to the first word of the block being reclaimed.  */
+    block_word_ptr =  nor_flash -> lx_nor_flash_base_address + (nor_flash -> lx_nor_flash_words_per_block * nor_flash -> lx_nor_flash_gc_block);
+
+    /* Setup a pointer to the mapping list entry of the current sector.  */
+    list_word_ptr =  block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + nor_flash -> lx_nor_flash_gc_sector;
+
+    /* Pickup the logical sector being relocated.  */
+    logical_sector =  nor_flash -> lx_nor_flash_gc_mapping_entry & LX_NOR_LOGICAL_SECTOR_MASK;
+
+    /* Determine if a relocation is being resumed after other requests had the chance to run.  */
+    if ((nor_flash -> lx_nor_flash_gc_resumed) && 
+        (nor_flash -> lx_nor_flash_gc_state >= LX_NOR_GC_STATE_COPY) && (nor_flash -> lx_nor_flash_gc_state <= LX_NOR_GC_STATE_COMMIT))
+    {
+
+        /* Clear the resumed flag, nothing else runs until this step returns.  */
+        nor_flash -> lx_nor_flash_gc_resumed =  LX_FALSE;
+
+        /* Read the old mapping entry again.  */
+#ifdef LX_DIRECT_READ
+        
+        /* Read the word directly.  */
+        list_word =  *(list_word_ptr);
+#else
+        status =  _lx_nor_flash_driver_read(nor_flash, list_word_ptr, &list_word, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+#endif
+
+        /* Determine if the logical sector was written or released since the relocation started.  */
+        if ((list_word & LX_NOR_PHYSICAL_SECTOR_VALID) == 0)
+        {
+
+            /* Yes, the copy is out of date. Obsolete the new physical sector, its mapping entry is not valid yet.  */
+            new_mapping_entry =  0;
+            status =  _lx_nor_flash_driver_write(nor_flash, nor_flash -> lx_nor_flash_gc_new_mapping_address, &new_mapping_entry, 1);
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+        
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+                /* Return the error.  */
+                return(status);
+            }
+
+            /* Increment the number of obsolete physical sectors.  */
+            nor_flash -> lx_nor_flash_obsolete_physical_sectors++;
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+            /* Update the block summary, the new sector went from free to obsolete.  */
+            _lx_nor_flash_block_summary_update(nor_flash, nor_flash -> lx_nor_flash_gc_new_mapping_address, LX_FALSE);
+            _lx_nor_flash_block_summary_update(nor_flash, nor_flash -> lx_nor_flash_gc_new_mapping_address, LX_TRUE);
+#endif
+
+            /* Decrement the number of mapped sectors left in the block.  */
+            nor_flash -> lx_nor_flash_gc_mapped_sectors--;
+
+            /* The old sector is no longer mapped, continue with the next sector of the block.  */
+            nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_SCAN;
+            nor_flash -> lx_nor_flash_gc_sector++;
+            if ((nor_flash -> lx_nor_flash_gc_mapped_sectors == 0) || 
+                (nor_flash -> lx_nor_flash_gc_sector >= nor_flash -> lx_nor_flash_physical_sectors_per_block))
+            {
+
+                /* Nothing is left to relocate, the block can be erased.  */
+                nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_ERASE;
+            }
+
+#ifndef LX_DIRECT_READ
+
+            /* Account for the read of the old mapping entry.  */
+            *operations =  2;
+#endif
+
+            /* Return success.  */
+            return(LX_SUCCESS);
+        }
+
+        /* Remember the current value of the old mapping entry.  */
+        nor_flash -> lx_nor_flash_gc_mapping_entry =  list_word;
+#ifndef LX_DIRECT_READ
+
+        /* Account for the read of the old mapping entry.  */
+        *operations =  2;
+#endif
+    }
+
+    /* Clear the resumed flag.  */
+    nor_flash -> lx_nor_flash_gc_resumed =  LX_FALSE;
+
+    /* Determine if the mapping list of the block is being scanned.  */
+    if (nor_flash -> lx_nor_flash_gc_state == LX_NOR_GC_STATE_SCAN)
+    {
+
+        /* Pickup the mapped sector list entry.  */
+#ifdef LX_DIRECT_READ
+        
+        /* Read the word directly.  */
+        list_word =  *(list_word_ptr);
+#else
+        status =  _lx_nor_flash_driver_read(nor_flash, list_word_ptr, &list_word, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+#endif
+
+        /* Determine if the entry hasn't been used.  */
+        if (list_word == LX_NOR_PHYSICAL_SECTOR_FREE)
+        {
+        
+            /* Since allocations are done sequentially in the block, we know nothing
+               else exists after this point. The block can be erased.  */
+            nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_ERASE;
+        }
+
+        /* Is this entry mapped?  */
+        else if (list_word & LX_NOR_PHYSICAL_SECTOR_VALID)
+        {
+
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+            /* Sectors still mapped when their block is reclaimed are cold.  */
+            nor_flash -> lx_nor_flash_write_stream =  LX_NOR_WRITE_STREAM_COLD;
+#endif
+
+            /* Allocate a new physical sector for the mapped sector.  */
+            _lx_nor_flash_physical_sector_allocate(nor_flash, list_word & LX_NOR_LOGICAL_SECTOR_MASK, 
+                                                   &(nor_flash -> lx_nor_flash_gc_new_mapping_address), &(nor_flash -> lx_nor_flash_gc_new_sector_address));
+
+            /* Determine if the new sector allocation was successful.  */
+            if (nor_flash -> lx_nor_flash_gc_new_mapping_address == LX_NULL)
+            {
+
+                /* Give up on this block, the sectors already relocated stay obsolete in it.  */
+                nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_IDLE;
+
+                /* Call system error handler - the allocation should always succeed at this point.  */
+                _lx_nor_flash_system_error(nor_flash, LX_SYSTEM_ALLOCATION_FAILED);
+
+                /* Return the error.  */
+                return(LX_SYSTEM_ALLOCATION_FAILED);
+            }
+
+            /* Update the number of free physical sectors.  */
+            nor_flash -> lx_nor_flash_free_physical_sectors--;
+
+            /* Increment the number of sectors relocated by block reclaims.  */
+            nor_flash -> lx_nor_flash_relocated_sector_writes++;
+
+            /* Remember the mapping entry of the sector being relocated.  */
+            nor_flash -> lx_nor_flash_gc_mapping_entry =  list_word;
+
+            /* Now build the new mapping entry - with the not valid bit set initially. It is written right away,
+               since a free mapping entry ends the search of a block for the sectors allocated after it.  */
+            new_mapping_entry =  ((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED) | (ULONG) LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID | 
+                                 (list_word & LX_NOR_LOGICAL_SECTOR_MASK);
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+            /* Keep the mark of a fill sector, its data is copied as it is.  */
+            new_mapping_entry =  new_mapping_entry | (list_word & LX_NOR_PHYSICAL_SECTOR_FILL);
+#endif
+            
+            /* Write out the new mapping entry.  */
+            status =  _lx_nor_flash_driver_write(nor_flash, nor_flash -> lx_nor_flash_gc_new_mapping_address, &new_mapping_entry, 1);
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+        
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+                /* Return the error.  */
+                return(status);
+            }
+
+            /* Copy the sector data next.  */
+            nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_COPY;
+#ifdef LX_DIRECT_READ
+            *operations =  2;
+#else
+            *operations =  3;
+#endif
+        }
+        else
+        {
+
+            /* The sector is obsolete, move to the next sector of the block.  */
+            nor_flash -> lx_nor_flash_gc_sector++;
+            if (nor_flash -> lx_nor_flash_gc_sector >= nor_flash -> lx_nor_flash_physical_sectors_per_block)
+                nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_ERASE;
+        }
+    }
+
+    /* Determine if the sector data is being copied.  */
+    else if (nor_flash -> lx_nor_flash_gc_state == LX_NOR_GC_STATE_COPY)
+    {
+
+#ifdef LX_DIRECT_READ
+        /* Write the sector data to the new physical sector.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, nor_flash -> lx_nor_flash_gc_new_sector_address, (block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_offset) +
+                                                        (nor_flash -> lx_nor_flash_gc_sector * nor_flash -> lx_nor_flash_words_per_sector), nor_flash -> lx_nor_flash_words_per_sector);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+#else
+
+        /* First, read the sector data into the internal memory of the NOR flash instance. This internal memory
+           is supplied by the underlying driver during initialization.  */
+        status =  _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_offset) +
+                                                       (nor_flash -> lx_nor_flash_gc_sector * nor_flash -> lx_nor_flash_words_per_sector), nor_flash -> lx_nor_flash_sector_buffer,
+                                                       nor_flash -> lx_nor_flash_words_per_sector);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+
+        /* Next, write the sector data from the internal buffer to the new physical sector.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, nor_flash -> lx_nor_flash_gc_new_sector_address, nor_flash -> lx_nor_flash_sector_buffer, nor_flash -> lx_nor_flash_words_per_sector);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+
+        /* Account for the read of the sector data.  */
+        *operations =  *operations + 1;
+#endif
+
+        /* Deprecate the old sector mapping next.  */
+        nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_SUPERCEDE;
+    }
+
+    /* Determine if the old sector mapping is being deprecated.  */
+    else if (nor_flash -> lx_nor_flash_gc_state == LX_NOR_GC_STATE_SUPERCEDE)
+    {
+
+        /* Clear bit 30, which indicates this sector is superceded.  */
+        nor_flash -> lx_nor_flash_gc_mapping_entry =  nor_flash -> lx_nor_flash_gc_mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED);
+            
+        /* Write the value back to the flash to clear bit 30.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, list_word_ptr, &(nor_flash -> lx_nor_flash_gc_mapping_entry), 1);
+                
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+
+        /* Commit the relocation next.  */
+        nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_COMMIT;
+    }
+
+    /* Determine if the relocation is being committed. Validating the new mapping and obsoleting the old one 
+       are done in the same step, so other requests never see two valid mappings of the logical sector.  */
+    else if (nor_flash -> lx_nor_flash_gc_state == LX_NOR_GC_STATE_COMMIT)
+    {
+
+        /* Build the new mapping entry with the not valid bit cleared to make this sector mapping valid.  This is done 
+           because the writing of the extra bytes itself can be interrupted and we need to make sure this can be 
+           detected when the flash is opened again.  */
+        new_mapping_entry =  ((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED) | logical_sector;
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+        /* Keep the mark of a fill sector.  */
+        new_mapping_entry =  new_mapping_entry | (nor_flash -> lx_nor_flash_gc_mapping_entry & LX_NOR_PHYSICAL_SECTOR_FILL);
+#endif
+            
+        /* Clear the not valid bit.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, nor_flash -> lx_nor_flash_gc_new_mapping_address, &new_mapping_entry, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+        /* Update the logical sector index with the new mapping.  */
+        _lx_nor_flash_logical_sector_index_update(nor_flash, logical_sector, nor_flash -> lx_nor_flash_gc_new_mapping_address);
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+        /* Update the block summary with the new mapping.  */
+        _lx_nor_flash_block_summary_update(nor_flash, nor_flash -> lx_nor_flash_gc_new_mapping_address, LX_FALSE);
+#endif
+
+        /* Now clear bit 31, which indicates this sector is now obsoleted.  */
+        list_word =  nor_flash -> lx_nor_flash_gc_mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID);
+            
+        /* Write the value back to the flash to clear bit 31.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, list_word_ptr, &list_word, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+
+        /* Increment the number of obsolete physical sectors.  */
+        nor_flash -> lx_nor_flash_obsolete_physical_sectors++;
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+        /* Update the block summary with the obsoleted sector.  */
+        _lx_nor_flash_block_summary_update(nor_flash, list_word_ptr, LX_TRUE);
+#endif
+
+        /* Invalidate the old sector mapping cache entry, it may have been cached again during the relocation.  */
+        _lx_nor_flash_sector_mapping_cache_invalidate(nor_flash, logical_sector);
+
+        /* Trace the relocation of the sector to its new block.  */
+        LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_RELOCATE, logical_sector,
+                            (ULONG) (nor_flash -> lx_nor_flash_gc_new_mapping_address - nor_flash -> lx_nor_flash_base_address) / nor_flash -> lx_nor_flash_words_per_block);
+
+        /* Account for the second write.  */
+        *operations =  *operations + 1;
+
+        /* Decrement the number of mapped sectors left in the block.  */
+        nor_flash -> lx_nor_flash_gc_mapped_sectors--;
+
+        /* Determine if there is anything left to relocate.  */
+        nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_SCAN;
+        nor_flash -> lx_nor_flash_gc_sector++;
+        if ((nor_flash -> lx_nor_flash_gc_mapped_sectors == 0) || 
+            (nor_flash -> lx_nor_flash_gc_sector >= nor_flash -> lx_nor_flash_physical_sectors_per_block))
+        {
+
+            /* No, the block can be erased.  */
+            nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_ERASE;
+        }
+    }
+
+    /* Determine if the block is being erased.  */
+    else if (nor_flash -> lx_nor_flash_gc_state == LX_NOR_GC_STATE_ERASE)
+    {
+
+        /* Write the erased started indication.  */            
+        erase_started_value =  LX_BLOCK_ERASE_STARTED;
+        status =  _lx_nor_flash_driver_write(nor_flash, block_word_ptr, &erase_started_value, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+       
+        /* Erase the entire block.  */
+        status =  _lx_nor_flash_driver_block_erase(nor_flash, nor_flash -> lx_nor_flash_gc_block, nor_flash -> lx_nor_flash_gc_erase_count + 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+            
+            /* Return the error.  */
+            return(status);
+        }
+
+        /* Determine if the erase count is at the minimum.  */
+        if (nor_flash -> lx_nor_flash_gc_erase_count == nor_flash -> lx_nor_flash_minimum_erase_count)
+        {
+            
+            /* Yes, decrement the minimum erased block count.  */
+            nor_flash -> lx_nor_flash_minimum_erased_blocks--;
+        }
+
+        /* Write the block header next.  */
+        nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_HEADER;
+        *operations =  2;
+    }
+
+    /* Otherwise, the header of the erased block is being written.  */
+    else
+    {
+
+        /* Increment the erase count.  */
+        erase_count =  nor_flash -> lx_nor_flash_gc_erase_count + 1;
+
+        /* Determine if the new erase count exceeds the maximum.  */
+        if (erase_count > ((ULONG) LX_BLOCK_ERASE_COUNT_MAX))
+        {
+                
+            /* Yes, erase count is in overflow. Stay at the maximum count.  */
+            erase_count =  ((ULONG) LX_BLOCK_ERASE_COUNT_MAX);
+        }
+        
+        /* Determine if we need to update the maximum erase count.  */
+        if (erase_count > nor_flash -> lx_nor_flash_maximum_erase_count)
+        {
+        
+            /* Yes, a new maximum is present.  */
+            nor_flash -> lx_nor_flash_maximum_erase_count =  erase_count;
+        }
+        
+        /* Setup the free bit map that corresponds to the free physical sectors in this
+           block. Note that we only need to setup the portion of the free bit map that doesn't 
+           have sectors associated with it.  */            
+        status =  _lx_nor_flash_driver_write(nor_flash, block_word_ptr+(nor_flash -> lx_nor_flash_block_free_bit_map_offset + (nor_flash -> lx_nor_flash_block_bit_map_words - 1)), 
+                                                                        &(nor_flash -> lx_nor_flash_block_bit_map_mask), 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+       
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+        
+        /* Write the initial erase count for the block with upper bit set.  */
+        temp_erase_count =  (erase_count | LX_BLOCK_ERASED);
+        status =  _lx_nor_flash_driver_write(nor_flash, block_word_ptr, &temp_erase_count, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+
+        /* Write the final initial erase count for the block.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, block_word_ptr, &erase_count, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+        
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return the error.  */
+            return(status);
+        }
+
+        /* Every sector of the block that wasn't free is obsolete now, and free again after the erase.  */
+        obsolete_sectors =  nor_flash -> lx_nor_flash_physical_sectors_per_block - nor_flash -> lx_nor_flash_gc_free_sectors;
+
+        /* Update parameters of this flash.  */
+        nor_flash -> lx_nor_flash_free_physical_sectors =      nor_flash -> lx_nor_flash_free_physical_sectors + obsolete_sectors;
+        nor_flash -> lx_nor_flash_obsolete_physical_sectors =  nor_flash -> lx_nor_flash_obsolete_physical_sectors - obsolete_sectors;
+#ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
+
+        /* Check if the block is cached by obsolete count cache.  */
+        if (nor_flash -> lx_nor_flash_gc_block < nor_flash -> lx_nor_flash_extended_cache_obsolete_count_max_block)
+        {
+
+            /* Yes, clear the obsolete count for this block.  */
+            nor_flash -> lx_nor_flash_extended_cache_obsolete_count[nor_flash -> lx_nor_flash_gc_block] =  0;
+        }
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+        /* Determine if the block summary is enabled.  */
+        if (nor_flash -> lx_nor_flash_block_summary_enabled)
+        {
+
+            /* Yes, the block is now erased and all of its sectors are free.  */
+            nor_flash -> lx_nor_flash_block_summary[nor_flash -> lx_nor_flash_gc_block].lx_nor_flash_block_summary_erase_count =      erase_count;
+            nor_flash -> lx_nor_flash_block_summary[nor_flash -> lx_nor_flash_gc_block].lx_nor_flash_block_summary_mapped_sectors =   0;
+            nor_flash -> lx_nor_flash_block_summary[nor_flash -> lx_nor_flash_gc_block].lx_nor_flash_block_summary_obsolete_sectors = 0;
+            nor_flash -> lx_nor_flash_block_summary[nor_flash -> lx_nor_flash_gc_block].lx_nor_flash_block_summary_free_sectors =     (USHORT) nor_flash -> lx_nor_flash_physical_sectors_per_block;
+            nor_flash -> lx_nor_flash_block_summary[nor_flash -> lx_nor_flash_gc_block].lx_nor_flash_block_summary_next_free_sector = 0;
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+
+            /* Update the erase queue with the new erase count.  */
+            _lx_nor_flash_erase_queue_update(nor_flash, nor_flash -> lx_nor_flash_gc_block);
+#endif
+        }
+#endif
+
+        /* The block is reclaimed.  */
+        nor_flash -> lx_nor_flash_gc_state =  LX_NOR_GC_STATE_IDLE;
+        *operations =  3;
+    }
+
+    /* Return success.  */
+    return(LX_SUCCESS);
+}
@@ -0,0 +1,320 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_block_summary_enable                  PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function enables or disables the RAM block summary. The block  */
+/*    summary holds the erase count, the number of mapped, obsolete and   */
+/*    free sectors and the next free sector of every block, which allows  */
+/*    the next block to erase to be selected and free sectors to be       */
+/*    allocated without reading the flash. The memory must be             */
+/*    large enough to cover all blocks. This function may be called from  */
+/*    the driver initialization, in which case the summary is built while */
+/*    the NOR flash is opened, or after the NOR flash is opened, in which */
+/*    case the summary is built here from the block headers.              */
+/*    When the erase queue is enabled, it is built from the summary.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    memory                                Address of RAM for summary    */
+/*    size                                  Size of the RAM for summary   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_driver_read             Driver read                   */
+/*    _lx_nor_flash_erase_queue_update      Update erase queue            */
+/*    _lx_nor_flash_system_error            Internal system error handler */
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_block_summary_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size)
+{
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+ULONG                       i;
+ULONG                       j;
+ULONG                       *block_word_ptr;
+ULONG                       block_word;
+ULONG                       free_sectors;
+ULONG                       mapped_sectors;
+ULONG                       obsolete_sectors;
+LX_NOR_FLASH_BLOCK_SUMMARY  *block_summary;
+#ifndef LX_DIRECT_READ
+UINT                        status;
+#endif
+
+
+    /* Check if the NOR flash is opened.  */
+    if (nor_flash -> lx_nor_flash_state != LX_NOR_FLASH_OPENED)
+    {
+
+        /* No, this is called from the driver initialization. Just remember the memory, the summary
+           is built by the open logic.  */
+        nor_flash -> lx_nor_flash_block_summary =  (LX_NOR_FLASH_BLOCK_SUMMARY *) memory;
+        nor_flash -> lx_nor_flash_block_summary_size =  size;
+        nor_flash -> lx_nor_flash_block_summary_enabled =  LX_FALSE;
+
+        /* Return successful completion.  */
+        return(LX_SUCCESS);
+    }
+
+    /* Determine if memory was specified but not enough to cover every block.  */
+    if ((memory) && (size < (ULONG) LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(nor_flash -> lx_nor_flash_total_blocks)))
+    {
+
+        /* Error in memory size supplied.  */
+        return(LX_ERROR);
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Disable the summary while it is being built.  */
+    nor_flash -> lx_nor_flash_block_summary_enabled =  LX_FALSE;
+
+    /* Setup the summary memory.  */
+    nor_flash -> lx_nor_flash_block_summary =  (LX_NOR_FLASH_BLOCK_SUMMARY *) memory;
+    nor_flash -> lx_nor_flash_block_summary_size =  size;
+
+    /* Determine if the summary is being disabled.  */
+    if (memory == LX_NULL)
+    {
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+        /* Return successful completion.  */
+        return(LX_SUCCESS);
+    }
+
+    /* Loop through the blocks.  */
+    for (i = 0; i < nor_flash -> lx_nor_flash_total_blocks; i++)
+    {
+
+        /* Setup the block word pointer to the first word of the block.  */
+        block_word_ptr =  (nor_flash -> lx_nor_flash_base_address + (i * nor_flash -> lx_nor_flash_words_per_block));
+
+        /* Read the erase count of this block.  */
+#ifdef LX_DIRECT_READ
+
+        /* Read the word directly.  */
+        block_word =  *(block_word_ptr);
+#else
+        status =  _lx_nor_flash_driver_read(nor_flash, block_word_ptr, &block_word, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+            /* Release the thread safe mutex.  */
+            LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+            /* Return an error.  */
+            return(LX_ERROR);
+        }
+#endif
+
+        /* Remember the erase count of this block.  */
+        nor_flash -> lx_nor_flash_block_summary[i].lx_nor_flash_block_summary_erase_count =  block_word;
+
+        /* Calculate the number of free sectors from the free sector bit map.  */
+        free_sectors =  0;
+        for (j = 0; j < nor_flash -> lx_nor_flash_block_bit_map_words; j++)
+        {
+
+            /* Read this word of the free sector bit map.  */
+#ifdef LX_DIRECT_READ
+
+            /* Read the word directly.  */
+            block_word =  *(block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j);
+#else
+            status =  _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+                /* Release the thread safe mutex.  */
+                LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+                /* Return an error.  */
+                return(LX_ERROR);
+            }
+#endif
+
+            /* Count the number of set bits (free sectors).  */
+            while (block_word)
+            {
+
+                /* Clear the lowest set bit.  */
+                block_word =  block_word & (block_word - 1);
+                free_sectors++;
+            }
+        }
+
+        /* Now walk the list of logical-physical sector mapping.  */
+        mapped_sectors =    0;
+        obsolete_sectors =  0;
+        for (j = 0; j < nor_flash -> lx_nor_flash_physical_sectors_per_block; j++)
+        {
+
+            /* Read this word of the sector mapping list.  */
+#ifdef LX_DIRECT_READ
+
+            /* Read the word directly.  */
+            block_word =  *(block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + j);
+#else
+            status =  _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + j), &block_word, 1);
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+                /* Release the thread safe mutex.  */
+                LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+                /* Return an error.  */
+                return(LX_ERROR);
+            }
+#endif
+
+            /* Determine if the entry hasn't been used.  */
+            if (block_word == LX_NOR_PHYSICAL_SECTOR_FREE)
+            {
+                break;
+            }
+
+            /* Is this entry obsolete?  */
+            if ((block_word & LX_NOR_PHYSICAL_SECTOR_VALID) == 0)
+            {
+
+                /* Increment the number of obsolete sectors.  */
+                obsolete_sectors++;
+            }
+            else
+            {
+
+                /* Increment the number of mapped sectors.  */
+                mapped_sectors++;
+            }
+        }
+
+        /* Save the sector counts of this block.  */
+        block_summary =  &nor_flash -> lx_nor_flash_block_summary[i];
+        block_summary -> lx_nor_flash_block_summary_mapped_sectors =    (USHORT) mapped_sectors;
+        block_summary -> lx_nor_flash_block_summary_obsolete_sectors =  (USHORT) obsolete_sectors;
+        block_summary -> lx_nor_flash_block_summary_free_sectors =      (USHORT) free_sectors;
+        block_summary -> lx_nor_flash_block_summary_next_free_sector =  (USHORT) (nor_flash -> lx_nor_flash_physical_sectors_per_block - free_sectors);
+    }
+
+    /* The summary is now complete, enable it.  */
+    nor_flash -> lx_nor_flash_block_summary_enabled =  LX_TRUE;
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+
+    /* Setup the erase queue, which follows the block summary entries, and build it.  */
+    nor_flash -> lx_nor_flash_erase_queue =  (LX_NOR_FLASH_ERASE_QUEUE_NODE *) (nor_flash -> lx_nor_flash_block_summary + nor_flash -> lx_nor_flash_total_blocks);
+    _lx_nor_flash_erase_queue_update(nor_flash, LX_NOR_ERASE_QUEUE_REBUILD);
+#endif
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return successful completion.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(memory);
+    LX_PARAMETER_NOT_USED(size);
+
+    /* Return disabled error message.  */
+    return(LX_DISABLED);
+#endif
+}
+
@@ -0,0 +1,129 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_block_summary_update                  PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the sector counts in the block summary entry  */
+/*    of the block that contains the physical sector mapping entry. A     */
+/*    newly mapped sector moves from free to mapped, an obsoleted sector  */
+/*    moves from mapped to obsolete.                                      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    physical_sector_map_entry             Pointer to mapping entry      */
+/*    sector_obsoleted                      LX_TRUE if sector obsoleted,  */
+/*                                            LX_FALSE if sector mapped   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_erase_queue_update      Update erase queue            */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_block_summary_update(LX_NOR_FLASH *nor_flash, ULONG *physical_sector_map_entry, UINT sector_obsoleted)
+{
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+ULONG                       block;
+LX_NOR_FLASH_BLOCK_SUMMARY  *block_summary;
+
+
+    /* Determine if the block summary is enabled.  */
+    if (nor_flash -> lx_nor_flash_block_summary_enabled == LX_FALSE)
+    {
+
+        /* No, nothing to do.  */
+        return;
+    }
+
+    /* Get the block number from mapping address.  */
+    block =  (ULONG)(physical_sector_map_entry - nor_flash -> lx_nor_flash_base_address) / nor_flash -> lx_nor_flash_words_per_block;
+
+    /* Pickup the summary entry of this block.  */
+    block_summary =  &nor_flash -> lx_nor_flash_block_summary[block];
+
+    /* Determine if the sector is being obsoleted.  */
+    if (sector_obsoleted)
+    {
+
+        /* Move the sector from mapped to obsolete.  */
+        block_summary -> lx_nor_flash_block_summary_mapped_sectors--;
+        block_summary -> lx_nor_flash_block_summary_obsolete_sectors++;
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+
+        /* Update the erase queue with the new obsolete sector count.  */
+        _lx_nor_flash_erase_queue_update(nor_flash, block);
+#endif
+    }
+    else
+    {
+
+        /* Move the sector from free to mapped.  */
+        block_summary -> lx_nor_flash_block_summary_free_sectors--;
+        block_summary -> lx_nor_flash_block_summary_mapped_sectors++;
+    }
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(physical_sector_map_entry);
+    LX_PARAMETER_NOT_USED(sector_obsoleted);
+#endif
+}
+
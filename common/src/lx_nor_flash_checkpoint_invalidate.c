@@ -0,0 +1,118 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_checkpoint_invalidate                 PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function is called before the NOR flash is changed. If the     */ 
+/*    checkpoint matches the flash, its valid word is cleared so the next */ 
+/*    open does not trust it.                                             */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    (lx_nor_flash_driver_write)           Driver flash sector write     */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Internal LevelX                                                     */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_checkpoint_invalidate(LX_NOR_FLASH *nor_flash)
+{
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+LX_NOR_FLASH_CHECKPOINT_HEADER  *checkpoint_header;
+ULONG                           valid;
+UINT                            status;
+
+
+    /* Determine if the checkpoint matches the flash.  */
+    if (nor_flash -> lx_nor_flash_checkpoint_valid == LX_FALSE)
+    {
+
+        /* No, there is nothing to do.  */
+        return(LX_SUCCESS);
+    }
+
+    /* Clear the valid flag first, the write below must not invalidate the checkpoint again.  */
+    nor_flash -> lx_nor_flash_checkpoint_valid =  LX_FALSE;
+
+    /* Pickup the address of the checkpoint, which follows the last block.  */
+    checkpoint_header =  (LX_NOR_FLASH_CHECKPOINT_HEADER *) (nor_flash -> lx_nor_flash_base_address + 
+                            (nor_flash -> lx_nor_flash_total_blocks * nor_flash -> lx_nor_flash_words_per_block));
+
+    /* Clear the valid word of the checkpoint. The checkpoint is outside the blocks, so the actual driver write 
+       function is called directly.  */
+    valid =  0;
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    status =  (nor_flash -> lx_nor_flash_driver_write)(nor_flash, &checkpoint_header -> lx_nor_flash_checkpoint_valid, &valid, 1);
+#else
+    status =  (nor_flash -> lx_nor_flash_driver_write)(&checkpoint_header -> lx_nor_flash_checkpoint_valid, &valid, 1);
+#endif
+
+    /* Return completion status.  */
+    return(status);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+
+    /* Return success.  */
+    return(LX_SUCCESS);
+#endif
+}
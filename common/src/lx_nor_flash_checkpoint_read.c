@@ -0,0 +1,355 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_checkpoint_read                       PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function restores the sector counts, erase counts, block       */ 
+/*    summary and logical sector index of the NOR flash from the          */ 
+/*    checkpoint. The checkpoint is only used if it is complete, still    */ 
+/*    matches the flash, was written for the same geometry and            */ 
+/*    configuration, and its CRC is correct. Otherwise, nothing is        */ 
+/*    restored and the checkpoint is invalidated, so the blocks are       */ 
+/*    walked instead.                                                     */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    LX_SUCCESS                            Checkpoint restored           */ 
+/*    LX_ERROR                              No valid checkpoint           */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_checkpoint_crc_update   Update checkpoint CRC         */ 
+/*    _lx_nor_flash_checkpoint_invalidate   Invalidate mount checkpoint   */
+/*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
+/*    _lx_nor_flash_system_error            Internal system error handler */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_open                    Open NOR flash                */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_checkpoint_read(LX_NOR_FLASH *nor_flash)
+{
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+LX_NOR_FLASH_CHECKPOINT_HEADER  header;
+ULONG                           *checkpoint_address;
+ULONG                           *word_ptr;
+ULONG                           word;
+ULONG                           crc;
+ULONG                           contents;
+ULONG                           index_entries;
+ULONG                           words;
+ULONG                           i;
+#ifndef LX_DIRECT_READ
+UINT                            status;
+#endif
+
+
+    /* Determine if the driver reserved blocks for the checkpoint.  */
+    if (nor_flash -> lx_nor_flash_checkpoint_blocks == 0)
+    {
+
+        /* No, there is no checkpoint.  */
+        return(LX_ERROR);
+    }
+
+    /* Pickup the address of the checkpoint, which follows the last block.  */
+    checkpoint_address =  nor_flash -> lx_nor_flash_base_address + (nor_flash -> lx_nor_flash_total_blocks * nor_flash -> lx_nor_flash_words_per_block);
+
+    /* Read the checkpoint header.  */
+#ifdef LX_DIRECT_READ
+
+    /* Read the words directly.  */
+    word_ptr =  (ULONG *) &header;
+    for (i = 0; i < (ULONG) (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG)); i++)
+    {
+        *word_ptr++ =  *(checkpoint_address + i);
+    }
+#else
+    status =  _lx_nor_flash_driver_read(nor_flash, checkpoint_address, (ULONG *) &header, (ULONG) (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG)));
+
+    /* Check for an error from flash driver. Drivers should never return an error..  */
+    if (status)
+    {
+
+        /* Call system error handler.  */
+        _lx_nor_flash_system_error(nor_flash, status);
+
+        /* Return an error.  */
+        return(LX_ERROR);
+    }
+#endif
+
+    /* Determine if a checkpoint was written before.  */
+    if (header.lx_nor_flash_checkpoint_magic == LX_NOR_CHECKPOINT_MAGIC)
+    {
+
+        /* Yes, continue its sequence numbers.  */
+        nor_flash -> lx_nor_flash_checkpoint_sequence =  header.lx_nor_flash_checkpoint_sequence;
+    }
+
+    /* Determine what the checkpoint must contain for the current configuration.  */
+    contents =       0;
+    index_entries =  0;
+    words =          (ULONG) (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG)) + 1;
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+    if (nor_flash -> lx_nor_flash_block_summary_enabled)
+    {
+        contents =  contents | LX_NOR_CHECKPOINT_BLOCK_SUMMARY;
+        words =     words + (3 * nor_flash -> lx_nor_flash_total_blocks);
+    }
+#endif
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+    if (nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector)
+    {
+        contents =       contents | LX_NOR_CHECKPOINT_LOGICAL_SECTOR_INDEX;
+        index_entries =  nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector;
+        words =          words + index_entries;
+    }
+#endif
+
+    /* Determine if the checkpoint is complete, still matches the flash and was written for the same geometry 
+       and configuration.  */
+    if ((header.lx_nor_flash_checkpoint_magic != LX_NOR_CHECKPOINT_MAGIC) ||
+        (header.lx_nor_flash_checkpoint_valid != LX_ALL_ONES) ||
+        (header.lx_nor_flash_checkpoint_words != words) ||
+        (words > (nor_flash -> lx_nor_flash_checkpoint_blocks * nor_flash -> lx_nor_flash_words_per_block)) ||
+        (header.lx_nor_flash_checkpoint_total_blocks != nor_flash -> lx_nor_flash_total_blocks) ||
+        (header.lx_nor_flash_checkpoint_words_per_block != nor_flash -> lx_nor_flash_words_per_block) ||
+        (header.lx_nor_flash_checkpoint_words_per_sector != nor_flash -> lx_nor_flash_words_per_sector) ||
+        (header.lx_nor_flash_checkpoint_contents != contents) ||
+        (header.lx_nor_flash_checkpoint_index_entries != index_entries))
+    {
+
+        /* Determine if the checkpoint is still marked valid.  */
+        if ((header.lx_nor_flash_checkpoint_magic == LX_NOR_CHECKPOINT_MAGIC) &&
+            (header.lx_nor_flash_checkpoint_valid == LX_ALL_ONES))
+        {
+
+            /* Yes, clear it so it is never used once the flash is changed.  */
+            nor_flash -> lx_nor_flash_checkpoint_valid =  LX_TRUE;
+            _lx_nor_flash_checkpoint_invalidate(nor_flash);
+        }
+
+        /* The checkpoint can't be used.  */
+        return(LX_ERROR);
+    }
+
+    /* Compute the CRC of the header, from the sequence number on.  */
+    crc =  LX_ALL_ONES;
+    word_ptr =  &header.lx_nor_flash_checkpoint_sequence;
+    for (i = 2; i < (ULONG) (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG)); i++)
+    {
+        crc =  _lx_nor_flash_checkpoint_crc_update(crc, *word_ptr++);
+    }
+
+    /* Add the rest of the checkpoint to the CRC, up to and including the stored CRC.  */
+    word_ptr =  checkpoint_address + (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG));
+    for (i = (ULONG) (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG)); i < words; i++)
+    {
+
+        /* Read the next word of the checkpoint.  */
+#ifdef LX_DIRECT_READ
+
+        /* Read the word directly.  */
+        word =  *word_ptr;
+#else
+        status =  _lx_nor_flash_driver_read(nor_flash, word_ptr, &word, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return an error.  */
+            return(LX_ERROR);
+        }
+#endif
+
+        /* Determine if this is the stored CRC.  */
+        if (i == (words - 1))
+        {
+
+            /* Yes, determine if it matches the computed CRC.  */
+            if (word != crc)
+            {
+
+                /* No, the checkpoint is corrupted. Clear its valid word so it is never used.  */
+                nor_flash -> lx_nor_flash_checkpoint_valid =  LX_TRUE;
+                _lx_nor_flash_checkpoint_invalidate(nor_flash);
+                return(LX_ERROR);
+            }
+        }
+        else
+        {
+
+            /* Add the word to the CRC.  */
+            crc =  _lx_nor_flash_checkpoint_crc_update(crc, word);
+        }
+
+        /* Move to the next word.  */
+        word_ptr++;
+    }
+
+    /* The checkpoint is valid, restore the sector counts and erase counts.  */
+    nor_flash -> lx_nor_flash_free_physical_sectors =      header.lx_nor_flash_checkpoint_free_physical_sectors;
+    nor_flash -> lx_nor_flash_mapped_physical_sectors =    header.lx_nor_flash_checkpoint_mapped_physical_sectors;
+    nor_flash -> lx_nor_flash_obsolete_physical_sectors =  header.lx_nor_flash_checkpoint_obsolete_physical_sectors;
+    nor_flash -> lx_nor_flash_minimum_erase_count =        header.lx_nor_flash_checkpoint_minimum_erase_count;
+    nor_flash -> lx_nor_flash_minimum_erased_blocks =      header.lx_nor_flash_checkpoint_minimum_erased_blocks;
+    nor_flash -> lx_nor_flash_maximum_erase_count =        header.lx_nor_flash_checkpoint_maximum_erase_count;
+    nor_flash -> lx_nor_flash_free_block_search =          header.lx_nor_flash_checkpoint_free_block_search;
+
+    /* Move past the header.  */
+    word_ptr =  checkpoint_address + (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG));
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+    /* Determine if the block summary is included.  */
+    if (contents & LX_NOR_CHECKPOINT_BLOCK_SUMMARY)
+    {
+
+        /* Restore the erase count and the sector counts of each block.  */
+        for (i = 0; i < (3 * nor_flash -> lx_nor_flash_total_blocks); i++)
+        {
+
+            /* Read the next word of the block summary.  */
+#ifdef LX_DIRECT_READ
+
+            /* Read the word directly.  */
+            word =  *word_ptr;
+#else
+            status =  _lx_nor_flash_driver_read(nor_flash, word_ptr, &word, 1);
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+                /* Return an error.  */
+                return(LX_ERROR);
+            }
+#endif
+
+            /* Store the word in the block summary entry.  */
+            if ((i % 3) == 0)
+            {
+                nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_erase_count =        word;
+            }
+            else if ((i % 3) == 1)
+            {
+                nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_mapped_sectors =     (USHORT) (word >> 16);
+                nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_obsolete_sectors =   (USHORT) (word & 0xFFFF);
+            }
+            else
+            {
+                nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_free_sectors =       (USHORT) (word >> 16);
+                nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_next_free_sector =   (USHORT) (word & 0xFFFF);
+            }
+            word_ptr++;
+        }
+    }
+#endif
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+    /* Restore the logical sector index entries.  */
+    for (i = 0; i < index_entries; i++)
+    {
+
+        /* Read the next index entry.  */
+#ifdef LX_DIRECT_READ
+
+        /* Read the word directly.  */
+        word =  *word_ptr;
+#else
+        status =  _lx_nor_flash_driver_read(nor_flash, word_ptr, &word, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return an error.  */
+            return(LX_ERROR);
+        }
+#endif
+
+        /* Store the entry in the index.  */
+        nor_flash -> lx_nor_flash_logical_sector_index[i] =  (LX_NOR_LOGICAL_SECTOR_INDEX_TYPE) word;
+        word_ptr++;
+    }
+#endif
+
+    /* The checkpoint matches the flash until the flash is changed.  */
+    nor_flash -> lx_nor_flash_checkpoint_valid =     LX_TRUE;
+    nor_flash -> lx_nor_flash_checkpoint_restored =  LX_TRUE;
+
+    /* Return success.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+
+    /* Return an error, there is no checkpoint.  */
+    return(LX_ERROR);
+#endif
+}
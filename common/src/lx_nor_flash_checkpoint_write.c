@@ -0,0 +1,316 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_checkpoint_write                      PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function writes the sector counts, erase counts, block summary */ 
+/*    and logical sector index of the NOR flash to the checkpoint blocks  */ 
+/*    reserved by the driver, so the next open can restore them instead   */ 
+/*    of walking every block. A reclaim in progress is finished first.    */ 
+/*    Nothing is written if the checkpoint still matches the flash.       */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_block_reclaim           Reclaim one flash block       */ 
+/*    _lx_nor_flash_checkpoint_crc_update   Update checkpoint CRC         */ 
+/*    (lx_nor_flash_driver_block_erase)     Driver erase block            */ 
+/*    _lx_nor_flash_driver_write            Driver flash sector write     */ 
+/*    _lx_nor_flash_system_error            Internal system error handler */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application Code                                                    */ 
+/*    _lx_nor_flash_close                   Close NOR flash               */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_checkpoint_write(LX_NOR_FLASH *nor_flash)
+{
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+LX_NOR_FLASH_CHECKPOINT_HEADER  header;
+ULONG                           *checkpoint_address;
+ULONG                           *word_ptr;
+#if defined(LX_NOR_ENABLE_BLOCK_SUMMARY) || defined(LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX)
+ULONG                           word;
+#endif
+ULONG                           crc;
+ULONG                           i;
+UINT                            status;
+
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Determine if the driver reserved blocks for the checkpoint.  */
+    if (nor_flash -> lx_nor_flash_checkpoint_blocks == 0)
+    {
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+        /* Return not supported.  */
+        return(LX_NOT_SUPPORTED);
+    }
+
+    /* Default the status to success.  */
+    status =  LX_SUCCESS;
+
+    /* Determine if a reclaim is in progress.  */
+    if (nor_flash -> lx_nor_flash_gc_state != LX_NOR_GC_STATE_IDLE)
+    {
+
+        /* Yes, finish it so the sector counts match the flash.  */
+        status =  _lx_nor_flash_block_reclaim(nor_flash);
+    }
+
+    /* Determine if the checkpoint still matches the flash.  */
+    if ((status != LX_SUCCESS) || (nor_flash -> lx_nor_flash_checkpoint_valid))
+    {
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+        /* Return the completion status.  */
+        return(status);
+    }
+
+    /* Build the checkpoint header.  */
+    header.lx_nor_flash_checkpoint_magic =                       LX_NOR_CHECKPOINT_MAGIC;
+    header.lx_nor_flash_checkpoint_valid =                       LX_ALL_ONES;
+    header.lx_nor_flash_checkpoint_sequence =                    nor_flash -> lx_nor_flash_checkpoint_sequence + 1;
+    header.lx_nor_flash_checkpoint_words =                       (ULONG) (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG)) + 1;
+    header.lx_nor_flash_checkpoint_total_blocks =                nor_flash -> lx_nor_flash_total_blocks;
+    header.lx_nor_flash_checkpoint_words_per_block =             nor_flash -> lx_nor_flash_words_per_block;
+    header.lx_nor_flash_checkpoint_words_per_sector =            nor_flash -> lx_nor_flash_words_per_sector;
+    header.lx_nor_flash_checkpoint_contents =                    0;
+    header.lx_nor_flash_checkpoint_index_entries =               0;
+    header.lx_nor_flash_checkpoint_free_physical_sectors =       nor_flash -> lx_nor_flash_free_physical_sectors;
+    header.lx_nor_flash_checkpoint_mapped_physical_sectors =     nor_flash -> lx_nor_flash_mapped_physical_sectors;
+    header.lx_nor_flash_checkpoint_obsolete_physical_sectors =   nor_flash -> lx_nor_flash_obsolete_physical_sectors;
+    header.lx_nor_flash_checkpoint_minimum_erase_count =         nor_flash -> lx_nor_flash_minimum_erase_count;
+    header.lx_nor_flash_checkpoint_minimum_erased_blocks =       nor_flash -> lx_nor_flash_minimum_erased_blocks;
+    header.lx_nor_flash_checkpoint_maximum_erase_count =         nor_flash -> lx_nor_flash_maximum_erase_count;
+    header.lx_nor_flash_checkpoint_free_block_search =           nor_flash -> lx_nor_flash_free_block_search;
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+    /* Determine if the block summary is enabled.  */
+    if (nor_flash -> lx_nor_flash_block_summary_enabled)
+    {
+
+        /* Yes, include 3 words for each block.  */
+        header.lx_nor_flash_checkpoint_contents =  header.lx_nor_flash_checkpoint_contents | LX_NOR_CHECKPOINT_BLOCK_SUMMARY;
+        header.lx_nor_flash_checkpoint_words =     header.lx_nor_flash_checkpoint_words + (3 * nor_flash -> lx_nor_flash_total_blocks);
+    }
+#endif
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+    /* Determine if the logical sector index is enabled.  */
+    if (nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector)
+    {
+
+        /* Yes, include one word for each index entry.  */
+        header.lx_nor_flash_checkpoint_contents =       header.lx_nor_flash_checkpoint_contents | LX_NOR_CHECKPOINT_LOGICAL_SECTOR_INDEX;
+        header.lx_nor_flash_checkpoint_index_entries =  nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector;
+        header.lx_nor_flash_checkpoint_words =          header.lx_nor_flash_checkpoint_words + header.lx_nor_flash_checkpoint_index_entries;
+    }
+#endif
+
+    /* Determine if the checkpoint fits in the reserved blocks.  */
+    if (header.lx_nor_flash_checkpoint_words > (nor_flash -> lx_nor_flash_checkpoint_blocks * nor_flash -> lx_nor_flash_words_per_block))
+    {
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+        /* Return no memory.  */
+        return(LX_NO_MEMORY);
+    }
+
+    /* Erase the checkpoint blocks, which follow the last block. They hold no sectors, so the driver is called
+       directly, without the cache, shared read, statistics and trace updates of a block erase.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < nor_flash -> lx_nor_flash_checkpoint_blocks); i++)
+    {
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+        status =  (nor_flash -> lx_nor_flash_driver_block_erase)(nor_flash, nor_flash -> lx_nor_flash_total_blocks + i, header.lx_nor_flash_checkpoint_sequence);
+#else
+        status =  (nor_flash -> lx_nor_flash_driver_block_erase)(nor_flash -> lx_nor_flash_total_blocks + i, header.lx_nor_flash_checkpoint_sequence);
+#endif
+    }
+
+    /* Write the header, except for the magic number and the valid word, and compute its CRC.  */
+    checkpoint_address =  nor_flash -> lx_nor_flash_base_address + (nor_flash -> lx_nor_flash_total_blocks * nor_flash -> lx_nor_flash_words_per_block);
+    word_ptr =  &header.lx_nor_flash_checkpoint_sequence;
+    if (status == LX_SUCCESS)
+    {
+        status =  _lx_nor_flash_driver_write(nor_flash, checkpoint_address + 2, word_ptr, (ULONG) (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG)) - 2);
+    }
+    crc =  LX_ALL_ONES;
+    for (i = 2; i < (ULONG) (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG)); i++)
+    {
+        crc =  _lx_nor_flash_checkpoint_crc_update(crc, *word_ptr++);
+    }
+
+    /* Move past the header.  */
+    checkpoint_address =  checkpoint_address + (sizeof(LX_NOR_FLASH_CHECKPOINT_HEADER) / sizeof(ULONG));
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+    /* Determine if the block summary is included.  */
+    if (header.lx_nor_flash_checkpoint_contents & LX_NOR_CHECKPOINT_BLOCK_SUMMARY)
+    {
+
+        /* Write the erase count and the sector counts of each block.  */
+        for (i = 0; (status == LX_SUCCESS) && (i < (3 * nor_flash -> lx_nor_flash_total_blocks)); i++)
+        {
+
+            /* Build the next word of the block summary.  */
+            if ((i % 3) == 0)
+                word =  nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_erase_count;
+            else if ((i % 3) == 1)
+                word =  (((ULONG) nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_mapped_sectors) << 16) |
+                        ((ULONG) nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_obsolete_sectors);
+            else
+                word =  (((ULONG) nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_free_sectors) << 16) |
+                        ((ULONG) nor_flash -> lx_nor_flash_block_summary[i / 3].lx_nor_flash_block_summary_next_free_sector);
+
+            /* Write the word and add it to the CRC.  */
+            status =  _lx_nor_flash_driver_write(nor_flash, checkpoint_address, &word, 1);
+            crc =  _lx_nor_flash_checkpoint_crc_update(crc, word);
+            checkpoint_address++;
+        }
+    }
+#endif
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+    /* Write the logical sector index entries.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < header.lx_nor_flash_checkpoint_index_entries); i++)
+    {
+
+        /* Write the entry and add it to the CRC.  */
+        word =  (ULONG) nor_flash -> lx_nor_flash_logical_sector_index[i];
+        status =  _lx_nor_flash_driver_write(nor_flash, checkpoint_address, &word, 1);
+        crc =  _lx_nor_flash_checkpoint_crc_update(crc, word);
+        checkpoint_address++;
+    }
+#endif
+
+    /* Write the CRC.  */
+    if (status == LX_SUCCESS)
+    {
+        status =  _lx_nor_flash_driver_write(nor_flash, checkpoint_address, &crc, 1);
+    }
+
+    /* Finally, write the magic number, which makes the checkpoint complete.  */
+    checkpoint_address =  nor_flash -> lx_nor_flash_base_address + (nor_flash -> lx_nor_flash_total_blocks * nor_flash -> lx_nor_flash_words_per_block);
+    if (status == LX_SUCCESS)
+    {
+        status =  _lx_nor_flash_driver_write(nor_flash, checkpoint_address, &header.lx_nor_flash_checkpoint_magic, 1);
+    }
+
+    /* Check for an error from flash driver. Drivers should never return an error..  */
+    if (status)
+    {
+
+        /* Call system error handler.  */
+        _lx_nor_flash_system_error(nor_flash, status);
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+        /* Return an error.  */
+        return(LX_ERROR);
+    }
+
+    /* The checkpoint now matches the flash.  */
+    nor_flash -> lx_nor_flash_checkpoint_sequence =  header.lx_nor_flash_checkpoint_sequence;
+    nor_flash -> lx_nor_flash_checkpoint_valid =     LX_TRUE;
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return success.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+
+    /* Return disabled error message.  */
+    return(LX_DISABLED);
+#endif
+}
@@ -39,14 +39,16 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_close                                 PORTABLE C      */ 
-/*                                                           6.1.7        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
 /*                                                                        */
 /*  DESCRIPTION                                                           */ 
 /*                                                                        */ 
-/*    This function closes a NOR flash instance.                          */ 
+/*    This function closes a NOR flash instance. If the driver reserved   */ 
+/*    blocks for the mount checkpoint, the checkpoint is written first so */ 
+/*    the next open doesn't have to walk the blocks.                      */ 
 /*                                                                        */ 
 /*  INPUT                                                                 */ 
 /*                                                                        */ 
@@ -58,7 +60,10 @@
 /*                                                                        */ 
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
-/*    tx_mutex_delete                       Delete thread-safe mutex      */ 
+/*    _lx_nor_flash_checkpoint_write        Write mount checkpoint        */
+/*    LX_LOCK_MUTEX_DELETE                  Delete thread-safe mutex      */ 
+/*    LX_LOCK_SEMAPHORE_DELETE              Delete shared read semaphore  */ 
+/*    LX_LOCK_RWLOCK_DELETE                 Delete shared read lock       */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -73,6 +78,11 @@
 /*                                            resulting in version 6.1    */
 /*  06-02-2021     Bhupendra Naphade        Modified comment(s),          */
 /*                                            resulting in version 6.1.7  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added mount checkpoint,     */
+/*                                            added shared reads,         */
+/*                                            added lock backend support, */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_close(LX_NOR_FLASH *nor_flash)
@@ -80,6 +90,22 @@ UINT  _lx_nor_flash_close(LX_NOR_FLASH *nor_flash)
 
 LX_INTERRUPT_SAVE_AREA
 
+UINT    status;
+
+
+    /* Default the status to success.  */
+    status =  LX_SUCCESS;
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+    /* Determine if the driver reserved blocks for the checkpoint.  */
+    if (nor_flash -> lx_nor_flash_checkpoint_blocks)
+    {
+
+        /* Yes, write the checkpoint so the next open can skip walking the blocks. The NOR flash
+           is closed in any case.  */
+        status =  _lx_nor_flash_checkpoint_write(nor_flash);
+    }
+#endif
 
     /* Lockout interrupts for NOR flash close.  */
     LX_DISABLE
@@ -123,10 +149,24 @@ LX_INTERRUPT_SAVE_AREA
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Delete the thread safe mutex.  */
-    tx_mutex_delete(&nor_flash -> lx_nor_flash_mutex);
+    LX_LOCK_MUTEX_DELETE(&nor_flash -> lx_nor_flash_mutex);
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Delete the shared read lock.  */
+    LX_LOCK_RWLOCK_DELETE(&nor_flash -> lx_nor_flash_shared_read_lock);
+#else
+
+    /* Delete the shared read mutex and semaphore.  */
+    LX_LOCK_MUTEX_DELETE(&nor_flash -> lx_nor_flash_shared_read_mutex);
+    LX_LOCK_SEMAPHORE_DELETE(&nor_flash -> lx_nor_flash_shared_read_semaphore);
 #endif
-    /* Return success.  */
-    return(LX_SUCCESS);
+#endif
+#endif
+
+    /* Return completion status.  */
+    return(status);
 }
 
 
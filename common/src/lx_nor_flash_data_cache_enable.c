@@ -0,0 +1,165 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_data_cache_enable                     PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function enables or disables the data cache. The data cache    */
+/*    holds whole logical sectors in RAM, so sectors that were recently   */
+/*    read or written are read without accessing the flash. The memory    */
+/*    is divided into cache entries followed by the sector memory and     */
+/*    must be aligned for pointers. This function must be called after    */
+/*    the NOR flash is opened. Supplying a NULL memory pointer disables   */
+/*    the data cache.                                                     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    memory                                Address of RAM for cache      */
+/*    size                                  Size of the RAM for cache     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_data_cache_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size)
+{
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+ULONG                           i;
+ULONG                           cache_entries;
+ULONG                           cache_sets;
+ULONG                           *cache_memory;
+LX_NOR_FLASH_DATA_CACHE_ENTRY   *cache_entry;
+
+
+    /* Calculate the number of sectors that fit in the memory. Each sector needs its cache entry and its 
+       sector memory.  */
+    cache_entries =  (ULONG) (size / ((nor_flash -> lx_nor_flash_words_per_sector * sizeof(ULONG)) + sizeof(LX_NOR_FLASH_DATA_CACHE_ENTRY)));
+
+    /* Determine if memory was specified but not enough for one set.  */
+    if ((memory) && (cache_entries < LX_NOR_DATA_CACHE_WAYS))
+    {
+
+        /* Error in memory size supplied.  */
+        return(LX_ERROR);
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Disable the data cache while it is being setup.  */
+    nor_flash -> lx_nor_flash_data_cache =  LX_NULL;
+    nor_flash -> lx_nor_flash_data_cache_set_mask =  0;
+
+    /* Determine if the data cache is being enabled.  */
+    if (memory)
+    {
+
+        /* Yes, the number of sets is the largest power of 2 that fits in the memory.  */
+        cache_sets =  1;
+        while ((cache_sets * 2 * LX_NOR_DATA_CACHE_WAYS) <= cache_entries)
+        {
+            cache_sets =  cache_sets * 2;
+        }
+        cache_entries =  cache_sets * LX_NOR_DATA_CACHE_WAYS;
+
+        /* Setup the cache entries, followed by the sector memory.  */
+        cache_entry =   (LX_NOR_FLASH_DATA_CACHE_ENTRY *) memory;
+        cache_memory =  (ULONG *) &cache_entry[cache_entries];
+        for (i = 0; i < cache_entries; i++)
+        {
+
+            /* Setup this cache entry.  */
+            cache_entry[i].lx_nor_flash_data_cache_entry_logical_sector =  0;
+            cache_entry[i].lx_nor_flash_data_cache_entry_sector_memory =   cache_memory;
+
+            /* Move the cache memory forward.  */
+            cache_memory =  cache_memory + nor_flash -> lx_nor_flash_words_per_sector;
+        }
+
+        /* Enable the data cache.  */
+        nor_flash -> lx_nor_flash_data_cache_set_mask =  cache_sets - 1;
+        nor_flash -> lx_nor_flash_data_cache =  cache_entry;
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return successful completion.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(memory);
+    LX_PARAMETER_NOT_USED(size);
+
+    /* Return disabled error message.  */
+    return(LX_DISABLED);
+#endif
+}
+
@@ -0,0 +1,127 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_data_cache_invalidate                 PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function removes the logical sector from the data cache. The   */
+/*    way is moved to the back of its set so it is the next one replaced. */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Logical sector number         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_data_cache_invalidate(LX_NOR_FLASH *nor_flash, ULONG logical_sector)
+{
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+ULONG                           i;
+ULONG                           *sector_memory;
+LX_NOR_FLASH_DATA_CACHE_ENTRY   *cache_entry;
+
+
+    /* Determine if the data cache is enabled.  */
+    if (nor_flash -> lx_nor_flash_data_cache == LX_NULL)
+    {
+
+        /* No, nothing to do.  */
+        return;
+    }
+
+    /* Count the invalidation, so a shared read that started before it doesn't place old data in the cache.  */
+    nor_flash -> lx_nor_flash_data_cache_invalidations++;
+
+    /* Pickup the first entry of the set for this sector.  */
+    cache_entry =  &nor_flash -> lx_nor_flash_data_cache[(logical_sector & nor_flash -> lx_nor_flash_data_cache_set_mask) * LX_NOR_DATA_CACHE_WAYS];
+
+    /* Search the set for the sector.  */
+    for (i = 0; i < LX_NOR_DATA_CACHE_WAYS; i++)
+    {
+
+        /* Is the sector in this way?  */
+        if (cache_entry[i].lx_nor_flash_data_cache_entry_logical_sector == (logical_sector | LX_NOR_DATA_CACHE_ENTRY_VALID))
+        {
+
+            /* Yes, move the ways behind it forward by one.  */
+            sector_memory =  cache_entry[i].lx_nor_flash_data_cache_entry_sector_memory;
+            while ((i + 1) < LX_NOR_DATA_CACHE_WAYS)
+            {
+                cache_entry[i] =  cache_entry[i + 1];
+                i++;
+            }
+
+            /* Place the unused way at the back of the set.  */
+            cache_entry[i].lx_nor_flash_data_cache_entry_logical_sector =  0;
+            cache_entry[i].lx_nor_flash_data_cache_entry_sector_memory =   sector_memory;
+            break;
+        }
+    }
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(logical_sector);
+#endif
+}
+
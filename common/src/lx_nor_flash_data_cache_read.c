@@ -0,0 +1,155 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_data_cache_read                       PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function copies the logical sector from the data cache, if it  */
+/*    is there. The entry found is moved to the front of its set, so the  */
+/*    last way of a set is always the least recently used.                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Logical sector number         */
+/*    buffer                                Pointer to buffer to read into*/
+/*                                            (the size is number of      */
+/*                                             bytes in a sector)         */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_data_cache_read(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer)
+{
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+ULONG                           i;
+ULONG                           j;
+ULONG                           tag;
+ULONG                           *source;
+ULONG                           *destination;
+LX_NOR_FLASH_DATA_CACHE_ENTRY   *cache_entry;
+
+
+    /* Determine if the data cache is enabled.  */
+    if (nor_flash -> lx_nor_flash_data_cache == LX_NULL)
+    {
+
+        /* No, the sector is not cached.  */
+        return(LX_SECTOR_NOT_FOUND);
+    }
+
+    /* Pickup the first entry of the set for this sector.  */
+    cache_entry =  &nor_flash -> lx_nor_flash_data_cache[(logical_sector & nor_flash -> lx_nor_flash_data_cache_set_mask) * LX_NOR_DATA_CACHE_WAYS];
+
+    /* Search the set for the sector.  */
+    tag =  logical_sector | LX_NOR_DATA_CACHE_ENTRY_VALID;
+    for (i = 0; i < LX_NOR_DATA_CACHE_WAYS; i++)
+    {
+
+        /* Is the sector in this way?  */
+        if (cache_entry[i].lx_nor_flash_data_cache_entry_logical_sector == tag)
+        {
+
+            /* Yes, copy the sector from the cache.  */
+            source =       cache_entry[i].lx_nor_flash_data_cache_entry_sector_memory;
+            destination =  (ULONG *) buffer;
+            for (j = 0; j < nor_flash -> lx_nor_flash_words_per_sector; j++)
+            {
+                destination[j] =  source[j];
+            }
+
+            /* Move this way to the front of the set.  */
+            while (i)
+            {
+                cache_entry[i] =  cache_entry[i - 1];
+                i--;
+            }
+            cache_entry[0].lx_nor_flash_data_cache_entry_logical_sector =  tag;
+            cache_entry[0].lx_nor_flash_data_cache_entry_sector_memory =   source;
+
+            /* Increment the number of data cache hits.  */
+            nor_flash -> lx_nor_flash_data_cache_hits++;
+
+            /* Return success.  */
+            return(LX_SUCCESS);
+        }
+    }
+
+    /* Increment the number of data cache misses.  */
+    nor_flash -> lx_nor_flash_data_cache_misses++;
+
+    /* Trace the cache miss.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_CACHE_MISS, LX_TRACE_CACHE_DATA, logical_sector);
+
+    /* The sector is not cached.  */
+    return(LX_SECTOR_NOT_FOUND);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(logical_sector);
+    LX_PARAMETER_NOT_USED(buffer);
+
+    /* The data cache is disabled.  */
+    return(LX_SECTOR_NOT_FOUND);
+#endif
+}
+
@@ -0,0 +1,148 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_data_cache_write                      PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function places a copy of the logical sector in the data       */
+/*    cache. If the sector is not already cached, an unused way or the    */
+/*    least recently used way of its set is replaced. A written sector is */
+/*    moved to the front of the set. A sector filled by a read stays in   */
+/*    its way until it is read again, so sectors that are only read once, */
+/*    such as a file being streamed, cannot push the repeatedly used      */
+/*    sectors out.                                                        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Logical sector number         */
+/*    buffer                                Pointer to the sector data    */
+/*    sector_written                        LX_TRUE if the sector was     */
+/*                                            written, LX_FALSE if read   */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_data_cache_write(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer, UINT sector_written)
+{
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+ULONG                           i;
+ULONG                           j;
+ULONG                           tag;
+ULONG                           *source;
+ULONG                           *destination;
+LX_NOR_FLASH_DATA_CACHE_ENTRY   *cache_entry;
+
+
+    /* Determine if the data cache is enabled.  */
+    if (nor_flash -> lx_nor_flash_data_cache == LX_NULL)
+    {
+
+        /* No, nothing to do.  */
+        return;
+    }
+
+    /* Pickup the first entry of the set for this sector.  */
+    cache_entry =  &nor_flash -> lx_nor_flash_data_cache[(logical_sector & nor_flash -> lx_nor_flash_data_cache_set_mask) * LX_NOR_DATA_CACHE_WAYS];
+
+    /* Search the set for the sector or the first unused way, defaulting to the least recently used way. The 
+       used ways are always at the front of the set.  */
+    tag =  logical_sector | LX_NOR_DATA_CACHE_ENTRY_VALID;
+    i =    0;
+    while (((i + 1) < LX_NOR_DATA_CACHE_WAYS) && (cache_entry[i].lx_nor_flash_data_cache_entry_logical_sector != tag) &&
+           (cache_entry[i].lx_nor_flash_data_cache_entry_logical_sector != 0))
+    {
+        i++;
+    }
+
+    /* Pickup the sector memory of the way to replace.  */
+    destination =  cache_entry[i].lx_nor_flash_data_cache_entry_sector_memory;
+
+    /* Determine if the sector was written.  */
+    if (sector_written)
+    {
+
+        /* Yes, move the ways in front of it back by one to place the sector at the front of the set.  */
+        while (i)
+        {
+            cache_entry[i] =  cache_entry[i - 1];
+            i--;
+        }
+    }
+
+    /* Copy the sector into the cache.  */
+    source =  (ULONG *) buffer;
+    for (j = 0; j < nor_flash -> lx_nor_flash_words_per_sector; j++)
+    {
+        destination[j] =  source[j];
+    }
+    cache_entry[i].lx_nor_flash_data_cache_entry_logical_sector =  tag;
+    cache_entry[i].lx_nor_flash_data_cache_entry_sector_memory =   destination;
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(logical_sector);
+    LX_PARAMETER_NOT_USED(buffer);
+    LX_PARAMETER_NOT_USED(sector_written);
+#endif
+}
+
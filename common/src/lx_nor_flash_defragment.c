@@ -59,8 +59,8 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_block_reclaim           Reclaim a NOR flash block     */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -76,20 +76,36 @@
 /*                                            resulting in version 6.1    */
 /*  06-02-2021     Bhupendra Naphade        Modified comment(s),          */
 /*                                            resulting in version 6.1.7  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_defragment(LX_NOR_FLASH *nor_flash)
 {
   
 ULONG    i;
+#ifdef LX_NOR_ENABLE_STATS
+ULONG    start_time;
+#endif
+
 
+#ifdef LX_NOR_ENABLE_STATS
 
+    /* Remember when this defragment started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Obtain the thread safe mutex.  */
-    tx_mutex_get(&nor_flash -> lx_nor_flash_mutex, TX_WAIT_FOREVER);
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
+    /* Trace the start of the defragment.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_ENTRY, LX_STATS_DEFRAGMENT, 0);
+
     /* Loop for max number of blocks, while there are obsolete count.  */
     for (i = 0; i < nor_flash -> lx_nor_flash_total_blocks; i++)
     {
@@ -102,10 +118,18 @@ ULONG    i;
         _lx_nor_flash_block_reclaim(nor_flash);
     }
 
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Record the latency of this defragment.  */
+    _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_DEFRAGMENT, start_time);
+#endif
+
+    /* Trace the end of the defragment.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_DEFRAGMENT, LX_SUCCESS);
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Release the thread safe mutex.  */
-    tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
     /* Return successful completion.  */    
@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_driver_block_erase                    PORTABLE C      */ 
-/*                                                           6.2.1       */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -61,6 +61,12 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    (lx_nor_flash_driver_block_erase)     Actual driver block erase     */ 
+/*    _lx_nor_flash_checkpoint_invalidate   Invalidate mount checkpoint   */
+/*    _lx_nor_flash_extended_cache_entry_assign                           */
+/*                                          Assign cache entry            */
+/*    _lx_nor_flash_extended_cache_entry_find                             */
+/*                                          Find cached sector            */
+/*    _lx_nor_flash_shared_read_wait        Wait for shared reads         */
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -78,6 +84,14 @@
 /*  03-08-2023     Xiuwen Cai               Modified comment(s),          */
 /*                                            added new driver interface, */
 /*                                            resulting in version 6.2.1 */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added runtime sector size,  */
+/*                                            added hashed extended cache,*/
+/*                                            added mount checkpoint,     */
+/*                                            added shared reads,         */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count)
@@ -87,44 +101,72 @@ UINT    status;
 
 #ifndef LX_NOR_DISABLE_EXTENDED_CACHE
 
-UINT    i;
-ULONG   *block_start_address;
+ULONG   *sector_address;
 ULONG   *block_end_address;
-ULONG   *cache_entry_start;
-ULONG   *cache_entry_end;
+LX_NOR_FLASH_EXTENDED_CACHE_ENTRY
+        *cache_entry;
 
 
-    /* Calculate the block starting address.  */
-    block_start_address =  nor_flash -> lx_nor_flash_base_address + (block * nor_flash -> lx_nor_flash_words_per_block);
-    block_end_address =    block_start_address + nor_flash -> lx_nor_flash_words_per_block;
-    
-    /* Loop through the cache entries to see if there is a sector in cache.  */
-    for (i = 0; i < nor_flash -> lx_nor_flash_extended_cache_entries; i++)
+    /* Determine if the extended cache is enabled.  */
+    if (nor_flash -> lx_nor_flash_extended_cache_entries)
     {
-        
-        /* Search through the cache to see if this cache entry needs to be invalidated.  */
-                
-        /* Determine the cache entry addresses.  */
-        cache_entry_start =  nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_address;
-        cache_entry_end =    cache_entry_start + LX_NOR_SECTOR_SIZE;
-                
-        /* Determine if the flash address in in the cache entry.  */
-        if ((cache_entry_start) && (block_start_address <= cache_entry_start) && (block_end_address > cache_entry_end))
+
+        /* Calculate the block starting and ending addresses.  */
+        sector_address =     nor_flash -> lx_nor_flash_base_address + (block * nor_flash -> lx_nor_flash_words_per_block);
+        block_end_address =  sector_address + nor_flash -> lx_nor_flash_words_per_block;
+
+        /* Loop through the sectors of the block to see if they are in the cache.  */
+        while (sector_address < block_end_address)
         {
+
+            /* Search the hash chain of this sector.  */
+            cache_entry =  _lx_nor_flash_extended_cache_entry_find(nor_flash, sector_address);
+            if (cache_entry)
+            {
     
-            /* Yes, this cache entry is in the block to be erased so invalidate it.  */
-            nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_address =  LX_NULL;
-            nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_access_count =    0;
+                /* Yes, this cache entry is in the block to be erased so invalidate it.  */
+                _lx_nor_flash_extended_cache_entry_assign(nor_flash, cache_entry, LX_NULL);
+                cache_entry -> lx_nor_flash_extended_cache_entry_access_count =  0;
+            }
+
+            /* Move to the next sector.  */
+            sector_address =  sector_address + nor_flash -> lx_nor_flash_words_per_sector;
         }
     }
 #endif
 
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+    /* The flash is about to change, so the checkpoint no longer matches it.  */
+    status =  _lx_nor_flash_checkpoint_invalidate(nor_flash);
+    if (status)
+    {
+
+        /* Return the error.  */
+        return(status);
+    }
+#endif
+
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+    /* Wait for shared reads, they may be reading sector data of this block.  */
+    _lx_nor_flash_shared_read_wait(nor_flash);
+#endif
+
     /* Call the actual driver block erase function.  */
 #ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
     status =  (nor_flash -> lx_nor_flash_driver_block_erase)(nor_flash, block, erase_count);
 #else
     status =  (nor_flash -> lx_nor_flash_driver_block_erase)(block, erase_count);
 #endif
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Count the driver block erase.  */
+    nor_flash -> lx_nor_flash_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_BLOCK_ERASE]++;
+#endif
+
+    /* Trace the block erase.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_BLOCK_ERASE, block, erase_count);
 
     /* Return completion status.  */
     return(status);   
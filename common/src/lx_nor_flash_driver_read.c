@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_extended_cache_read                  PORTABLE C       */ 
-/*                                                           6.2.1       */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -62,6 +62,10 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    (lx_nor_flash_driver_read)            Actual driver read            */ 
+/*    _lx_nor_flash_extended_cache_entry_assign                           */
+/*                                          Assign cache entry            */
+/*    _lx_nor_flash_extended_cache_entry_find                             */
+/*                                          Find cached sector            */
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -79,6 +83,11 @@
 /*  03-08-2023     Xiuwen Cai               Modified comment(s),          */
 /*                                            added new driver interface, */
 /*                                            resulting in version 6.2.1 */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added runtime sector size,  */
+/*                                            added hashed extended cache,*/
+/*                                            added statistics,           */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words)
@@ -86,11 +95,10 @@ UINT  _lx_nor_flash_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, U
 #ifndef LX_NOR_DISABLE_EXTENDED_CACHE
 
 UINT    status;
-UINT    i;
 ULONG   *cache_entry_start;
-ULONG   *cache_entry_end;
 ULONG   cache_offset;
-UINT    least_used_cache_entry;
+LX_NOR_FLASH_EXTENDED_CACHE_ENTRY
+        *cache_entry;
 
 
     /* Is the request a whole sector or a partial sector.  */
@@ -98,78 +106,61 @@ UINT    least_used_cache_entry;
     {
 
         /* One word request, which implies that it is a NOR flash metadata read.  */
-            
-            
-        /* Initialize the least used cache entry.  */
-        least_used_cache_entry =  0;
-            
-        do
-        {    
 
-            /* Loop through the cache entries to see if there is a sector in cache.  */
-            for (i = 0; i < nor_flash -> lx_nor_flash_extended_cache_entries; i++)
+        /* Search the hash chain of the sector to see if it is in the cache.  */
+        cache_entry =  _lx_nor_flash_extended_cache_entry_find(nor_flash, flash_address);
+        if (cache_entry == LX_NULL)
+        {
+
+            /* No, pick the entry to replace. The clock hand skips entries that have been accessed since 
+               its last pass, halving their access count so that entries that are no longer used age out.  */
+            do
             {
-        
-                /* Search through the cache to find the entry.  */
-                
-                /* Determine the cache entry addresses.  */
-                cache_entry_start =  nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_address;
-                cache_entry_end =    cache_entry_start + LX_NOR_SECTOR_SIZE;
-                
-                /* Determine if the flash address in in the cache entry.  */
-                if ((cache_entry_start) && (flash_address >= cache_entry_start) && (flash_address < cache_entry_end))
+
+                /* Pickup the entry under the clock hand and advance the hand.  */
+                cache_entry =  &nor_flash -> lx_nor_flash_extended_cache[nor_flash -> lx_nor_flash_extended_cache_clock_hand];
+                nor_flash -> lx_nor_flash_extended_cache_clock_hand++;
+                if (nor_flash -> lx_nor_flash_extended_cache_clock_hand >= nor_flash -> lx_nor_flash_extended_cache_entries)
                 {
-                
-                    /* Yes, we found the entry.  */
-                    
-                    /* Increment the accessed count.  */
-                    nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_access_count++;
-                    
-                    /* Calculate the offset into the cache entry.  */
-                    cache_offset =  (ULONG)(flash_address - cache_entry_start);
-                    
-                    /* Copy the word from the cache.  */
-                    *destination =  *(nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_memory + cache_offset);
-                    
-                    /* Increment the number of cache hits.  */
-                    nor_flash -> lx_nor_flash_extended_cache_hits++;
-                    
-                    /* Return success.  */
-                    return(LX_SUCCESS);                    
+                    nor_flash -> lx_nor_flash_extended_cache_clock_hand =  0;
                 }
-                else
+
+                /* Determine if this entry can be replaced.  */
+                if ((cache_entry -> lx_nor_flash_extended_cache_entry_sector_address == LX_NULL) ||
+                    (cache_entry -> lx_nor_flash_extended_cache_entry_access_count == 0))
                 {
-                    
-                    /* Determine if we have a new least used sector.  */
-                    if (i != least_used_cache_entry)
-                    {
-                    
-                        /* Determine if this entry has a smaller accessed count.  */
-                        if (nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_access_count <
-                            nor_flash -> lx_nor_flash_extended_cache[least_used_cache_entry].lx_nor_flash_extended_cache_entry_access_count)
-                        {
-                        
-                            /* New least used entry.  */
-                            least_used_cache_entry =  i;
-                        }
-                    }
+
+                    /* Yes, get out of the loop.  */
+                    break;
                 }
-            }
+
+                /* Age this entry.  */
+                cache_entry -> lx_nor_flash_extended_cache_entry_access_count =  cache_entry -> lx_nor_flash_extended_cache_entry_access_count >> 1;
+
+            } while (LX_TRUE);
+
+            /* Invalidate the entry before its sector memory is overwritten.  */
+            _lx_nor_flash_extended_cache_entry_assign(nor_flash, cache_entry, LX_NULL);
 
             /* Now read in the sector into the cache.  */
             cache_offset =  (ULONG)(flash_address - nor_flash -> lx_nor_flash_base_address);
-            cache_offset =  cache_offset & ~((ULONG) (LX_NOR_SECTOR_SIZE-1));
+            cache_offset =  cache_offset & ~((ULONG) (nor_flash -> lx_nor_flash_words_per_sector - 1));
             cache_entry_start =  nor_flash -> lx_nor_flash_base_address + cache_offset;
             
             /* Call the actual driver read function.  */
 #ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
             status =  (nor_flash -> lx_nor_flash_driver_read)(nor_flash, cache_entry_start, 
-                            nor_flash -> lx_nor_flash_extended_cache[least_used_cache_entry].lx_nor_flash_extended_cache_entry_sector_memory, 
-                            LX_NOR_SECTOR_SIZE);
+                            cache_entry -> lx_nor_flash_extended_cache_entry_sector_memory, 
+                            nor_flash -> lx_nor_flash_words_per_sector);
 #else
             status =  (nor_flash -> lx_nor_flash_driver_read)(cache_entry_start, 
-                            nor_flash -> lx_nor_flash_extended_cache[least_used_cache_entry].lx_nor_flash_extended_cache_entry_sector_memory, 
-                            LX_NOR_SECTOR_SIZE);
+                            cache_entry -> lx_nor_flash_extended_cache_entry_sector_memory, 
+                            nor_flash -> lx_nor_flash_words_per_sector);
+#endif
+#ifdef LX_NOR_ENABLE_STATS
+
+            /* Count the driver read.  */
+            nor_flash -> lx_nor_flash_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_READ]++;
 #endif
 
             /* Determine if there was an error.  */
@@ -181,17 +172,33 @@ UINT    least_used_cache_entry;
             }
             
             /* Setup the cache entry.  */
-            nor_flash -> lx_nor_flash_extended_cache[least_used_cache_entry].lx_nor_flash_extended_cache_entry_sector_address =  cache_entry_start;
-            nor_flash -> lx_nor_flash_extended_cache[least_used_cache_entry].lx_nor_flash_extended_cache_entry_access_count =    0;
+            _lx_nor_flash_extended_cache_entry_assign(nor_flash, cache_entry, cache_entry_start);
+            cache_entry -> lx_nor_flash_extended_cache_entry_access_count =  0;
             
             /* Increment the number of cache misses.  */
             nor_flash -> lx_nor_flash_extended_cache_misses++;
-            
-            /* Decrement the number of cache hits, so that the increment that will happen next will be cancelled out.  */
-            nor_flash -> lx_nor_flash_extended_cache_hits--;
-            
-        } while (status == LX_SUCCESS);
-        
+        }
+        else
+        {
+
+            /* Yes, we found the entry.  */
+
+            /* Increment the accessed count.  */
+            if (cache_entry -> lx_nor_flash_extended_cache_entry_access_count < LX_NOR_EXTENDED_CACHE_MAX_ACCESS_COUNT)
+            {
+                cache_entry -> lx_nor_flash_extended_cache_entry_access_count++;
+            }
+
+            /* Increment the number of cache hits.  */
+            nor_flash -> lx_nor_flash_extended_cache_hits++;
+        }
+
+        /* Calculate the offset into the cache entry.  */
+        cache_offset =  (ULONG)(flash_address - cache_entry -> lx_nor_flash_extended_cache_entry_sector_address);
+                    
+        /* Copy the word from the cache.  */
+        *destination =  *(cache_entry -> lx_nor_flash_extended_cache_entry_sector_memory + cache_offset);
+
         /* Return success.  */
         return(LX_SUCCESS);
     }
@@ -204,6 +211,11 @@ UINT    least_used_cache_entry;
 #else
         status =  (nor_flash -> lx_nor_flash_driver_read)(flash_address, destination, words);
 #endif
+#ifdef LX_NOR_ENABLE_STATS
+
+        /* Count the driver read.  */
+        nor_flash -> lx_nor_flash_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_READ]++;
+#endif
 
         /* Return completion status.  */
         return(status);   
@@ -218,6 +230,11 @@ UINT    status;
 #else
     status =  (nor_flash -> lx_nor_flash_driver_read)(flash_address, destination, words);
 #endif
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Count the driver read.  */
+    nor_flash -> lx_nor_flash_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_READ]++;
+#endif
 
     /* Return completion status.  */
     return(status);   
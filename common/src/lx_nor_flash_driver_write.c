@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_driver_write                          PORTABLE C      */ 
-/*                                                           6.2.1       */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -62,6 +62,9 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    (lx_nor_flash_driver_write)           Actual driver write           */ 
+/*    _lx_nor_flash_checkpoint_invalidate   Invalidate mount checkpoint   */
+/*    _lx_nor_flash_extended_cache_entry_find                             */
+/*                                          Find cached sector            */
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -79,6 +82,12 @@
 /*  03-08-2023     Xiuwen Cai               Modified comment(s),          */
 /*                                            added new driver interface, */
 /*                                            resulting in version 6.2.1 */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added runtime sector size,  */
+/*                                            added hashed extended cache,*/
+/*                                            added mount checkpoint,     */
+/*                                            added statistics,           */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words)
@@ -87,43 +96,41 @@ UINT  _lx_nor_flash_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address,
 #ifndef LX_NOR_DISABLE_EXTENDED_CACHE
 
 UINT    status;
-UINT    i;
-ULONG   *cache_entry_start;
-ULONG   *cache_entry_end;
 ULONG   cache_offset;
+LX_NOR_FLASH_EXTENDED_CACHE_ENTRY
+        *cache_entry;
 
 
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+    /* The flash is about to change, so the checkpoint no longer matches it.  */
+    status =  _lx_nor_flash_checkpoint_invalidate(nor_flash);
+    if (status)
+    {
+
+        /* Return the error.  */
+        return(status);
+    }
+#endif
+
     /* Is the request a whole sector or a partial sector.  */
     if ((words == 1) && (nor_flash -> lx_nor_flash_extended_cache_entries))
     {
 
         /* One word request, which implies that it is a NOR flash metadata write.  */
 
-        /* Loop through the cache entries to see if there is a sector in cache.  */
-        for (i = 0; i < nor_flash -> lx_nor_flash_extended_cache_entries; i++)
+        /* Search the hash chain of the sector to see if it is in the cache.  */
+        cache_entry =  _lx_nor_flash_extended_cache_entry_find(nor_flash, flash_address);
+        if (cache_entry)
         {
-        
-            /* Search through the cache to see if there is a cache entry.  */
-                
-            /* Determine the cache entry addresses.  */
-            cache_entry_start =  nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_address;
-            cache_entry_end =    cache_entry_start + LX_NOR_SECTOR_SIZE;
-                
-            /* Determine if the flash address in in the cache entry.  */
-            if ((cache_entry_start) && (flash_address >= cache_entry_start) && (flash_address < cache_entry_end))
-            {
                 
-                /* Yes, we found the entry.  */
+            /* Yes, we found the entry.  */
                     
-                /* Calculate the offset into the cache entry.  */
-                cache_offset =  (ULONG)(flash_address - cache_entry_start);
+            /* Calculate the offset into the cache entry.  */
+            cache_offset =  (ULONG)(flash_address - cache_entry -> lx_nor_flash_extended_cache_entry_sector_address);
                     
-                /* Copy the word into the cache.  */
-                *(nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_memory + cache_offset) =  *source;
-                
-                /* Get out of the loop.  */
-                break;
-            }
+            /* Copy the word into the cache.  */
+            *(cache_entry -> lx_nor_flash_extended_cache_entry_sector_memory + cache_offset) =  *source;
         }
     }
     
@@ -133,6 +140,12 @@ ULONG   cache_offset;
 #else
     status =  (nor_flash -> lx_nor_flash_driver_write)(flash_address, source, words);
 #endif
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Count the driver write.  */
+    nor_flash -> lx_nor_flash_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_WRITE]++;
+    nor_flash -> lx_nor_flash_stats.lx_flash_stats_bytes_programmed +=  words * sizeof(ULONG);
+#endif
 
     /* Return completion status.  */
     return(status);   
@@ -141,12 +154,30 @@ ULONG   cache_offset;
 UINT    status;
 
 
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+    /* The flash is about to change, so the checkpoint no longer matches it.  */
+    status =  _lx_nor_flash_checkpoint_invalidate(nor_flash);
+    if (status)
+    {
+
+        /* Return the error.  */
+        return(status);
+    }
+#endif
+
     /* Call the actual driver write function.  */
 #ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
     status =  (nor_flash -> lx_nor_flash_driver_write)(nor_flash, flash_address, source, words);
 #else
     status =  (nor_flash -> lx_nor_flash_driver_write)(flash_address, source, words);
 #endif
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Count the driver write.  */
+    nor_flash -> lx_nor_flash_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_WRITE]++;
+    nor_flash -> lx_nor_flash_stats.lx_flash_stats_bytes_programmed +=  words * sizeof(ULONG);
+#endif
     
     /* Return completion status.  */
     return(status);   
@@ -0,0 +1,266 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_erase_queue_update                    PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the erase queue after the block summary entry */
+/*    of the specified block has changed. The erase queue is a tournament */
+/*    tree with one node for each block, node 1 is the root and the       */
+/*    children of node n are nodes 2n and 2n+1. Children that are not     */
+/*    less than the number of blocks are the blocks themselves. Each node */
+/*    holds the block with the most obsolete sectors, the same among the  */
+/*    blocks within the erase count threshold, and the block with the     */
+/*    smallest erase count together with the number of blocks that have   */
+/*    that erase count. Ties are broken by the smallest erase count and   */
+/*    then the lowest block number, which is the same order the blocks    */
+/*    are examined in without the erase queue. Only the nodes on the path */
+/*    from the block to the root are updated. When the block is           */
+/*    LX_NOR_ERASE_QUEUE_REBUILD, the erase count threshold is            */
+/*    recalculated from the minimum erase count and all nodes rebuilt.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    block                                 Block that changed, or        */
+/*                                            LX_NOR_ERASE_QUEUE_REBUILD  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_erase_queue_update(LX_NOR_FLASH *nor_flash, ULONG block)
+{
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+
+ULONG                           total_blocks;
+ULONG                           node;
+ULONG                           child;
+ULONG                           i;
+ULONG                           best_block;
+ULONG                           candidate_block;
+ULONG                           obsolete_block[2];
+ULONG                           eligible_block[2];
+ULONG                           erase_block[2];
+ULONG                           erase_blocks[2];
+LX_NOR_FLASH_BLOCK_SUMMARY      *block_summary;
+LX_NOR_FLASH_ERASE_QUEUE_NODE   *erase_queue;
+
+
+    /* Determine if the block summary is enabled.  */
+    if (nor_flash -> lx_nor_flash_block_summary_enabled == LX_FALSE)
+    {
+
+        /* No, nothing to do.  */
+        return;
+    }
+
+    /* Setup local pointers to the block summary and the erase queue.  */
+    total_blocks =   nor_flash -> lx_nor_flash_total_blocks;
+    block_summary =  nor_flash -> lx_nor_flash_block_summary;
+    erase_queue =    nor_flash -> lx_nor_flash_erase_queue;
+
+    /* Determine if the whole erase queue needs to be rebuilt.  */
+    if (block == LX_NOR_ERASE_QUEUE_REBUILD)
+    {
+
+        /* Yes, calculate the erase count threshold from the current minimum erase count.  */
+        nor_flash -> lx_nor_flash_erase_queue_erase_count_threshold =  nor_flash -> lx_nor_flash_minimum_erase_count + LX_NOR_FLASH_MAX_ERASE_COUNT_DELTA;
+
+        /* Start with the last node, children are always rebuilt before their parent.  */
+        node =  total_blocks - 1;
+    }
+    else
+    {
+
+        /* Start with the parent of this block.  */
+        node =  (block + total_blocks) >> 1;
+    }
+
+    /* Loop to update the nodes.  */
+    while (node)
+    {
+
+        /* Pickup the winners of both children.  */
+        for (i = 0; i < 2; i++)
+        {
+
+            /* Calculate the child node.  */
+            child =  (node << 1) + i;
+
+            /* Is this child a block?  */
+            if (child >= total_blocks)
+            {
+
+                /* Yes, the block is the only candidate of this child.  */
+                child =  child - total_blocks;
+                obsolete_block[i] =  child;
+                erase_block[i] =     child;
+                erase_blocks[i] =    1;
+
+                /* Determine if the block is within the erase count threshold.  */
+                if (block_summary[child].lx_nor_flash_block_summary_erase_count <= nor_flash -> lx_nor_flash_erase_queue_erase_count_threshold)
+                {
+                    eligible_block[i] =  child;
+                }
+                else
+                {
+                    eligible_block[i] =  LX_NOR_ERASE_QUEUE_NONE;
+                }
+            }
+            else
+            {
+
+                /* Pickup the winners of the child node.  */
+                obsolete_block[i] =  erase_queue[child].lx_nor_flash_erase_queue_node_obsolete_block;
+                eligible_block[i] =  erase_queue[child].lx_nor_flash_erase_queue_node_eligible_block;
+                erase_block[i] =     erase_queue[child].lx_nor_flash_erase_queue_node_erase_block;
+                erase_blocks[i] =    erase_queue[child].lx_nor_flash_erase_queue_node_erase_blocks;
+            }
+        }
+
+        /* Select the block with the most obsolete sectors, first over all blocks and then over the blocks 
+           within the erase count threshold.  */
+        for (i = 0; i < 2; i++)
+        {
+
+            /* Pickup the candidates of the children.  */
+            if (i == 0)
+            {
+                best_block =       obsolete_block[0];
+                candidate_block =  obsolete_block[1];
+            }
+            else
+            {
+                best_block =       eligible_block[0];
+                candidate_block =  eligible_block[1];
+            }
+
+            /* Determine if the second candidate is better.  */
+            if ((best_block == LX_NOR_ERASE_QUEUE_NONE) ||
+                ((candidate_block != LX_NOR_ERASE_QUEUE_NONE) &&
+                 ((block_summary[candidate_block].lx_nor_flash_block_summary_obsolete_sectors > block_summary[best_block].lx_nor_flash_block_summary_obsolete_sectors) ||
+                  ((block_summary[candidate_block].lx_nor_flash_block_summary_obsolete_sectors == block_summary[best_block].lx_nor_flash_block_summary_obsolete_sectors) &&
+                   ((block_summary[candidate_block].lx_nor_flash_block_summary_erase_count < block_summary[best_block].lx_nor_flash_block_summary_erase_count) ||
+                    ((block_summary[candidate_block].lx_nor_flash_block_summary_erase_count == block_summary[best_block].lx_nor_flash_block_summary_erase_count) &&
+                     (candidate_block < best_block)))))))
+            {
+
+                /* Yes, the second candidate is better.  */
+                best_block =  candidate_block;
+            }
+
+            /* Save the winner.  */
+            if (i == 0)
+            {
+                erase_queue[node].lx_nor_flash_erase_queue_node_obsolete_block =  best_block;
+            }
+            else
+            {
+                erase_queue[node].lx_nor_flash_erase_queue_node_eligible_block =  best_block;
+            }
+        }
+
+        /* Select the block with the smallest erase count.  */
+        best_block =       erase_block[0];
+        candidate_block =  erase_block[1];
+        if (block_summary[candidate_block].lx_nor_flash_block_summary_erase_count == block_summary[best_block].lx_nor_flash_block_summary_erase_count)
+        {
+
+            /* Same erase count, keep the lowest block and count the blocks of both children.  */
+            if (candidate_block < best_block)
+            {
+                best_block =  candidate_block;
+            }
+            erase_queue[node].lx_nor_flash_erase_queue_node_erase_block =   best_block;
+            erase_queue[node].lx_nor_flash_erase_queue_node_erase_blocks =  erase_blocks[0] + erase_blocks[1];
+        }
+        else if (block_summary[candidate_block].lx_nor_flash_block_summary_erase_count < block_summary[best_block].lx_nor_flash_block_summary_erase_count)
+        {
+
+            /* The second child has the smaller erase count.  */
+            erase_queue[node].lx_nor_flash_erase_queue_node_erase_block =   candidate_block;
+            erase_queue[node].lx_nor_flash_erase_queue_node_erase_blocks =  erase_blocks[1];
+        }
+        else
+        {
+
+            /* The first child has the smaller erase count.  */
+            erase_queue[node].lx_nor_flash_erase_queue_node_erase_block =   best_block;
+            erase_queue[node].lx_nor_flash_erase_queue_node_erase_blocks =  erase_blocks[0];
+        }
+
+        /* Move to the next node.  */
+        if (block == LX_NOR_ERASE_QUEUE_REBUILD)
+        {
+            node--;
+        }
+        else
+        {
+            node =  node >> 1;
+        }
+    }
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(block);
+#endif
+}
+
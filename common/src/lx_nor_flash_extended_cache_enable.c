@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_extended_cache_enable                 PORTABLE C      */ 
-/*                                                           6.3.0        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -48,6 +48,10 @@
 /*                                                                        */ 
 /*    This function enables or disables the extended cache.               */ 
 /*                                                                        */ 
+/*    After the mapping bitmap and obsolete count caches, the memory is   */ 
+/*    divided into cache entries, a hash table indexed by sector and the  */ 
+/*    sector memory, so the memory must be aligned for pointers.          */ 
+/*                                                                        */ 
 /*  INPUT                                                                 */ 
 /*                                                                        */ 
 /*    nor_flash                             NOR flash instance            */ 
@@ -87,6 +91,13 @@
 /*                                            added mapping bitmap cache, */
 /*                                            added obsolete count cache, */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            fixed out of bound access to*/
+/*                                            the sector cache entries,   */
+/*                                            added runtime sector size,  */
+/*                                            added hashed extended cache,*/
+/*                                            added lock backend support, */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_extended_cache_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size)
@@ -96,6 +107,8 @@ UINT  _lx_nor_flash_extended_cache_enable(LX_NOR_FLASH *nor_flash, VOID *memory,
 UINT    i;
 ULONG   cache_size;
 ULONG   *cache_memory;
+ULONG   cache_entries;
+ULONG   hash_buckets;
 #ifdef LX_NOR_ENABLE_MAPPING_BITMAP
 ULONG   mapping_bitmap_words;
 ULONG   mapping_bitmap_word;
@@ -115,7 +128,7 @@ ULONG   block_word;
 
 
     /* Determine if memory was specified but with an invalid size (less than one NOR sector).  */
-    if ((memory) && (size < LX_NOR_SECTOR_SIZE))
+    if ((memory) && (size < nor_flash -> lx_nor_flash_words_per_sector))
     {
     
         /* Error in memory size supplied.  */
@@ -125,7 +138,7 @@ ULONG   block_word;
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Obtain the thread safe mutex.  */
-    tx_mutex_get(&nor_flash -> lx_nor_flash_mutex, TX_WAIT_FOREVER);
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
     /* Initialize the internal NOR cache.  */
@@ -288,42 +301,81 @@ ULONG   block_word;
     }
 #endif
     
-    /* Loop through the memory supplied and assign to cache entries.  */
-    i =  0;
-    while (cache_size >= LX_NOR_SECTOR_SIZE)
+    /* Align the remaining memory for the pointers in the cache entries.  */
+    while ((cache_size) && (((ULONG) (cache_memory - ((ULONG *) memory))) % (sizeof(VOID *) / sizeof(ULONG))))
     {
-    
-        /* Setup this cache entry.  */
-        nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_address =  LX_NULL;
-        nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_memory =   cache_memory;
-        nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_access_count =    0;
-        
-        /* Move the cache memory forward.   */
-        cache_memory =  cache_memory + LX_NOR_SECTOR_SIZE;
-        
-        /* Decrement the size.  */
-        cache_size =  cache_size - LX_NOR_SECTOR_SIZE;
-    
-        /* Move to next cache entry.  */
-        i++;
+
+        /* Skip this word.  */
+        cache_memory++;
+        cache_size--;
     }
-    
-    /* Save the number of cache entries.  */
-    if(i > LX_NOR_EXTENDED_CACHE_SIZE)
+
+    /* Calculate the number of sectors that fit in the remaining memory. Each sector needs its cache entry, its 
+       sector memory and one hash table slot.  */
+    cache_entries =  (ULONG) ((cache_size * sizeof(ULONG)) / 
+                        ((nor_flash -> lx_nor_flash_words_per_sector * sizeof(ULONG)) + sizeof(LX_NOR_FLASH_EXTENDED_CACHE_ENTRY) + sizeof(LX_NOR_FLASH_EXTENDED_CACHE_ENTRY *)));
+
+    /* There is no point in caching more sectors than the flash has.  */
+    if (cache_entries > ((nor_flash -> lx_nor_flash_words_per_block / nor_flash -> lx_nor_flash_words_per_sector) * nor_flash -> lx_nor_flash_total_blocks))
     {
+        cache_entries =  (nor_flash -> lx_nor_flash_words_per_block / nor_flash -> lx_nor_flash_words_per_sector) * nor_flash -> lx_nor_flash_total_blocks;
+    }
+
+#ifdef LX_NOR_EXTENDED_CACHE_SIZE
 
-        nor_flash -> lx_nor_flash_extended_cache_entries =  LX_NOR_EXTENDED_CACHE_SIZE;
+    /* Limit the number of cache entries to the configured maximum.  */
+    if (cache_entries > LX_NOR_EXTENDED_CACHE_SIZE)
+    {
+        cache_entries =  LX_NOR_EXTENDED_CACHE_SIZE;
     }
-    else
+#endif
+
+    /* Determine if there is room for at least one sector.  */
+    if (cache_entries)
     {
 
-        nor_flash -> lx_nor_flash_extended_cache_entries =  i;
-    }  
+        /* Yes, the hash table size is the largest power of 2 that does not exceed the number of entries.  */
+        hash_buckets =  1;
+        while (((hash_buckets * 2) <= cache_entries) && ((hash_buckets * 2) <= LX_NOR_EXTENDED_CACHE_HASH_MAX_BUCKETS))
+        {
+            hash_buckets =  hash_buckets * 2;
+        }
+
+        /* Setup the cache entries, followed by the hash table and the sector memory.  */
+        nor_flash -> lx_nor_flash_extended_cache =             (LX_NOR_FLASH_EXTENDED_CACHE_ENTRY *) cache_memory;
+        nor_flash -> lx_nor_flash_extended_cache_hash_table =  (LX_NOR_FLASH_EXTENDED_CACHE_ENTRY **) &nor_flash -> lx_nor_flash_extended_cache[cache_entries];
+        nor_flash -> lx_nor_flash_extended_cache_hash_mask =   hash_buckets - 1;
+        nor_flash -> lx_nor_flash_extended_cache_clock_hand =  0;
+        cache_memory =  (ULONG *) &nor_flash -> lx_nor_flash_extended_cache_hash_table[hash_buckets];
+
+        /* Clear the hash table.  */
+        for (i = 0; i < hash_buckets; i++)
+        {
+            nor_flash -> lx_nor_flash_extended_cache_hash_table[i] =  LX_NULL;
+        }
+
+        /* Loop through the cache entries to assign their sector memory.  */
+        for (i = 0; i < cache_entries; i++)
+        {
+    
+            /* Setup this cache entry.  */
+            nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_address =  LX_NULL;
+            nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_sector_memory =   cache_memory;
+            nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_access_count =    0;
+            nor_flash -> lx_nor_flash_extended_cache[i].lx_nor_flash_extended_cache_entry_next =            LX_NULL;
+        
+            /* Move the cache memory forward.   */
+            cache_memory =  cache_memory + nor_flash -> lx_nor_flash_words_per_sector;
+        }
+    }
+    
+    /* Save the number of cache entries.  */
+    nor_flash -> lx_nor_flash_extended_cache_entries =  (UINT) cache_entries;
 
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Release the thread safe mutex.  */
-    tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
     /* Return successful completion.  */
@@ -0,0 +1,130 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_extended_cache_entry_assign           PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function assigns an extended cache entry to a sector. The      */
+/*    entry is removed from the hash chain of its current sector and, if  */
+/*    a sector address is supplied, placed at the head of the hash chain  */
+/*    of the new sector. A NULL sector address invalidates the entry.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    cache_entry                           Extended cache entry          */
+/*    sector_address                        Address of the sector, or     */
+/*                                            LX_NULL                     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_extended_cache_entry_assign(LX_NOR_FLASH *nor_flash, LX_NOR_FLASH_EXTENDED_CACHE_ENTRY *cache_entry, ULONG *sector_address)
+{
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+
+ULONG                               sector_offset;
+LX_NOR_FLASH_EXTENDED_CACHE_ENTRY   **link_ptr;
+
+
+    /* Determine if the entry currently holds a sector.  */
+    if (cache_entry -> lx_nor_flash_extended_cache_entry_sector_address)
+    {
+
+        /* Yes, find the link to this entry in the hash chain of its sector.  */
+        sector_offset =  (ULONG)(cache_entry -> lx_nor_flash_extended_cache_entry_sector_address - nor_flash -> lx_nor_flash_base_address);
+        link_ptr =  &nor_flash -> lx_nor_flash_extended_cache_hash_table[LX_NOR_EXTENDED_CACHE_HASH(sector_offset, nor_flash -> lx_nor_flash_extended_cache_hash_mask)];
+        while ((*link_ptr) && (*link_ptr != cache_entry))
+        {
+
+            /* Move to the next link.  */
+            link_ptr =  &((*link_ptr) -> lx_nor_flash_extended_cache_entry_next);
+        }
+
+        /* Remove the entry from the chain.  */
+        if (*link_ptr)
+        {
+            *link_ptr =  cache_entry -> lx_nor_flash_extended_cache_entry_next;
+        }
+    }
+
+    /* Setup the new sector of the entry.  */
+    cache_entry -> lx_nor_flash_extended_cache_entry_sector_address =  sector_address;
+    cache_entry -> lx_nor_flash_extended_cache_entry_next =            LX_NULL;
+
+    /* Determine if a sector was supplied.  */
+    if (sector_address)
+    {
+
+        /* Yes, place the entry at the head of the hash chain of the new sector.  */
+        sector_offset =  (ULONG)(sector_address - nor_flash -> lx_nor_flash_base_address);
+        link_ptr =  &nor_flash -> lx_nor_flash_extended_cache_hash_table[LX_NOR_EXTENDED_CACHE_HASH(sector_offset, nor_flash -> lx_nor_flash_extended_cache_hash_mask)];
+        cache_entry -> lx_nor_flash_extended_cache_entry_next =  *link_ptr;
+        *link_ptr =  cache_entry;
+    }
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(cache_entry);
+    LX_PARAMETER_NOT_USED(sector_address);
+#endif
+}
+
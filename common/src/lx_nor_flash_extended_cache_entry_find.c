@@ -0,0 +1,127 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_extended_cache_entry_find             PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function finds the extended cache entry holding the sector     */
+/*    that contains the flash address. The hash chain of the sector is    */
+/*    searched, so the cost does not depend on the number of entries.     */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    flash_address                         Address of NOR flash          */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    Cache entry, LX_NULL if the sector is not cached                    */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+LX_NOR_FLASH_EXTENDED_CACHE_ENTRY  *_lx_nor_flash_extended_cache_entry_find(LX_NOR_FLASH *nor_flash, ULONG *flash_address)
+{
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+
+ULONG                               sector_offset;
+ULONG                               *sector_address;
+LX_NOR_FLASH_EXTENDED_CACHE_ENTRY   *cache_entry;
+
+
+    /* Determine if the extended cache is enabled.  */
+    if (nor_flash -> lx_nor_flash_extended_cache_entries == 0)
+    {
+
+        /* No, the sector is not cached.  */
+        return(LX_NULL);
+    }
+
+    /* Calculate the offset and the address of the sector that contains the flash address.  */
+    sector_offset =   (ULONG)(flash_address - nor_flash -> lx_nor_flash_base_address);
+    sector_offset =   sector_offset & ~((ULONG) (nor_flash -> lx_nor_flash_words_per_sector - 1));
+    sector_address =  nor_flash -> lx_nor_flash_base_address + sector_offset;
+
+    /* Walk the hash chain of the sector.  */
+    cache_entry =  nor_flash -> lx_nor_flash_extended_cache_hash_table[LX_NOR_EXTENDED_CACHE_HASH(sector_offset, nor_flash -> lx_nor_flash_extended_cache_hash_mask)];
+    while (cache_entry)
+    {
+
+        /* Is this the entry of the sector?  */
+        if (cache_entry -> lx_nor_flash_extended_cache_entry_sector_address == sector_address)
+        {
+
+            /* Yes, return it.  */
+            return(cache_entry);
+        }
+
+        /* Move to the next entry in the chain.  */
+        cache_entry =  cache_entry -> lx_nor_flash_extended_cache_entry_next;
+    }
+
+    /* The sector is not cached.  */
+    return(LX_NULL);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(flash_address);
+
+    /* The extended cache is disabled.  */
+    return(LX_NULL);
+#endif
+}
+
@@ -0,0 +1,110 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_fill_sector_check                     PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function determines if all the words of the sector data hold   */ 
+/*    the same value, so the sector can be written as a fill sector.      */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    buffer                                Pointer to sector data        */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_overwrite                                      */ 
+/*    _lx_nor_flash_sector_write                                          */ 
+/*    _lx_nor_flash_sectors_write                                         */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_fill_sector_check(LX_NOR_FLASH *nor_flash, VOID *buffer)
+{
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+ULONG   *source_ptr;
+ULONG   i;
+
+
+    /* Loop to compare each word with the first word of the sector.  */
+    source_ptr =  (ULONG *) buffer;
+    for (i = 1; i < nor_flash -> lx_nor_flash_words_per_sector; i++)
+    {
+
+        /* Determine if this word is different.  */
+        if (source_ptr[i] != source_ptr[0])
+        {
+
+            /* Yes, the sector data must be written.  */
+            return(LX_ERROR);
+        }
+    }
+
+    /* Return success, the sector can be written as a fill sector.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(buffer);
+
+    /* Return an error, the sector data must be written.  */
+    return(LX_ERROR);
+#endif
+}
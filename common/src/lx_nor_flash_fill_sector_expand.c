@@ -0,0 +1,147 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_fill_sector_expand                    PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function completes the data of a sector that was just read     */ 
+/*    from its physical sector. If the mapping entry marks a fill sector, */ 
+/*    only the first word was programmed and it is copied over the whole  */ 
+/*    sector buffer.                                                      */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    physical_sector_map_entry             Address of the mapping entry  */ 
+/*    buffer                                Pointer to sector data        */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    (lx_nor_flash_driver_read)            Actual driver read            */ 
+/*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_compare                                        */ 
+/*    _lx_nor_flash_sector_read                                           */ 
+/*    _lx_nor_flash_sectors_read                                          */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_fill_sector_expand(LX_NOR_FLASH *nor_flash, ULONG *physical_sector_map_entry, VOID *buffer)
+{
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+ULONG   mapping_entry;
+ULONG   *destination_ptr;
+ULONG   i;
+#ifndef LX_DIRECT_READ
+UINT    status;
+#endif
+
+
+    /* Read the mapping entry of the sector.  */
+#ifdef LX_DIRECT_READ
+
+    /* Read the word directly.  */
+    mapping_entry =  *(physical_sector_map_entry);
+#else
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+    /* Call the actual driver read function. The extended cache can't be used, since this may be 
+       called during a shared read without the NOR flash mutex.  */
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    status =  (nor_flash -> lx_nor_flash_driver_read)(nor_flash, physical_sector_map_entry, &mapping_entry, 1);
+#else
+    status =  (nor_flash -> lx_nor_flash_driver_read)(physical_sector_map_entry, &mapping_entry, 1);
+#endif
+#else
+    status =  _lx_nor_flash_driver_read(nor_flash, physical_sector_map_entry, &mapping_entry, 1);
+#endif
+
+    /* Check for an error from flash driver. Drivers should never return an error..  */
+    if (status)
+    {
+
+        /* Return the error.  */
+        return(status);
+    }
+#endif
+
+    /* Determine if this is a fill sector.  */
+    if (mapping_entry & LX_NOR_PHYSICAL_SECTOR_FILL)
+    {
+
+        /* Yes, copy the first word over the whole sector.  */
+        destination_ptr =  (ULONG *) buffer;
+        for (i = 1; i < nor_flash -> lx_nor_flash_words_per_sector; i++)
+        {
+
+            /* Copy the fill word.  */
+            destination_ptr[i] =  destination_ptr[0];
+        }
+    }
+
+    /* Return success.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(physical_sector_map_entry);
+    LX_PARAMETER_NOT_USED(buffer);
+
+    /* Return success, there are no fill sectors.  */
+    return(LX_SUCCESS);
+#endif
+}
@@ -0,0 +1,137 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_free_sectors_reclaim                  PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function makes sure the specified number of sectors can be     */ 
+/*    written without the free sectors dropping below the low watermark.  */ 
+/*    If they would, blocks are reclaimed until the low watermark is      */
+/*    reached after the write. Once a block's worth of sectors is free    */
+/*    for the reclaim, blocks are only reclaimed while they have obsolete */
+/*    sectors, and no more than LX_NOR_FLASH_FOREGROUND_RECLAIM_BLOCKS    */
+/*    per call. The gap to the high watermark is left to                  */
+/*    lx_nor_flash_gc_step.                                               */
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    sectors                               Number of sectors to write    */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_block_reclaim           Reclaim one flash block       */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Internal LevelX                                                     */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_free_sectors_reclaim(LX_NOR_FLASH *nor_flash, ULONG sectors)
+{
+
+ULONG   i;
+UINT    status;
+
+
+    /* Determine if the write would leave fewer free sectors than the low watermark.  */
+    if (nor_flash -> lx_nor_flash_free_physical_sectors >= (nor_flash -> lx_nor_flash_free_sectors_low_watermark + sectors))
+    {
+
+        /* No, there is nothing to do.  */
+        return;
+    }
+
+    /* Loop to reclaim blocks until the low watermark is reached.  */
+    i =  0;
+    while (nor_flash -> lx_nor_flash_free_physical_sectors < (nor_flash -> lx_nor_flash_free_sectors_low_watermark + sectors))
+    {
+
+        /* Once the sectors needed to reclaim a block are free, bound the work done in the foreground and only
+           reclaim blocks while there are obsolete sectors to free.  */
+        if ((nor_flash -> lx_nor_flash_free_physical_sectors >= (nor_flash -> lx_nor_flash_physical_sectors_per_block + sectors)) &&
+            ((i >= LX_NOR_FLASH_FOREGROUND_RECLAIM_BLOCKS) || (nor_flash -> lx_nor_flash_obsolete_physical_sectors == 0)))
+        {
+
+            /* Leave the rest to the following writes and to lx_nor_flash_gc_step.  */
+            break;
+        }
+
+        /* Attempt to reclaim one physical block.  */
+        status =  _lx_nor_flash_block_reclaim(nor_flash);
+
+        /* Determine if the block could not be reclaimed. The next attempt would select the same block.  */
+        if (status)
+        {
+
+            /* Yes, break out of the loop.  */
+            break;
+        }
+
+        /* Increment the number of blocks reclaimed in the foreground.  */
+        nor_flash -> lx_nor_flash_foreground_reclaims++;
+
+        /* Increment the block count.  */
+        i++;
+
+        /* Have we exceeded the number of blocks in the system?  */
+        if (i >= nor_flash -> lx_nor_flash_total_blocks)
+        { 
+          
+            /* Yes, break out of the loop.  */
+            break;
+        }
+    }
+}
@@ -0,0 +1,156 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_gc_step                               PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function performs garbage collection of the NOR flash for up   */ 
+/*    to the specified number of driver operations. It is intended to be */
+/*    called from an idle thread, so free sectors are reclaimed before    */
+/*    the sector write needs to erase a block. Blocks are reclaimed       */
+/*    while there are obsolete sectors and no more free sectors than the  */
+/*    high watermark. The reclaim of a block resumes where the previous   */
+/*    call left off. The budget is checked before each reclaim step, so   */
+/*    the last step can exceed it by up to two driver operations.         */
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    budget                                Maximum number of driver      */ 
+/*                                            operations                  */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    LX_SUCCESS                            Budget used, more garbage     */ 
+/*                                            collection may be needed    */ 
+/*    LX_NO_BLOCKS                          No block needs to be          */ 
+/*                                            reclaimed                   */ 
+/*    LX_NO_SECTORS                         Not enough free sectors to    */ 
+/*                                            reclaim the next block      */ 
+/*    return status                         Other error                   */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_block_reclaim_step      Perform one reclaim step      */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application Code                                                    */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_gc_step(LX_NOR_FLASH *nor_flash, ULONG budget)
+{
+
+ULONG   operations;
+UINT    status;
+
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Other requests may have run since the last reclaim step.  */
+    nor_flash -> lx_nor_flash_gc_resumed =  LX_TRUE;
+
+    /* Default the status to success.  */
+    status =  LX_SUCCESS;
+
+    /* Loop until the budget is used.  */
+    while (budget)
+    {
+
+        /* Determine if a new block would have to be selected.  */
+        if (nor_flash -> lx_nor_flash_gc_state == LX_NOR_GC_STATE_IDLE)
+        {
+
+            /* Determine if there is any garbage to collect and if more free sectors are needed.  */
+            if ((nor_flash -> lx_nor_flash_obsolete_physical_sectors == 0) ||
+                (nor_flash -> lx_nor_flash_free_physical_sectors > nor_flash -> lx_nor_flash_free_sectors_high_watermark))
+            {
+
+                /* No, there is nothing to do.  */
+                status =  LX_NO_BLOCKS;
+                break;
+            }
+        }
+
+        /* Perform the next reclaim step.  */
+        status =  _lx_nor_flash_block_reclaim_step(nor_flash, &operations);
+
+        /* Check for an error.  */
+        if (status)
+            break;
+
+        /* Update the number of garbage collection operations.  */
+        nor_flash -> lx_nor_flash_gc_operations =  nor_flash -> lx_nor_flash_gc_operations + operations;
+
+        /* Take the operations of this step from the budget.  */
+        if (operations >= budget)
+            budget =  0;
+        else
+            budget =  budget - operations;
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return the completion status.  */
+    return(status);
+}
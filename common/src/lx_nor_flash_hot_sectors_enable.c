@@ -0,0 +1,143 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_hot_sectors_enable                    PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function enables or disables the hot sector table. The table   */
+/*    holds the most recently written logical sectors, one per ULONG of   */
+/*    the memory. A sector written again while it is in the table is      */
+/*    written to the hot write stream. This function can be called from   */
+/*    the driver initialization or after the NOR flash is opened.         */
+/*    Supplying a NULL memory pointer disables the hot sector table.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    memory                                Address of RAM for the table  */
+/*    size                                  Size of the RAM for the table */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_hot_sectors_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size)
+{
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+ULONG   i;
+ULONG   entries;
+
+
+    /* Calculate the number of logical sectors that fit in the memory.  */
+    entries =  (ULONG) (size / sizeof(ULONG));
+
+    /* Determine if memory was specified but not enough for one sector.  */
+    if ((memory) && (entries == 0))
+    {
+
+        /* Error in memory size supplied.  */
+        return(LX_ERROR);
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Disable the hot sector table while it is being setup.  */
+    nor_flash -> lx_nor_flash_hot_sector_entries =  0;
+    nor_flash -> lx_nor_flash_hot_sector_next =     0;
+    nor_flash -> lx_nor_flash_hot_sectors =         (ULONG *) memory;
+
+    /* Determine if the hot sector table is being enabled.  */
+    if (memory)
+    {
+
+        /* Yes, no logical sector was written recently.  */
+        for (i = 0; i < entries; i++)
+        {
+            nor_flash -> lx_nor_flash_hot_sectors[i] =  LX_NOR_LOGICAL_SECTOR_MASK;
+        }
+
+        /* Enable the hot sector table.  */
+        nor_flash -> lx_nor_flash_hot_sector_entries =  entries;
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return successful completion.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(memory);
+    LX_PARAMETER_NOT_USED(size);
+
+    /* Return disabled error message.  */
+    return(LX_DISABLED);
+#endif
+}
@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_logical_sector_find                   PORTABLE C      */ 
-/*                                                           6.3.0        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -70,6 +70,10 @@
 /*                                                                        */ 
 /*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
 /*    _lx_nor_flash_driver_write            Driver flash sector write     */ 
+/*    _lx_nor_flash_sector_mapping_cache_find                             */
+/*                                          Find sector in mapping cache  */
+/*    _lx_nor_flash_sector_mapping_cache_insert                           */
+/*                                          Place sector in mapping cache */
 /*    _lx_nor_flash_system_error            Internal system error handler */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
@@ -91,6 +95,12 @@
 /*                                            optimized full obsoleted    */
 /*                                            block searching logic,      */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added logical sector index, */
+/*                                            added runtime sector size,  */
+/*                                            used sector mapping cache   */
+/*                                            functions,                  */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_logical_sector_find(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG superceded_check, ULONG **physical_sector_map_entry, ULONG **physical_sector_address)
@@ -106,13 +116,14 @@ ULONG                               total_blocks;
 ULONG                               total_sectors;
 ULONG                               i, j;
 ULONG                               search_start;
-LX_NOR_SECTOR_MAPPING_CACHE_ENTRY   *sector_mapping_cache_entry_ptr = LX_NULL;
-LX_NOR_SECTOR_MAPPING_CACHE_ENTRY   temp_sector_mapping_cache_entry;
 #ifndef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
 ULONG                               valid_sector_found;
 #endif
 #if !defined(LX_DIRECT_READ)  || !defined(LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE)
 UINT                                status;
+#endif
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+ULONG                               physical_sector;
 #endif
 
 
@@ -146,93 +157,49 @@ UINT                                status;
 #endif
 #endif
 
-    /* Determine if the sector mapping cache is enabled.  */
-    if (nor_flash -> lx_nor_flash_sector_mapping_cache_enabled)
-    {
-    
-        /* Calculate the starting index of the sector cache for this sector entry.  */
-        i =  (logical_sector & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) * LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
-
-        /* Build a pointer to the cache entry.  */
-        sector_mapping_cache_entry_ptr =  &nor_flash -> lx_nor_flash_sector_mapping_cache[i];
-
-        /* Determine if the sector is in the sector mapping cache - assuming the depth of the sector 
-           mapping cache is LX_NOR_SECTOR_MAPPING_CACHE_DEPTH entries.  */
-        if ((sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_logical_sector) == (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID))
-        {
-
-            /* Increment the sector mapping cache hit counter.  */
-            nor_flash -> lx_nor_flash_sector_mapping_cache_hits++;
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
 
-            /* Yes, return the cached values associated with the sector.  */
-            *physical_sector_map_entry =  sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_physical_sector_map_entry;
-            *physical_sector_address =    sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_physical_sector_address;
+    /* Determine if the logical sector is covered by the logical sector index. The index only tracks
+       the current mapping, so it can't be used when searching for the superceded entry.  */
+    if ((superceded_check == LX_FALSE) && (logical_sector < nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector))
+    {
 
-            /* Don't move anything since we found the entry at the top.  */
+        /* Pickup the physical sector of this logical sector.  */
+        physical_sector =  (ULONG) nor_flash -> lx_nor_flash_logical_sector_index[logical_sector];
 
-            /* Return a successful status.  */
-            return(LX_SUCCESS);
-        }
-        else if (((sector_mapping_cache_entry_ptr + 1) -> lx_nor_sector_mapping_cache_logical_sector) == (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID))
+        /* Determine if the logical sector is mapped.  */
+        if (physical_sector == ((ULONG) LX_NOR_LOGICAL_SECTOR_INDEX_UNMAPPED))
         {
 
-            /* Increment the sector mapping cache hit counter.  */
-            nor_flash -> lx_nor_flash_sector_mapping_cache_hits++;
-
-            /* Yes, return the cached values associated with the sector.  */
-            *physical_sector_map_entry =  (sector_mapping_cache_entry_ptr + 1) -> lx_nor_sector_mapping_cache_physical_sector_map_entry;
-            *physical_sector_address =    (sector_mapping_cache_entry_ptr + 1) -> lx_nor_sector_mapping_cache_physical_sector_address;
-
-            /* Just swap the first and second entry.  */
-            temp_sector_mapping_cache_entry =        *(sector_mapping_cache_entry_ptr);
-            *(sector_mapping_cache_entry_ptr) =      *(sector_mapping_cache_entry_ptr + 1);
-            *(sector_mapping_cache_entry_ptr + 1) =  temp_sector_mapping_cache_entry;
-
-            /* Return a successful status.  */
-            return(LX_SUCCESS);
+            /* Not mapped, return not found.  */
+            return(LX_SECTOR_NOT_FOUND);
         }
-        else if (((sector_mapping_cache_entry_ptr + 2) -> lx_nor_sector_mapping_cache_logical_sector) == (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID))
-        {
 
-            /* Increment the sector mapping cache hit counter.  */
-            nor_flash -> lx_nor_flash_sector_mapping_cache_hits++;
+        /* Increment the logical sector index hit counter.  */
+        nor_flash -> lx_nor_flash_logical_sector_index_hits++;
 
-            /* Yes, return the cached value.  */
-            *physical_sector_map_entry =  (sector_mapping_cache_entry_ptr + 2) -> lx_nor_sector_mapping_cache_physical_sector_map_entry;
-            *physical_sector_address =    (sector_mapping_cache_entry_ptr + 2) -> lx_nor_sector_mapping_cache_physical_sector_address;
+        /* Calculate the block and the sector within the block.  */
+        i =  physical_sector / nor_flash -> lx_nor_flash_physical_sectors_per_block;
+        j =  physical_sector - (i * nor_flash -> lx_nor_flash_physical_sectors_per_block);
 
-            /* Move the third entry to the top and the first two entries down.  */
-            temp_sector_mapping_cache_entry =        *(sector_mapping_cache_entry_ptr);
-            *(sector_mapping_cache_entry_ptr) =      *(sector_mapping_cache_entry_ptr + 2);
-            *(sector_mapping_cache_entry_ptr + 2) =  *(sector_mapping_cache_entry_ptr + 1);
-            *(sector_mapping_cache_entry_ptr + 1) =  temp_sector_mapping_cache_entry;
-
-            /* Return a successful status.  */
-            return(LX_SUCCESS);
-        }
-        else if (((sector_mapping_cache_entry_ptr + 3) -> lx_nor_sector_mapping_cache_logical_sector) == (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID))
-        {
+        /* Setup the block word pointer to the first word of the block.  */
+        block_word_ptr =  (nor_flash -> lx_nor_flash_base_address + (i * nor_flash -> lx_nor_flash_words_per_block));
 
-            /* Increment the sector mapping cache hit counter.  */
-            nor_flash -> lx_nor_flash_sector_mapping_cache_hits++;
+        /* Prepare the return information.  */
+        *physical_sector_map_entry =  block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + j;
+        *physical_sector_address =    block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_offset + (j * nor_flash -> lx_nor_flash_words_per_sector);
 
-            /* Yes, return the cached value.  */
-            *physical_sector_map_entry =  (sector_mapping_cache_entry_ptr + 3) -> lx_nor_sector_mapping_cache_physical_sector_map_entry;
-            *physical_sector_address =    (sector_mapping_cache_entry_ptr + 3) -> lx_nor_sector_mapping_cache_physical_sector_address;
+        /* Return a successful status.  */
+        return(LX_SUCCESS);
+    }
+#endif
 
-            /* Move the last entry to the top and the first three entries down.  */
-            temp_sector_mapping_cache_entry =        *(sector_mapping_cache_entry_ptr);
-            *(sector_mapping_cache_entry_ptr) =      *(sector_mapping_cache_entry_ptr + 3);
-            *(sector_mapping_cache_entry_ptr + 3) =  *(sector_mapping_cache_entry_ptr + 2);
-            *(sector_mapping_cache_entry_ptr + 2) =  *(sector_mapping_cache_entry_ptr + 1);
-            *(sector_mapping_cache_entry_ptr + 1) =  temp_sector_mapping_cache_entry;
+    /* Determine if the sector is in the sector mapping cache.  */
+    if (_lx_nor_flash_sector_mapping_cache_find(nor_flash, logical_sector, physical_sector_map_entry, physical_sector_address) == LX_SUCCESS)
+    {
 
-            /* Return a successful status.  */
-            return(LX_SUCCESS);
-        }
-    
-        /* If we get here, we have a cache miss so increment the counter before we fall through the loop.  */
-        nor_flash -> lx_nor_flash_sector_mapping_cache_misses++;
+        /* Yes, return a successful status.  */
+        return(LX_SUCCESS);
     }
 
     /* Setup the total number of mapped sectors.  */
@@ -448,24 +415,10 @@ UINT                                status;
                                     
                         /* Prepare the return information.  */
                         *physical_sector_map_entry =  list_word_ptr;
-                        *physical_sector_address =    block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_offset + (j * LX_NOR_SECTOR_SIZE);
+                        *physical_sector_address =    block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_offset + (j * nor_flash -> lx_nor_flash_words_per_sector);
 
-                        /* Determine if the sector mapping cache is enabled.  */
-                        if (nor_flash -> lx_nor_flash_sector_mapping_cache_enabled)
-                        {
-
-                            /* Yes, update the cache with the sector mapping.  */
-                            
-                            /* Move all the cache entries down so the oldest is at the bottom.  */
-                            *(sector_mapping_cache_entry_ptr + 3) =  *(sector_mapping_cache_entry_ptr + 2);
-                            *(sector_mapping_cache_entry_ptr + 2) =  *(sector_mapping_cache_entry_ptr + 1);
-                            *(sector_mapping_cache_entry_ptr + 1) =  *(sector_mapping_cache_entry_ptr);
-
-                            /* Setup the new sector information in the cache.  */
-                            sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_logical_sector =             (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID);
-                            sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_physical_sector_map_entry =  *physical_sector_map_entry;
-                            sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_physical_sector_address =    *physical_sector_address;
-                        }
+                        /* Update the sector mapping cache with the sector mapping.  */
+                        _lx_nor_flash_sector_mapping_cache_insert(nor_flash, logical_sector, *physical_sector_map_entry, *physical_sector_address);
 
                         /* Remember the last found block for next search.  */
                         nor_flash -> lx_nor_flash_found_block_search =  i;
@@ -491,7 +444,7 @@ UINT                                status;
                         
                         /* Prepare the return information.  */
                         *physical_sector_map_entry =  list_word_ptr;
-                        *physical_sector_address =    block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_offset + (j * LX_NOR_SECTOR_SIZE);
+                        *physical_sector_address =    block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_offset + (j * nor_flash -> lx_nor_flash_words_per_sector);
 
                         /* No need to update the cache here, since this condition only happens during initialization.  */
 
@@ -0,0 +1,255 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_logical_sector_index_enable           PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function enables or disables the RAM logical sector index.     */
+/*    Each index entry holds the physical sector currently mapped to the  */
+/*    logical sector, which allows the logical sector to be found without */
+/*    searching the mapping lists in flash. This function may be called   */
+/*    from the driver initialization, in which case the index is built   */
+/*    while the NOR flash is opened, or after the NOR flash is opened, in */
+/*    which case the index is built here from the mapping lists.          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    memory                                Address of RAM for index      */
+/*    size                                  Size of the RAM for index     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_driver_read             Driver read                   */
+/*    _lx_nor_flash_system_error            Internal system error handler */
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_logical_sector_index_enable(LX_NOR_FLASH *nor_flash, VOID *memory, ULONG size)
+{
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+ULONG   i;
+ULONG   j;
+ULONG   max_logical_sector;
+ULONG   logical_sector;
+ULONG   *block_word_ptr;
+ULONG   block_word;
+#ifndef LX_DIRECT_READ
+UINT    status;
+#endif
+
+
+    /* Determine if memory was specified but with an invalid size (less than one index entry).  */
+    if ((memory) && (size < sizeof(LX_NOR_LOGICAL_SECTOR_INDEX_TYPE)))
+    {
+
+        /* Error in memory size supplied.  */
+        return(LX_ERROR);
+    }
+
+    /* Check if the NOR flash is opened.  */
+    if (nor_flash -> lx_nor_flash_state != LX_NOR_FLASH_OPENED)
+    {
+
+        /* No, this is called from the driver initialization. Just remember the memory, the index
+           is built by the open logic.  */
+        nor_flash -> lx_nor_flash_logical_sector_index =  (LX_NOR_LOGICAL_SECTOR_INDEX_TYPE *) memory;
+        nor_flash -> lx_nor_flash_logical_sector_index_size =  size;
+        nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  0;
+
+        /* Return successful completion.  */
+        return(LX_SUCCESS);
+    }
+
+    /* Calculate the number of logical sectors covered by the index.  */
+    max_logical_sector =  size / (ULONG) sizeof(LX_NOR_LOGICAL_SECTOR_INDEX_TYPE);
+
+    /* There is no need to cover more logical sectors than there are physical sectors.  */
+    if (max_logical_sector > nor_flash -> lx_nor_flash_total_physical_sectors)
+    {
+        max_logical_sector =  nor_flash -> lx_nor_flash_total_physical_sectors;
+    }
+
+    /* Determine if memory was specified but every physical sector can't be represented by the index entry type.  */
+    if ((memory) && (nor_flash -> lx_nor_flash_total_physical_sectors >= ((ULONG) LX_NOR_LOGICAL_SECTOR_INDEX_UNMAPPED)))
+    {
+
+        /* Index entry type is too small for this NOR flash.  */
+        return(LX_ERROR);
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Disable the index while it is being built.  */
+    nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  0;
+
+    /* Setup the index memory.  */
+    nor_flash -> lx_nor_flash_logical_sector_index =  (LX_NOR_LOGICAL_SECTOR_INDEX_TYPE *) memory;
+    nor_flash -> lx_nor_flash_logical_sector_index_size =  size;
+
+    /* Determine if the index is being disabled.  */
+    if (memory == LX_NULL)
+    {
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+        /* Return successful completion.  */
+        return(LX_SUCCESS);
+    }
+
+    /* Mark all the index entries as unmapped.  */
+    for (i = 0; i < max_logical_sector; i++)
+    {
+        nor_flash -> lx_nor_flash_logical_sector_index[i] =  LX_NOR_LOGICAL_SECTOR_INDEX_UNMAPPED;
+    }
+
+    /* Loop through the blocks.  */
+    for (i = 0; i < nor_flash -> lx_nor_flash_total_blocks; i++)
+    {
+
+        /* Setup the block word pointer to the first word of the block.  */
+        block_word_ptr =  (nor_flash -> lx_nor_flash_base_address + (i * nor_flash -> lx_nor_flash_words_per_block));
+
+        /* Now walk the list of logical-physical sector mapping.  */
+        for (j = 0; j < nor_flash -> lx_nor_flash_physical_sectors_per_block; j++)
+        {
+
+            /* Read this word of the sector mapping list.  */
+#ifdef LX_DIRECT_READ
+
+            /* Read the word directly.  */
+            block_word =  *(block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + j);
+#else
+            status =  _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + j), &block_word, 1);
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+                /* Release the thread safe mutex.  */
+                LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+                /* Return an error.  */
+                return(LX_ERROR);
+            }
+#endif
+
+            /* Determine if the entry hasn't been used.  */
+            if (block_word == LX_NOR_PHYSICAL_SECTOR_FREE)
+            {
+                break;
+            }
+
+            /* Is this entry valid?  */
+            if ((block_word & (LX_NOR_PHYSICAL_SECTOR_VALID | LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID)) == LX_NOR_PHYSICAL_SECTOR_VALID)
+            {
+
+                /* Yes, get the logical sector.  */
+                logical_sector =  block_word & LX_NOR_LOGICAL_SECTOR_MASK;
+
+                /* Check if the logical sector is covered by the index.  */
+                if (logical_sector < max_logical_sector)
+                {
+
+                    /* Remember the physical sector of this logical sector.  */
+                    nor_flash -> lx_nor_flash_logical_sector_index[logical_sector] =
+                                (LX_NOR_LOGICAL_SECTOR_INDEX_TYPE) ((i * nor_flash -> lx_nor_flash_physical_sectors_per_block) + j);
+                }
+            }
+        }
+    }
+
+    /* The index is now complete, enable it.  */
+    nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  max_logical_sector;
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return successful completion.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(memory);
+    LX_PARAMETER_NOT_USED(size);
+
+    /* Return disabled error message.  */
+    return(LX_DISABLED);
+#endif
+}
+
@@ -0,0 +1,122 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_logical_sector_index_update           PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the logical sector's entry in the RAM logical */
+/*    sector index. A NULL mapping entry marks the sector as unmapped.    */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Logical sector                */
+/*    physical_sector_map_entry             Pointer to mapping entry, or  */
+/*                                            NULL if sector is unmapped  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_logical_sector_index_update(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG *physical_sector_map_entry)
+{
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+ULONG   block;
+ULONG   offset;
+
+
+    /* Determine if this logical sector is covered by the logical sector index.  */
+    if (logical_sector >= nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector)
+    {
+
+        /* No, nothing to do.  */
+        return;
+    }
+
+    /* Determine if the logical sector is no longer mapped.  */
+    if (physical_sector_map_entry == LX_NULL)
+    {
+
+        /* Mark the logical sector as unmapped.  */
+        nor_flash -> lx_nor_flash_logical_sector_index[logical_sector] =  LX_NOR_LOGICAL_SECTOR_INDEX_UNMAPPED;
+        return;
+    }
+
+    /* Calculate the word offset of the mapping entry from the base of the flash.  */
+    offset =  (ULONG) (physical_sector_map_entry - nor_flash -> lx_nor_flash_base_address);
+
+    /* Calculate the block of the mapping entry.  */
+    block =  offset / nor_flash -> lx_nor_flash_words_per_block;
+
+    /* Calculate the index of the mapping entry within the block's mapping list.  */
+    offset =  offset - (block * nor_flash -> lx_nor_flash_words_per_block) - nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset;
+
+    /* Remember the physical sector of this logical sector.  */
+    nor_flash -> lx_nor_flash_logical_sector_index[logical_sector] =
+                (LX_NOR_LOGICAL_SECTOR_INDEX_TYPE) ((block * nor_flash -> lx_nor_flash_physical_sectors_per_block) + offset);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(logical_sector);
+    LX_PARAMETER_NOT_USED(physical_sector_map_entry);
+#endif
+}
+
@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_next_block_to_erase_find              PORTABLE C      */ 
-/*                                                           6.3.0        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -65,6 +65,7 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
+/*    _lx_nor_flash_erase_queue_update      Update erase queue            */
 /*    _lx_nor_flash_system_error            Internal system error handler */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
@@ -86,6 +87,10 @@
 /*                                            optimized full obsoleted    */
 /*                                            block searching logic,      */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added block summary,        */
+/*                                            added erase queue,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_next_block_to_erase_find(LX_NOR_FLASH *nor_flash, ULONG *return_erase_block, ULONG *return_erase_count, ULONG *return_mapped_sectors, ULONG *return_obsolete_sectors)
@@ -119,6 +124,10 @@ UINT    status;
 #endif
 UINT    obsolete_sectors_available;
 UINT    mapped_sectors_available;
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+LX_NOR_FLASH_BLOCK_SUMMARY      *block_summary;
+LX_NOR_FLASH_ERASE_QUEUE_NODE   *erase_queue;
+#endif
 
 
     /* Setup the block word pointer to the first word of the search block.  */
@@ -148,11 +157,93 @@ UINT    mapped_sectors_available;
         /* When the number of free sectors is low, simply pick the block that has the most number of obsolete sectors.  */
         erase_count_threshold =  LX_ALL_ONES;
     }
+
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+
+    /* Determine if the erase queue is available.  */
+    if ((nor_flash -> lx_nor_flash_block_summary_enabled) && (nor_flash -> lx_nor_flash_total_blocks > 1))
+    {
+
+        /* Yes, the winners of all the blocks are in the root node of the erase queue.  */
+        block_summary =  nor_flash -> lx_nor_flash_block_summary;
+        erase_queue =    &nor_flash -> lx_nor_flash_erase_queue[1];
+
+        /* Pickup the block with the most obsolete sectors. When there are full obsoleted blocks, this is 
+           the first one with the smallest erase count.  */
+        i =  erase_queue -> lx_nor_flash_erase_queue_node_obsolete_block;
+
+        /* Determine if this block contains full obsoleted sectors and the erase count is minimum.  */
+        if ((block_summary[i].lx_nor_flash_block_summary_obsolete_sectors == nor_flash -> lx_nor_flash_physical_sectors_per_block) && 
+            (block_summary[i].lx_nor_flash_block_summary_erase_count == nor_flash -> lx_nor_flash_minimum_erase_count) &&
+            (nor_flash -> lx_nor_flash_minimum_erased_blocks > 0))
+        {
+
+            /* Yes, we have a full obsoleted block with minimum erase count.  */
+            *return_erase_block =       i;
+            *return_erase_count =       block_summary[i].lx_nor_flash_block_summary_erase_count;
+            *return_obsolete_sectors =  (ULONG) block_summary[i].lx_nor_flash_block_summary_obsolete_sectors;
+            *return_mapped_sectors =    (ULONG) block_summary[i].lx_nor_flash_block_summary_mapped_sectors;
+
+            /* Return success.  */
+            return(LX_SUCCESS);
+        }
+
+        /* Determine if the erase count threshold applies.  */
+        if (erase_count_threshold != LX_ALL_ONES)
+        {
+
+            /* Determine if the minimum erase count has moved since the erase queue was built.  */
+            if (erase_count_threshold != nor_flash -> lx_nor_flash_erase_queue_erase_count_threshold)
+            {
+
+                /* Yes, rebuild the erase queue with the new erase count threshold.  */
+                _lx_nor_flash_erase_queue_update(nor_flash, LX_NOR_ERASE_QUEUE_REBUILD);
+            }
+
+            /* Pickup the block with the most obsolete sectors within the erase count threshold.  */
+            i =  erase_queue -> lx_nor_flash_erase_queue_node_eligible_block;
+        }
+
+        /* Determine if we can erase the block with the most obsolete sectors.  */
+        if ((i == LX_NOR_ERASE_QUEUE_NONE) || (block_summary[i].lx_nor_flash_block_summary_obsolete_sectors == 0))
+        {
+
+            /* Otherwise, choose the first block with the smallest erase count.  */
+            i =  erase_queue -> lx_nor_flash_erase_queue_node_erase_block;
+        }
+
+        /* Return the selected block.  */
+        *return_erase_block =       i;
+        *return_erase_count =       block_summary[i].lx_nor_flash_block_summary_erase_count;
+        *return_obsolete_sectors =  (ULONG) block_summary[i].lx_nor_flash_block_summary_obsolete_sectors;
+        *return_mapped_sectors =    (ULONG) block_summary[i].lx_nor_flash_block_summary_mapped_sectors;
+
+        /* Update the overall minimum erase count. The maximum erase count is kept current by the block reclaim.  */
+        i =  erase_queue -> lx_nor_flash_erase_queue_node_erase_block;
+        nor_flash -> lx_nor_flash_minimum_erase_count =    block_summary[i].lx_nor_flash_block_summary_erase_count;
+        nor_flash -> lx_nor_flash_minimum_erased_blocks =  erase_queue -> lx_nor_flash_erase_queue_node_erase_blocks;
+
+        /* Return success.  */
+        return(LX_SUCCESS);
+    }
+#endif
     
     /* Loop through the blocks to attempt to find the mapped logical sector.  */
     for (i = 0; i < nor_flash -> lx_nor_flash_total_blocks; i++)
     {
 
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+        /* Determine if the block summary is enabled.  */
+        if (nor_flash -> lx_nor_flash_block_summary_enabled)
+        {
+
+            /* Yes, pickup the erase count of this block from the block summary.  */
+            erase_count =  nor_flash -> lx_nor_flash_block_summary[i].lx_nor_flash_block_summary_erase_count;
+        }
+        else
+        {
+#endif
         /* Read the erase count of this block.  */
 #ifdef LX_DIRECT_READ
         
@@ -172,6 +263,9 @@ UINT    mapped_sectors_available;
             return(status);
         }
 #endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+        }
+#endif
 
         /* Update the system minimum and maximum erase counts.  */
         if (erase_count == min_system_block_erase_count)
@@ -189,6 +283,22 @@ UINT    mapped_sectors_available;
         /* Initialize the obsolete and mapped sector count available flags.  */
         obsolete_sectors_available =  LX_FALSE;
         mapped_sectors_available =  LX_FALSE;
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+        /* Determine if the block summary is enabled.  */
+        if (nor_flash -> lx_nor_flash_block_summary_enabled)
+        {
+
+            /* Yes, the obsolete and mapped sector counts are available from the block summary.  */
+            obsolete_sectors =  (ULONG) nor_flash -> lx_nor_flash_block_summary[i].lx_nor_flash_block_summary_obsolete_sectors;
+            mapped_sectors =    (ULONG) nor_flash -> lx_nor_flash_block_summary[i].lx_nor_flash_block_summary_mapped_sectors;
+            obsolete_sectors_available =  LX_TRUE;
+            mapped_sectors_available =  LX_TRUE;
+        }
+        else
+        {
+#endif
         
 #ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
 
@@ -259,6 +369,9 @@ UINT    mapped_sectors_available;
 #ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
         }
 #endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+        }
+#endif
 
         /* Determine if the mapped sector count is available.  */
         if (obsolete_sectors_available == LX_FALSE)
@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_open                                  PORTABLE C      */ 
-/*                                                           6.3.0        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -62,14 +62,18 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    (nor_driver_initialize)               Driver initialize             */ 
+/*    _lx_nor_flash_checkpoint_read         Restore mount checkpoint      */
 /*    _lx_nor_flash_driver_read             Driver read                   */ 
 /*    _lx_nor_flash_driver_write            Driver write                  */ 
 /*    (lx_nor_flash_driver_block_erased_verify)                           */ 
 /*                                          NOR flash verify block erased */ 
 /*    _lx_nor_flash_driver_block_erase      Driver block erase            */ 
 /*    _lx_nor_flash_logical_sector_find     Find logical sector           */ 
+/*    _lx_nor_flash_erase_queue_update      Update erase queue            */
 /*    _lx_nor_flash_system_error            System error handler          */ 
-/*    tx_mutex_create                       Create thread-safe mutex      */ 
+/*    LX_LOCK_MUTEX_CREATE                  Create thread-safe mutex      */ 
+/*    LX_LOCK_SEMAPHORE_CREATE              Create shared read semaphore  */ 
+/*    LX_LOCK_RWLOCK_CREATE                 Create shared read lock       */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -102,6 +106,20 @@
 /*                                            extension in flash control  */
 /*                                            block,                      */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added logical sector index, */
+/*                                            added block summary,        */
+/*                                            added erase queue,          */
+/*                                            added runtime sector size,  */
+/*                                            added next free sector,     */
+/*                                            added free sector           */
+/*                                            watermarks,                 */
+/*                                            added mount checkpoint,     */
+/*                                            added write streams,        */
+/*                                            added shared reads,         */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_open(LX_NOR_FLASH  *nor_flash, CHAR *name, UINT (*nor_driver_initialize)(LX_NOR_FLASH *))
@@ -120,12 +138,18 @@ ULONG           used_sectors;
 ULONG           *new_map_entry;
 ULONG           *new_sector_address;
 ULONG           erased_count, min_erased_count, max_erased_count, temp_erased_count, min_erased_blocks;
+ULONG           blocks_to_walk;
 ULONG           j, k, l;    
 UINT            status;
 #ifdef LX_FREE_SECTOR_DATA_VERIFY
 ULONG           *sector_word_ptr;
 ULONG           sector_word;
 #endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+ULONG           block_free_sectors;
+ULONG           block_mapped_sectors;
+ULONG           block_obsolete_sectors;
+#endif
 LX_NOR_FLASH   *tail_ptr;
 LX_INTERRUPT_SAVE_AREA
 
@@ -137,6 +161,26 @@ LX_INTERRUPT_SAVE_AREA
     /* Call the flash driver's initialization function.  */
     (nor_driver_initialize)(nor_flash);
 
+    /* Determine if the driver supplied the sector size.  */
+    if (nor_flash -> lx_nor_flash_words_per_sector == 0)
+    {
+
+        /* No, use the default sector size.  */
+        nor_flash -> lx_nor_flash_words_per_sector =  LX_NOR_SECTOR_SIZE;
+    }
+
+    /* Determine if the sector size is valid. It must be a power of 2, between the minimum and maximum sector
+       sizes, and each block must have room for the block header and at least one physical sector.  */
+    if ((nor_flash -> lx_nor_flash_words_per_sector & (nor_flash -> lx_nor_flash_words_per_sector - 1)) ||
+        (nor_flash -> lx_nor_flash_words_per_sector < LX_NOR_SECTOR_SIZE_MIN) ||
+        (nor_flash -> lx_nor_flash_words_per_sector > LX_NOR_SECTOR_SIZE_MAX) ||
+        (nor_flash -> lx_nor_flash_words_per_block < (2 * nor_flash -> lx_nor_flash_words_per_sector)))
+    {
+
+        /* Return an error.  */
+        return(LX_ERROR);
+    }
+
 #ifndef LX_DIRECT_READ
 
     /* Determine if the driver supplied a RAM buffer for reading the NOR sector if direct read is not
@@ -155,7 +199,7 @@ LX_INTERRUPT_SAVE_AREA
     /* Calculate the number of bits we need in the free physical sector bit map.  Subtract 1 to account for the 
        flash block header itself. The case where multiple physical sectors are needed for certain sized flash 
        devices is handled below.  */
-    sectors_per_block =  (nor_flash -> lx_nor_flash_words_per_block / LX_NOR_SECTOR_SIZE) - 1;
+    sectors_per_block =  (nor_flash -> lx_nor_flash_words_per_block / nor_flash -> lx_nor_flash_words_per_sector) - 1;
 
     /* Calculate the number of words required for the sector map array.  */
     sector_map_words =  sectors_per_block;
@@ -173,23 +217,23 @@ LX_INTERRUPT_SAVE_AREA
     total_header_words =  sizeof(LX_NOR_FLASH_BLOCK_HEADER)/sizeof(ULONG) + bit_map_words + sector_map_words;
     
     /* Determine if more physical sectors are needed, which can happen on large devices.  */
-    if (total_header_words <= LX_NOR_SECTOR_SIZE)
+    if (total_header_words <= nor_flash -> lx_nor_flash_words_per_sector)
     {
     
         /* Round up to the size of 1 physical sector.  */
-        total_header_words =  LX_NOR_SECTOR_SIZE;
+        total_header_words =  nor_flash -> lx_nor_flash_words_per_sector;
     }
     else
     {
 
         /* Otherwise calculate how many header sectors are necessary.  */
-        header_sectors =  (total_header_words-1)/LX_NOR_SECTOR_SIZE;
+        header_sectors =  (total_header_words-1)/nor_flash -> lx_nor_flash_words_per_sector;
         
         /* Round up to the next sector.  */
         header_sectors++;
         
         /* Compute the total header words, rounding to the next sector.  */
-        total_header_words =  header_sectors * LX_NOR_SECTOR_SIZE;
+        total_header_words =  header_sectors * nor_flash -> lx_nor_flash_words_per_sector;
         
         /* Adjust the number of sectors per block.  */
         sectors_per_block =  sectors_per_block - (header_sectors - 1);
@@ -201,6 +245,39 @@ LX_INTERRUPT_SAVE_AREA
     /* Save the physical sectors per block and total physical sectors.  */
     nor_flash -> lx_nor_flash_physical_sectors_per_block =  sectors_per_block;
     nor_flash -> lx_nor_flash_total_physical_sectors =      nor_flash -> lx_nor_flash_total_blocks * sectors_per_block;
+
+    /* Determine if the driver supplied the free sector watermarks.  */
+    if (nor_flash -> lx_nor_flash_free_sectors_low_watermark == 0)
+    {
+
+        /* No, use the default low watermark.  */
+        nor_flash -> lx_nor_flash_free_sectors_low_watermark =  sectors_per_block * LX_NOR_FLASH_LOW_WATERMARK_BLOCKS;
+    }
+    if (nor_flash -> lx_nor_flash_free_sectors_high_watermark == 0)
+    {
+
+        /* No, use the default high watermark, but not below the low watermark.  */
+        nor_flash -> lx_nor_flash_free_sectors_high_watermark =  sectors_per_block * LX_NOR_FLASH_HIGH_WATERMARK_BLOCKS;
+        if (nor_flash -> lx_nor_flash_free_sectors_high_watermark < nor_flash -> lx_nor_flash_free_sectors_low_watermark)
+            nor_flash -> lx_nor_flash_free_sectors_high_watermark =  nor_flash -> lx_nor_flash_free_sectors_low_watermark;
+    }
+
+    /* Determine if the watermarks are valid. A block's worth of free sectors is needed to reclaim a block.  */
+    if ((nor_flash -> lx_nor_flash_free_sectors_low_watermark < sectors_per_block) ||
+        (nor_flash -> lx_nor_flash_free_sectors_high_watermark < nor_flash -> lx_nor_flash_free_sectors_low_watermark))
+    {
+
+        /* Return an error.  */
+        return(LX_ERROR);
+    }
+    
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+    /* No write stream is filling a block yet.  */
+    nor_flash -> lx_nor_flash_write_stream_hint =  LX_NOR_WRITE_STREAM_AUTO;
+    for (j = 0; j < LX_NOR_WRITE_STREAMS; j++)
+        nor_flash -> lx_nor_flash_write_stream_block[j] =  nor_flash -> lx_nor_flash_total_blocks;
+#endif
     
     /* Build the free bit map mask, for the portion of the bit map that is less than 32 bits.  */
     if ((sectors_per_block % 32) != 0)
@@ -217,7 +294,68 @@ LX_INTERRUPT_SAVE_AREA
 
     /* Save the free bit map mask in the control block.  */
     nor_flash -> lx_nor_flash_block_bit_map_mask =  bit_map_mask;
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+    /* Determine if the driver supplied memory for the logical sector index.  */
+    if (nor_flash -> lx_nor_flash_logical_sector_index)
+    {
+
+        /* Calculate the number of logical sectors covered by the index.  */
+        nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  nor_flash -> lx_nor_flash_logical_sector_index_size / (ULONG) sizeof(LX_NOR_LOGICAL_SECTOR_INDEX_TYPE);
+
+        /* There is no need to cover more logical sectors than there are physical sectors.  */
+        if (nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector > nor_flash -> lx_nor_flash_total_physical_sectors)
+        {
+            nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  nor_flash -> lx_nor_flash_total_physical_sectors;
+        }
+
+        /* Determine if every physical sector can be represented by the index entry type.  */
+        if (nor_flash -> lx_nor_flash_total_physical_sectors >= ((ULONG) LX_NOR_LOGICAL_SECTOR_INDEX_UNMAPPED))
+        {
+
+            /* No, the index can't be used with this geometry.  */
+            nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  0;
+        }
+
+        /* Mark all the index entries as unmapped. The entries are filled in while walking the mapping lists below.  */
+        for (j = 0; j < nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector; j++)
+        {
+            nor_flash -> lx_nor_flash_logical_sector_index[j] =  LX_NOR_LOGICAL_SECTOR_INDEX_UNMAPPED;
+        }
+    }
+#endif
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+    /* Determine if the driver supplied enough memory for the block summary to cover every block.  */
+    if ((nor_flash -> lx_nor_flash_block_summary) && 
+        (nor_flash -> lx_nor_flash_block_summary_size >= (ULONG) LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(nor_flash -> lx_nor_flash_total_blocks)))
+    {
+
+        /* Yes, enable the block summary. The entries are filled in while walking the blocks below.  */
+        nor_flash -> lx_nor_flash_block_summary_enabled =  LX_TRUE;
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+
+        /* Setup the erase queue, which follows the block summary entries. It is built once all the blocks are walked.  */
+        nor_flash -> lx_nor_flash_erase_queue =  (LX_NOR_FLASH_ERASE_QUEUE_NODE *) (nor_flash -> lx_nor_flash_block_summary + nor_flash -> lx_nor_flash_total_blocks);
+#endif
+    }
+#endif
     
+    /* By default, walk all the blocks to rebuild the NOR flash state.  */
+    blocks_to_walk =  nor_flash -> lx_nor_flash_total_blocks;
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+    /* Determine if the state can be restored from the checkpoint instead.  */
+    if (_lx_nor_flash_checkpoint_read(nor_flash) == LX_SUCCESS)
+    {
+
+        /* Yes, there is no need to walk the blocks.  */
+        blocks_to_walk =  0;
+    }
+#endif
+
     /* Setup default values for the max/min erased counts.  */
     min_erased_count =  LX_ALL_ONES;
     min_erased_blocks = 0;
@@ -228,7 +366,7 @@ LX_INTERRUPT_SAVE_AREA
     block_word_ptr =  nor_flash -> lx_nor_flash_base_address;
     
     /* Loop through the blocks to determine the minimum and maximum erase count.  */
-    for (l = 0; l < nor_flash -> lx_nor_flash_total_blocks; l++)
+    for (l = 0; l < blocks_to_walk; l++)
     {
     
         /* Pickup the first word of the block. If the flash manager has executed before, this word contains the
@@ -297,7 +435,7 @@ LX_INTERRUPT_SAVE_AREA
 
     /* If we haven't found any erased counts, we can assume the flash is completely erased and needs to 
        be setup for the first time.  */
-    if (min_erased_count == LX_ALL_ONES)
+    if ((blocks_to_walk) && (min_erased_count == LX_ALL_ONES))
     {
     
         /* Indicate that this is the initial format.  */
@@ -351,12 +489,27 @@ LX_INTERRUPT_SAVE_AREA
 
             /* Update the number of free physical sectors.  */
             nor_flash -> lx_nor_flash_free_physical_sectors =   nor_flash -> lx_nor_flash_free_physical_sectors + sectors_per_block;
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+            /* Determine if the block summary is enabled.  */
+            if (nor_flash -> lx_nor_flash_block_summary_enabled)
+            {
+
+                /* Yes, all the sectors of this block are free.  */
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_erase_count =      block_word;
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_mapped_sectors =   0;
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_obsolete_sectors = 0;
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_free_sectors =     (USHORT) sectors_per_block;
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_next_free_sector = 0;
+            }
+#endif
         
             /* Move to the next flash block.  */
             block_word_ptr =  block_word_ptr + (nor_flash -> lx_nor_flash_words_per_block);
         }    
     }
-    else
+    else if (blocks_to_walk)
     {
 
         /* At this point, we have a previously managed flash structure. This needs to be traversed to prepare for the 
@@ -393,6 +546,19 @@ LX_INTERRUPT_SAVE_AREA
             }
 #endif
 
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+            /* Remember the erase count and the sector counts before walking this block.  */
+            if (nor_flash -> lx_nor_flash_block_summary_enabled)
+            {
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_erase_count =     block_word;
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_next_free_sector = 0;
+            }
+            block_free_sectors =      nor_flash -> lx_nor_flash_free_physical_sectors;
+            block_mapped_sectors =    nor_flash -> lx_nor_flash_mapped_physical_sectors;
+            block_obsolete_sectors =  nor_flash -> lx_nor_flash_obsolete_physical_sectors;
+#endif
+
             /* Is the block erased?  */
             if (((block_word & LX_BLOCK_ERASED) == LX_BLOCK_ERASED) || (block_word == LX_BLOCK_ERASE_STARTED))
             {
@@ -421,6 +587,11 @@ LX_INTERRUPT_SAVE_AREA
 #else
                 status =  (nor_flash -> lx_nor_flash_driver_block_erased_verify)(l);
 #endif
+#ifdef LX_NOR_ENABLE_STATS
+
+                /* Count the driver erased verify.  */
+                nor_flash -> lx_nor_flash_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_BLOCK_ERASED_VERIFY]++;
+#endif
 
                 /* Is the block completely erased?  */
                 if (status != LX_SUCCESS)
@@ -503,6 +674,17 @@ LX_INTERRUPT_SAVE_AREA
 
                 /* Update the number of free physical sectors.  */
                 nor_flash -> lx_nor_flash_free_physical_sectors =   nor_flash -> lx_nor_flash_free_physical_sectors + sectors_per_block;
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+                /* Determine if the block summary is enabled.  */
+                if (nor_flash -> lx_nor_flash_block_summary_enabled)
+                {
+
+                    /* Yes, remember the erase count written to this block.  */
+                    nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_erase_count =  max_erased_count;
+                }
+#endif
             }
             else
             {
@@ -559,6 +741,17 @@ LX_INTERRUPT_SAVE_AREA
                 /* Update the number of free physical sectors.  */
                 nor_flash -> lx_nor_flash_free_physical_sectors =   nor_flash -> lx_nor_flash_free_physical_sectors + free_sectors;
 
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+                /* Determine if the block summary is enabled.  */
+                if (nor_flash -> lx_nor_flash_block_summary_enabled)
+                {
+
+                    /* Yes, free sectors are allocated in order, so the free sectors are at the end of the block.  */
+                    nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_next_free_sector =  (USHORT) (sectors_per_block - free_sectors);
+                }
+#endif
+
                 /* We need to now examine the mapping list.  */
                     
                 /* Calculate how many non-free sectors there are - this includes valid and obsolete sectors.  */
@@ -734,6 +927,18 @@ LX_INTERRUPT_SAVE_AREA
                         {
                             /* Increment the number of mapped physical sectors.  */
                             nor_flash -> lx_nor_flash_mapped_physical_sectors++;
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+                            /* Determine if this logical sector is covered by the logical sector index.  */
+                            if ((block_word & LX_NOR_LOGICAL_SECTOR_MASK) < nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector)
+                            {
+
+                                /* Yes, remember the physical sector of this logical sector.  */
+                                nor_flash -> lx_nor_flash_logical_sector_index[block_word & LX_NOR_LOGICAL_SECTOR_MASK] =  
+                                            (LX_NOR_LOGICAL_SECTOR_INDEX_TYPE) ((l * sectors_per_block) + j);
+                            }
+#endif
                         }
                         
                         /* Decrease the number of used sectors.  */
@@ -773,10 +978,10 @@ LX_INTERRUPT_SAVE_AREA
 #ifdef LX_FREE_SECTOR_DATA_VERIFY
 
                         /* Pickup address of the free sector data area.  */
-                        sector_word_ptr =  block_word_ptr + (nor_flash -> lx_nor_flash_block_physical_sector_offset) + (j * LX_NOR_SECTOR_SIZE);
+                        sector_word_ptr =  block_word_ptr + (nor_flash -> lx_nor_flash_block_physical_sector_offset) + (j * nor_flash -> lx_nor_flash_words_per_sector);
 
                         /* Determine if the data for this sector is free.  */
-                        for (k = 0; k < LX_NOR_SECTOR_SIZE; k++)
+                        for (k = 0; k < nor_flash -> lx_nor_flash_words_per_sector; k++)
                         {
 
 #ifdef LX_DIRECT_READ
@@ -819,6 +1024,22 @@ LX_INTERRUPT_SAVE_AREA
                     }
                 }
             }       
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+            /* Determine if the block summary is enabled.  */
+            if (nor_flash -> lx_nor_flash_block_summary_enabled)
+            {
+
+                /* Yes, save the sector counts found in this block.  */
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_free_sectors =     
+                            (USHORT) (nor_flash -> lx_nor_flash_free_physical_sectors - block_free_sectors);
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_mapped_sectors =   
+                            (USHORT) (nor_flash -> lx_nor_flash_mapped_physical_sectors - block_mapped_sectors);
+                nor_flash -> lx_nor_flash_block_summary[l].lx_nor_flash_block_summary_obsolete_sectors = 
+                            (USHORT) (nor_flash -> lx_nor_flash_obsolete_physical_sectors - block_obsolete_sectors);
+            }
+#endif
             
             /* Move to the next flash block.  */
             block_word_ptr =  block_word_ptr + (nor_flash -> lx_nor_flash_words_per_block);
@@ -838,11 +1059,17 @@ LX_INTERRUPT_SAVE_AREA
         }
     }
 
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+
+    /* Build the erase queue from the block summary.  */
+    _lx_nor_flash_erase_queue_update(nor_flash, LX_NOR_ERASE_QUEUE_REBUILD);
+#endif
+
 #ifdef LX_THREAD_SAFE_ENABLE
 
-    /* If the thread safe option is enabled, create a ThreadX mutex that will be used in all external APIs 
+    /* If the thread safe option is enabled, create a mutex that will be used in all external APIs 
        in order to provide thread-safe operation.  */
-    status =  tx_mutex_create(&nor_flash -> lx_nor_flash_mutex, "NOR Flash Mutex", TX_NO_INHERIT);
+    status =  LX_LOCK_MUTEX_CREATE(&nor_flash -> lx_nor_flash_mutex, "NOR Flash Mutex");
 
     /* Determine if the mutex creation encountered an error.  */
     if (status != LX_SUCCESS)
@@ -854,6 +1081,33 @@ LX_INTERRUPT_SAVE_AREA
         /* Return error to caller.  */
         return(LX_ERROR);
     }
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Create the read/write lock that coordinates shared reads with block erases.  */
+    status =  LX_LOCK_RWLOCK_CREATE(&nor_flash -> lx_nor_flash_shared_read_lock, "NOR Flash Shared Read Lock");
+#else
+
+    /* Create the mutex and semaphore that coordinate shared reads with block erases.  */
+    status =  LX_LOCK_MUTEX_CREATE(&nor_flash -> lx_nor_flash_shared_read_mutex, "NOR Flash Shared Read Mutex");
+    if (status == LX_SUCCESS)
+    {
+        status =  LX_LOCK_SEMAPHORE_CREATE(&nor_flash -> lx_nor_flash_shared_read_semaphore, "NOR Flash Shared Read Semaphore");
+    }
+#endif
+
+    /* Determine if the creation encountered an error.  */
+    if (status != LX_SUCCESS)
+    {
+    
+        /* Call system error handler, since this should not happen.  */
+        _lx_nor_flash_system_error(nor_flash, LX_SYSTEM_MUTEX_CREATE_FAILED);
+    
+        /* Return error to caller.  */
+        return(LX_ERROR);
+    }
+#endif
 #endif
 
     /* Enable the sector mapping cache.  */
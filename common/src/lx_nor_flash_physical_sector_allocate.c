@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_physical_sector_allocate              PORTABLE C      */ 
-/*                                                           6.1.7        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -47,7 +47,8 @@
 /*  DESCRIPTION                                                           */ 
 /*                                                                        */ 
 /*    This function allocates a free physical sector for mapping to a     */ 
-/*    logical sector.                                                     */ 
+/*    logical sector. With write streams, each stream fills its own       */ 
+/*    block, so sectors of different streams are not mixed.              */ 
 /*                                                                        */ 
 /*  INPUT                                                                 */ 
 /*                                                                        */ 
@@ -79,6 +80,13 @@
 /*                                            resulting in version 6.1    */
 /*  06-02-2021     Bhupendra Naphade        Modified comment(s),          */
 /*                                            resulting in version 6.1.7  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added runtime sector size,  */
+/*                                            improved free sector search,*/
+/*                                            skipped the block being     */
+/*                                            reclaimed,                  */
+/*                                            added write streams,        */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_physical_sector_allocate(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG **physical_sector_map_entry, ULONG **physical_sector_address)
@@ -91,8 +99,14 @@ ULONG   min_logical_sector;
 ULONG   max_logical_sector;
 ULONG   *list_word_ptr;
 ULONG   list_word;
+ULONG   free_sector;
 ULONG   i, j, k, l;
 UINT    status;
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+ULONG   stream;
+ULONG   search_blocks;
+UINT    other_stream_block;
+#endif
 
 
     /* Increment the number of physical sector allocation requests.  */
@@ -113,27 +127,140 @@ UINT    status;
         return(LX_NO_SECTORS);
     }
 
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+    /* Pickup the search for a free physical sector at the block the write stream is filling. If the 
+       stream isn't filling a block, start at the specified block.  */
+    stream =        nor_flash -> lx_nor_flash_write_stream;
+    search_block =  nor_flash -> lx_nor_flash_write_stream_block[stream];
+    if (search_block >= nor_flash -> lx_nor_flash_total_blocks)
+        search_block =  nor_flash -> lx_nor_flash_free_block_search;
+
+    /* Blocks filled by other write streams are skipped during the first pass through the blocks, and are 
+       only used during the second pass if there is no other free physical sector.  */
+    search_blocks =  2 * nor_flash -> lx_nor_flash_total_blocks;
+
+    /* Loop through the blocks to find a free physical sector.  */
+    for (i = 0; i < search_blocks; i++)
+    {
+
+        /* Determine if another write stream is filling this block during the first pass.  */
+        other_stream_block =  LX_FALSE;
+        for (j = 0; (i < nor_flash -> lx_nor_flash_total_blocks) && (j < LX_NOR_WRITE_STREAMS); j++)
+        {
+            if ((j != stream) && (nor_flash -> lx_nor_flash_write_stream_block[j] == search_block))
+                other_stream_block =  LX_TRUE;
+        }
+#else
+
     /* Pickup the search for a free physical sector at the specified block.  */
     search_block =  nor_flash -> lx_nor_flash_free_block_search;
 
     /* Loop through the blocks to find a free physical sector.  */
     for (i = 0; i < nor_flash -> lx_nor_flash_total_blocks; i++)
     {
+#endif
 
         /* Setup the block word pointer to the first word of the search block.  */
         block_word_ptr =  nor_flash -> lx_nor_flash_base_address + (search_block * nor_flash -> lx_nor_flash_words_per_block);
 
-        /* Find the first free physical sector from the free sector bit map of this block.  */
-        for (j = 0; j < nor_flash -> lx_nor_flash_block_bit_map_words; j++)
+        /* Default to no free physical sector in this block.  */
+        free_sector =  nor_flash -> lx_nor_flash_physical_sectors_per_block;
+        block_word =   0;
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+        /* Determine if the block summary is enabled.  */
+        if (nor_flash -> lx_nor_flash_block_summary_enabled)
         {
+
+            /* Yes, pickup the next free physical sector of this block from the block summary. Free sectors are 
+               allocated in order, so all the sectors before it are in use and all the sectors after it are free.  */
+            free_sector =  (ULONG) nor_flash -> lx_nor_flash_block_summary[search_block].lx_nor_flash_block_summary_next_free_sector;
+
+            /* Is there a free sector in this block?  */
+            if (free_sector < nor_flash -> lx_nor_flash_physical_sectors_per_block)
+            {
+
+                /* Yes, build the free sector bit map word of this sector without reading it from the flash.  */
+                block_word =  (ULONG) (LX_ALL_ONES << (free_sector & 31));
+
+                /* Determine if this is the last word of the free sector bit map.  */
+                if ((free_sector >> 5) == (nor_flash -> lx_nor_flash_block_bit_map_words - 1))
+                {
+
+                    /* Yes, apply the mask of the valid sectors in the last word.  */
+                    block_word =  block_word & nor_flash -> lx_nor_flash_block_bit_map_mask;
+                }
+            }
+        }
+        else
+#endif
+        {
+
+            /* Find the first free physical sector from the free sector bit map of this block.  */
+            for (j = 0; j < nor_flash -> lx_nor_flash_block_bit_map_words; j++)
+            {
                 
-            /* Read this word of the free sector bit map.  */
+                /* Read this word of the free sector bit map.  */
 #ifdef LX_DIRECT_READ
         
-            /* Read the word directly.  */
-            block_word =  *(block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j);
+                /* Read the word directly.  */
+                block_word =  *(block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j);
 #else
-            status =  _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
+                status =  _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
+
+                /* Check for an error from flash driver. Drivers should never return an error..  */
+                if (status)
+                {
+        
+                    /* Call system error handler.  */
+                    _lx_nor_flash_system_error(nor_flash, status);
+                
+                    /* Return the error.  */
+                    return(status);
+                }
+#endif
+                    
+                /* Are there any free sectors in this word?  */
+                if (block_word)
+                {
+
+                    /* Yes, the lowest set bit is the first free sector in this word.  */
+#ifdef LX_NOR_FLASH_FIRST_SET_BIT
+                    k =  LX_NOR_FLASH_FIRST_SET_BIT(block_word);
+#else
+                    k =  0;
+                    while ((block_word & (((ULONG) 1) << k)) == 0)
+                    {
+                        k++;
+                    }
+#endif
+                    free_sector =  (j * 32) + k;
+                    break;
+                }
+            }
+        }
+
+        /* Is there a free sector in this block? Sectors of the block being reclaimed are not allocated, 
+           since the block is erased once its mapped sectors have been relocated.  */
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+        if ((free_sector < nor_flash -> lx_nor_flash_physical_sectors_per_block) && (other_stream_block == LX_FALSE) &&
+#else
+        if ((free_sector < nor_flash -> lx_nor_flash_physical_sectors_per_block) &&
+#endif
+            ((nor_flash -> lx_nor_flash_gc_state == LX_NOR_GC_STATE_IDLE) || (search_block != nor_flash -> lx_nor_flash_gc_block)))
+        {
+
+            /* Yes, calculate the word and the bit of this sector in the free sector bit map.  */
+            j =  free_sector >> 5;
+            k =  free_sector & 31;
+
+            /* Clear the bit associated with the free sector to indicate it is not free.  */
+            block_word =  block_word & ~(((ULONG) 1) << k);
+                        
+            /* Now write back free bit map word with the bit for this sector cleared.  */
+            status =  _lx_nor_flash_driver_write(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
 
             /* Check for an error from flash driver. Drivers should never return an error..  */
             if (status)
@@ -141,182 +268,141 @@ UINT    status;
         
                 /* Call system error handler.  */
                 _lx_nor_flash_system_error(nor_flash, status);
-                
+
                 /* Return the error.  */
                 return(status);
             }
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+            /* Determine if the block summary is enabled.  */
+            if (nor_flash -> lx_nor_flash_block_summary_enabled)
+            {
+
+                /* Yes, move the next free sector of this block forward.  */
+                nor_flash -> lx_nor_flash_block_summary[search_block].lx_nor_flash_block_summary_next_free_sector++;
+            }
 #endif
-                    
-            /* Are there any free sectors in this word?  */
-            if (block_word)
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+            /* Remember the block this write stream is filling.  */
+            nor_flash -> lx_nor_flash_write_stream_block[stream] =  search_block;
+#endif
+
+            /* Determine if this is the last entry available in this block.  */
+            if (free_sector == (nor_flash -> lx_nor_flash_physical_sectors_per_block - 1))
             {
-            
-                /* Yes, there are free sectors in this word.  */
-                for (k = 0; k < 32; k++)
-                {
-                    
-                    /* Is this sector free?  */
-                    if (block_word & 1)
-                    {
-                        
-                        /* Yes, this sector is free, clear the bit for this sector in the free sector map.  */
                         
-                        /* Read this word of the free sector bit map again.  */
+                /* This is the last physical sector in the block.  Now we need to calculate the minimum valid logical
+                   sector and the maximum valid logical sector.  */
+
+                /* Setup the minimum and maximum logical sectors to the current logical sector.  */
+                min_logical_sector =  logical_sector;
+                max_logical_sector =  logical_sector;
+                   
+                /* Setup a pointer to the mapped list.  */
+                list_word_ptr =  block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset;
+
+                /* Loop to search the mapped list.  */
+                for (l = 0; l < nor_flash -> lx_nor_flash_physical_sectors_per_block; l++)
+                {
+
+                    /* Read the mapped sector entry.  */
 #ifdef LX_DIRECT_READ
         
-                        /* Read the word directly.  */
-                        block_word =  *(block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j);
+                    /* Read the word directly.  */
+                    list_word =  *(list_word_ptr);
 #else
-                        status =  _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
-
-                        /* Check for an error from flash driver. Drivers should never return an error..  */
-                        if (status)
-                        {
+                    status =  _lx_nor_flash_driver_read(nor_flash, list_word_ptr, &list_word, 1);
+                    
+                    /* Check for an error from flash driver. Drivers should never return an error..  */
+                    if (status)
+                    {
         
-                            /* Call system error handler.  */
-                            _lx_nor_flash_system_error(nor_flash, status);
+                        /* Call system error handler.  */
+                        _lx_nor_flash_system_error(nor_flash, status);
 
-                            /* Return the error.  */
-                            return(status);
-                        }
+                        /* Return the error.  */
+                        return(status);
+                    }
 #endif
-                        
-                        /* Clear the bit associated with the free sector to indicate it is not free.  */
-                        block_word =  block_word & ~(((ULONG) 1) << k);
-                        
-                        /* Now write back free bit map word with the bit for this sector cleared.  */
-                        status =  _lx_nor_flash_driver_write(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
 
-                        /* Check for an error from flash driver. Drivers should never return an error..  */
-                        if (status)
-                        {
-        
-                            /* Call system error handler.  */
-                            _lx_nor_flash_system_error(nor_flash, status);
+                    /* Is this entry valid?  */
+                    if (list_word & LX_NOR_PHYSICAL_SECTOR_VALID)
+                    {
 
-                            /* Return the error.  */
-                            return(status);
-                        }
+                        /* Isolate the logical sector.  */
+                        list_word =  list_word & LX_NOR_LOGICAL_SECTOR_MASK;
 
-                        /* Determine if this is the last entry available in this block.  */
-                        if (((block_word >> 1) == 0) && (j == (nor_flash -> lx_nor_flash_block_bit_map_words - 1)))
+                        /* Determine if a new minimum has been found.  */
+                        if (list_word < min_logical_sector)
+                            min_logical_sector =  list_word;
+    
+                        /* Determine if a new maximum has been found.  */
+                        if (list_word != LX_NOR_LOGICAL_SECTOR_MASK)
                         {
-                        
-                            /* This is the last physical sector in the block.  Now we need to calculate the minimum valid logical
-                               sector and the maximum valid logical sector.  */
-
-                            /* Setup the minimum and maximum logical sectors to the current logical sector.  */
-                            min_logical_sector =  logical_sector;
-                            max_logical_sector =  logical_sector;
-                               
-                            /* Setup a pointer to the mapped list.  */
-                            list_word_ptr =  block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset;
-
-                            /* Loop to search the mapped list.  */
-                            for (l = 0; l < nor_flash -> lx_nor_flash_physical_sectors_per_block; l++)
-                            {
+                            if (list_word > max_logical_sector)
+                                max_logical_sector =  list_word;                    
+                        }
+                    }
 
-                                /* Read the mapped sector entry.  */
-#ifdef LX_DIRECT_READ
-        
-                                /* Read the word directly.  */
-                                list_word =  *(list_word_ptr);
-#else
-                                status =  _lx_nor_flash_driver_read(nor_flash, list_word_ptr, &list_word, 1);
-                                
-                                /* Check for an error from flash driver. Drivers should never return an error..  */
-                                if (status)
-                                {
-        
-                                    /* Call system error handler.  */
-                                    _lx_nor_flash_system_error(nor_flash, status);
+                    /* Move the list pointer ahead.  */
+                    list_word_ptr++;
+                }
+                
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
 
-                                    /* Return the error.  */
-                                    return(status);
-                                }
+                /* The block is full, so the write stream needs another block for its next sector.  */
+                nor_flash -> lx_nor_flash_write_stream_block[stream] =  nor_flash -> lx_nor_flash_total_blocks;
 #endif
-            
-                                /* Is this entry valid?  */
-                                if (list_word & LX_NOR_PHYSICAL_SECTOR_VALID)
-                                {
-
-                                    /* Isolate the logical sector.  */
-                                    list_word =  list_word & LX_NOR_LOGICAL_SECTOR_MASK;
 
-                                    /* Determine if a new minimum has been found.  */
-                                    if (list_word < min_logical_sector)
-                                        min_logical_sector =  list_word;
+                /* Move the search pointer forward, since we know this block is exhausted.  */
+                search_block++;
+                
+                /* Check for wrap condition on the search block.  */
+                if (search_block >= nor_flash -> lx_nor_flash_total_blocks)
+                {
                 
-                                    /* Determine if a new maximum has been found.  */
-                                    if (list_word != LX_NOR_LOGICAL_SECTOR_MASK)
-                                    {
-                                        if (list_word > max_logical_sector)
-                                            max_logical_sector =  list_word;                    
-                                    }
-                                }
-
-                                /* Move the list pointer ahead.  */
-                                list_word_ptr++;
-                            }
-                            
-                            /* Move the search pointer forward, since we know this block is exhausted.  */
-                            search_block++;
-                            
-                            /* Check for wrap condition on the search block.  */
-                            if (search_block >= nor_flash -> lx_nor_flash_total_blocks)
-                            {
-                            
-                                /* Reset search block to the beginning.  */
-                                search_block =  0;
-                            }
-                            
-                            /* Now write the minimum and maximum logical sector in this block.  */
-                            status =  _lx_nor_flash_driver_write(nor_flash, block_word_ptr + LX_NOR_FLASH_MIN_LOGICAL_SECTOR_OFFSET, &min_logical_sector, 1);
-
-                            /* Check for an error from flash driver. Drivers should never return an error..  */
-                            if (status)
-                            {
+                    /* Reset search block to the beginning.  */
+                    search_block =  0;
+                }
+                
+                /* Now write the minimum and maximum logical sector in this block.  */
+                status =  _lx_nor_flash_driver_write(nor_flash, block_word_ptr + LX_NOR_FLASH_MIN_LOGICAL_SECTOR_OFFSET, &min_logical_sector, 1);
+
+                /* Check for an error from flash driver. Drivers should never return an error..  */
+                if (status)
+                {
         
-                                /* Call system error handler.  */
-                                _lx_nor_flash_system_error(nor_flash, status);
-
-                                /* Return the error.  */
-                                return(status);
-                            }
-                            
-                            status =  _lx_nor_flash_driver_write(nor_flash, block_word_ptr + LX_NOR_FLASH_MAX_LOGICAL_SECTOR_OFFSET, &max_logical_sector, 1);
-
-                            /* Check for an error from flash driver. Drivers should never return an error..  */
-                            if (status)
-                            {
+                    /* Call system error handler.  */
+                    _lx_nor_flash_system_error(nor_flash, status);
+
+                    /* Return the error.  */
+                    return(status);
+                }
+                
+                status =  _lx_nor_flash_driver_write(nor_flash, block_word_ptr + LX_NOR_FLASH_MAX_LOGICAL_SECTOR_OFFSET, &max_logical_sector, 1);
+
+                /* Check for an error from flash driver. Drivers should never return an error..  */
+                if (status)
+                {
         
-                                /* Call system error handler.  */
-                                _lx_nor_flash_system_error(nor_flash, status);
+                    /* Call system error handler.  */
+                    _lx_nor_flash_system_error(nor_flash, status);
 
-                                /* Return the error.  */
-                                return(status);
-                            }
-                        }
+                    /* Return the error.  */
+                    return(status);
+                }
+            }
                                                 
-                        /* Remember the block to search.  */
-                        nor_flash -> lx_nor_flash_free_block_search =  search_block;
+            /* Remember the block to search.  */
+            nor_flash -> lx_nor_flash_free_block_search =  search_block;
                                                 
-                        /* Prepare the return information.  */
-                        *physical_sector_map_entry =  block_word_ptr + (nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + (j * 32)) + k;
-                        *physical_sector_address =    block_word_ptr + (nor_flash -> lx_nor_flash_block_physical_sector_offset) + (((j * 32) + k) * LX_NOR_SECTOR_SIZE);
+            /* Prepare the return information.  */
+            *physical_sector_map_entry =  block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + free_sector;
+            *physical_sector_address =    block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_offset + (free_sector * nor_flash -> lx_nor_flash_words_per_sector);
 
-                        /* Return success!  */
-                        return(LX_SUCCESS);                     
-                    }
-                        
-                    /* Shift down the bit map.  */
-                    block_word =  block_word >> 1;
-                    
-                    /* Determine if there are any more bits set? If not, we can break out of the search of this word.  */
-                    if (block_word == 0)
-                        break;
-                }
-            }
+            /* Return success!  */
+            return(LX_SUCCESS);                     
         }
             
         /* Move to the next flash block.  */
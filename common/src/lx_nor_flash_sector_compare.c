@@ -0,0 +1,188 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_compare                        PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function compares the data of a logical sector with the        */ 
+/*    buffer, so a write of the same data can be skipped. The data is     */ 
+/*    compared directly in the flash with LX_DIRECT_READ. Otherwise it is */ 
+/*    taken from the data cache if possible, and read from the flash      */ 
+/*    into the internal sector buffer if not. Fill sectors are always     */ 
+/*    read into the internal sector buffer and expanded there.            */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    logical_sector                        Logical sector number         */ 
+/*    buffer                                Pointer to new sector data    */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                         LX_SUCCESS if the sector is   */ 
+/*                                            mapped with the same data   */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_data_cache_read         Read sector from data cache   */ 
+/*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
+/*    _lx_nor_flash_fill_sector_expand      Expand fill sector data       */ 
+/*    _lx_nor_flash_logical_sector_find     Find logical sector           */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_write                                          */ 
+/*    _lx_nor_flash_sectors_write                                         */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_sector_compare(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer)
+{
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
+
+ULONG   *mapping_address;
+ULONG   *sector_address;
+ULONG   *source_ptr;
+ULONG   *current_ptr;
+ULONG   i;
+#if !defined(LX_DIRECT_READ) || defined(LX_NOR_ENABLE_FILL_PROGRAM_SKIP)
+UINT    status;
+#endif
+
+
+    /* Default to no copy of the sector data.  */
+    current_ptr =  LX_NULL;
+#if defined(LX_NOR_ENABLE_DATA_CACHE) && !defined(LX_DIRECT_READ)
+
+    /* Determine if the sector data is in the data cache, which only holds mapped sectors.  */
+    if (_lx_nor_flash_data_cache_read(nor_flash, logical_sector, nor_flash -> lx_nor_flash_sector_buffer) == LX_SUCCESS)
+    {
+
+        /* Yes, compare with the cached copy.  */
+        current_ptr =  nor_flash -> lx_nor_flash_sector_buffer;
+    }
+#endif
+
+    /* Determine if the sector data still has to be found in the flash.  */
+    if (current_ptr == LX_NULL)
+    {
+
+        /* See if we can find the sector in the current mapping.  */
+        _lx_nor_flash_logical_sector_find(nor_flash, logical_sector, LX_FALSE, &mapping_address, &sector_address);
+
+        /* Determine if the sector is mapped.  */
+        if (mapping_address == LX_NULL)
+        {
+
+            /* No, the sector must be written.  */
+            return(LX_SECTOR_NOT_FOUND);
+        }
+
+#if defined(LX_DIRECT_READ) && !defined(LX_NOR_ENABLE_FILL_PROGRAM_SKIP)
+
+        /* Compare with the sector data directly.  */
+        current_ptr =  sector_address;
+#else
+
+        /* Read the sector data into the internal memory of the NOR flash instance.  */
+        status =  _lx_nor_flash_driver_read(nor_flash, sector_address, nor_flash -> lx_nor_flash_sector_buffer, nor_flash -> lx_nor_flash_words_per_sector);
+
+        /* Check for an error from flash driver.  */
+        if (status)
+        {
+
+            /* Return the error, the sector must be written.  */
+            return(status);
+        }
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+        /* Expand the fill word of a fill sector, which can't be compared directly in the flash.  */
+        status =  _lx_nor_flash_fill_sector_expand(nor_flash, mapping_address, nor_flash -> lx_nor_flash_sector_buffer);
+
+        /* Check for an error from flash driver.  */
+        if (status)
+        {
+
+            /* Return the error, the sector must be written.  */
+            return(status);
+        }
+#endif
+
+        /* Compare with the sector data in the internal memory.  */
+        current_ptr =  nor_flash -> lx_nor_flash_sector_buffer;
+#endif
+    }
+
+    /* Loop to compare the sector data.  */
+    source_ptr =  (ULONG *) buffer;
+    for (i = 0; i < nor_flash -> lx_nor_flash_words_per_sector; i++)
+    {
+
+        /* Determine if this word is different.  */
+        if (source_ptr[i] != current_ptr[i])
+        {
+
+            /* Yes, the sector must be written.  */
+            return(LX_ERROR);
+        }
+    }
+
+    /* Return success, the sector already holds the data.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(logical_sector);
+    LX_PARAMETER_NOT_USED(buffer);
+
+    /* Return an error, the sector must be written.  */
+    return(LX_ERROR);
+#endif
+}
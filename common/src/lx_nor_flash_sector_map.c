@@ -0,0 +1,262 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_sector_map                            PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function maps a logical sector to a new physical sector, once  */
+/*    the sector data and the new mapping entry are written. The mapping  */
+/*    entry is written with the mapping not valid bit set. The old        */
+/*    mapping is superceded first, then the new mapping is made valid and */
+/*    the old physical sector is obsoleted, so the flash opens with       */
+/*    either mapping after a power interruption. The caches and the       */
+/*    sector counts of the NOR flash instance are updated as well.        */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Logical sector number         */
+/*    old_mapping_address                   Address of the old mapping    */
+/*                                            entry, NULL if not mapped   */
+/*    new_mapping_address                   Address of the new mapping    */
+/*                                            entry                       */
+/*    new_sector_address                    Address of the new sector     */
+/*    new_mapping_entry                     New mapping entry as written  */
+/*    buffer                                Pointer to the sector data    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_driver_write            Driver flash sector write     */
+/*    _lx_nor_flash_driver_read             Driver flash sector read      */
+/*    _lx_nor_flash_sector_mapping_cache_insert                           */
+/*                                          Place sector in mapping cache */
+/*    _lx_nor_flash_sector_mapping_cache_invalidate                       */
+/*                                          Invalidate cache entry        */
+/*    _lx_nor_flash_logical_sector_index_update                           */
+/*                                          Update logical sector index   */
+/*    _lx_nor_flash_block_summary_update    Update block summary          */
+/*    _lx_nor_flash_data_cache_write        Place sector in data cache    */
+/*    _lx_nor_flash_system_error            Internal system error handler */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    _lx_nor_flash_sector_write                                          */
+/*    _lx_nor_flash_sectors_write                                         */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_sector_map(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG *old_mapping_address, ULONG *new_mapping_address, ULONG *new_sector_address, ULONG new_mapping_entry, VOID *buffer)
+{
+
+ULONG                           old_mapping_entry;
+UINT                            status;
+#ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
+ULONG                           block;
+#endif
+
+#ifndef LX_NOR_ENABLE_DATA_CACHE
+    LX_PARAMETER_NOT_USED(buffer);
+#endif
+
+    /* Was there a previously mapped sector?  */
+    old_mapping_entry =  0;
+    if (old_mapping_address)
+    {
+
+        /* Now deprecate the old sector mapping.  */
+
+        /* Read in the old sector mapping.  */
+#ifdef LX_DIRECT_READ
+
+        /* Read the word directly.  */
+        old_mapping_entry =  *(old_mapping_address);
+#else
+        status =  _lx_nor_flash_driver_read(nor_flash, old_mapping_address, &old_mapping_entry, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return status.  */
+            return(LX_ERROR);
+        }
+#endif
+
+        /* Clear bit 30, which indicates this sector is superceded.  */
+        old_mapping_entry =  old_mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED);
+
+        /* Write the value back to the flash to clear bit 30.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, old_mapping_address, &old_mapping_entry, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return status.  */
+            return(LX_ERROR);
+        }
+    }
+
+    /* Now clear the not valid bit to make this sector mapping valid.  This is done because the writing of the extra bytes itself can
+       be interrupted and we need to make sure this can be detected when the flash is opened again.  */
+    new_mapping_entry =  new_mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID);
+
+    /* Clear the not valid bit.  */
+    status =  _lx_nor_flash_driver_write(nor_flash, new_mapping_address, &new_mapping_entry, 1);
+
+    /* Check for an error from flash driver. Drivers should never return an error..  */
+    if (status)
+    {
+
+        /* Call system error handler.  */
+        _lx_nor_flash_system_error(nor_flash, status);
+
+        /* Return status.  */
+        return(LX_ERROR);
+    }
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+#ifdef LX_NOR_ENABLE_MAPPING_BITMAP
+
+    /* Determine if the logical sector is within the mapping bitmap.  */
+    if (logical_sector < nor_flash -> lx_nor_flash_extended_cache_mapping_bitmap_max_logical_sector)
+    {
+
+        /* Set the bit in the mapping bitmap.  */
+        nor_flash -> lx_nor_flash_extended_cache_mapping_bitmap[logical_sector >> 5] |= (ULONG)(1 << (logical_sector & 31));
+    }
+#endif
+#endif
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+    /* Update the logical sector index with the new mapping.  */
+    _lx_nor_flash_logical_sector_index_update(nor_flash, logical_sector, new_mapping_address);
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+    /* Update the block summary with the new mapping.  */
+    _lx_nor_flash_block_summary_update(nor_flash, new_mapping_address, LX_FALSE);
+#endif
+
+    /* Increment the number of mapped physical sectors.  */
+    nor_flash -> lx_nor_flash_mapped_physical_sectors++;
+
+    /* Was there a previously mapped sector?  */
+    if (old_mapping_address)
+    {
+
+        /* Now clear bit 31, which indicates this sector is now obsoleted.  */
+        old_mapping_entry =  old_mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID);
+
+        /* Write the value back to the flash to clear bit 31.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, old_mapping_address, &old_mapping_entry, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+
+            /* Call system error handler.  */
+            _lx_nor_flash_system_error(nor_flash, status);
+
+            /* Return status.  */
+            return(LX_ERROR);
+        }
+
+        /* Increment the number of obsolete physical sectors.  */
+        nor_flash -> lx_nor_flash_obsolete_physical_sectors++;
+
+#ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
+
+        /* Get the block number from mapping address.  */
+        block = (ULONG)(old_mapping_address - nor_flash -> lx_nor_flash_base_address) / nor_flash -> lx_nor_flash_words_per_block;
+
+        /* Determine if this block is within the range of the obsolete count cache.  */
+        if (block < nor_flash -> lx_nor_flash_extended_cache_obsolete_count_max_block)
+        {
+
+            /* Increment the obsolete count for this block.  */
+            nor_flash -> lx_nor_flash_extended_cache_obsolete_count[block] ++;
+        }
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+        /* Update the block summary with the obsoleted sector.  */
+        _lx_nor_flash_block_summary_update(nor_flash, old_mapping_address, LX_TRUE);
+#endif
+
+        /* Decrement the number of mapped physical sectors.  */
+        nor_flash -> lx_nor_flash_mapped_physical_sectors--;
+
+        /* Invalidate the old sector mapping cache entry.  */
+        _lx_nor_flash_sector_mapping_cache_invalidate(nor_flash, logical_sector);
+    }
+
+    /* Place this sector information in the sector mapping cache.  */
+    _lx_nor_flash_sector_mapping_cache_insert(nor_flash, logical_sector, new_mapping_address, new_sector_address);
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+    /* Place a copy of the new sector data in the data cache.  */
+    _lx_nor_flash_data_cache_write(nor_flash, logical_sector, buffer, LX_TRUE);
+#endif
+
+    /* Return success.  */
+    return(LX_SUCCESS);
+}
@@ -0,0 +1,137 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_sector_mapping_cache_find             PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function looks up the logical sector in the sector mapping     */
+/*    cache and returns the cached mapping entry and sector address.      */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Logical sector number         */
+/*    physical_sector_map_entry             Destination for physical      */
+/*                                            sector map entry address    */
+/*    physical_sector_address               Destination for physical      */
+/*                                            sector data                 */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_sector_mapping_cache_update                           */
+/*                                          Update replacement state      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_sector_mapping_cache_find(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG **physical_sector_map_entry, ULONG **physical_sector_address)
+{
+
+ULONG   index;
+ULONG   tag;
+ULONG   *tags;
+ULONG   i;
+
+
+    /* Determine if the sector mapping cache is enabled.  */
+    if (nor_flash -> lx_nor_flash_sector_mapping_cache_enabled == LX_FALSE)
+    {
+
+        /* No, the sector can't be in the cache.  */
+        return(LX_SECTOR_NOT_FOUND);
+    }
+
+    /* Calculate the starting index of the sector mapping cache for this sector entry.  */
+    index =  (logical_sector & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) * LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
+
+    /* Build the tag of this sector and a pointer to the tags of the set.  */
+    tag =   logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID;
+    tags =  &nor_flash -> lx_nor_flash_sector_mapping_cache_tags[index];
+
+    /* Search the tags of the set for the sector.  */
+    for (i = 0; i < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; i++)
+    {
+
+        /* Is the sector in this way?  */
+        if (tags[i] == tag)
+        {
+
+            /* Increment the sector mapping cache hit counter.  */
+            nor_flash -> lx_nor_flash_sector_mapping_cache_hits++;
+
+            /* Yes, return the cached values associated with the sector.  */
+            *physical_sector_map_entry =  nor_flash -> lx_nor_flash_sector_mapping_cache[index + i].lx_nor_sector_mapping_cache_physical_sector_map_entry;
+            *physical_sector_address =    nor_flash -> lx_nor_flash_sector_mapping_cache[index + i].lx_nor_sector_mapping_cache_physical_sector_address;
+
+            /* Update the replacement state of the set.  */
+            _lx_nor_flash_sector_mapping_cache_update(nor_flash, index, i, LX_TRUE);
+
+            /* Return a successful status.  */
+            return(LX_SUCCESS);
+        }
+    }
+
+    /* If we get here, we have a cache miss so increment the counter.  */
+    nor_flash -> lx_nor_flash_sector_mapping_cache_misses++;
+
+    /* Trace the cache miss.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_CACHE_MISS, LX_TRACE_CACHE_SECTOR_MAPPING, logical_sector);
+
+    /* Return sector not found status.  */
+    return(LX_SECTOR_NOT_FOUND);
+}
+
@@ -0,0 +1,191 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_sector_mapping_cache_insert           PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function places the mapping of the logical sector in the       */
+/*    sector mapping cache. An unused way of the set is taken first,      */
+/*    otherwise the way selected by the replacement policy is replaced.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Logical sector number         */
+/*    physical_sector_map_entry             Physical sector map entry     */
+/*    physical_sector_address               Physical sector address       */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_sector_mapping_cache_update                           */
+/*                                          Update replacement state      */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_sector_mapping_cache_insert(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG *physical_sector_map_entry, ULONG *physical_sector_address)
+{
+
+ULONG   index;
+ULONG   tag;
+ULONG   *tags;
+UCHAR   *state;
+ULONG   way;
+ULONG   i;
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY == LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK
+ULONG   hand;
+#else
+ULONG   rank;
+ULONG   victim_rank;
+#endif
+
+
+    /* Determine if the sector mapping cache is enabled.  */
+    if (nor_flash -> lx_nor_flash_sector_mapping_cache_enabled == LX_FALSE)
+    {
+
+        /* No, nothing to do.  */
+        return;
+    }
+
+    /* Calculate the starting index of the sector mapping cache for this sector entry.  */
+    index =  (logical_sector & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) * LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
+
+    /* Build the tag of this sector and pointers to the tags and the replacement state of the set.  */
+    tag =    logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID;
+    tags =   &nor_flash -> lx_nor_flash_sector_mapping_cache_tags[index];
+    state =  &nor_flash -> lx_nor_flash_sector_mapping_cache_state[index];
+
+    /* Look for the sector or the first unused way in the set.  */
+    way =  LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
+    for (i = 0; i < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; i++)
+    {
+
+        /* Is the sector already in this way?  */
+        if (tags[i] == tag)
+        {
+
+            /* Yes, replace the mapping in this way.  */
+            way =  i;
+            break;
+        }
+
+        /* Is this the first unused way?  */
+        if ((tags[i] == 0) && (way == LX_NOR_SECTOR_MAPPING_CACHE_DEPTH))
+        {
+
+            /* Yes, remember it.  */
+            way =  i;
+        }
+    }
+
+    /* Determine if a way must be replaced.  */
+    if (way == LX_NOR_SECTOR_MAPPING_CACHE_DEPTH)
+    {
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY == LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK
+
+        /* Advance the clock hand of this set past the referenced ways, clearing their reference bits.  */
+        hand =  (ULONG) nor_flash -> lx_nor_flash_sector_mapping_cache_clock_hand[index / LX_NOR_SECTOR_MAPPING_CACHE_DEPTH];
+        while (state[hand])
+        {
+
+            /* Give this way a second chance.  */
+            state[hand] =  0;
+            hand =  (hand + 1) % LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
+        }
+
+        /* Replace the way under the clock hand and move the hand past it.  */
+        way =  hand;
+        nor_flash -> lx_nor_flash_sector_mapping_cache_clock_hand[index / LX_NOR_SECTOR_MAPPING_CACHE_DEPTH] =  (UCHAR) ((hand + 1) % LX_NOR_SECTOR_MAPPING_CACHE_DEPTH);
+#else
+
+        /* Replace the least recently used way. For 2Q, probationary ways are replaced before protected ways.  */
+        way =          0;
+        victim_rank =  0;
+        for (i = 0; i < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; i++)
+        {
+
+            /* Pickup the rank of this way.  */
+            rank =  (ULONG) (state[i] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK);
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY == LX_NOR_SECTOR_MAPPING_CACHE_POLICY_2Q
+
+            /* Rank probationary ways after all protected ways.  */
+            if ((state[i] & LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED) == 0)
+                rank =  rank + LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
+#endif
+
+            /* Is this the least recently used way so far?  */
+            if (rank >= victim_rank)
+            {
+
+                /* Yes, remember it.  */
+                way =          i;
+                victim_rank =  rank;
+            }
+        }
+#endif
+    }
+
+    /* Update the replacement state of the set for the new sector.  */
+    _lx_nor_flash_sector_mapping_cache_update(nor_flash, index, way, LX_FALSE);
+
+    /* Setup the new sector information in the cache.  */
+    tags[way] =  tag;
+    nor_flash -> lx_nor_flash_sector_mapping_cache[index + way].lx_nor_sector_mapping_cache_physical_sector_map_entry =  physical_sector_map_entry;
+    nor_flash -> lx_nor_flash_sector_mapping_cache[index + way].lx_nor_sector_mapping_cache_physical_sector_address =    physical_sector_address;
+}
+
@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_sector_mapping_cache_invalidate       PORTABLE C      */ 
-/*                                                           6.1.7        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -47,7 +47,7 @@
 /*  DESCRIPTION                                                           */ 
 /*                                                                        */ 
 /*    This function invalidates the sector's entry in the NOR flash       */ 
-/*    cache.                                                              */ 
+/*    sector mapping cache.                                               */ 
 /*                                                                        */ 
 /*  INPUT                                                                 */ 
 /*                                                                        */ 
@@ -75,13 +75,25 @@
 /*                                            resulting in version 6.1    */
 /*  06-02-2021     Bhupendra Naphade        Modified comment(s),          */
 /*                                            resulting in version 6.1.7  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            supported configurable      */
+/*                                            depth and replacement       */
+/*                                            policy,                     */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 VOID  _lx_nor_flash_sector_mapping_cache_invalidate(LX_NOR_FLASH *nor_flash, ULONG logical_sector)
 {
 
-ULONG                           i;
-LX_NOR_SECTOR_MAPPING_CACHE_ENTRY  *sector_mapping_cache_entry_ptr;
+ULONG   index;
+ULONG   tag;
+ULONG   *tags;
+UCHAR   *state;
+ULONG   i;
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY != LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK
+ULONG   rank;
+ULONG   j;
+#endif
 
 
     /* Determine if the sector mapping cache is enabled.  */
@@ -89,48 +101,36 @@ LX_NOR_SECTOR_MAPPING_CACHE_ENTRY  *sector_mapping_cache_entry_ptr;
     {
     
         /* Calculate the starting index of the sector mapping cache for this sector entry.  */
-        i =  (logical_sector & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) * LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
-
-        /* Build a pointer to the cache entry.  */
-        sector_mapping_cache_entry_ptr =  &nor_flash -> lx_nor_flash_sector_mapping_cache[i];
+        index =  (logical_sector & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) * LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
 
-        /* Determine if the sector is in the sector mapping cache - assuming the depth of the sector 
-           mapping cache is LX_NOR_SECTOR_MAPPING_CACHE_DEPTH entries.  */
-        if ((sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_logical_sector) == (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID))
-        {
-
-            /* Move all cache entries up and invalidate the last entry.  */
-            *(sector_mapping_cache_entry_ptr) =      *(sector_mapping_cache_entry_ptr + 1);
-            *(sector_mapping_cache_entry_ptr + 1) =  *(sector_mapping_cache_entry_ptr + 2);
-            *(sector_mapping_cache_entry_ptr + 2) =  *(sector_mapping_cache_entry_ptr + 3);
-            
-            /* Invalidate the last entry.  */
-            (sector_mapping_cache_entry_ptr + 3) -> lx_nor_sector_mapping_cache_logical_sector =   0;
-        }
-        else if (((sector_mapping_cache_entry_ptr + 1) -> lx_nor_sector_mapping_cache_logical_sector) == (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID))
-        {
+        /* Build the tag of this sector and pointers to the tags and the replacement state of the set.  */
+        tag =    logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID;
+        tags =   &nor_flash -> lx_nor_flash_sector_mapping_cache_tags[index];
+        state =  &nor_flash -> lx_nor_flash_sector_mapping_cache_state[index];
 
-            /* Move all subsequent cache entries up and invalidate the last entry.  */
-            *(sector_mapping_cache_entry_ptr + 1) =  *(sector_mapping_cache_entry_ptr + 2);
-            *(sector_mapping_cache_entry_ptr + 2) =  *(sector_mapping_cache_entry_ptr + 3);
-            
-            /* Invalidate the last entry.  */
-            (sector_mapping_cache_entry_ptr + 3) -> lx_nor_sector_mapping_cache_logical_sector =   0;
-        }
-        else if (((sector_mapping_cache_entry_ptr + 2) -> lx_nor_sector_mapping_cache_logical_sector) == (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID))
+        /* Search the tags of the set for the sector.  */
+        for (i = 0; i < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; i++)
         {
 
-            /* Move all subsequent cache entries up and invalidate the last entry.  */
-            *(sector_mapping_cache_entry_ptr + 2) =  *(sector_mapping_cache_entry_ptr + 3);
-            
-            /* Invalidate the last entry.  */
-            (sector_mapping_cache_entry_ptr + 3) -> lx_nor_sector_mapping_cache_logical_sector =   0;
-        }
-        else if (((sector_mapping_cache_entry_ptr + 3) -> lx_nor_sector_mapping_cache_logical_sector) == (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID))
-        {
+            /* Is the sector in this way?  */
+            if (tags[i] == tag)
+            {
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY != LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK
+
+                /* Move the used ways ranked after this way up one rank.  */
+                rank =  (ULONG) (state[i] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK);
+                for (j = 0; j < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; j++)
+                {
+                    if ((tags[j]) && ((ULONG) (state[j] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK) > rank))
+                        state[j]--;
+                }
+#endif
 
-            /* Simply invalidate the last entry.  */
-            (sector_mapping_cache_entry_ptr + 3) -> lx_nor_sector_mapping_cache_logical_sector =   0;
+                /* Invalidate this way.  */
+                tags[i] =   0;
+                state[i] =  0;
+                break;
+            }
         }
     }
 }
@@ -0,0 +1,174 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_sector_mapping_cache_update           PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function updates the replacement state of a set in the sector  */
+/*    mapping cache when a way is found in the cache or is about to be    */
+/*    replaced with a new sector. The entries of the set are not moved.   */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    index                                 Index of the first way of set */
+/*    way                                   Way within the set            */
+/*    cache_hit                             LX_TRUE if the way was found  */
+/*                                            in the cache, LX_FALSE if   */
+/*                                            it is replaced              */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    None                                                                */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Internal LevelX                                                     */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_sector_mapping_cache_update(LX_NOR_FLASH *nor_flash, ULONG index, ULONG way, UINT cache_hit)
+{
+
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY == LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK
+
+    /* Set the reference bit of this way when it is found in the cache. New sectors start without the 
+       reference bit, so they are replaced before sectors that have been used again.  */
+    nor_flash -> lx_nor_flash_sector_mapping_cache_state[index + way] =  (UCHAR) ((cache_hit) ? 1 : 0);
+#else
+
+ULONG   *tags;
+UCHAR   *state;
+ULONG   rank;
+ULONG   i;
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY == LX_NOR_SECTOR_MAPPING_CACHE_POLICY_2Q
+ULONG   protected_ways;
+ULONG   demote_way;
+#endif
+
+
+    /* Setup pointers to the tags and the replacement state of this set.  */
+    tags =   &nor_flash -> lx_nor_flash_sector_mapping_cache_tags[index];
+    state =  &nor_flash -> lx_nor_flash_sector_mapping_cache_state[index];
+
+    /* Pickup the rank of this way. An unused way is ranked after all the used ways.  */
+    if (tags[way])
+        rank =  (ULONG) (state[way] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK);
+    else
+        rank =  LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
+
+    /* Age the used ways that were used more recently than this way.  */
+    for (i = 0; i < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; i++)
+    {
+
+        /* Is this a used way ranked before this way?  */
+        if ((i != way) && (tags[i]) && ((ULONG) (state[i] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK) < rank))
+        {
+
+            /* Yes, move it down one rank.  */
+            state[i]++;
+        }
+    }
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY == LX_NOR_SECTOR_MAPPING_CACHE_POLICY_2Q
+
+    /* Determine if the way was found in the cache.  */
+    if (cache_hit)
+    {
+
+        /* Yes, the sector has been used again, make it the most recently used protected way.  */
+        state[way] =  LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED;
+
+        /* Count the protected ways and find the least recently used protected way other than this way.  */
+        protected_ways =  0;
+        demote_way =      LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
+        for (i = 0; i < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; i++)
+        {
+
+            /* Is this a used protected way?  */
+            if ((tags[i]) && (state[i] & LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED))
+            {
+
+                /* Yes, count it.  */
+                protected_ways++;
+
+                /* Is this the least recently used protected way so far?  */
+                if ((i != way) && ((demote_way == LX_NOR_SECTOR_MAPPING_CACHE_DEPTH) || (state[i] > state[demote_way])))
+                    demote_way =  i;
+            }
+        }
+
+        /* Determine if there are too many protected ways.  */
+        if ((protected_ways > LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED_WAYS) && (demote_way < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH))
+        {
+
+            /* Yes, move the least recently used protected way back to probation.  */
+            state[demote_way] =  (UCHAR) (state[demote_way] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK);
+        }
+    }
+    else
+    {
+
+        /* New sectors start on probation as the most recently used way.  */
+        state[way] =  0;
+    }
+#else
+
+    LX_PARAMETER_NOT_USED(cache_hit);
+
+    /* Make this way the most recently used way.  */
+    state[way] =  0;
+#endif
+#endif
+}
+
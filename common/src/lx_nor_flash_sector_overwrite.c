@@ -0,0 +1,278 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_overwrite                      PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function overwrites the data of a mapped physical sector in   */ 
+/*    place, if the new data only clears bits of the current data. Only   */ 
+/*    the words that change are programmed and the sector mapping stays   */ 
+/*    the same. If a bit would have to be set, or if the block of the     */ 
+/*    sector is being reclaimed, the sector isn't changed and the write   */ 
+/*    has to be done to a new physical sector. A fill sector is compared  */ 
+/*    with its fill word and becomes a regular sector once all its data   */ 
+/*    is programmed.                                                      */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    physical_sector_map_entry             Address of the mapping entry  */ 
+/*    physical_sector_address               Address of the mapped sector  */ 
+/*    buffer                                Pointer to new sector data    */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
+/*    _lx_nor_flash_driver_write            Driver flash sector write     */ 
+/*    _lx_nor_flash_fill_sector_check       Check for fill sector data    */ 
+/*    _lx_nor_flash_shared_read_wait        Wait for shared reads         */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_write                                          */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_sector_overwrite(LX_NOR_FLASH *nor_flash, ULONG *physical_sector_map_entry, ULONG *physical_sector_address, VOID *buffer)
+{
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+
+ULONG   *source_ptr;
+ULONG   *current_ptr;
+ULONG   block;
+ULONG   first_word;
+ULONG   last_word;
+ULONG   current_word;
+ULONG   i;
+UINT    status;
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+ULONG   mapping_entry;
+UINT    fill_cleared;
+#endif
+
+
+    /* Calculate the block of the physical sector.  */
+    block =  (ULONG) (physical_sector_address - nor_flash -> lx_nor_flash_base_address) / nor_flash -> lx_nor_flash_words_per_block;
+
+    /* Determine if the block is being reclaimed. The reclaim may have copied the sector already, and it only 
+       detects a change of the sector from its mapping entry.  */
+    if ((nor_flash -> lx_nor_flash_gc_state != LX_NOR_GC_STATE_IDLE) && (block == nor_flash -> lx_nor_flash_gc_block))
+    {
+
+        /* Yes, the sector must be written to a new physical sector.  */
+        return(LX_INVALID_WRITE);
+    }
+#ifndef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+    LX_PARAMETER_NOT_USED(physical_sector_map_entry);
+#else
+
+    /* Read the mapping entry of the sector.  */
+#ifdef LX_DIRECT_READ
+
+    /* Read the word directly.  */
+    mapping_entry =  *(physical_sector_map_entry);
+#else
+    status =  _lx_nor_flash_driver_read(nor_flash, physical_sector_map_entry, &mapping_entry, 1);
+
+    /* Check for an error from flash driver. Drivers should never return an error..  */
+    if (status)
+    {
+
+        /* Return the error.  */
+        return(status);
+    }
+#endif
+#endif
+
+#ifdef LX_DIRECT_READ
+
+    /* Compare with the sector data directly.  */
+    current_ptr =  physical_sector_address;
+#else
+
+    /* Read the current sector data into the internal memory of the NOR flash instance.  */
+    status =  _lx_nor_flash_driver_read(nor_flash, physical_sector_address, nor_flash -> lx_nor_flash_sector_buffer, nor_flash -> lx_nor_flash_words_per_sector);
+
+    /* Check for an error from flash driver. Drivers should never return an error..  */
+    if (status)
+    {
+
+        /* Return the error.  */
+        return(status);
+    }
+
+    /* Compare with the sector data in the internal memory.  */
+    current_ptr =  nor_flash -> lx_nor_flash_sector_buffer;
+#endif
+
+    /* Find the range of words that change, and make sure no bit of them has to be set.  */
+    source_ptr =  (ULONG *) buffer;
+    first_word =  nor_flash -> lx_nor_flash_words_per_sector;
+    last_word =   0;
+    for (i = 0; i < nor_flash -> lx_nor_flash_words_per_sector; i++)
+    {
+
+        /* Pickup the current data of this word.  */
+        current_word =  current_ptr[i];
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+        /* The data of a fill sector is its fill word, the words after it are still erased.  */
+        if (mapping_entry & LX_NOR_PHYSICAL_SECTOR_FILL)
+            current_word =  current_ptr[0];
+#endif
+
+        /* Determine if a bit of this word has to be set, which requires an erase.  */
+        if (source_ptr[i] & ~current_word)
+        {
+
+            /* Yes, the sector must be written to a new physical sector.  */
+            return(LX_INVALID_WRITE);
+        }
+
+        /* Determine if this word has to be programmed.  */
+        if (source_ptr[i] != current_ptr[i])
+        {
+
+            /* Update the range of words that change.  */
+            if (first_word == nor_flash -> lx_nor_flash_words_per_sector)
+                first_word =  i;
+            last_word =  i;
+        }
+    }
+
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+    /* Determine if the sector is a fill sector.  */
+    fill_cleared =  LX_FALSE;
+    if (mapping_entry & LX_NOR_PHYSICAL_SECTOR_FILL)
+    {
+
+        /* Determine if the new data is uniform as well.  */
+        if (_lx_nor_flash_fill_sector_check(nor_flash, buffer) == LX_SUCCESS)
+        {
+
+            /* Yes, the sector stays a fill sector, so only its fill word is programmed.  */
+            if (first_word != 0)
+                first_word =  nor_flash -> lx_nor_flash_words_per_sector;
+            last_word =  0;
+
+            /* Increment the number of fill sector writes.  */
+            nor_flash -> lx_nor_flash_fill_sector_writes++;
+        }
+        else
+        {
+
+            /* No, the sector becomes a regular sector once all its data is programmed.  */
+            fill_cleared =  LX_TRUE;
+        }
+    }
+#endif
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+    /* Wait for shared reads, they may be reading the data of this sector.  */
+    _lx_nor_flash_shared_read_wait(nor_flash);
+#endif
+
+    /* Determine if any word changes.  */
+    if (first_word < nor_flash -> lx_nor_flash_words_per_sector)
+    {
+
+        /* Program the words that change. Bits that are already clear stay clear, so the words in between can be written as well.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, physical_sector_address + first_word, source_ptr + first_word, (last_word - first_word) + 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+
+            /* Return the error.  */
+            return(status);
+        }
+    }
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+    /* Determine if the sector is no longer a fill sector.  */
+    if (fill_cleared)
+    {
+
+        /* Clear the fill bit of the mapping entry, now that all the sector data is programmed.  */
+        mapping_entry =  mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_FILL);
+        status =  _lx_nor_flash_driver_write(nor_flash, physical_sector_map_entry, &mapping_entry, 1);
+
+        /* Check for an error from flash driver. Drivers should never return an error..  */
+        if (status)
+        {
+
+            /* Return the error.  */
+            return(status);
+        }
+    }
+#endif
+
+    /* Increment the number of sectors overwritten in place.  */
+    nor_flash -> lx_nor_flash_in_place_overwrites++;
+
+    /* Return success.  */
+    return(LX_SUCCESS);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(physical_sector_map_entry);
+    LX_PARAMETER_NOT_USED(physical_sector_address);
+    LX_PARAMETER_NOT_USED(buffer);
+
+    /* Return an error, the sector can't be overwritten in place.  */
+    return(LX_INVALID_WRITE);
+#endif
+}
@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_sector_read                           PORTABLE C      */ 
-/*                                                           6.3.0        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -53,7 +53,8 @@
 /*    nor_flash                             NOR flash instance            */ 
 /*    logical_sector                        Logical sector number         */ 
 /*    buffer                                Pointer to buffer to read into*/ 
-/*                                            (the size is 512 bytes)     */ 
+/*                                            (the size is the sector     */
+/*                                             size)                      */
 /*                                                                        */ 
 /*  OUTPUT                                                                */ 
 /*                                                                        */ 
@@ -66,9 +67,18 @@
 /*    _lx_nor_flash_logical_sector_find     Find logical sector           */ 
 /*    _lx_nor_flash_physical_sector_allocate                              */ 
 /*                                          Allocate new logical sector   */ 
+/*    _lx_nor_flash_logical_sector_index_update                           */
+/*                                          Update logical sector index   */
+/*    _lx_nor_flash_block_summary_update    Update block summary          */
+/*    _lx_nor_flash_data_cache_read         Read sector from data cache   */
+/*    _lx_nor_flash_data_cache_write        Place sector in data cache    */
+/*    _lx_nor_flash_fill_sector_expand      Expand fill sector data       */
+/*    _lx_nor_flash_free_sectors_reclaim    Reclaim free sectors          */
+/*    _lx_nor_flash_shared_read_begin       Start a shared read           */
+/*    _lx_nor_flash_shared_read_end         End a shared read             */
 /*    _lx_nor_flash_system_error            Internal system error handler */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -86,6 +96,20 @@
 /*  10-31-2023     Xiuwen Cai               Modified comment(s),          */
 /*                                            added mapping bitmap cache, */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added logical sector index, */
+/*                                            added block summary,        */
+/*                                            added runtime sector size,  */
+/*                                            added data cache,           */
+/*                                            reclaimed blocks before     */
+/*                                            mapping a sector,           */
+/*                                            added write streams,        */
+/*                                            added fill sectors,         */
+/*                                            added shared reads,         */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_sector_read(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer)
@@ -95,16 +119,59 @@ UINT    status;
 ULONG   *mapping_address;
 ULONG   mapping_entry;
 ULONG   *sector_address;
+#if defined(LX_NOR_ENABLE_SHARED_READ) && defined(LX_NOR_ENABLE_DATA_CACHE)
+ULONG   data_cache_invalidations;
+#endif
+#ifdef LX_NOR_ENABLE_STATS
+ULONG   start_time;
+#endif
+
 
+#ifdef LX_NOR_ENABLE_STATS
 
+    /* Remember when this sector read started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Obtain the thread safe mutex.  */
-    tx_mutex_get(&nor_flash -> lx_nor_flash_mutex, TX_WAIT_FOREVER);
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
+    /* Trace the start of the sector read.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTOR_READ, logical_sector);
+
     /* Increment the number of read requests.  */
     nor_flash -> lx_nor_flash_read_requests++;
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+    /* Determine if the sector is in the data cache.  */
+    if (_lx_nor_flash_data_cache_read(nor_flash, logical_sector, buffer) == LX_SUCCESS)
+    {
+
+#ifdef LX_NOR_ENABLE_STATS
+
+        /* Record the latency of this sector read.  */
+        _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTOR_READ, start_time);
+#endif
+
+        /* Trace the end of the sector read.  */
+        LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, LX_SUCCESS);
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+        /* Return success.  */
+        return(LX_SUCCESS);
+    }
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+    /* Remember the data cache invalidations, to detect writes during a shared read.  */
+    data_cache_invalidations =  nor_flash -> lx_nor_flash_data_cache_invalidations;
+#endif
+#endif
 
     /* See if we can find the sector in the current mapping.  */
     _lx_nor_flash_logical_sector_find(nor_flash, logical_sector, LX_FALSE, &mapping_address, &sector_address);
@@ -114,9 +181,25 @@ ULONG   *sector_address;
     {
     
         /* Yes, we were able to find the logical sector.  */
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+        /* Release the NOR flash mutex while the sector data is read, so other reads can run at the same time.  */
+        _lx_nor_flash_shared_read_begin(nor_flash);
+#endif
         
         /* Read the sector data from the physical sector.  */
-        status =  _lx_nor_flash_driver_read(nor_flash, sector_address, buffer, LX_NOR_SECTOR_SIZE);
+        status =  _lx_nor_flash_driver_read(nor_flash, sector_address, buffer, nor_flash -> lx_nor_flash_words_per_sector);
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+        /* Expand the fill word of a fill sector.  */
+        if (status == LX_SUCCESS)
+            status =  _lx_nor_flash_fill_sector_expand(nor_flash, mapping_address, buffer);
+#endif
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+        /* Obtain the NOR flash mutex again.  */
+        _lx_nor_flash_shared_read_end(nor_flash);
+#endif
 
         /* Check for an error from flash driver. Drivers should never return an error..  */
         if (status)
@@ -137,7 +220,16 @@ ULONG   *sector_address;
     }
     else
     {
-        
+
+        /* Mapping the sector uses a free sector, so reclaim blocks if it would leave fewer free sectors than
+           the low watermark.  */
+        _lx_nor_flash_free_sectors_reclaim(nor_flash, 1);
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+        /* Sectors that are only read are cold.  */
+        nor_flash -> lx_nor_flash_write_stream =  LX_NOR_WRITE_STREAM_COLD;
+#endif
+
         /* Allocate a new physical sector for this write.  */
         _lx_nor_flash_physical_sector_allocate(nor_flash, logical_sector, &mapping_address, &sector_address);
 
@@ -149,7 +241,7 @@ ULONG   *sector_address;
             nor_flash -> lx_nor_flash_free_physical_sectors--;
     
             /* Read the sector data from the physical sector.  */
-            status =  _lx_nor_flash_driver_read(nor_flash, sector_address, buffer, LX_NOR_SECTOR_SIZE);
+            status =  _lx_nor_flash_driver_read(nor_flash, sector_address, buffer, nor_flash -> lx_nor_flash_words_per_sector);
 
             /* Check for an error from flash driver. Drivers should never return an error..  */
             if (status)
@@ -172,10 +264,13 @@ ULONG   *sector_address;
                 /* Call system error handler.  */
                 _lx_nor_flash_system_error(nor_flash, status);
                 
+
+                /* Trace the end of the sector read.  */
+                LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
                 /* Release the thread safe mutex.  */
-                tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+                LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
                 /* Return status.  */
@@ -194,6 +289,17 @@ ULONG   *sector_address;
 #endif
 #endif
 
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+            /* Update the logical sector index with the new mapping.  */
+            _lx_nor_flash_logical_sector_index_update(nor_flash, logical_sector, mapping_address);
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+            /* Update the block summary with the new mapping.  */
+            _lx_nor_flash_block_summary_update(nor_flash, mapping_address, LX_FALSE);
+#endif
+
             /* Increment the number of mapped physical sectors.  */
             nor_flash -> lx_nor_flash_mapped_physical_sectors++;
 
@@ -207,11 +313,36 @@ ULONG   *sector_address;
             status =  LX_SECTOR_NOT_FOUND;
         }
     }
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+    /* Determine if the sector was read.  */
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+    /* A sector written during a shared read may have been read before the write, so the data 
+       is only placed in the data cache if no sector was written.  */
+    if ((status == LX_SUCCESS) && (data_cache_invalidations == nor_flash -> lx_nor_flash_data_cache_invalidations))
+#else
+    if (status == LX_SUCCESS)
+#endif
+    {
+
+        /* Yes, place a copy of the sector in the data cache.  */
+        _lx_nor_flash_data_cache_write(nor_flash, logical_sector, buffer, LX_FALSE);
+    }
+#endif
     
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Record the latency of this sector read.  */
+    _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTOR_READ, start_time);
+#endif
+
+    /* Trace the end of the sector read.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_READ, status);
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Release the thread safe mutex.  */
-    tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
     /* Return status.  */
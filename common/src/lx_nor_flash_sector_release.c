@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_sector_release                        PORTABLE C      */ 
-/*                                                           6.3.0        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -62,13 +62,18 @@
 /*                                                                        */ 
 /*    _lx_nor_flash_driver_write            Driver flash sector write     */ 
 /*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
-/*    _lx_nor_flash_block_reclaim           Reclaim one flash block       */ 
+/*    _lx_nor_flash_free_sectors_reclaim    Reclaim blocks below the low  */
+/*                                            watermark                   */
 /*    _lx_nor_flash_sector_mapping_cache_invalidate                       */ 
 /*                                          Invalidate cache entry        */ 
 /*    _lx_nor_flash_logical_sector_find     Find logical sector           */ 
+/*    _lx_nor_flash_logical_sector_index_update                           */
+/*                                          Update logical sector index   */
+/*    _lx_nor_flash_block_summary_update    Update block summary          */
+/*    _lx_nor_flash_data_cache_invalidate   Invalidate data cache sector  */
 /*    _lx_nor_flash_system_error            Internal system error handler */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -87,6 +92,17 @@
 /*                                            added mapping bitmap cache, */
 /*                                            added obsolete count cache, */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added logical sector index, */
+/*                                            added block summary,        */
+/*                                            added data cache,           */
+/*                                            added reclaim count,        */
+/*                                            added free sector           */
+/*                                            watermarks,                 */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_sector_release(LX_NOR_FLASH *nor_flash, ULONG logical_sector)
@@ -96,18 +112,28 @@ UINT    status;
 ULONG   *mapping_address;
 ULONG   mapping_entry;
 ULONG   *sector_address;
-ULONG   i;
 #ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
 ULONG   block;
 #endif
+#ifdef LX_NOR_ENABLE_STATS
+ULONG   start_time;
+#endif
+
 
+#ifdef LX_NOR_ENABLE_STATS
 
+    /* Remember when this sector release started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Obtain the thread safe mutex.  */
-    tx_mutex_get(&nor_flash -> lx_nor_flash_mutex, TX_WAIT_FOREVER);
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
+    /* Trace the start of the sector release.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTOR_RELEASE, logical_sector);
+
     /* Increment the number of read requests.  */
     nor_flash -> lx_nor_flash_read_requests++;
 
@@ -135,10 +161,12 @@ ULONG   block;
             /* Call system error handler.  */
             _lx_nor_flash_system_error(nor_flash, status);
 
+            /* Trace the end of the sector release.  */
+            LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
             /* Return status.  */
@@ -160,10 +188,12 @@ ULONG   block;
             /* Call system error handler.  */
             _lx_nor_flash_system_error(nor_flash, status);
 
+            /* Trace the end of the sector release.  */
+            LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
             /* Return status.  */
@@ -183,6 +213,12 @@ ULONG   block;
 #endif
 #endif
 
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+        /* Mark the logical sector as unmapped in the logical sector index.  */
+        _lx_nor_flash_logical_sector_index_update(nor_flash, logical_sector, LX_NULL);
+#endif
+
         /* Increment the number of obsolete physical sectors.  */
         nor_flash -> lx_nor_flash_obsolete_physical_sectors++;
 
@@ -199,32 +235,25 @@ ULONG   block;
             nor_flash -> lx_nor_flash_extended_cache_obsolete_count[block] ++;
         }
 #endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+        /* Update the block summary with the obsoleted sector.  */
+        _lx_nor_flash_block_summary_update(nor_flash, mapping_address, LX_TRUE);
+#endif
 
         /* Decrement the number of mapped physical sectors.  */
         nor_flash -> lx_nor_flash_mapped_physical_sectors--;
             
         /* Ensure the sector mapping cache no longer has this sector.  */
         _lx_nor_flash_sector_mapping_cache_invalidate(nor_flash, logical_sector);
+#ifdef LX_NOR_ENABLE_DATA_CACHE
 
-        /* Determine if there are less than two block's worth of free sectors.  */
-        i =  0;
-        while (nor_flash -> lx_nor_flash_free_physical_sectors <= nor_flash -> lx_nor_flash_physical_sectors_per_block)
-        {
-     
-            /* Attempt to reclaim one physical block.  */
-            _lx_nor_flash_block_reclaim(nor_flash);
-
-            /* Increment the block count.  */
-            i++;
-
-            /* Have we exceeded the number of blocks in the system?  */
-            if (i >= nor_flash -> lx_nor_flash_total_blocks)
-            { 
-          
-                /* Yes, break out of the loop.  */
-                break;
-            }
-        }
+        /* Ensure the data cache no longer has this sector.  */
+        _lx_nor_flash_data_cache_invalidate(nor_flash, logical_sector);
+#endif
+
+        /* Reclaim blocks if the free sectors are below the low watermark.  */
+        _lx_nor_flash_free_sectors_reclaim(nor_flash, 1);
 
         /* Set the status to success.  */
         status =  LX_SUCCESS;
@@ -236,10 +265,18 @@ ULONG   block;
         status =  LX_SECTOR_NOT_FOUND;
     }
     
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Record the latency of this sector release.  */
+    _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTOR_RELEASE, start_time);
+#endif
+
+    /* Trace the end of the sector release.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_RELEASE, status);
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Release the thread safe mutex.  */
-    tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
     /* Return status.  */
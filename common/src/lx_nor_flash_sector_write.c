@@ -39,7 +39,7 @@
 /*  FUNCTION                                               RELEASE        */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_sector_write                          PORTABLE C      */ 
-/*                                                           6.3.0        */
+/*                                                           6.x          */
 /*  AUTHOR                                                                */
 /*                                                                        */
 /*    William E. Lamie, Microsoft Corporation                             */
@@ -53,7 +53,8 @@
 /*    nor_flash                             NOR flash instance            */ 
 /*    logical_sector                        Logical sector number         */ 
 /*    buffer                                Pointer to buffer to write    */ 
-/*                                            (the size is 512 bytes)     */ 
+/*                                            (the size is the sector     */
+/*                                             size)                      */
 /*                                                                        */ 
 /*  OUTPUT                                                                */ 
 /*                                                                        */ 
@@ -62,16 +63,21 @@
 /*  CALLS                                                                 */ 
 /*                                                                        */ 
 /*    _lx_nor_flash_driver_write            Driver flash sector write     */ 
-/*    _lx_nor_flash_driver_read             Driver flash sector read      */ 
-/*    _lx_nor_flash_block_reclaim           Reclaim one flash block       */ 
+/*    _lx_nor_flash_free_sectors_reclaim    Reclaim blocks below the low  */
+/*                                            watermark                   */
 /*    _lx_nor_flash_logical_sector_find     Find logical sector           */ 
 /*    _lx_nor_flash_physical_sector_allocate                              */ 
 /*                                          Allocate new physical sector  */ 
-/*    _lx_nor_flash_sector_mapping_cache_invalidate                       */ 
-/*                                          Invalidate cache entry        */ 
+/*    _lx_nor_flash_sector_map              Map the new physical sector   */
+/*    _lx_nor_flash_data_cache_invalidate   Invalidate data cache sector  */
+/*    _lx_nor_flash_data_cache_write        Place sector in data cache    */
 /*    _lx_nor_flash_system_error            Internal system error handler */ 
-/*    tx_mutex_get                          Get thread protection         */ 
-/*    tx_mutex_put                          Release thread protection     */ 
+/*    _lx_nor_flash_write_stream_select     Select write stream           */
+/*    _lx_nor_flash_sector_overwrite        Overwrite sector in place     */
+/*    _lx_nor_flash_sector_compare          Compare sector data           */
+/*    _lx_nor_flash_fill_sector_check       Check for fill sector data    */
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
 /*                                                                        */ 
 /*  CALLED BY                                                             */ 
 /*                                                                        */ 
@@ -90,6 +96,24 @@
 /*                                            added mapping bitmap cache, */
 /*                                            added obsolete count cache, */
 /*                                            resulting in version 6.3.0  */
+/*  xx-xx-xxxx     Eclipse ThreadX          Modified comment(s),          */
+/*                                            added logical sector index, */
+/*                                            added block summary,        */
+/*                                            moved the mapping update to */
+/*                                            _lx_nor_flash_sector_map,   */
+/*                                            added runtime sector size,  */
+/*                                            added data cache,           */
+/*                                            added reclaim count,        */
+/*                                            added free sector           */
+/*                                            watermarks,                 */
+/*                                            added write streams,        */
+/*                                            added in-place overwrite,   */
+/*                                            added write if changed,     */
+/*                                            added fill sectors,         */
+/*                                            added lock backend support, */
+/*                                            added statistics,           */
+/*                                            added event trace,          */
+/*                                            resulting in version 6.x    */
 /*                                                                        */
 /**************************************************************************/
 UINT  _lx_nor_flash_sector_write(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer)
@@ -97,143 +121,178 @@ UINT  _lx_nor_flash_sector_write(LX_NOR_FLASH *nor_flash, ULONG logical_sector,
 
 ULONG                           *old_mapping_address;
 ULONG                           *old_sector_address;
-ULONG                           old_mapping_entry;
 ULONG                           *new_mapping_address;
 ULONG                           *new_sector_address;
 ULONG                           new_mapping_entry;
-ULONG                           i;
-LX_NOR_SECTOR_MAPPING_CACHE_ENTRY  *sector_mapping_cache_entry_ptr;
 UINT                            status;
-#ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
-ULONG                           block;
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+UINT                            fill_sector;
 #endif
+#ifdef LX_NOR_ENABLE_STATS
+ULONG                           start_time;
+#endif
+
+#ifdef LX_NOR_ENABLE_STATS
 
+    /* Remember when this sector write started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Obtain the thread safe mutex.  */
-    tx_mutex_get(&nor_flash -> lx_nor_flash_mutex, TX_WAIT_FOREVER);
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Trace the start of the sector write.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTOR_WRITE, logical_sector);
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Count the bytes written by the application.  */
+    nor_flash -> lx_nor_flash_stats.lx_flash_stats_bytes_requested +=  nor_flash -> lx_nor_flash_words_per_sector * sizeof(ULONG);
 #endif
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
 
-    /* Determine if there are less than two block's worth of free sectors.  */
-    i =  0;
-    while (nor_flash -> lx_nor_flash_free_physical_sectors <= nor_flash -> lx_nor_flash_physical_sectors_per_block)
+    /* Determine if the sector is already mapped with the same data.  */
+    if (_lx_nor_flash_sector_compare(nor_flash, logical_sector, buffer) == LX_SUCCESS)
     {
-     
-        /* Attempt to reclaim one physical block.  */
-        _lx_nor_flash_block_reclaim(nor_flash);
-
-        /* Increment the block count.  */
-        i++;
-
-        /* Have we exceeded the number of blocks in the system?  */
-        if (i >= nor_flash -> lx_nor_flash_total_blocks)
-        { 
-          
-            /* Yes, break out of the loop.  */
-            break;
-        }
+
+        /* Yes, the flash doesn't need to be changed.  */
+        nor_flash -> lx_nor_flash_write_requests++;
+        nor_flash -> lx_nor_flash_elided_writes++;
+
+#ifdef LX_NOR_ENABLE_STATS
+
+        /* Record the latency of this sector write.  */
+        _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTOR_WRITE, start_time);
+#endif
+
+        /* Trace the end of the sector write.  */
+        LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_SUCCESS);
+#ifdef LX_THREAD_SAFE_ENABLE
+
+        /* Release the thread safe mutex.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+        /* Return success.  */
+        return(LX_SUCCESS);
     }
+#endif
+
+    /* Reclaim blocks if the free sectors are below the low watermark.  */
+    _lx_nor_flash_free_sectors_reclaim(nor_flash, 1);
 
     /* Increment the number of write requests.  */
     nor_flash -> lx_nor_flash_write_requests++;
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+    /* Remove the old sector data from the data cache, in case the write does not complete.  */
+    _lx_nor_flash_data_cache_invalidate(nor_flash, logical_sector);
+#endif
 
     /* See if we can find the sector in the current mapping.  */
     _lx_nor_flash_logical_sector_find(nor_flash, logical_sector, LX_FALSE, &old_mapping_address, &old_sector_address);
-       
-    /* Allocate a new physical sector for this write.  */
-    _lx_nor_flash_physical_sector_allocate(nor_flash, logical_sector, &new_mapping_address, &new_sector_address);
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
 
-    /* Determine if the new sector allocation was successful.  */
-    if (new_mapping_address)
+    /* Determine if the sector is mapped and the new data only clears bits of it.  */
+    if (old_mapping_address)
     {
-    
-        /* Yes, we were able to allocate a new physical sector.  */
 
-        /* Update the number of free physical sectors.  */
-        nor_flash -> lx_nor_flash_free_physical_sectors--;
+        /* Try to overwrite the sector in place, without a new physical sector.  */
+        status =  _lx_nor_flash_sector_overwrite(nor_flash, old_mapping_address, old_sector_address, buffer);
 
-        /* Write the sector data to the new physical sector.  */
-        status =  _lx_nor_flash_driver_write(nor_flash, new_sector_address, buffer, LX_NOR_SECTOR_SIZE);
-
-        /* Check for an error from flash driver. Drivers should never return an error..  */
-        if (status)
+        /* Determine if the sector was overwritten.  */
+        if (status != LX_INVALID_WRITE)
         {
-        
-            /* Call system error handler.  */
-            _lx_nor_flash_system_error(nor_flash, status);
 
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+                /* Indicate the write was unsuccessful.  */
+                status =  LX_ERROR;
+            }
+            else
+            {
+
+                /* Increment the number of sectors written by the application.  */
+                nor_flash -> lx_nor_flash_host_sector_writes++;
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+                /* Place a copy of the new sector data in the data cache.  */
+                _lx_nor_flash_data_cache_write(nor_flash, logical_sector, buffer, LX_TRUE);
+#endif
+            }
+
+#ifdef LX_NOR_ENABLE_STATS
+
+            /* Record the latency of this sector write.  */
+            _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTOR_WRITE, start_time);
+#endif
+
+            /* Trace the end of the sector write.  */
+            LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, status);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
             /* Return status.  */
-            return(LX_ERROR);
+            return(status);
         }
+    }
+#endif
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
 
-        /* Was there a previously mapped sector?  */
-        if (old_mapping_address)
-        {
+    /* Select the write stream, so hot and cold sectors are written to different blocks.  */
+    _lx_nor_flash_write_stream_select(nor_flash, logical_sector);
+#endif
+       
+    /* Allocate a new physical sector for this write.  */
+    _lx_nor_flash_physical_sector_allocate(nor_flash, logical_sector, &new_mapping_address, &new_sector_address);
 
-            /* Now deprecate the old sector mapping.  */
-            
-            /* Read in the old sector mapping.  */
-#ifdef LX_DIRECT_READ
-        
-            /* Read the word directly.  */
-            old_mapping_entry =  *(old_mapping_address);
-#else
-            status =  _lx_nor_flash_driver_read(nor_flash, old_mapping_address, &old_mapping_entry, 1);
+    /* Determine if the new sector allocation was successful.  */
+    if (new_mapping_address)
+    {
+    
+        /* Yes, we were able to allocate a new physical sector.  */
 
-            /* Check for an error from flash driver. Drivers should never return an error..  */
-            if (status)
-            {
-        
-                /* Call system error handler.  */
-                _lx_nor_flash_system_error(nor_flash, status);
+        /* Update the number of free physical sectors.  */
+        nor_flash -> lx_nor_flash_free_physical_sectors--;
 
-#ifdef LX_THREAD_SAFE_ENABLE
+        /* Increment the number of sectors written by the application.  */
+        nor_flash -> lx_nor_flash_host_sector_writes++;
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
 
-                /* Release the thread safe mutex.  */
-                tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
-#endif
+        /* Determine if all the words of the sector data are the same.  */
+        fill_sector =  _lx_nor_flash_fill_sector_check(nor_flash, buffer);
+        if (fill_sector == LX_SUCCESS)
+        {
 
-                /* Return status.  */
-                return(LX_ERROR);
-            }
-#endif
-            
-            /* Clear bit 30, which indicates this sector is superceded.  */
-            old_mapping_entry =  old_mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED);
-            
-            /* Write the value back to the flash to clear bit 30.  */
-            status =  _lx_nor_flash_driver_write(nor_flash, old_mapping_address, &old_mapping_entry, 1);
+            /* Yes, only program the fill word, which is already there if it is all ones.  */
+            status =  LX_SUCCESS;
+            if (*((ULONG *) buffer) != LX_ALL_ONES)
+                status =  _lx_nor_flash_driver_write(nor_flash, new_sector_address, buffer, 1);
 
-            /* Check for an error from flash driver. Drivers should never return an error..  */
-            if (status)
-            {
-        
-                /* Call system error handler.  */
-                _lx_nor_flash_system_error(nor_flash, status);
+            /* Increment the number of fill sector writes.  */
+            nor_flash -> lx_nor_flash_fill_sector_writes++;
+        }
+        else
+        {
 
-#ifdef LX_THREAD_SAFE_ENABLE
+            /* Write the sector data to the new physical sector.  */
+            status =  _lx_nor_flash_driver_write(nor_flash, new_sector_address, buffer, nor_flash -> lx_nor_flash_words_per_sector);
+        }
+#else
 
-                /* Release the thread safe mutex.  */
-                tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+        /* Write the sector data to the new physical sector.  */
+        status =  _lx_nor_flash_driver_write(nor_flash, new_sector_address, buffer, nor_flash -> lx_nor_flash_words_per_sector);
 #endif
 
-                /* Return status.  */
-                return(LX_ERROR);
-            }
-        }
-        
-        /* Now build the new mapping entry - with the not valid bit set initially.  */
-        new_mapping_entry =  ((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID) | logical_sector;
-            
-        /* Write out the new mapping entry.  */
-        status =  _lx_nor_flash_driver_write(nor_flash, new_mapping_address, &new_mapping_entry, 1);
-
         /* Check for an error from flash driver. Drivers should never return an error..  */
         if (status)
         {
@@ -241,21 +300,28 @@ ULONG                           block;
             /* Call system error handler.  */
             _lx_nor_flash_system_error(nor_flash, status);
 
+            /* Trace the end of the sector write.  */
+            LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
             /* Return status.  */
             return(LX_ERROR);
         }
 
-        /* Now clear the not valid bit to make this sector mapping valid.  This is done because the writing of the extra bytes itself can 
-           be interrupted and we need to make sure this can be detected when the flash is opened again.  */
-        new_mapping_entry =  new_mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID);
+        /* Now build the new mapping entry - with the not valid bit set initially.  */
+        new_mapping_entry =  ((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID) | logical_sector;
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+        /* Mark the mapping entry of a fill sector.  */
+        if (fill_sector == LX_SUCCESS)
+            new_mapping_entry =  new_mapping_entry | ((ULONG) LX_NOR_PHYSICAL_SECTOR_FILL);
+#endif
             
-        /* Clear the not valid bit.  */
+        /* Write out the new mapping entry.  */
         status =  _lx_nor_flash_driver_write(nor_flash, new_mapping_address, &new_mapping_entry, 1);
 
         /* Check for an error from flash driver. Drivers should never return an error..  */
@@ -265,107 +331,20 @@ ULONG                           block;
             /* Call system error handler.  */
             _lx_nor_flash_system_error(nor_flash, status);
 
+            /* Trace the end of the sector write.  */
+            LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, LX_ERROR);
 #ifdef LX_THREAD_SAFE_ENABLE
 
             /* Release the thread safe mutex.  */
-            tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+            LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
             /* Return status.  */
             return(LX_ERROR);
         }
-#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
-#ifdef LX_NOR_ENABLE_MAPPING_BITMAP
-
-        /* Determine if the logical sector is within the mapping bitmap.  */
-        if (logical_sector < nor_flash -> lx_nor_flash_extended_cache_mapping_bitmap_max_logical_sector)
-        {
-
-            /* Set the bit in the mapping bitmap.  */
-            nor_flash -> lx_nor_flash_extended_cache_mapping_bitmap[logical_sector >> 5] |= (ULONG)(1 << (logical_sector & 31));
-        }
-#endif
-#endif
-
-        /* Increment the number of mapped physical sectors.  */
-        nor_flash -> lx_nor_flash_mapped_physical_sectors++;
-        
-        /* Was there a previously mapped sector?  */
-        if (old_mapping_address)
-        {
-        
-            /* Now clear bit 31, which indicates this sector is now obsoleted.  */
-            old_mapping_entry =  old_mapping_entry & ~((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID);
-            
-            /* Write the value back to the flash to clear bit 31.  */
-            status =  _lx_nor_flash_driver_write(nor_flash, old_mapping_address, &old_mapping_entry, 1);
-            
-            /* Check for an error from flash driver. Drivers should never return an error..  */
-            if (status)
-            {
-        
-                /* Call system error handler.  */
-                _lx_nor_flash_system_error(nor_flash, status);
-
-#ifdef LX_THREAD_SAFE_ENABLE
-
-                /* Release the thread safe mutex.  */
-                tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
-#endif
-
-              /* Return status.  */
-                return(LX_ERROR);
-            }
-
-            /* Increment the number of obsolete physical sectors.  */
-            nor_flash -> lx_nor_flash_obsolete_physical_sectors++;
-
-#ifdef LX_NOR_ENABLE_OBSOLETE_COUNT_CACHE
-
-            /* Get the block number from mapping address.  */
-            block = (ULONG)(old_mapping_address - nor_flash -> lx_nor_flash_base_address) / nor_flash -> lx_nor_flash_words_per_block;
-
-            /* Determine if this block is within the range of the obsolete count cache.  */
-            if (block < nor_flash -> lx_nor_flash_extended_cache_obsolete_count_max_block)
-            {
-
-                /* Increment the obsolete count for this block.  */
-                nor_flash -> lx_nor_flash_extended_cache_obsolete_count[block] ++;
-            }
-#endif
-
-            /* Decrement the number of mapped physical sectors.  */
-            nor_flash -> lx_nor_flash_mapped_physical_sectors--;
-            
-            /* Invalidate the old sector mapping cache entry.  */
-            _lx_nor_flash_sector_mapping_cache_invalidate(nor_flash, logical_sector);
-        }
 
-        /* Determine if the sector mapping cache is enabled.  */
-        if (nor_flash -> lx_nor_flash_sector_mapping_cache_enabled)
-        {
-        
-            /* Yes, sector mapping cache is enabled, place this sector information in the cache.  */
-            
-            /* Calculate the starting index of the sector mapping cache for this sector entry.  */
-            i =  (logical_sector & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) * LX_NOR_SECTOR_MAPPING_CACHE_DEPTH;
-
-            /* Build a pointer to the cache entry.  */
-            sector_mapping_cache_entry_ptr =  &nor_flash -> lx_nor_flash_sector_mapping_cache[i];
-
-            /* Move all the cache entries down so the oldest is at the bottom.  */
-            *(sector_mapping_cache_entry_ptr + 3) =  *(sector_mapping_cache_entry_ptr + 2);
-            *(sector_mapping_cache_entry_ptr + 2) =  *(sector_mapping_cache_entry_ptr + 1);
-            *(sector_mapping_cache_entry_ptr + 1) =  *(sector_mapping_cache_entry_ptr);
-           
-            /* Setup the new sector information in the cache.  */
-            sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_logical_sector =             (logical_sector | LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_VALID);
-            sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_physical_sector_map_entry =  new_mapping_address;
-            sector_mapping_cache_entry_ptr -> lx_nor_sector_mapping_cache_physical_sector_address =    new_sector_address;
-        }
-
-        /* Indicate the write was successful.  */
-        status =  LX_SUCCESS;        
+        /* Supercede the old mapping, make the new mapping valid and obsolete the old physical sector.  */
+        status =  _lx_nor_flash_sector_map(nor_flash, logical_sector, old_mapping_address, new_mapping_address, new_sector_address, new_mapping_entry, buffer);
     }
     else
     {
@@ -374,10 +353,18 @@ ULONG                           block;
         status =  LX_NO_SECTORS;
     }
 
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Record the latency of this sector write.  */
+    _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTOR_WRITE, start_time);
+#endif
+
+    /* Trace the end of the sector write.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTOR_WRITE, status);
 #ifdef LX_THREAD_SAFE_ENABLE
 
     /* Release the thread safe mutex.  */
-    tx_mutex_put(&nor_flash -> lx_nor_flash_mutex);
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
 #endif
 
     /* Return the completion status.  */
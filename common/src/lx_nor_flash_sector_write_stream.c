@@ -0,0 +1,128 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_write_stream                   PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function writes a logical sector to the NOR flash, like        */ 
+/*    lx_nor_flash_sector_write, but with the write stream given by the   */ 
+/*    caller. Sectors rewritten often, such as FAT and directory sectors, */ 
+/*    should be written to LX_NOR_WRITE_STREAM_HOT and file data to       */ 
+/*    LX_NOR_WRITE_STREAM_COLD, so they are not mixed in the same blocks. */ 
+/*    With LX_NOR_WRITE_STREAM_AUTO, the stream is selected as for        */ 
+/*    lx_nor_flash_sector_write.                                          */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    logical_sector                        Logical sector number         */ 
+/*    buffer                                Pointer to buffer to write    */ 
+/*                                            (the size is number of      */ 
+/*                                             bytes in a sector)         */ 
+/*    stream                                Write stream                  */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    return status                                                       */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_write            Write logical sector          */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application Code                                                    */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_sector_write_stream(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer, ULONG stream)
+{
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+UINT    status;
+
+
+    /* Determine if the write stream is valid.  */
+    if ((stream != LX_NOR_WRITE_STREAM_AUTO) && (stream >= LX_NOR_WRITE_STREAMS))
+    {
+
+        /* Return an error.  */
+        return(LX_ERROR);
+    }
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex, the sector write obtains it again.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Write the sector with the write stream of the caller.  */
+    nor_flash -> lx_nor_flash_write_stream_hint =  stream;
+    status =  _lx_nor_flash_sector_write(nor_flash, logical_sector, buffer);
+    nor_flash -> lx_nor_flash_write_stream_hint =  LX_NOR_WRITE_STREAM_AUTO;
+
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return completion status.  */
+    return(status);
+#else
+
+    LX_PARAMETER_NOT_USED(stream);
+
+    /* There is a single write stream, just write the sector.  */
+    return(_lx_nor_flash_sector_write(nor_flash, logical_sector, buffer));
+#endif
+}
@@ -0,0 +1,264 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_sectors_read                          PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function reads multiple consecutive logical sectors from the   */
+/*    NOR flash. Mapped sectors that are physically contiguous are read   */
+/*    with a single driver read. Sectors that are not mapped are handled  */
+/*    by the single sector read.                                          */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Starting logical sector       */
+/*    buffer                                Pointer to buffer to read into*/
+/*                                            (the size is the sector     */
+/*                                             size times sector_count)   */
+/*    sector_count                          Number of sectors to read     */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_driver_read             Driver flash sector read      */
+/*    _lx_nor_flash_fill_sector_expand      Expand fill sector data       */
+/*    _lx_nor_flash_logical_sector_find     Find logical sector           */
+/*    _lx_nor_flash_sector_read             Read a sector                 */
+/*    _lx_nor_flash_shared_read_begin       Start a shared read           */
+/*    _lx_nor_flash_shared_read_end         End a shared read             */
+/*    _lx_nor_flash_system_error            Internal system error handler */
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_sectors_read(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer, ULONG sector_count)
+{
+
+UINT    status;
+ULONG   *mapping_address;
+ULONG   *sector_address;
+ULONG   *run_sector_address;
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+ULONG   *run_mapping_address;
+ULONG   j;
+#endif
+ULONG   *run_buffer;
+ULONG   run_sectors;
+ULONG   i;
+#ifdef LX_NOR_ENABLE_STATS
+ULONG   start_time;
+#endif
+
+
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Remember when this multiple sector read started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Trace the start of the multiple sector read.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTORS_READ, logical_sector);
+
+    /* Default the status to success.  */
+    status =  LX_SUCCESS;
+
+    /* Initialize the current run of physically contiguous sectors.  */
+    run_sector_address =  LX_NULL;
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+    run_mapping_address =  LX_NULL;
+#endif
+    run_buffer =          (ULONG *) buffer;
+    run_sectors =         0;
+
+    /* Loop through the logical sectors, with one extra pass to read the last run.  */
+    for (i = 0; i <= sector_count; i++)
+    {
+
+        /* Default to no mapping.  */
+        mapping_address =  LX_NULL;
+        sector_address =   LX_NULL;
+
+        /* Determine if there is another logical sector.  */
+        if (i < sector_count)
+        {
+
+            /* See if we can find the sector in the current mapping.  */
+            _lx_nor_flash_logical_sector_find(nor_flash, logical_sector + i, LX_FALSE, &mapping_address, &sector_address);
+
+            /* Determine if the sector was found and follows the current run in flash.  */
+            if ((mapping_address) && (run_sectors) && (sector_address == (run_sector_address + (run_sectors * nor_flash -> lx_nor_flash_words_per_sector))))
+            {
+
+                /* Increment the number of read requests.  */
+                nor_flash -> lx_nor_flash_read_requests++;
+
+                /* Yes, extend the run.  */
+                run_sectors++;
+                continue;
+            }
+        }
+
+        /* Determine if there is a run to read.  */
+        if (run_sectors)
+        {
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+            /* Release the NOR flash mutex while the run is read, so other reads can run at the same time.  */
+            _lx_nor_flash_shared_read_begin(nor_flash);
+#endif
+
+            /* Read the sector data of the whole run.  */
+            status =  _lx_nor_flash_driver_read(nor_flash, run_sector_address, run_buffer, run_sectors * nor_flash -> lx_nor_flash_words_per_sector);
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+            /* Expand the fill word of the fill sectors in the run. The mapping entries of the run are consecutive as well.  */
+            for (j = 0; (status == LX_SUCCESS) && (j < run_sectors); j++)
+            {
+
+                /* Expand this sector if it is a fill sector.  */
+                status =  _lx_nor_flash_fill_sector_expand(nor_flash, run_mapping_address + j, run_buffer + (j * nor_flash -> lx_nor_flash_words_per_sector));
+            }
+#endif
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+            /* Obtain the NOR flash mutex again.  */
+            _lx_nor_flash_shared_read_end(nor_flash);
+#endif
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+                /* Adjust return status.  */
+                status =  LX_ERROR;
+                break;
+            }
+
+            /* The run is complete.  */
+            run_sectors =  0;
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+            /* Sectors may have been written while the NOR flash mutex was released, so find the next sector again.  */
+            if (i < sector_count)
+                _lx_nor_flash_logical_sector_find(nor_flash, logical_sector + i, LX_FALSE, &mapping_address, &sector_address);
+#endif
+        }
+
+        /* Determine if all the sectors have been read.  */
+        if (i == sector_count)
+            break;
+
+        /* Setup the buffer for this logical sector.  */
+        run_buffer =  ((ULONG *) buffer) + (i * nor_flash -> lx_nor_flash_words_per_sector);
+
+        /* Determine if the logical sector was found.  */
+        if (mapping_address)
+        {
+
+            /* Increment the number of read requests.  */
+            nor_flash -> lx_nor_flash_read_requests++;
+
+            /* Yes, start a new run with this sector.  */
+            run_sector_address =  sector_address;
+            run_sectors =         1;
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+            run_mapping_address =  mapping_address;
+#endif
+        }
+        else
+        {
+
+            /* No, let the single sector read handle the unmapped sector.  */
+            status =  _lx_nor_flash_sector_read(nor_flash, logical_sector + i, run_buffer);
+
+            /* Check for an error.  */
+            if (status)
+            {
+
+                /* Error, break the loop.  */
+                break;
+            }
+        }
+    }
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Record the latency of this multiple sector read.  */
+    _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTORS_READ, start_time);
+#endif
+
+    /* Trace the end of the multiple sector read.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTORS_READ, status);
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return status.  */
+    return(status);
+}
+
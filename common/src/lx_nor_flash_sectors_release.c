@@ -0,0 +1,139 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_sectors_release                       PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function releases multiple consecutive logical sectors from    */
+/*    being managed in the NOR flash. The thread safe mutex is obtained   */
+/*    once for all the sectors.                                           */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Starting logical sector       */
+/*    sector_count                          Number of sectors to release  */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_sector_release          Release one sector            */
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_sectors_release(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG sector_count)
+{
+
+UINT    status;
+ULONG   i;
+#ifdef LX_NOR_ENABLE_STATS
+ULONG   start_time;
+#endif
+
+
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Remember when this multiple sector release started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Trace the start of the multiple sector release.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTORS_RELEASE, logical_sector);
+
+    /* Default the status to success.  */
+    status =  LX_SUCCESS;
+
+    /* Loop to release all the sectors.  */
+    for (i = 0; i < sector_count; i++)
+    {
+
+        /* Release one sector.  */
+        status =  _lx_nor_flash_sector_release(nor_flash, logical_sector + i);
+
+        /* Check return status.  */
+        if (status)
+        {
+
+            /* Error, break the loop.  */
+            break;
+        }
+    }
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Record the latency of this multiple sector release.  */
+    _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTORS_RELEASE, start_time);
+#endif
+
+    /* Trace the end of the multiple sector release.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTORS_RELEASE, status);
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return status.  */
+    return(status);
+}
+
@@ -0,0 +1,529 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/
+/*                                                                        */
+/*  FUNCTION                                               RELEASE        */
+/*                                                                        */
+/*    _lx_nor_flash_sectors_write                         PORTABLE C      */
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */
+/*                                                                        */
+/*    This function writes multiple consecutive logical sectors to the    */
+/*    NOR flash. Free sectors are reclaimed once for each block's worth   */
+/*    of logical sectors and physically contiguous sectors are allocated  */
+/*    in runs, so the sector data of each run is written with a single    */
+/*    driver write. A run ends when an allocated sector does not follow   */
+/*    it. The mapping entry of each sector is written as not valid when   */
+/*    the sector is allocated, so a power interruption before the run is  */
+/*    mapped only leaves obsolete sectors.                                */
+/*                                                                        */
+/*  INPUT                                                                 */
+/*                                                                        */
+/*    nor_flash                             NOR flash instance            */
+/*    logical_sector                        Starting logical sector       */
+/*    buffer                                Pointer to buffer to write    */
+/*                                            (the size is the sector     */
+/*                                             size times sector_count)   */
+/*    sector_count                          Number of sectors to write    */
+/*                                                                        */
+/*  OUTPUT                                                                */
+/*                                                                        */
+/*    return status                                                       */
+/*                                                                        */
+/*  CALLS                                                                 */
+/*                                                                        */
+/*    _lx_nor_flash_driver_write            Driver flash sector write     */
+/*    _lx_nor_flash_free_sectors_reclaim    Reclaim blocks below the low  */
+/*                                            watermark                   */
+/*    _lx_nor_flash_logical_sector_find     Find logical sector           */
+/*    _lx_nor_flash_physical_sector_allocate                              */
+/*                                          Allocate new physical sector  */
+/*    _lx_nor_flash_sector_map              Map the new physical sector   */
+/*    _lx_nor_flash_data_cache_invalidate   Invalidate data cache sector  */
+/*    _lx_nor_flash_data_cache_write        Place sector in data cache    */
+/*    _lx_nor_flash_system_error            Internal system error handler */
+/*    _lx_nor_flash_write_stream_select     Select write stream           */
+/*    _lx_nor_flash_sector_overwrite        Overwrite sector in place     */
+/*    _lx_nor_flash_sector_compare          Compare sector data           */
+/*    _lx_nor_flash_fill_sector_check       Check for fill sector data    */
+/*    _lx_nor_flash_sector_write            Write a sector                */
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */
+/*                                                                        */
+/*  CALLED BY                                                             */
+/*                                                                        */
+/*    Application Code                                                    */
+/*                                                                        */
+/*  RELEASE HISTORY                                                       */
+/*                                                                        */
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+UINT  _lx_nor_flash_sectors_write(LX_NOR_FLASH *nor_flash, ULONG logical_sector, VOID *buffer, ULONG sector_count)
+{
+
+ULONG                           *old_mapping_address;
+ULONG                           *old_sector_address;
+ULONG                           *new_mapping_address;
+ULONG                           *new_sector_address;
+ULONG                           new_mapping_entry;
+ULONG                           *run_mapping_address;
+ULONG                           *run_sector_address;
+ULONG                           *tail_mapping_address;
+ULONG                           *tail_sector_address;
+ULONG                           run_sectors;
+ULONG                           run_limit;
+ULONG                           sector;
+ULONG                           block;
+ULONG                           i;
+UINT                            status;
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+UINT                            overwritten;
+UINT                            overwrite_status;
+#endif
+#ifdef LX_NOR_ENABLE_STATS
+ULONG                           start_time;
+#endif
+
+
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Remember when this multiple sector write started.  */
+    start_time =  LX_STATS_CLOCK_GET();
+#endif
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Obtain the thread safe mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Trace the start of the multiple sector write.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_ENTRY, LX_STATS_SECTORS_WRITE, logical_sector);
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Count the bytes written by the application.  */
+    nor_flash -> lx_nor_flash_stats.lx_flash_stats_bytes_requested +=  ((ULONG64) sector_count) * nor_flash -> lx_nor_flash_words_per_sector * sizeof(ULONG);
+#endif
+
+    /* Default the status to success.  */
+    status =  LX_SUCCESS;
+
+    /* Loop to write the logical sectors, one run of physically contiguous sectors at a time.  */
+    while (sector_count)
+    {
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
+
+        /* Determine if the next sector is already mapped with the same data.  */
+        if (_lx_nor_flash_sector_compare(nor_flash, logical_sector, buffer) == LX_SUCCESS)
+        {
+
+            /* Yes, skip it without changing the flash.  */
+            nor_flash -> lx_nor_flash_write_requests++;
+            nor_flash -> lx_nor_flash_elided_writes++;
+            logical_sector++;
+            buffer =        (VOID *) (((ULONG *) buffer) + nor_flash -> lx_nor_flash_words_per_sector);
+            sector_count--;
+            continue;
+        }
+#endif
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+        /* Determine if the next sector is a fill sector.  */
+        if (_lx_nor_flash_fill_sector_check(nor_flash, buffer) == LX_SUCCESS)
+        {
+#ifdef LX_NOR_ENABLE_STATS
+
+            /* The single sector write counts the bytes of this sector itself.  */
+            nor_flash -> lx_nor_flash_stats.lx_flash_stats_bytes_requested -=  nor_flash -> lx_nor_flash_words_per_sector * sizeof(ULONG);
+#endif
+
+            /* Yes, let the single sector write program only its fill word.  */
+            status =  _lx_nor_flash_sector_write(nor_flash, logical_sector, buffer);
+
+            /* Check for an error.  */
+            if (status)
+            {
+
+                /* Error, break the loop.  */
+                break;
+            }
+
+            /* Move to the next sector.  */
+            logical_sector++;
+            buffer =        (VOID *) (((ULONG *) buffer) + nor_flash -> lx_nor_flash_words_per_sector);
+            sector_count--;
+            continue;
+        }
+#endif
+
+        /* Limit the run to one block's worth of sectors.  */
+        run_limit =  sector_count;
+        if (run_limit > nor_flash -> lx_nor_flash_physical_sectors_per_block)
+            run_limit =  nor_flash -> lx_nor_flash_physical_sectors_per_block;
+
+        /* Reclaim blocks if the free sectors left after this run are below the low watermark.  */
+        _lx_nor_flash_free_sectors_reclaim(nor_flash, run_limit);
+
+        /* Determine if fewer free sectors could be reclaimed.  */
+        if (nor_flash -> lx_nor_flash_free_physical_sectors < (nor_flash -> lx_nor_flash_free_sectors_low_watermark + run_limit))
+        {
+
+            /* Yes, shorten the run so it uses no more of the free sectors below the low watermark than a single sector write.  */
+            if (nor_flash -> lx_nor_flash_free_physical_sectors > (nor_flash -> lx_nor_flash_free_sectors_low_watermark + 1))
+                run_limit =  nor_flash -> lx_nor_flash_free_physical_sectors - nor_flash -> lx_nor_flash_free_sectors_low_watermark;
+            else
+                run_limit =  1;
+        }
+
+        /* Allocate the physical sectors of this run. Free sectors within a block are always allocated in
+           ascending order, so consecutive allocations from the same block are physically contiguous.  */
+        run_mapping_address =  LX_NULL;
+        run_sector_address =   LX_NULL;
+        tail_mapping_address = LX_NULL;
+        tail_sector_address =  LX_NULL;
+        run_sectors =  0;
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+        overwritten =       LX_FALSE;
+        overwrite_status =  LX_SUCCESS;
+#endif
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+        /* Select the write stream of the run from its first sector, so the run stays contiguous.  */
+        _lx_nor_flash_write_stream_select(nor_flash, logical_sector);
+#endif
+        while (run_sectors < run_limit)
+        {
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
+
+            /* End the run before a sector that is already mapped with the same data, so it is skipped.  */
+            if ((run_sectors) && 
+                (_lx_nor_flash_sector_compare(nor_flash, logical_sector + run_sectors, ((ULONG *) buffer) + (run_sectors * nor_flash -> lx_nor_flash_words_per_sector)) == LX_SUCCESS))
+            {
+
+                /* The run ends here.  */
+                break;
+            }
+#endif
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+            /* End the run before a fill sector, so only its fill word is programmed.  */
+            if ((run_sectors) && 
+                (_lx_nor_flash_fill_sector_check(nor_flash, ((ULONG *) buffer) + (run_sectors * nor_flash -> lx_nor_flash_words_per_sector)) == LX_SUCCESS))
+            {
+
+                /* The run ends here.  */
+                break;
+            }
+#endif
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+            /* Remove the old sector data from the data cache, in case the write does not complete.  */
+            _lx_nor_flash_data_cache_invalidate(nor_flash, logical_sector + run_sectors);
+#endif
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+
+            /* Determine if the sector is mapped and the new data only clears bits of it.  */
+            _lx_nor_flash_logical_sector_find(nor_flash, logical_sector + run_sectors, LX_FALSE, &old_mapping_address, &old_sector_address);
+            if (old_mapping_address)
+            {
+
+                /* Try to overwrite the sector in place, without a new physical sector.  */
+                overwrite_status =  _lx_nor_flash_sector_overwrite(nor_flash, old_mapping_address, old_sector_address,
+                                                                   ((ULONG *) buffer) + (run_sectors * nor_flash -> lx_nor_flash_words_per_sector));
+
+                /* Determine if the sector was overwritten.  */
+                if (overwrite_status != LX_INVALID_WRITE)
+                {
+
+                    /* Yes, the run ends before it.  */
+                    overwritten =  LX_TRUE;
+                    break;
+                }
+            }
+#endif
+
+            /* Allocate a new physical sector.  */
+            _lx_nor_flash_physical_sector_allocate(nor_flash, logical_sector + run_sectors, &new_mapping_address, &new_sector_address);
+
+            /* Determine if the new sector allocation was successful.  */
+            if (new_mapping_address == LX_NULL)
+            {
+
+                /* No, the run ends here.  */
+                break;
+            }
+
+            /* Update the number of free physical sectors.  */
+            nor_flash -> lx_nor_flash_free_physical_sectors--;
+
+            /* Increment the number of sectors written by the application.  */
+            nor_flash -> lx_nor_flash_host_sector_writes++;
+
+            /* Write out the new mapping entry right away - with the not valid bit set. The flash open discards
+               entries that are not valid, while it only tolerates one allocated sector with a free entry.  */
+            new_mapping_entry =  ((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID) |
+                                 (logical_sector + run_sectors);
+            status =  _lx_nor_flash_driver_write(nor_flash, new_mapping_address, &new_mapping_entry, 1);
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+                /* Indicate the write was unsuccessful.  */
+                status =  LX_ERROR;
+                break;
+            }
+
+            /* Remember the start of the run.  */
+            if (run_sectors == 0)
+            {
+                run_mapping_address =  new_mapping_address;
+                run_sector_address =   new_sector_address;
+            }
+
+            /* Determine if the new sector does not follow the run, for example when the allocation moved to
+               another block.  */
+            else if (new_sector_address != (run_sector_address + (run_sectors * nor_flash -> lx_nor_flash_words_per_sector)))
+            {
+
+                /* Yes, the run ends before it. The sector is written on its own after the run.  */
+                tail_mapping_address =  new_mapping_address;
+                tail_sector_address =   new_sector_address;
+                break;
+            }
+
+            /* Increment the number of sectors in the run.  */
+            run_sectors++;
+
+            /* Calculate the block and the index of the allocated sector within the block.  */
+            block =   (ULONG) (new_mapping_address - nor_flash -> lx_nor_flash_base_address) / nor_flash -> lx_nor_flash_words_per_block;
+            sector =  (ULONG) (new_mapping_address - nor_flash -> lx_nor_flash_base_address) - (block * nor_flash -> lx_nor_flash_words_per_block) -
+                                                                nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset;
+
+            /* Determine if the next free sector is the last one of this block, or if the block is full. Allocating
+               the last free sector records the block's logical sector range from its mapping list, so the run must
+               be mapped before that allocation.  */
+            if ((sector + 2) >= nor_flash -> lx_nor_flash_physical_sectors_per_block)
+            {
+
+                /* Yes, the run ends here.  */
+                break;
+            }
+        }
+
+        /* Check for an error writing a mapping entry.  */
+        if (status)
+        {
+
+            /* Error, break the loop.  */
+            break;
+        }
+
+        /* Determine if any physical sector was allocated.  */
+        if (run_sectors)
+        {
+
+            /* Write the sector data of the whole run to the new physical sectors.  */
+            status =  _lx_nor_flash_driver_write(nor_flash, run_sector_address, (ULONG *) buffer, run_sectors * nor_flash -> lx_nor_flash_words_per_sector);
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, status);
+
+                /* Indicate the write was unsuccessful.  */
+                status =  LX_ERROR;
+                break;
+            }
+
+            /* Now map each sector of the run.  */
+            for (i = 0; i < run_sectors; i++)
+            {
+
+                /* Increment the number of write requests.  */
+                nor_flash -> lx_nor_flash_write_requests++;
+
+                /* See if we can find the sector in the current mapping.  */
+                _lx_nor_flash_logical_sector_find(nor_flash, logical_sector, LX_FALSE, &old_mapping_address, &old_sector_address);
+
+                /* Supercede the old mapping, make the new mapping valid and obsolete the old physical sector.  */
+                new_mapping_entry =  ((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID) | logical_sector;
+                status =  _lx_nor_flash_sector_map(nor_flash, logical_sector, old_mapping_address, run_mapping_address + i,
+                                                   run_sector_address + (i * nor_flash -> lx_nor_flash_words_per_sector), new_mapping_entry, buffer);
+
+                /* Check for an error.  */
+                if (status)
+                {
+
+                    /* Error, break the loop.  */
+                    break;
+                }
+
+                /* Move to the next logical sector.  */
+                logical_sector++;
+                buffer =        (VOID *) (((ULONG *) buffer) + nor_flash -> lx_nor_flash_words_per_sector);
+                sector_count--;
+            }
+
+            /* Check for an error.  */
+            if (status)
+            {
+
+                /* Error, break the loop.  */
+                break;
+            }
+
+            /* Determine if a sector that does not follow the run was allocated.  */
+            if (tail_mapping_address)
+            {
+
+                /* Yes, write its sector data on its own.  */
+                status =  _lx_nor_flash_driver_write(nor_flash, tail_sector_address, (ULONG *) buffer, nor_flash -> lx_nor_flash_words_per_sector);
+
+                /* Check for an error from flash driver. Drivers should never return an error..  */
+                if (status)
+                {
+
+                    /* Call system error handler.  */
+                    _lx_nor_flash_system_error(nor_flash, status);
+
+                    /* Indicate the write was unsuccessful.  */
+                    status =  LX_ERROR;
+                    break;
+                }
+
+                /* Increment the number of write requests.  */
+                nor_flash -> lx_nor_flash_write_requests++;
+
+                /* See if we can find the sector in the current mapping.  */
+                _lx_nor_flash_logical_sector_find(nor_flash, logical_sector, LX_FALSE, &old_mapping_address, &old_sector_address);
+
+                /* Supercede the old mapping, make the new mapping valid and obsolete the old physical sector.  */
+                new_mapping_entry =  ((ULONG) LX_NOR_PHYSICAL_SECTOR_VALID) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_SUPERCEDED) | ((ULONG) LX_NOR_PHYSICAL_SECTOR_MAPPING_NOT_VALID) | logical_sector;
+                status =  _lx_nor_flash_sector_map(nor_flash, logical_sector, old_mapping_address, tail_mapping_address, tail_sector_address, new_mapping_entry, buffer);
+
+                /* Check for an error.  */
+                if (status)
+                {
+
+                    /* Error, break the loop.  */
+                    break;
+                }
+
+                /* Move to the next logical sector.  */
+                logical_sector++;
+                buffer =        (VOID *) (((ULONG *) buffer) + nor_flash -> lx_nor_flash_words_per_sector);
+                sector_count--;
+            }
+        }
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+
+        /* Determine if the sector after the run was overwritten in place.  */
+        else if (overwritten == LX_FALSE)
+#else
+        else
+#endif
+        {
+
+            /* Indicate the write was unsuccessful.  */
+            status =  LX_NO_SECTORS;
+            break;
+        }
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+
+        /* Determine if the sector after the run was overwritten in place.  */
+        if (overwritten)
+        {
+
+            /* Increment the number of write requests.  */
+            nor_flash -> lx_nor_flash_write_requests++;
+
+            /* Check for an error from flash driver. Drivers should never return an error..  */
+            if (overwrite_status)
+            {
+
+                /* Call system error handler.  */
+                _lx_nor_flash_system_error(nor_flash, overwrite_status);
+
+                /* Indicate the write was unsuccessful.  */
+                status =  LX_ERROR;
+                break;
+            }
+
+            /* Increment the number of sectors written by the application.  */
+            nor_flash -> lx_nor_flash_host_sector_writes++;
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+            /* Place a copy of the new sector data in the data cache.  */
+            _lx_nor_flash_data_cache_write(nor_flash, logical_sector, buffer, LX_TRUE);
+#endif
+
+            /* Move to the next logical sector.  */
+            logical_sector++;
+            buffer =        (VOID *) (((ULONG *) buffer) + nor_flash -> lx_nor_flash_words_per_sector);
+            sector_count--;
+        }
+#endif
+    }
+#ifdef LX_NOR_ENABLE_STATS
+
+    /* Record the latency of this multiple sector write.  */
+    _lx_stats_api_record(&nor_flash -> lx_nor_flash_stats, LX_STATS_SECTORS_WRITE, start_time);
+#endif
+
+    /* Trace the end of the multiple sector write.  */
+    LX_NOR_TRACE_INSERT(nor_flash, LX_TRACE_API_EXIT, LX_STATS_SECTORS_WRITE, status);
+#ifdef LX_THREAD_SAFE_ENABLE
+
+    /* Release the thread safe mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#endif
+
+    /* Return status.  */
+    return(status);
+}
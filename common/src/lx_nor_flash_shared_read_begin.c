@@ -0,0 +1,113 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_shared_read_begin                 PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function starts a shared read. The caller holds the NOR flash  */ 
+/*    mutex and has found the sector to read. The reader is counted and   */ 
+/*    the NOR flash mutex is released, so other reads can run while the   */ 
+/*    sector data is transferred. Block erases and in-place overwrites    */ 
+/*    wait until the count of readers drops to zero.                      */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*    LX_LOCK_RWLOCK_READ_GET               Get shared read lock          */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_read                                           */ 
+/*    _lx_nor_flash_sectors_read                                          */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_shared_read_begin(LX_NOR_FLASH *nor_flash)
+{
+#ifdef LX_NOR_ENABLE_SHARED_READ
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Count this reader. With the read/write lock, the count only changes with the NOR flash 
+       mutex held.  */
+    nor_flash -> lx_nor_flash_shared_readers++;
+    nor_flash -> lx_nor_flash_shared_reads++;
+
+    /* Obtain the shared read lock for reading. This does not block, since block erases only 
+       obtain it for writing with the NOR flash mutex held.  */
+    LX_LOCK_RWLOCK_READ_GET(&nor_flash -> lx_nor_flash_shared_read_lock);
+#else
+
+    /* Obtain the shared read mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_shared_read_mutex);
+
+    /* Count this reader.  */
+    nor_flash -> lx_nor_flash_shared_readers++;
+    nor_flash -> lx_nor_flash_shared_reads++;
+
+    /* Release the shared read mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_shared_read_mutex);
+#endif
+
+    /* Release the thread safe mutex, the sector data is read without it.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_mutex);
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+}
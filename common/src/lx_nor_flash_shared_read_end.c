@@ -0,0 +1,121 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_shared_read_end                   PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function ends a shared read. The reader is removed from the    */ 
+/*    count, a waiting writer is resumed when the last reader is done,    */ 
+/*    and the NOR flash mutex is obtained again for the caller.           */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*    LX_LOCK_SEMAPHORE_PUT                 Resume waiting writer         */ 
+/*    LX_LOCK_RWLOCK_PUT                    Release shared read lock      */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_sector_read                                           */ 
+/*    _lx_nor_flash_sectors_read                                          */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_shared_read_end(LX_NOR_FLASH *nor_flash)
+{
+#ifdef LX_NOR_ENABLE_SHARED_READ
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Release the shared read lock, a waiting block erase can now obtain it.  */
+    LX_LOCK_RWLOCK_PUT(&nor_flash -> lx_nor_flash_shared_read_lock);
+
+    /* Obtain the thread safe mutex again.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+
+    /* This reader is done.  */
+    nor_flash -> lx_nor_flash_shared_readers--;
+#else
+
+    /* Obtain the shared read mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_shared_read_mutex);
+
+    /* This reader is done.  */
+    nor_flash -> lx_nor_flash_shared_readers--;
+
+    /* Determine if this was the last reader and a writer is waiting for it.  */
+    if ((nor_flash -> lx_nor_flash_shared_readers == 0) && (nor_flash -> lx_nor_flash_shared_read_waiting))
+    {
+
+        /* Yes, resume the writer.  */
+        nor_flash -> lx_nor_flash_shared_read_waiting =  LX_FALSE;
+        LX_LOCK_SEMAPHORE_PUT(&nor_flash -> lx_nor_flash_shared_read_semaphore);
+    }
+
+    /* Release the shared read mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_shared_read_mutex);
+
+    /* Obtain the thread safe mutex again. The reader count is already decremented, so a writer 
+       that holds the thread safe mutex never waits for this thread.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_mutex);
+#endif
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+}
@@ -0,0 +1,128 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_shared_read_wait                  PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function waits until no shared read is in progress. It is      */ 
+/*    called with the NOR flash mutex held before flash that may hold     */ 
+/*    mapped sector data is erased or programmed again. Since shared      */ 
+/*    reads only start with the NOR flash mutex held, no new reader can   */ 
+/*    start while the caller waits.                                       */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_LOCK_MUTEX_GET                     Get thread protection         */ 
+/*    LX_LOCK_MUTEX_PUT                     Release thread protection     */ 
+/*    LX_LOCK_SEMAPHORE_GET                 Wait for readers to finish    */ 
+/*    LX_LOCK_RWLOCK_WRITE_GET              Wait for shared reads         */ 
+/*    LX_LOCK_RWLOCK_PUT                    Release shared read lock      */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_driver_block_erase                                    */ 
+/*    _lx_nor_flash_sector_overwrite                                      */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_shared_read_wait(LX_NOR_FLASH *nor_flash)
+{
+#ifdef LX_NOR_ENABLE_SHARED_READ
+
+    /* Determine if there are any readers. This is also the case while the NOR flash is 
+       opened or formatted, before the shared read mutex is created.  */
+    if (nor_flash -> lx_nor_flash_shared_readers == 0)
+    {
+
+        /* Nothing to wait for, return.  */
+        return;
+    }
+#if (LX_LOCK_BACKEND == LX_LOCK_BACKEND_PTHREAD_RWLOCK)
+
+    /* Obtain the shared read lock for writing, which waits for the readers that still hold it. 
+       New readers cannot start, since this thread holds the NOR flash mutex.  */
+    LX_LOCK_RWLOCK_WRITE_GET(&nor_flash -> lx_nor_flash_shared_read_lock);
+    LX_LOCK_RWLOCK_PUT(&nor_flash -> lx_nor_flash_shared_read_lock);
+#else
+
+    /* Obtain the shared read mutex.  */
+    LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_shared_read_mutex);
+
+    /* Loop until the last reader is done.  */
+    while (nor_flash -> lx_nor_flash_shared_readers)
+    {
+
+        /* Let the last reader resume this thread.  */
+        nor_flash -> lx_nor_flash_shared_read_waiting =  LX_TRUE;
+
+        /* Release the shared read mutex and wait.  */
+        LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_shared_read_mutex);
+        LX_LOCK_SEMAPHORE_GET(&nor_flash -> lx_nor_flash_shared_read_semaphore);
+
+        /* Obtain the shared read mutex again.  */
+        LX_LOCK_MUTEX_GET(&nor_flash -> lx_nor_flash_shared_read_mutex);
+    }
+
+    /* Release the shared read mutex.  */
+    LX_LOCK_MUTEX_PUT(&nor_flash -> lx_nor_flash_shared_read_mutex);
+#endif
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+}
@@ -23,10 +23,18 @@
 /* Include necessary files.  */
 
 #include "lx_api.h"
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /* Define constants for the NOR flash simulation. */
 
-/* This configuration is for one physical sector of overhead.  */
+/* This configuration is for one physical sector of overhead. It is the default geometry, the number of
+   blocks and the physical sectors per block can be changed at run time with
+   _lx_nor_flash_simulator_geometry_set or _lx_nor_flash_simulator_file_open.  */
 
 
 #define TOTAL_BLOCKS                        8
@@ -37,6 +45,24 @@
 #define UNUSED_METADATA_WORDS_PER_BLOCK     (WORDS_PER_PHYSICAL_SECTOR-(3+FREE_BIT_MAP_WORDS+USABLE_SECTORS_PER_BLOCK))
 
 
+/* Define the default timing of the simulated NOR flash, in nanoseconds. Every driver operation adds its
+   time to the simulated device time, which _lx_nor_flash_simulator_time_get returns. The times can be
+   changed at run time with _lx_nor_flash_simulator_timing_set.  */
+
+#ifndef LX_NOR_SIMULATOR_WORD_READ_TIME
+#define LX_NOR_SIMULATOR_WORD_READ_TIME     100         /* Read of one word.                            */
+#endif
+#ifndef LX_NOR_SIMULATOR_WORD_PROGRAM_TIME
+#define LX_NOR_SIMULATOR_WORD_PROGRAM_TIME  10000       /* Program of one word.                         */
+#endif
+#ifndef LX_NOR_SIMULATOR_BLOCK_ERASE_TIME
+#define LX_NOR_SIMULATOR_BLOCK_ERASE_TIME   25000000    /* Erase of one block.                          */
+#endif
+#ifndef LX_NOR_SIMULATOR_BUS_BYTE_TIME
+#define LX_NOR_SIMULATOR_BUS_BYTE_TIME      0           /* Transfer of one byte, for serial NOR flash.  */
+#endif
+
+
 typedef struct PHYSICAL_SECTOR_STRUCT
 {
     unsigned long memory[WORDS_PER_PHYSICAL_SECTOR];
@@ -58,8 +84,53 @@ FLASH_BLOCK   nor_memory_area[TOTAL_BLOCKS];
 
 ULONG         nor_sector_memory[WORDS_PER_PHYSICAL_SECTOR];
 
+/* Define the geometry and the memory of the simulated NOR flash, the default geometry in nor_memory_area
+   unless another one is selected at run time.  */
+
+ULONG         nor_simulator_total_blocks =       TOTAL_BLOCKS;
+ULONG         nor_simulator_words_per_block =    sizeof(FLASH_BLOCK)/sizeof(ULONG);
+ULONG         *nor_simulator_memory =            (ULONG *) &nor_memory_area[0];
+
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+
+/* Define the device image file and its mapping.  */
+
+int           nor_simulator_file =               -1;
+void          *nor_simulator_file_memory;
+size_t        nor_simulator_file_size;
+#endif
+
+/* Define the timing of the simulated NOR flash and the simulated device time.  */
+
+ULONG         nor_simulator_word_read_time =     LX_NOR_SIMULATOR_WORD_READ_TIME;
+ULONG         nor_simulator_word_program_time =  LX_NOR_SIMULATOR_WORD_PROGRAM_TIME;
+ULONG         nor_simulator_block_erase_time =   LX_NOR_SIMULATOR_BLOCK_ERASE_TIME;
+ULONG         nor_simulator_bus_byte_time =      LX_NOR_SIMULATOR_BUS_BYTE_TIME;
+ULONG64       nor_simulator_time;
+
+/* Define the fast forward mode, which follows the wear of long workloads quickly. The metadata of the
+   blocks and the blocks LevelX doesn't manage are read and programmed as usual. Of the physical sectors
+   that hold sector data only the first word, the token of the data, is read and programmed, the other
+   words are skipped and keep their erased value in flash. Single words are always read and programmed,
+   LevelX reads and programs sector data in whole sectors. The layout of the blocks is taken from the
+   NOR flash that was initialized last.  */
+
+UINT          nor_simulator_fast_forward;
+LX_NOR_FLASH  *nor_simulator_flash;
+
 UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash);
 UINT  _lx_nor_flash_simulator_erase_all(VOID);
+UINT  _lx_nor_flash_simulator_timing_set(ULONG word_read_time, ULONG word_program_time, ULONG block_erase_time, ULONG bus_byte_time);
+UINT  _lx_nor_flash_simulator_time_get(ULONG64 *time);
+UINT  _lx_nor_flash_simulator_time_reset(VOID);
+UINT  _lx_nor_flash_simulator_geometry_set(ULONG total_blocks, ULONG physical_sectors_per_block, ULONG *memory, ULONG64 memory_size);
+UINT  _lx_nor_flash_simulator_fast_forward_set(UINT enable);
+VOID  _lx_nor_flash_simulator_fast_forward_copy(ULONG *flash_address, ULONG *destination, ULONG *source, ULONG words);
+ULONG _lx_nor_flash_simulator_fast_forward_step(ULONG block, ULONG offset);
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+UINT  _lx_nor_flash_simulator_file_open(CHAR *file_name, ULONG total_blocks, ULONG physical_sectors_per_block);
+UINT  _lx_nor_flash_simulator_file_close(VOID);
+#endif
 #ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
 UINT  _lx_nor_flash_simulator_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
 UINT  _lx_nor_flash_simulator_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
@@ -79,11 +150,12 @@ UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash)
 {
 
     /* Setup the base address of the flash memory.  */
-    nor_flash -> lx_nor_flash_base_address =                (ULONG *) &nor_memory_area[0];
+    nor_flash -> lx_nor_flash_base_address =                nor_simulator_memory;
 
     /* Setup geometry of the flash.  */
-    nor_flash -> lx_nor_flash_total_blocks =                TOTAL_BLOCKS;
-    nor_flash -> lx_nor_flash_words_per_block =             sizeof(FLASH_BLOCK)/sizeof(ULONG);
+    nor_flash -> lx_nor_flash_total_blocks =                nor_simulator_total_blocks;
+    nor_flash -> lx_nor_flash_words_per_block =             nor_simulator_words_per_block;
+    nor_flash -> lx_nor_flash_words_per_sector =            WORDS_PER_PHYSICAL_SECTOR;
 
     /* Setup function pointers for the NOR flash services.  */
     nor_flash -> lx_nor_flash_driver_read =                 _lx_nor_flash_simulator_read;
@@ -94,6 +166,9 @@ UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash)
     /* Setup local buffer for NOR flash operation. This buffer must be the sector size of the NOR flash memory.  */
     nor_flash -> lx_nor_flash_sector_buffer =  &nor_sector_memory[0];
 
+    /* Remember the flash for the layout of its blocks in fast forward mode.  */
+    nor_simulator_flash =  nor_flash;
+
     /* Return success.  */
     return(LX_SUCCESS);
 }
@@ -109,6 +184,16 @@ UINT  _lx_nor_flash_simulator_read(ULONG *flash_address, ULONG *destination, ULO
     LX_PARAMETER_NOT_USED(nor_flash);
 #endif
 
+    /* Add the time of the read.  */
+    nor_simulator_time +=  (ULONG64) words * (nor_simulator_word_read_time + (sizeof(ULONG) * nor_simulator_bus_byte_time));
+
+    /* In fast forward mode only the metadata and the tokens are read.  */
+    if ((nor_simulator_fast_forward) && (words > 1))
+    {
+        _lx_nor_flash_simulator_fast_forward_copy(flash_address, destination, flash_address, words);
+        return(LX_SUCCESS);
+    }
+
     /* Loop to read flash.  */
     while (words--)
     {
@@ -131,6 +216,16 @@ UINT  _lx_nor_flash_simulator_write(ULONG *flash_address, ULONG *source, ULONG w
     LX_PARAMETER_NOT_USED(nor_flash);
 #endif
 
+    /* Add the time of the program.  */
+    nor_simulator_time +=  (ULONG64) words * (nor_simulator_word_program_time + (sizeof(ULONG) * nor_simulator_bus_byte_time));
+
+    /* In fast forward mode only the metadata and the tokens are programmed.  */
+    if ((nor_simulator_fast_forward) && (words > 1))
+    {
+        _lx_nor_flash_simulator_fast_forward_copy(flash_address, flash_address, source, words);
+        return(LX_SUCCESS);
+    }
+
     /* Loop to write flash.  */
     while (words--)
     {
@@ -157,11 +252,22 @@ ULONG   words;
 #endif
     LX_PARAMETER_NOT_USED(erase_count);
 
+    /* Add the time of the erase.  */
+    nor_simulator_time +=  nor_simulator_block_erase_time;
+
     /* Setup pointer.  */
-    pointer =  (ULONG *) &nor_memory_area[block];
+    pointer =  nor_simulator_memory + (block * nor_simulator_words_per_block);
+
+    /* In fast forward mode the metadata is erased and the tokens of the physical sectors.  */
+    if (nor_simulator_fast_forward)
+    {
+        for (words =  0; words < nor_simulator_words_per_block; words =  words + _lx_nor_flash_simulator_fast_forward_step(block, words))
+            pointer[words] =  (ULONG) 0xFFFFFFFF;
+        return(LX_SUCCESS);
+    }
 
     /* Loop to erase block.  */
-    words =  sizeof(FLASH_BLOCK)/sizeof(ULONG);
+    words =  nor_simulator_words_per_block;
     while (words--)
     {
         
@@ -181,10 +287,10 @@ ULONG   words;
 
 
     /* Setup pointer.  */
-    pointer =  (ULONG *) &nor_memory_area[0];
+    pointer =  nor_simulator_memory;
 
     /* Loop to erase block.  */
-    words =  sizeof(nor_memory_area)/(sizeof(ULONG));
+    words =  nor_simulator_total_blocks * nor_simulator_words_per_block;
     while (words--)
     {
         
@@ -213,10 +319,24 @@ ULONG   words;
     /* Determine if the block is completely erased.  */
     
     /* Pickup the pointer to the first word of the block.  */
-    word_ptr =  (ULONG *) &nor_memory_area[block].erase_count;
+    word_ptr =  nor_simulator_memory + (block * nor_simulator_words_per_block);
     
     /* Calculate the number of words in a block.  */
-    words =  sizeof(FLASH_BLOCK)/sizeof(ULONG);
+    words =  nor_simulator_words_per_block;
+
+    /* Add the time of reading the block.  */
+    nor_simulator_time +=  (ULONG64) words * (nor_simulator_word_read_time + (sizeof(ULONG) * nor_simulator_bus_byte_time));
+
+    /* In fast forward mode only the metadata and the tokens of the physical sectors can be programmed.  */
+    if (nor_simulator_fast_forward)
+    {
+        for (words =  0; words < nor_simulator_words_per_block; words =  words + _lx_nor_flash_simulator_fast_forward_step(block, words))
+        {
+            if (word_ptr[words] != 0xFFFFFFFF)
+                return(LX_ERROR);
+        }
+        return(LX_SUCCESS);
+    }
     
     /* Loop to check if the block is erased.  */
     while (words--)
@@ -249,3 +369,211 @@ UINT  _lx_nor_flash_simulator_system_error(UINT error_code, ULONG block, ULONG s
     return(LX_ERROR);
 }
 
+
+UINT  _lx_nor_flash_simulator_timing_set(ULONG word_read_time, ULONG word_program_time, ULONG block_erase_time, ULONG bus_byte_time)
+{
+
+    /* Setup the time of each operation, in nanoseconds.  */
+    nor_simulator_word_read_time =     word_read_time;
+    nor_simulator_word_program_time =  word_program_time;
+    nor_simulator_block_erase_time =   block_erase_time;
+    nor_simulator_bus_byte_time =      bus_byte_time;
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nor_flash_simulator_time_get(ULONG64 *time)
+{
+
+    /* Return the simulated device time, in nanoseconds.  */
+    *time =  nor_simulator_time;
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nor_flash_simulator_time_reset(VOID)
+{
+
+    /* Start the simulated device time again from zero.  */
+    nor_simulator_time =  0;
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nor_flash_simulator_geometry_set(ULONG total_blocks, ULONG physical_sectors_per_block, ULONG *memory, ULONG64 memory_size)
+{
+
+    /* A null memory selects nor_memory_area.  */
+    if (memory == LX_NULL)
+    {
+        memory =       (ULONG *) &nor_memory_area[0];
+        memory_size =  sizeof(nor_memory_area);
+    }
+
+    /* Check the geometry, the block metadata must fit in one physical sector and the flash in the memory.  */
+    if ((total_blocks < 2) || (physical_sectors_per_block < 2) || (physical_sectors_per_block > 120) ||
+        (((ULONG64) total_blocks * physical_sectors_per_block * WORDS_PER_PHYSICAL_SECTOR * sizeof(ULONG)) > memory_size))
+        return(LX_ERROR);
+
+    /* Setup the geometry and the memory, which take effect when the flash is opened next.  */
+    nor_simulator_total_blocks =     total_blocks;
+    nor_simulator_words_per_block =  physical_sectors_per_block * WORDS_PER_PHYSICAL_SECTOR;
+    nor_simulator_memory =           memory;
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nor_flash_simulator_fast_forward_set(UINT enable)
+{
+
+    /* Select the mode, flash written in one mode can't be used in the other, so the flash is erased.  */
+    nor_simulator_fast_forward =  enable;
+    _lx_nor_flash_simulator_erase_all();
+
+    return(LX_SUCCESS);
+}
+
+
+VOID  _lx_nor_flash_simulator_fast_forward_copy(ULONG *flash_address, ULONG *destination, ULONG *source, ULONG words)
+{
+
+ULONG   block;
+ULONG   offset;
+ULONG   step;
+
+
+    /* Pickup the block and the offset of the flash address in the block.  */
+    offset =  (ULONG) (flash_address - nor_simulator_memory);
+    block =   offset / nor_simulator_words_per_block;
+    offset =  offset % nor_simulator_words_per_block;
+
+    /* Copy the words of the metadata and the token of each physical sector, skip the other words.  */
+    while (words)
+    {
+        step =  _lx_nor_flash_simulator_fast_forward_step(block, offset);
+        if (step > 1)
+            step =  step - ((offset - nor_simulator_flash -> lx_nor_flash_block_physical_sector_offset) % step);
+        if ((step == 1) || (step == nor_simulator_flash -> lx_nor_flash_words_per_sector))
+            *destination =  *source;
+        if (step > words)
+            step =  words;
+        destination =  destination + step;
+        source =       source + step;
+        words =        words - step;
+        offset =       offset + step;
+        if (offset >= nor_simulator_words_per_block)
+        {
+            block++;
+            offset =  0;
+        }
+    }
+}
+
+
+ULONG  _lx_nor_flash_simulator_fast_forward_step(ULONG block, ULONG offset)
+{
+
+    /* All the words of the metadata and of the blocks LevelX doesn't manage, like the checkpoint blocks,
+       are used, of the physical sectors only their first word.  */
+    if ((nor_simulator_flash == LX_NULL) || (block >= nor_simulator_flash -> lx_nor_flash_total_blocks) ||
+        (nor_simulator_flash -> lx_nor_flash_block_physical_sector_offset == 0) ||
+        (offset < nor_simulator_flash -> lx_nor_flash_block_physical_sector_offset))
+        return(1);
+    return(nor_simulator_flash -> lx_nor_flash_words_per_sector);
+}
+
+
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+UINT  _lx_nor_flash_simulator_file_open(CHAR *file_name, ULONG total_blocks, ULONG physical_sectors_per_block)
+{
+
+struct stat file_status;
+ULONG64     size;
+void        *memory;
+UINT        new_image;
+UINT        status;
+
+
+    /* Close the device image that is still open.  */
+    _lx_nor_flash_simulator_file_close();
+
+    /* Open the device image, it is created if it doesn't exist.  */
+    nor_simulator_file =  open(file_name, O_RDWR | O_CREAT, 0644);
+    if (nor_simulator_file < 0)
+        return(LX_ERROR);
+
+    /* A new image is extended to the size of the flash and erased, an existing image must already have
+       the size of the flash.  */
+    size =  (ULONG64) total_blocks * physical_sectors_per_block * WORDS_PER_PHYSICAL_SECTOR * sizeof(ULONG);
+    new_image =  LX_FALSE;
+    status =  LX_ERROR;
+    if (fstat(nor_simulator_file, &file_status) == 0)
+    {
+        if (file_status.st_size == 0)
+        {
+            new_image =  LX_TRUE;
+            if ((size > 0) && (ftruncate(nor_simulator_file, (off_t) size) == 0))
+                status =  LX_SUCCESS;
+        }
+        else if ((ULONG64) file_status.st_size == size)
+            status =  LX_SUCCESS;
+    }
+
+    /* Map the image and make it the memory of the flash.  */
+    if (status == LX_SUCCESS)
+    {
+        memory =  mmap(NULL, (size_t) size, PROT_READ | PROT_WRITE, MAP_SHARED, nor_simulator_file, 0);
+        if (memory != MAP_FAILED)
+        {
+            nor_simulator_file_memory =  memory;
+            nor_simulator_file_size =    (size_t) size;
+            status =  _lx_nor_flash_simulator_geometry_set(total_blocks, physical_sectors_per_block, (ULONG *) memory, size);
+        }
+        else
+            status =  LX_ERROR;
+    }
+    if (status != LX_SUCCESS)
+    {
+        _lx_nor_flash_simulator_file_close();
+        return(LX_ERROR);
+    }
+
+    /* Erase a new image.  */
+    if (new_image)
+        _lx_nor_flash_simulator_erase_all();
+
+    return(LX_SUCCESS);
+}
+
+
+UINT  _lx_nor_flash_simulator_file_close(VOID)
+{
+
+UINT    status =  LX_SUCCESS;
+
+
+    /* Write the mapped image back to the file and return to the default geometry in nor_memory_area.  */
+    if (nor_simulator_file_memory != NULL)
+    {
+        if (msync(nor_simulator_file_memory, nor_simulator_file_size, MS_SYNC) != 0)
+            status =  LX_ERROR;
+        munmap(nor_simulator_file_memory, nor_simulator_file_size);
+        nor_simulator_file_memory =  NULL;
+        _lx_nor_flash_simulator_geometry_set(TOTAL_BLOCKS, PHYSICAL_SECTORS_PER_BLOCK, LX_NULL, 0);
+    }
+
+    /* Close the file.  */
+    if (nor_simulator_file >= 0)
+    {
+        close(nor_simulator_file);
+        nor_simulator_file =  -1;
+    }
+
+    return(status);
+}
+#endif
+
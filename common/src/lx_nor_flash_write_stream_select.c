@@ -0,0 +1,146 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   NOR Flash                                                           */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_nor_flash_write_stream_select                   PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function selects the write stream of a logical sector write.   */ 
+/*    The stream given to lx_nor_flash_sector_write_stream is used if     */ 
+/*    there is one. Otherwise, if the hot sector table is enabled, a      */ 
+/*    sector written again while it is still among the most recently      */ 
+/*    written sectors is hot. Any other sector is cold. Sectors are       */ 
+/*    replaced in the table with a clock, so sectors that keep being      */ 
+/*    written again stay in it.                                           */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    nor_flash                             NOR flash instance            */ 
+/*    logical_sector                        Logical sector number         */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Internal LevelX                                                     */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+VOID  _lx_nor_flash_write_stream_select(LX_NOR_FLASH *nor_flash, ULONG logical_sector)
+{
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+ULONG   i;
+
+
+    /* Determine if the caller supplied the write stream.  */
+    if (nor_flash -> lx_nor_flash_write_stream_hint != LX_NOR_WRITE_STREAM_AUTO)
+    {
+
+        /* Yes, use it.  */
+        nor_flash -> lx_nor_flash_write_stream =  nor_flash -> lx_nor_flash_write_stream_hint;
+    }
+    else
+    {
+
+        /* Default to the cold write stream.  */
+        nor_flash -> lx_nor_flash_write_stream =  LX_NOR_WRITE_STREAM_COLD;
+
+        /* Determine if this logical sector was written recently.  */
+        for (i = 0; i < nor_flash -> lx_nor_flash_hot_sector_entries; i++)
+        {
+
+            /* Is this the logical sector?  */
+            if ((nor_flash -> lx_nor_flash_hot_sectors[i] & LX_NOR_LOGICAL_SECTOR_MASK) == logical_sector)
+            {
+
+                /* Yes, the sector is rewritten often, use the hot write stream.  */
+                nor_flash -> lx_nor_flash_write_stream =  LX_NOR_WRITE_STREAM_HOT;
+
+                /* Mark the sector as referenced, so the clock passes over it once.  */
+                nor_flash -> lx_nor_flash_hot_sectors[i] =  logical_sector | LX_NOR_HOT_SECTOR_REFERENCED;
+                break;
+            }
+        }
+
+        /* Determine if the hot sector table is enabled and the logical sector was not found.  */
+        if ((nor_flash -> lx_nor_flash_hot_sector_entries) && (i == nor_flash -> lx_nor_flash_hot_sector_entries))
+        {
+
+            /* No, move the clock past the referenced sectors, clearing their reference.  */
+            while (nor_flash -> lx_nor_flash_hot_sectors[nor_flash -> lx_nor_flash_hot_sector_next] & LX_NOR_HOT_SECTOR_REFERENCED)
+            {
+                nor_flash -> lx_nor_flash_hot_sectors[nor_flash -> lx_nor_flash_hot_sector_next] &=  ~((ULONG) LX_NOR_HOT_SECTOR_REFERENCED);
+                nor_flash -> lx_nor_flash_hot_sector_next++;
+                if (nor_flash -> lx_nor_flash_hot_sector_next >= nor_flash -> lx_nor_flash_hot_sector_entries)
+                    nor_flash -> lx_nor_flash_hot_sector_next =  0;
+            }
+
+            /* Remember the sector in place of the sector under the clock.  */
+            nor_flash -> lx_nor_flash_hot_sectors[nor_flash -> lx_nor_flash_hot_sector_next] =  logical_sector;
+            nor_flash -> lx_nor_flash_hot_sector_next++;
+            if (nor_flash -> lx_nor_flash_hot_sector_next >= nor_flash -> lx_nor_flash_hot_sector_entries)
+                nor_flash -> lx_nor_flash_hot_sector_next =  0;
+        }
+    }
+
+    /* Increment the number of sectors written to this stream.  */
+    nor_flash -> lx_nor_flash_write_stream_sectors[nor_flash -> lx_nor_flash_write_stream]++;
+#else
+
+    LX_PARAMETER_NOT_USED(nor_flash);
+    LX_PARAMETER_NOT_USED(logical_sector);
+#endif
+}
@@ -0,0 +1,121 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   Statistics                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_stats_api_record                                PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function records a completed call of a timed API in the        */ 
+/*    flash statistics. The latency since the start time is added to      */ 
+/*    the log2 latency histogram of the API.                              */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    stats                                 Flash statistics              */ 
+/*    api                                   Timed API                     */ 
+/*    start_time                            Clock at the start of the API */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    LX_STATS_CLOCK_GET                    Get the statistics clock      */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    _lx_nand_flash_defragment                                           */ 
+/*    _lx_nand_flash_partial_defragment                                   */ 
+/*    _lx_nand_flash_sector_read                                          */ 
+/*    _lx_nand_flash_sector_release                                       */ 
+/*    _lx_nand_flash_sector_write                                         */ 
+/*    _lx_nor_flash_defragment                                            */ 
+/*    _lx_nor_flash_partial_defragment                                    */ 
+/*    _lx_nor_flash_sector_read                                           */ 
+/*    _lx_nor_flash_sector_release                                        */ 
+/*    _lx_nor_flash_sector_write                                          */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+
+VOID  _lx_stats_api_record(LX_FLASH_STATS *stats, UINT api, ULONG start_time)
+{
+
+ULONG   latency;
+UINT    bucket;
+
+
+    /* Calculate the latency of this call. The clock may wrap.  */
+    latency =  (ULONG) (LX_STATS_CLOCK_GET() - start_time);
+
+    /* The histogram bucket is the number of significant bits of the latency.  */
+    bucket =  0;
+    while ((bucket < (LX_STATS_HISTOGRAM_BUCKETS - 1)) && ((latency >> bucket) != 0))
+    {
+
+        /* Move to the next bucket.  */
+        bucket++;
+    }
+
+    /* Record the call.  */
+    stats -> lx_flash_stats_api_calls[api]++;
+    stats -> lx_flash_stats_api_latency_total[api] +=  latency;
+    stats -> lx_flash_stats_api_latency_histogram[api][bucket]++;
+
+    /* Determine if this is the longest call so far.  */
+    if (latency > stats -> lx_flash_stats_api_latency_max[api])
+    {
+
+        /* Yes, remember its latency.  */
+        stats -> lx_flash_stats_api_latency_max[api] =  latency;
+    }
+}
@@ -0,0 +1,130 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   Statistics                                                          */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_stats_latency_percentile                        PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function returns a latency percentile of a timed API from      */ 
+/*    the flash statistics, e.g. the 99th percentile of sector writes.    */ 
+/*    The result is the upper bound of the histogram bucket that holds    */ 
+/*    the percentile, limited to the maximum latency of the API.          */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    stats                                 Flash statistics              */ 
+/*    api                                   Timed API                     */ 
+/*    percent                               Percentile, 1 through 100     */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    latency                               Latency percentile            */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    Application Code                                                    */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+
+ULONG  _lx_stats_latency_percentile(LX_FLASH_STATS *stats, UINT api, UINT percent)
+{
+
+ULONG64 threshold;
+ULONG64 calls;
+UINT    bucket;
+ULONG   latency;
+
+
+    /* Determine if the parameters are valid and the API was called.  */
+    if ((api >= LX_STATS_APIS) || (percent == 0) || (percent > 100) || (stats -> lx_flash_stats_api_calls[api] == 0))
+    {
+
+        /* No percentile, return 0.  */
+        return(0);
+    }
+
+    /* Calculate the number of calls at or below the percentile, rounded up.  */
+    threshold =  (((ULONG64) stats -> lx_flash_stats_api_calls[api] * percent) + 99) / 100;
+
+    /* Loop through the buckets until the threshold is reached.  */
+    calls =  0;
+    for (bucket = 0; bucket < (LX_STATS_HISTOGRAM_BUCKETS - 1); bucket++)
+    {
+
+        /* Count the calls of this bucket.  */
+        calls +=  stats -> lx_flash_stats_api_latency_histogram[api][bucket];
+
+        /* Determine if the percentile is in this bucket.  */
+        if (calls >= threshold)
+        {
+
+            /* Yes, get out of the loop.  */
+            break;
+        }
+    }
+
+    /* The upper bound of bucket n is 2^n - 1, the last bucket is bounded by the maximum.  */
+    latency =  stats -> lx_flash_stats_api_latency_max[api];
+    if ((bucket < (LX_STATS_HISTOGRAM_BUCKETS - 1)) && ((((ULONG) 1 << bucket) - 1) < latency))
+    {
+
+        /* Use the upper bound of the bucket.  */
+        latency =  ((ULONG) 1 << bucket) - 1;
+    }
+
+    /* Return the percentile.  */
+    return(latency);
+}
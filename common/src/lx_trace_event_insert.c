@@ -0,0 +1,112 @@
+/***************************************************************************
+ * Copyright (c) 2024 Microsoft Corporation
+ *
+ * This program and the accompanying materials are made available under the
+ * terms of the MIT License which is available at
+ * https://opensource.org/licenses/MIT.
+ *
+ * SPDX-License-Identifier: MIT
+ **************************************************************************/
+
+
+/**************************************************************************/
+/**************************************************************************/
+/**                                                                       */
+/** LevelX Component                                                      */
+/**                                                                       */
+/**   Trace                                                               */
+/**                                                                       */
+/**************************************************************************/
+/**************************************************************************/
+
+#define LX_SOURCE_CODE
+
+
+/* Disable ThreadX error checking.  */
+
+#ifndef LX_DISABLE_ERROR_CHECKING
+#define LX_DISABLE_ERROR_CHECKING
+#endif
+
+
+/* Include necessary system files.  */
+
+#include "lx_api.h"
+
+
+
+
+/**************************************************************************/ 
+/*                                                                        */ 
+/*  FUNCTION                                               RELEASE        */ 
+/*                                                                        */ 
+/*    _lx_trace_event_insert                              PORTABLE C      */ 
+/*                                                           6.x          */
+/*  AUTHOR                                                                */
+/*                                                                        */
+/*    Eclipse ThreadX Contributors                                        */
+/*                                                                        */
+/*  DESCRIPTION                                                           */ 
+/*                                                                        */ 
+/*    This function records an event in the trace buffer of a flash       */ 
+/*    instance. Once the buffer is full, the oldest event is overwritten. */ 
+/*                                                                        */ 
+/*  INPUT                                                                 */ 
+/*                                                                        */ 
+/*    trace                                 Trace buffer, LX_NULL if none */ 
+/*    event                                 Trace event                   */ 
+/*    info1                                 First event information       */ 
+/*    info2                                 Second event information      */ 
+/*                                                                        */ 
+/*  OUTPUT                                                                */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLS                                                                 */ 
+/*                                                                        */ 
+/*    None                                                                */ 
+/*                                                                        */ 
+/*  CALLED BY                                                             */ 
+/*                                                                        */ 
+/*    NOR and NAND flash internal functions                               */ 
+/*                                                                        */ 
+/*  RELEASE HISTORY                                                       */ 
+/*                                                                        */ 
+/*    DATE              NAME                      DESCRIPTION             */
+/*                                                                        */
+/*  xx-xx-xxxx     Eclipse ThreadX          Initial Version 6.x           */
+/*                                                                        */
+/**************************************************************************/
+
+VOID  _lx_trace_event_insert(LX_TRACE_HEADER *trace, ULONG event, ULONG info1, ULONG info2)
+{
+
+LX_TRACE_EVENT  *event_ptr;
+
+
+    /* Determine if the trace is enabled.  */
+    if (trace == LX_NULL)
+    {
+
+        /* No, nothing to record.  */
+        return;
+    }
+
+    /* Pickup the next event of the buffer, the events follow the header.  */
+    event_ptr =  ((LX_TRACE_EVENT *) (trace + 1)) + trace -> lx_trace_header_next;
+
+    /* Record the event.  */
+    event_ptr -> lx_trace_event_time =   LX_STATS_CLOCK_GET();
+    event_ptr -> lx_trace_event_id =     event;
+    event_ptr -> lx_trace_event_info1 =  info1;
+    event_ptr -> lx_trace_event_info2 =  info2;
+
+    /* Move to the next event, wrapping to the start of the buffer.  */
+    trace -> lx_trace_header_next++;
+    if (trace -> lx_trace_header_next >= trace -> lx_trace_header_events)
+        trace -> lx_trace_header_next =  0;
+
+    /* Increment the number of events recorded.  */
+    trace -> lx_trace_header_total++;
+}
+
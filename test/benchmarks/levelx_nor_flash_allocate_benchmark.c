@@ -0,0 +1,397 @@
+/* NOR flash physical sector allocation benchmark. Compares the allocations per second of the previous
+   free sector search, which tests the free sector bit map one bit at a time, against the word bit scan
+   and, when the block summary is enabled, the next free sector kept in RAM. All methods must allocate
+   the same sectors in the same order. The results are printed as CSV, one line per geometry and
+   method.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "lx_api.h"
+
+#define     DEMO_STACK_SIZE         4096
+
+/* Define the benchmark parameters. BENCHMARK_BUILD names the build configuration in the results.  */
+
+#ifndef BENCHMARK_BUILD
+#define BENCHMARK_BUILD                     "default"
+#endif
+
+/* Define the geometry of the benchmark flash. The first physical sector of each block is used for the
+   block header, free sector bit map and mapping list.  */
+
+#define BENCHMARK_TOTAL_BLOCKS              64
+#define BENCHMARK_GEOMETRIES                4
+#define BENCHMARK_ALLOCATIONS               262144
+
+/* Define the allocation methods.  */
+
+#define BENCHMARK_METHOD_BIT_SEARCH         0
+#define BENCHMARK_METHOD_BIT_SCAN           1
+#define BENCHMARK_METHOD_NEXT_FREE_SECTOR   2
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+#define BENCHMARK_METHODS                   3
+#else
+#define BENCHMARK_METHODS                   2
+#endif
+
+
+/* Define the ThreadX object control blocks...  */
+#ifndef LX_STANDALONE_ENABLE
+TX_THREAD               thread_0;
+#endif
+UCHAR                   thread_0_stack[DEMO_STACK_SIZE];
+
+/* Define LevelX structures.  */
+
+LX_NOR_FLASH    nor_benchmark_flash;
+ULONG           nor_benchmark_sector_memory[LX_NOR_SECTOR_SIZE];
+
+ULONG           benchmark_sectors_per_block[BENCHMARK_GEOMETRIES] = {8, 32, 128, 512};
+CHAR            *benchmark_method_name[3] = {"bit_search", "bit_scan", "next_free_sector"};
+ULONG           *benchmark_memory_area;
+ULONG           benchmark_words_per_block;
+ULONG           benchmark_method;
+ULONG           benchmark_bit_map_reads;
+VOID            *benchmark_summary_memory;
+ULONG           benchmark_summary_size;
+
+
+/* Define the benchmark flash driver prototypes.  */
+
+UINT  benchmark_driver_initialize(LX_NOR_FLASH *nor_flash);
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  benchmark_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
+UINT  benchmark_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+UINT  benchmark_driver_block_erased_verify(LX_NOR_FLASH *nor_flash, ULONG block);
+#else
+UINT  benchmark_driver_read(ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  benchmark_driver_write(ULONG *flash_address, ULONG *source, ULONG words);
+UINT  benchmark_driver_block_erase(ULONG block, ULONG erase_count);
+UINT  benchmark_driver_block_erased_verify(ULONG block);
+#endif
+UINT  benchmark_bit_search_allocate(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG **physical_sector_map_entry);
+
+
+/* Define thread prototypes.  */
+
+void    thread_0_entry(ULONG thread_input);
+void    benchmark_failed(void);
+
+
+
+/* Define main entry point.  */
+
+int main()
+{
+
+    /* Enter the ThreadX kernel.  */
+#ifndef LX_STANDALONE_ENABLE
+    tx_kernel_enter();
+#else
+    thread_0_entry(0);
+#endif
+
+}
+
+
+/* Define what the initial system looks like.  */
+#ifndef LX_STANDALONE_ENABLE
+void    tx_application_define(void *first_unused_memory)
+{
+
+
+    /* Create the main thread.  */
+    tx_thread_create(&thread_0, "thread 0", thread_0_entry, 0,
+            thread_0_stack, DEMO_STACK_SIZE,
+            1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+#endif
+
+/* Define the benchmark thread.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   i, j, k;
+ULONG   allocations;
+ULONG   sector;
+ULONG   expected_sector;
+ULONG   mismatches;
+ULONG   bit_map_reads;
+ULONG   *map_entry;
+ULONG   *sector_address;
+clock_t start;
+double  allocate_time;
+UINT    status;
+
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("build,blocks,sectors_per_block,method,allocations,ns_per_allocation,allocations_per_second,bit_map_reads_per_allocation\n");
+
+    for (i = 0; i < BENCHMARK_GEOMETRIES; i++)
+    {
+
+        /* Allocate the flash and the block summary memory.  */
+        benchmark_words_per_block = benchmark_sectors_per_block[i] * LX_NOR_SECTOR_SIZE;
+        benchmark_memory_area =     malloc(BENCHMARK_TOTAL_BLOCKS * benchmark_words_per_block * sizeof(ULONG));
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+        benchmark_summary_size =    (ULONG) LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(BENCHMARK_TOTAL_BLOCKS);
+#else
+        benchmark_summary_size =    sizeof(ULONG);
+#endif
+        benchmark_summary_memory =  malloc(benchmark_summary_size);
+        if ((benchmark_memory_area == LX_NULL) || (benchmark_summary_memory == LX_NULL))
+            benchmark_failed();
+
+        for (benchmark_method = 0; benchmark_method < BENCHMARK_METHODS; benchmark_method++)
+        {
+
+            allocations =  0;
+            mismatches =  0;
+            bit_map_reads =  0;
+            allocate_time =  0.0;
+            while (allocations < BENCHMARK_ALLOCATIONS)
+            {
+
+                /* Erase the flash and open it.  */
+                for (j = 0; j < BENCHMARK_TOTAL_BLOCKS * benchmark_words_per_block; j++)
+                    benchmark_memory_area[j] =  LX_ALL_ONES;
+                status =  lx_nor_flash_open(&nor_benchmark_flash, "benchmark nor flash", benchmark_driver_initialize);
+                if (status != LX_SUCCESS)
+                    benchmark_failed();
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+                if (nor_benchmark_flash.lx_nor_flash_block_summary_enabled != (benchmark_method == BENCHMARK_METHOD_NEXT_FREE_SECTOR))
+                    benchmark_failed();
+#endif
+
+                /* Allocate every free physical sector of the flash.  */
+                expected_sector =  nor_benchmark_flash.lx_nor_flash_free_block_search * nor_benchmark_flash.lx_nor_flash_physical_sectors_per_block;
+                benchmark_bit_map_reads =  0;
+                start =  clock();
+                for (k = 0; nor_benchmark_flash.lx_nor_flash_free_physical_sectors; k++)
+                {
+
+                    if (benchmark_method == BENCHMARK_METHOD_BIT_SEARCH)
+                        status =  benchmark_bit_search_allocate(&nor_benchmark_flash, k, &map_entry);
+                    else
+                        status =  _lx_nor_flash_physical_sector_allocate(&nor_benchmark_flash, k, &map_entry, &sector_address);
+                    if (status != LX_SUCCESS)
+                        benchmark_failed();
+                    nor_benchmark_flash.lx_nor_flash_free_physical_sectors--;
+
+                    /* Every method must allocate the sectors in order.  */
+                    j =  (ULONG) (map_entry - benchmark_memory_area) / benchmark_words_per_block;
+                    sector =  (j * nor_benchmark_flash.lx_nor_flash_physical_sectors_per_block) +
+                              (ULONG) (map_entry - (benchmark_memory_area + (j * benchmark_words_per_block) + nor_benchmark_flash.lx_nor_flash_block_physical_sector_mapping_offset));
+                    if (sector != expected_sector)
+                        mismatches++;
+                    expected_sector =  (sector + 1) % nor_benchmark_flash.lx_nor_flash_total_physical_sectors;
+                }
+                allocate_time +=  (double) (clock() - start);
+                allocations +=  k;
+                bit_map_reads +=  benchmark_bit_map_reads;
+
+                status =  lx_nor_flash_close(&nor_benchmark_flash);
+                if (status != LX_SUCCESS)
+                    benchmark_failed();
+            }
+
+            printf("%s,%d,%lu,%s,%lu,%.1f,%.0f,%.3f\n", BENCHMARK_BUILD, BENCHMARK_TOTAL_BLOCKS, (unsigned long) benchmark_sectors_per_block[i], benchmark_method_name[benchmark_method],
+                   (unsigned long) allocations, (allocate_time * 1.0e9) / (CLOCKS_PER_SEC * (double) allocations),
+                   (allocate_time > 0.0) ? (((double) allocations * CLOCKS_PER_SEC) / allocate_time) : 0.0,
+                   ((double) bit_map_reads) / (double) allocations);
+
+            if (mismatches != 0)
+                benchmark_failed();
+        }
+
+        free(benchmark_memory_area);
+        free(benchmark_summary_memory);
+    }
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+void  benchmark_failed(void)
+{
+
+    printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+    while(1)
+    {
+    }
+}
+
+
+/* Allocate a free physical sector with the previous free sector search. The free sector bit map is tested
+   one bit at a time and the word is read again before the bit is cleared.  */
+
+UINT  benchmark_bit_search_allocate(LX_NOR_FLASH *nor_flash, ULONG logical_sector, ULONG **physical_sector_map_entry)
+{
+
+ULONG   search_block;
+ULONG   *block_word_ptr;
+ULONG   block_word;
+ULONG   list_word;
+ULONG   i, j, k, l;
+
+
+    search_block =  nor_flash -> lx_nor_flash_free_block_search;
+    for (i = 0; i < nor_flash -> lx_nor_flash_total_blocks; i++)
+    {
+
+        block_word_ptr =  nor_flash -> lx_nor_flash_base_address + (search_block * nor_flash -> lx_nor_flash_words_per_block);
+        for (j = 0; j < nor_flash -> lx_nor_flash_block_bit_map_words; j++)
+        {
+
+            _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
+            for (k = 0; (k < 32) && (block_word); k++)
+            {
+
+                if (block_word & 1)
+                {
+
+                    _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
+                    block_word =  block_word & ~(((ULONG) 1) << k);
+                    _lx_nor_flash_driver_write(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_free_bit_map_offset + j), &block_word, 1);
+
+                    /* Read the mapping list and write the minimum and maximum logical sector when the block is full.  */
+                    if (((block_word >> 1) == 0) && (j == (nor_flash -> lx_nor_flash_block_bit_map_words - 1)))
+                    {
+                        for (l = 0; l < nor_flash -> lx_nor_flash_physical_sectors_per_block; l++)
+                            _lx_nor_flash_driver_read(nor_flash, (block_word_ptr + nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + l), &list_word, 1);
+                        _lx_nor_flash_driver_write(nor_flash, block_word_ptr + LX_NOR_FLASH_MIN_LOGICAL_SECTOR_OFFSET, &logical_sector, 1);
+                        _lx_nor_flash_driver_write(nor_flash, block_word_ptr + LX_NOR_FLASH_MAX_LOGICAL_SECTOR_OFFSET, &logical_sector, 1);
+                        search_block =  (search_block + 1) % nor_flash -> lx_nor_flash_total_blocks;
+                    }
+
+                    nor_flash -> lx_nor_flash_free_block_search =  search_block;
+                    *physical_sector_map_entry =  block_word_ptr + (nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + (j * 32)) + k;
+                    return(LX_SUCCESS);
+                }
+                block_word =  block_word >> 1;
+            }
+        }
+        search_block =  (search_block + 1) % nor_flash -> lx_nor_flash_total_blocks;
+    }
+    return(LX_NO_SECTORS);
+}
+
+
+UINT  benchmark_driver_initialize(LX_NOR_FLASH *nor_flash)
+{
+
+    /* Setup the base address and geometry of the flash.  */
+    nor_flash -> lx_nor_flash_base_address =    benchmark_memory_area;
+    nor_flash -> lx_nor_flash_total_blocks =    BENCHMARK_TOTAL_BLOCKS;
+    nor_flash -> lx_nor_flash_words_per_block = benchmark_words_per_block;
+
+    /* Setup function pointers for the NOR flash services.  */
+    nor_flash -> lx_nor_flash_driver_read =                 benchmark_driver_read;
+    nor_flash -> lx_nor_flash_driver_write =                benchmark_driver_write;
+    nor_flash -> lx_nor_flash_driver_block_erase =          benchmark_driver_block_erase;
+    nor_flash -> lx_nor_flash_driver_block_erased_verify =  benchmark_driver_block_erased_verify;
+    nor_flash -> lx_nor_flash_sector_buffer =               nor_benchmark_sector_memory;
+
+    /* Supply the block summary memory for the next free sector method.  */
+    if (benchmark_method == BENCHMARK_METHOD_NEXT_FREE_SECTOR)
+        return(lx_nor_flash_block_summary_enable(nor_flash, benchmark_summary_memory, benchmark_summary_size));
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words)
+#else
+UINT  benchmark_driver_read(ULONG *flash_address, ULONG *destination, ULONG words)
+#endif
+{
+
+ULONG   offset;
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    /* Count the reads of the free sector bit map.  */
+    offset =  (ULONG) (flash_address - benchmark_memory_area) % benchmark_words_per_block;
+    if ((offset >= nor_benchmark_flash.lx_nor_flash_block_free_bit_map_offset) &&
+        (offset < nor_benchmark_flash.lx_nor_flash_block_physical_sector_mapping_offset))
+        benchmark_bit_map_reads++;
+
+    while (words--)
+        *destination++ =  *flash_address++;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words)
+#else
+UINT  benchmark_driver_write(ULONG *flash_address, ULONG *source, ULONG words)
+#endif
+{
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    while (words--)
+        *flash_address++ =  *source++;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count)
+#else
+UINT  benchmark_driver_block_erase(ULONG block, ULONG erase_count)
+#endif
+{
+
+ULONG   i;
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+    LX_PARAMETER_NOT_USED(erase_count);
+
+    for (i = 0; i < benchmark_words_per_block; i++)
+        benchmark_memory_area[(block * benchmark_words_per_block) + i] =  LX_ALL_ONES;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_block_erased_verify(LX_NOR_FLASH *nor_flash, ULONG block)
+#else
+UINT  benchmark_driver_block_erased_verify(ULONG block)
+#endif
+{
+
+ULONG   i;
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    for (i = 0; i < benchmark_words_per_block; i++)
+    {
+        if (benchmark_memory_area[(block * benchmark_words_per_block) + i] != LX_ALL_ONES)
+            return(LX_ERROR);
+    }
+    return(LX_SUCCESS);
+}
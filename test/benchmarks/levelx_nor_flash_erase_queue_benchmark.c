@@ -0,0 +1,336 @@
+/* NOR flash erase queue benchmark. Compares the time to select the next block to erase with the
+   erase queue against the scan of all blocks, and checks that both select the same block. The
+   results are printed as CSV, one line per flash size.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "lx_api.h"
+
+#define     DEMO_STACK_SIZE         4096
+
+/* Define the benchmark parameters. BENCHMARK_BUILD names the build configuration in the results.  */
+
+#ifndef BENCHMARK_BUILD
+#define BENCHMARK_BUILD                     "default"
+#endif
+
+/* Define the geometry of the benchmark flash. Each block is 8 physical sectors (4KB), one of which
+   is used for the block header and mapping list.  */
+
+#define BENCHMARK_SECTORS_PER_BLOCK         8
+#define BENCHMARK_WORDS_PER_BLOCK           (BENCHMARK_SECTORS_PER_BLOCK * LX_NOR_SECTOR_SIZE)
+#define BENCHMARK_GEOMETRIES                4
+#define BENCHMARK_SELECTIONS                256
+#define BENCHMARK_QUEUE_REPEAT              1000
+#define BENCHMARK_SCAN_REPEAT               4
+
+
+/* Define the ThreadX object control blocks...  */
+#ifndef LX_STANDALONE_ENABLE
+TX_THREAD               thread_0;
+#endif
+UCHAR                   thread_0_stack[DEMO_STACK_SIZE];
+
+/* Define LevelX structures.  */
+
+LX_NOR_FLASH    nor_benchmark_flash;
+ULONG           buffer[LX_NOR_SECTOR_SIZE];
+ULONG           nor_benchmark_sector_memory[LX_NOR_SECTOR_SIZE];
+
+ULONG           benchmark_total_blocks[BENCHMARK_GEOMETRIES] = {64, 256, 1024, 4096};
+ULONG           *benchmark_memory_area;
+ULONG           benchmark_blocks;
+ULONG           benchmark_driver_reads;
+VOID            *benchmark_summary_memory;
+ULONG           benchmark_summary_size;
+
+
+/* Define the benchmark flash driver prototypes.  */
+
+UINT  benchmark_driver_initialize(LX_NOR_FLASH *nor_flash);
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  benchmark_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
+UINT  benchmark_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+UINT  benchmark_driver_block_erased_verify(LX_NOR_FLASH *nor_flash, ULONG block);
+#else
+UINT  benchmark_driver_read(ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  benchmark_driver_write(ULONG *flash_address, ULONG *source, ULONG words);
+UINT  benchmark_driver_block_erase(ULONG block, ULONG erase_count);
+UINT  benchmark_driver_block_erased_verify(ULONG block);
+#endif
+
+
+/* Define thread prototypes.  */
+
+void    thread_0_entry(ULONG thread_input);
+void    benchmark_failed(void);
+
+
+
+/* Define main entry point.  */
+
+int main()
+{
+
+    /* Enter the ThreadX kernel.  */
+#ifndef LX_STANDALONE_ENABLE
+    tx_kernel_enter();
+#else
+    thread_0_entry(0);
+#endif
+
+}
+
+
+/* Define what the initial system looks like.  */
+#ifndef LX_STANDALONE_ENABLE
+void    tx_application_define(void *first_unused_memory)
+{
+
+
+    /* Create the main thread.  */
+    tx_thread_create(&thread_0, "thread 0", thread_0_entry, 0,
+            thread_0_stack, DEMO_STACK_SIZE,
+            1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+#endif
+
+/* Define the benchmark thread.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_ERASE_QUEUE
+ULONG   i, j, k;
+ULONG   logical_sectors;
+ULONG   writes;
+ULONG   interval;
+ULONG   random;
+ULONG   selections;
+ULONG   mismatches;
+ULONG   scan_reads;
+ULONG   queue_block, queue_erase_count, queue_mapped_sectors, queue_obsolete_sectors;
+ULONG   scan_block, scan_erase_count, scan_mapped_sectors, scan_obsolete_sectors;
+clock_t start;
+double  queue_time;
+double  scan_time;
+UINT    status;
+
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("build,blocks,sectors_per_block,selections,mismatches,queue_ns_per_select,scan_ns_per_select,scan_reads_per_select\n");
+
+    for (i = 0; i < BENCHMARK_GEOMETRIES; i++)
+    {
+
+        /* Allocate and erase the flash and the block summary memory.  */
+        benchmark_blocks =          benchmark_total_blocks[i];
+        benchmark_memory_area =     malloc(benchmark_blocks * BENCHMARK_WORDS_PER_BLOCK * sizeof(ULONG));
+        benchmark_summary_size =    (ULONG) LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(benchmark_blocks);
+        benchmark_summary_memory =  malloc(benchmark_summary_size);
+        if ((benchmark_memory_area == LX_NULL) || (benchmark_summary_memory == LX_NULL))
+            benchmark_failed();
+        for (j = 0; j < benchmark_blocks * BENCHMARK_WORDS_PER_BLOCK; j++)
+            benchmark_memory_area[j] =  LX_ALL_ONES;
+
+        status =  lx_nor_flash_open(&nor_benchmark_flash, "benchmark nor flash", benchmark_driver_initialize);
+        if ((status != LX_SUCCESS) || (nor_benchmark_flash.lx_nor_flash_block_summary_enabled != LX_TRUE))
+            benchmark_failed();
+
+        /* Fill three quarters of the flash, then overwrite as many random sectors.  */
+        logical_sectors =  (nor_benchmark_flash.lx_nor_flash_total_physical_sectors * 3) / 4;
+        writes =  logical_sectors * 2;
+        interval =  writes / BENCHMARK_SELECTIONS;
+        random =  1;
+        selections =  0;
+        mismatches =  0;
+        scan_reads =  0;
+        queue_time =  0.0;
+        scan_time =   0.0;
+        for (j = 0; j < writes; j++)
+        {
+
+            if (j < logical_sectors)
+            {
+                k =  j;
+            }
+            else
+            {
+                random =  (random * 1103515245UL) + 12345UL;
+                k =  (random >> 8) % logical_sectors;
+            }
+
+            buffer[0] =  j;
+            status =  lx_nor_flash_sector_write(&nor_benchmark_flash, k, buffer);
+            if (status != LX_SUCCESS)
+                benchmark_failed();
+
+            /* Periodically compare the selection of the next block to erase.  */
+            if ((j % interval) != 0)
+                continue;
+
+            /* Select with the erase queue.  */
+            start =  clock();
+            for (k = 0; k < BENCHMARK_QUEUE_REPEAT; k++)
+            {
+                _lx_nor_flash_next_block_to_erase_find(&nor_benchmark_flash, &queue_block, &queue_erase_count, &queue_mapped_sectors, &queue_obsolete_sectors);
+            }
+            queue_time +=  ((double) (clock() - start)) / BENCHMARK_QUEUE_REPEAT;
+
+            /* Select by scanning all the blocks in the flash.  */
+            nor_benchmark_flash.lx_nor_flash_block_summary_enabled =  LX_FALSE;
+            benchmark_driver_reads =  0;
+            start =  clock();
+            for (k = 0; k < BENCHMARK_SCAN_REPEAT; k++)
+            {
+                _lx_nor_flash_next_block_to_erase_find(&nor_benchmark_flash, &scan_block, &scan_erase_count, &scan_mapped_sectors, &scan_obsolete_sectors);
+            }
+            scan_time +=  ((double) (clock() - start)) / BENCHMARK_SCAN_REPEAT;
+            scan_reads +=  benchmark_driver_reads / BENCHMARK_SCAN_REPEAT;
+            nor_benchmark_flash.lx_nor_flash_block_summary_enabled =  LX_TRUE;
+
+            selections++;
+            if ((queue_block != scan_block) || (queue_erase_count != scan_erase_count) ||
+                (queue_mapped_sectors != scan_mapped_sectors) || (queue_obsolete_sectors != scan_obsolete_sectors))
+                mismatches++;
+        }
+
+        printf("%s,%lu,%d,%lu,%lu,%.0f,%.0f,%lu\n", BENCHMARK_BUILD, (unsigned long) benchmark_blocks, BENCHMARK_SECTORS_PER_BLOCK,
+               (unsigned long) selections, (unsigned long) mismatches,
+               (queue_time * 1.0e9) / (CLOCKS_PER_SEC * (double) selections), (scan_time * 1.0e9) / (CLOCKS_PER_SEC * (double) selections),
+               (unsigned long) (scan_reads / selections));
+
+        status =  lx_nor_flash_close(&nor_benchmark_flash);
+        free(benchmark_memory_area);
+        free(benchmark_summary_memory);
+
+        if ((status != LX_SUCCESS) || (mismatches != 0))
+            benchmark_failed();
+    }
+#else
+
+    printf("NOR flash erase queue benchmark requires LX_NOR_ENABLE_ERASE_QUEUE\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+void  benchmark_failed(void)
+{
+
+    printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+    while(1)
+    {
+    }
+}
+
+
+UINT  benchmark_driver_initialize(LX_NOR_FLASH *nor_flash)
+{
+
+    /* Setup the base address and geometry of the flash.  */
+    nor_flash -> lx_nor_flash_base_address =    benchmark_memory_area;
+    nor_flash -> lx_nor_flash_total_blocks =    benchmark_blocks;
+    nor_flash -> lx_nor_flash_words_per_block = BENCHMARK_WORDS_PER_BLOCK;
+
+    /* Setup function pointers for the NOR flash services.  */
+    nor_flash -> lx_nor_flash_driver_read =                 benchmark_driver_read;
+    nor_flash -> lx_nor_flash_driver_write =                benchmark_driver_write;
+    nor_flash -> lx_nor_flash_driver_block_erase =          benchmark_driver_block_erase;
+    nor_flash -> lx_nor_flash_driver_block_erased_verify =  benchmark_driver_block_erased_verify;
+    nor_flash -> lx_nor_flash_sector_buffer =               nor_benchmark_sector_memory;
+
+    /* Supply the block summary memory.  */
+    return(lx_nor_flash_block_summary_enable(nor_flash, benchmark_summary_memory, benchmark_summary_size));
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words)
+#else
+UINT  benchmark_driver_read(ULONG *flash_address, ULONG *destination, ULONG words)
+#endif
+{
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    benchmark_driver_reads++;
+    while (words--)
+        *destination++ =  *flash_address++;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words)
+#else
+UINT  benchmark_driver_write(ULONG *flash_address, ULONG *source, ULONG words)
+#endif
+{
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    while (words--)
+        *flash_address++ =  *source++;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count)
+#else
+UINT  benchmark_driver_block_erase(ULONG block, ULONG erase_count)
+#endif
+{
+
+ULONG   i;
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+    LX_PARAMETER_NOT_USED(erase_count);
+
+    for (i = 0; i < BENCHMARK_WORDS_PER_BLOCK; i++)
+        benchmark_memory_area[(block * BENCHMARK_WORDS_PER_BLOCK) + i] =  LX_ALL_ONES;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_driver_block_erased_verify(LX_NOR_FLASH *nor_flash, ULONG block)
+#else
+UINT  benchmark_driver_block_erased_verify(ULONG block)
+#endif
+{
+
+ULONG   i;
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    for (i = 0; i < BENCHMARK_WORDS_PER_BLOCK; i++)
+    {
+        if (benchmark_memory_area[(block * BENCHMARK_WORDS_PER_BLOCK) + i] != LX_ALL_ONES)
+            return(LX_ERROR);
+    }
+    return(LX_SUCCESS);
+}
@@ -0,0 +1,593 @@
+/* NOR and NAND flash shared read benchmark. Several reader threads read sectors while the flash
+   driver models the read time of the flash by sleeping. Reads that hold the thread safe mutex
+   for the whole transfer serialize, shared reads overlap. A final pass rewrites sectors, which
+   erases blocks, while the readers check every sector they read. Standalone builds with a pthread
+   lock backend run the threads as pthreads, with a tick of one millisecond. The results are printed
+   as CSV, one line per device and pass.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lx_api.h"
+#ifdef LX_STANDALONE_ENABLE
+#include <sched.h>
+#include <time.h>
+#endif
+
+/* The benchmark threads need a lock backend that serializes them.  */
+#if defined(LX_THREAD_SAFE_ENABLE) && (LX_LOCK_BACKEND != LX_LOCK_BACKEND_NONE)
+#define BENCHMARK_THREADS
+#endif
+
+#define     DEMO_STACK_SIZE         4096
+
+/* Define the benchmark parameters. BENCHMARK_BUILD names the build configuration in the results.
+   Every flash read of sector data sleeps for BENCHMARK_READ_TICKS while the throughput is measured.  */
+
+#ifndef BENCHMARK_BUILD
+#define BENCHMARK_BUILD                     "default"
+#endif
+
+#define BENCHMARK_MAX_READERS               8
+#define BENCHMARK_READS                     32
+#define BENCHMARK_SECTORS                   64
+#define BENCHMARK_SECTOR_WORDS              128
+#define BENCHMARK_WRITES                    512
+#define BENCHMARK_READ_TICKS                1
+#define BENCHMARK_NAND_MEMORY_SIZE          4096
+
+
+/* Define the ThreadX object control blocks...  */
+#ifndef LX_STANDALONE_ENABLE
+TX_THREAD               thread_0;
+TX_THREAD               benchmark_thread[BENCHMARK_MAX_READERS + 1];
+TX_SEMAPHORE            benchmark_done_semaphore;
+#elif defined(BENCHMARK_THREADS)
+pthread_t               benchmark_thread[BENCHMARK_MAX_READERS + 1];
+sem_t                   benchmark_done_semaphore;
+void                    (*benchmark_thread_entry[BENCHMARK_MAX_READERS + 1])(ULONG thread_input);
+ULONG                   benchmark_thread_input[BENCHMARK_MAX_READERS + 1];
+#endif
+UCHAR                   thread_0_stack[DEMO_STACK_SIZE];
+UCHAR                   benchmark_stack[BENCHMARK_MAX_READERS + 1][DEMO_STACK_SIZE];
+
+/* Define LevelX structures.  */
+
+LX_NOR_FLASH    nor_benchmark_flash;
+LX_NAND_FLASH   nand_benchmark_flash;
+ULONG           nand_benchmark_memory[BENCHMARK_NAND_MEMORY_SIZE];
+ULONG           benchmark_write_buffer[BENCHMARK_SECTOR_WORDS];
+ULONG           benchmark_read_buffer[BENCHMARK_MAX_READERS][BENCHMARK_SECTOR_WORDS];
+
+/* Define the benchmark state. The counters of each reader are only updated by that reader.  */
+
+UINT            benchmark_nand;
+volatile UINT   benchmark_writer_active;
+ULONG           benchmark_version[BENCHMARK_SECTORS];
+ULONG           benchmark_reader_reads[BENCHMARK_MAX_READERS];
+ULONG           benchmark_reader_errors[BENCHMARK_MAX_READERS];
+ULONG           benchmark_writer_errors;
+ULONG           benchmark_read_ticks;
+
+
+/* Define the flash simulator prototypes and the original driver read functions, which the
+   benchmark drivers call after sleeping.  */
+
+UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash);
+UINT  _lx_nor_flash_simulator_erase_all(VOID);
+UINT  _lx_nand_flash_simulator_initialize(LX_NAND_FLASH *nand_flash);
+UINT  _lx_nand_flash_simulator_erase_all(VOID);
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  (*benchmark_nor_driver_read)(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  benchmark_nor_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
+#else
+UINT  (*benchmark_nor_driver_read)(ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  benchmark_nor_read(ULONG *flash_address, ULONG *destination, ULONG words);
+#endif
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  (*benchmark_nand_driver_pages_read)(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  benchmark_nand_pages_read(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+#else
+UINT  (*benchmark_nand_driver_pages_read)(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  benchmark_nand_pages_read(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+#endif
+
+
+/* Define thread prototypes.  */
+
+void    thread_0_entry(ULONG thread_input);
+void    benchmark_reader_entry(ULONG reader);
+void    benchmark_writer_entry(ULONG thread_input);
+UINT    benchmark_sector_write(ULONG sector);
+UINT    benchmark_sector_check(ULONG sector, ULONG *sector_buffer);
+void    benchmark_failed(void);
+void    benchmark_thread_start(ULONG index, void (*entry)(ULONG thread_input), ULONG thread_input);
+void    benchmark_thread_stop(ULONG index);
+void    benchmark_done_put(void);
+void    benchmark_done_get(void);
+ULONG   benchmark_time_get(void);
+void    benchmark_sleep(ULONG ticks);
+void    benchmark_relinquish(void);
+#if defined(LX_STANDALONE_ENABLE) && defined(BENCHMARK_THREADS)
+void    *benchmark_pthread_entry(void *index);
+#endif
+
+
+
+/* Define main entry point.  */
+
+int main()
+{
+
+    /* Enter the ThreadX kernel.  */
+#ifndef LX_STANDALONE_ENABLE
+    tx_kernel_enter();
+#else
+    thread_0_entry(0);
+#endif
+
+}
+
+
+/* Define what the initial system looks like.  */
+#ifndef LX_STANDALONE_ENABLE
+void    tx_application_define(void *first_unused_memory)
+{
+
+
+    /* Create the main thread.  */
+    tx_thread_create(&thread_0, "thread 0", thread_0_entry, 0,
+            thread_0_stack, DEMO_STACK_SIZE,
+            1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+#endif
+
+/* Define the benchmark thread.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef BENCHMARK_THREADS
+ULONG   readers;
+ULONG   threads;
+UINT    writer;
+ULONG   reads;
+ULONG   errors;
+ULONG   shared_reads;
+ULONG   start;
+ULONG   ticks;
+ULONG   i;
+UINT    status;
+
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+    _lx_nand_flash_initialize();
+
+    /* Create the semaphore the benchmark threads put when they are done.  */
+#ifndef LX_STANDALONE_ENABLE
+    tx_semaphore_create(&benchmark_done_semaphore, "benchmark done", 0);
+#else
+    sem_init(&benchmark_done_semaphore, 0, 0);
+#endif
+
+    printf("build,device,readers,writer,read_ticks,reads,ticks,reads_per_100_ticks,shared_reads,errors\n");
+
+    for (benchmark_nand = LX_FALSE; benchmark_nand <= LX_TRUE; benchmark_nand++)
+    {
+
+        /* Erase and open the flash.  */
+        if (benchmark_nand)
+        {
+            _lx_nand_flash_simulator_erase_all();
+            status =  lx_nand_flash_format(&nand_benchmark_flash, "benchmark nand flash", _lx_nand_flash_simulator_initialize, nand_benchmark_memory, sizeof(nand_benchmark_memory));
+            if (status == LX_SUCCESS)
+                status =  lx_nand_flash_open(&nand_benchmark_flash, "benchmark nand flash", _lx_nand_flash_simulator_initialize, nand_benchmark_memory, sizeof(nand_benchmark_memory));
+            if ((status != LX_SUCCESS) || (nand_benchmark_flash.lx_nand_flash_bytes_per_page != (BENCHMARK_SECTOR_WORDS * sizeof(ULONG))))
+                benchmark_failed();
+        }
+        else
+        {
+            _lx_nor_flash_simulator_erase_all();
+            status =  lx_nor_flash_open(&nor_benchmark_flash, "benchmark nor flash", _lx_nor_flash_simulator_initialize);
+            if ((status != LX_SUCCESS) || (nor_benchmark_flash.lx_nor_flash_words_per_sector != BENCHMARK_SECTOR_WORDS))
+                benchmark_failed();
+        }
+
+        /* Write all the sectors.  */
+        for (i = 0; i < BENCHMARK_SECTORS; i++)
+        {
+            benchmark_version[i] =  0;
+            if (benchmark_sector_write(i) != LX_SUCCESS)
+                benchmark_failed();
+        }
+
+        /* Model the read time of the flash from now on.  */
+        if (benchmark_nand)
+        {
+            benchmark_nand_driver_pages_read =  nand_benchmark_flash.lx_nand_flash_driver_pages_read;
+            nand_benchmark_flash.lx_nand_flash_driver_pages_read =  benchmark_nand_pages_read;
+        }
+        else
+        {
+            benchmark_nor_driver_read =  nor_benchmark_flash.lx_nor_flash_driver_read;
+            nor_benchmark_flash.lx_nor_flash_driver_read =  benchmark_nor_read;
+        }
+
+        /* Measure the reads with 1, 2, 4 and 8 readers, then check the reads of 4 readers while a writer
+           rewrites sectors.  */
+        for (readers = 1; readers <= (BENCHMARK_MAX_READERS * 2); readers =  readers * 2)
+        {
+
+            /* Setup the counters for this pass.  */
+            writer =  (readers > BENCHMARK_MAX_READERS);
+            threads =  writer ? (BENCHMARK_MAX_READERS / 2) : readers;
+            for (i = 0; i < BENCHMARK_MAX_READERS; i++)
+            {
+                benchmark_reader_reads[i] =   0;
+                benchmark_reader_errors[i] =  0;
+            }
+            benchmark_writer_errors =  0;
+            shared_reads =  0;
+#ifdef LX_NOR_ENABLE_SHARED_READ
+            if (benchmark_nand == LX_FALSE)
+                shared_reads =  nor_benchmark_flash.lx_nor_flash_shared_reads;
+#endif
+#ifdef LX_NAND_ENABLE_SHARED_READ
+            if (benchmark_nand)
+                shared_reads =  nand_benchmark_flash.lx_nand_flash_shared_reads;
+#endif
+
+            /* NAND reads of rewritten blocks search the pages of the block, so the read time is only modeled
+               for NOR while the writer runs.  */
+            benchmark_read_ticks =  (writer && benchmark_nand) ? 0 : BENCHMARK_READ_TICKS;
+
+            /* Start the readers and the writer.  */
+            benchmark_writer_active =  writer;
+            start =  benchmark_time_get();
+            for (i = 0; i < threads; i++)
+            {
+                benchmark_thread_start(i, benchmark_reader_entry, i);
+            }
+            if (writer)
+            {
+                benchmark_thread_start(threads, benchmark_writer_entry, 0);
+            }
+
+            /* Wait for them to finish.  */
+            for (i = 0; i < (threads + writer); i++)
+            {
+                benchmark_done_get();
+            }
+            ticks =  benchmark_time_get() - start;
+            for (i = 0; i < (threads + writer); i++)
+            {
+                benchmark_thread_stop(i);
+            }
+
+            /* Total the counters of the readers.  */
+            reads =   0;
+            errors =  benchmark_writer_errors;
+            for (i = 0; i < BENCHMARK_MAX_READERS; i++)
+            {
+                reads +=   benchmark_reader_reads[i];
+                errors +=  benchmark_reader_errors[i];
+            }
+#ifdef LX_NOR_ENABLE_SHARED_READ
+            if (benchmark_nand == LX_FALSE)
+                shared_reads =  nor_benchmark_flash.lx_nor_flash_shared_reads - shared_reads;
+#endif
+#ifdef LX_NAND_ENABLE_SHARED_READ
+            if (benchmark_nand)
+                shared_reads =  nand_benchmark_flash.lx_nand_flash_shared_reads - shared_reads;
+#endif
+
+            if (ticks == 0)
+                ticks =  1;
+            printf("%s,%s,%lu,%u,%lu,%lu,%lu,%lu,%lu,%lu\n", BENCHMARK_BUILD, benchmark_nand ? "nand" : "nor",
+                   (unsigned long) threads, writer, (unsigned long) benchmark_read_ticks, (unsigned long) reads, (unsigned long) ticks,
+                   (unsigned long) ((reads * 100) / ticks), (unsigned long) shared_reads, (unsigned long) errors);
+
+            if (errors)
+                benchmark_failed();
+        }
+
+        /* Check all the sectors once more and close the flash.  */
+        for (i = 0; i < BENCHMARK_SECTORS; i++)
+        {
+            if (benchmark_nand)
+                status =  lx_nand_flash_sector_read(&nand_benchmark_flash, i, benchmark_read_buffer[0]);
+            else
+                status =  lx_nor_flash_sector_read(&nor_benchmark_flash, i, benchmark_read_buffer[0]);
+            if ((status != LX_SUCCESS) || (benchmark_sector_check(i, benchmark_read_buffer[0]) != LX_SUCCESS) ||
+                ((benchmark_read_buffer[0][0] & 0xFFFF) != benchmark_version[i]))
+                benchmark_failed();
+        }
+        if (benchmark_nand)
+            status =  lx_nand_flash_close(&nand_benchmark_flash);
+        else
+            status =  lx_nor_flash_close(&nor_benchmark_flash);
+        if (status != LX_SUCCESS)
+            benchmark_failed();
+    }
+#else
+
+    printf("Flash shared read benchmark requires LX_THREAD_SAFE_ENABLE and a lock backend\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+#ifdef BENCHMARK_THREADS
+void  benchmark_reader_entry(ULONG reader)
+{
+
+ULONG   random;
+ULONG   sector;
+UINT    status;
+
+
+    /* Read random sectors until this reader has done its reads and the writer is done.  */
+    random =  reader + 1;
+    do
+    {
+
+        random =  (random * 1103515245UL) + 12345UL;
+        sector =  (random >> 8) % BENCHMARK_SECTORS;
+        if (benchmark_nand)
+            status =  lx_nand_flash_sector_read(&nand_benchmark_flash, sector, benchmark_read_buffer[reader]);
+        else
+            status =  lx_nor_flash_sector_read(&nor_benchmark_flash, sector, benchmark_read_buffer[reader]);
+        if ((status != LX_SUCCESS) || (benchmark_sector_check(sector, benchmark_read_buffer[reader]) != LX_SUCCESS))
+            benchmark_reader_errors[reader]++;
+        benchmark_reader_reads[reader]++;
+
+        /* Let the writer and the other readers run.  */
+        benchmark_relinquish();
+
+    } while ((benchmark_reader_reads[reader] < BENCHMARK_READS) || (benchmark_writer_active));
+
+    benchmark_done_put();
+}
+
+
+void  benchmark_writer_entry(ULONG thread_input)
+{
+
+ULONG   random;
+ULONG   sector;
+ULONG   i;
+
+
+    LX_PARAMETER_NOT_USED(thread_input);
+
+    /* Rewrite random sectors, enough to erase blocks.  */
+    random =  12345;
+    for (i = 0; i < BENCHMARK_WRITES; i++)
+    {
+
+        random =  (random * 1103515245UL) + 12345UL;
+        sector =  (random >> 8) % BENCHMARK_SECTORS;
+        benchmark_version[sector] =  (benchmark_version[sector] + 1) & 0xFFFF;
+        if (benchmark_sector_write(sector) != LX_SUCCESS)
+            benchmark_writer_errors++;
+
+        /* Let the readers run.  */
+        benchmark_relinquish();
+    }
+
+    benchmark_writer_active =  LX_FALSE;
+    benchmark_done_put();
+}
+
+
+void  benchmark_thread_start(ULONG index, void (*entry)(ULONG thread_input), ULONG thread_input)
+{
+
+#ifndef LX_STANDALONE_ENABLE
+    tx_thread_create(&benchmark_thread[index], "benchmark thread", entry, thread_input,
+            benchmark_stack[index], DEMO_STACK_SIZE,
+            2, 2, TX_NO_TIME_SLICE, TX_AUTO_START);
+#else
+    benchmark_thread_entry[index] =  entry;
+    benchmark_thread_input[index] =  thread_input;
+    if (pthread_create(&benchmark_thread[index], NULL, benchmark_pthread_entry, &benchmark_thread_input[index]) != 0)
+        benchmark_failed();
+#endif
+}
+
+
+#ifdef LX_STANDALONE_ENABLE
+void  *benchmark_pthread_entry(void *index)
+{
+
+ULONG   i;
+
+
+    /* Call the entry function of the thread with its input.  */
+    i =  (ULONG) ((ULONG *) index - benchmark_thread_input);
+    (benchmark_thread_entry[i])(benchmark_thread_input[i]);
+    return(NULL);
+}
+#endif
+
+
+void  benchmark_thread_stop(ULONG index)
+{
+
+#ifndef LX_STANDALONE_ENABLE
+    tx_thread_terminate(&benchmark_thread[index]);
+    tx_thread_delete(&benchmark_thread[index]);
+#else
+    pthread_join(benchmark_thread[index], NULL);
+#endif
+}
+
+
+void  benchmark_done_put(void)
+{
+
+#ifndef LX_STANDALONE_ENABLE
+    tx_semaphore_put(&benchmark_done_semaphore);
+#else
+    sem_post(&benchmark_done_semaphore);
+#endif
+}
+
+
+void  benchmark_done_get(void)
+{
+
+#ifndef LX_STANDALONE_ENABLE
+    tx_semaphore_get(&benchmark_done_semaphore, TX_WAIT_FOREVER);
+#else
+    while (sem_wait(&benchmark_done_semaphore) != 0)
+    {
+    }
+#endif
+}
+
+
+ULONG  benchmark_time_get(void)
+{
+
+#ifndef LX_STANDALONE_ENABLE
+    return(tx_time_get());
+#else
+
+struct timespec     now;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return((ULONG) ((now.tv_sec * 1000) + (now.tv_nsec / 1000000)));
+#endif
+}
+
+
+void  benchmark_sleep(ULONG ticks)
+{
+
+#ifndef LX_STANDALONE_ENABLE
+    tx_thread_sleep(ticks);
+#else
+
+struct timespec     duration;
+
+
+    duration.tv_sec =   (time_t) (ticks / 1000);
+    duration.tv_nsec =  (long) ((ticks % 1000) * 1000000);
+    nanosleep(&duration, NULL);
+#endif
+}
+
+
+void  benchmark_relinquish(void)
+{
+
+#ifndef LX_STANDALONE_ENABLE
+    tx_thread_relinquish();
+#else
+    sched_yield();
+#endif
+}
+#endif
+
+
+UINT  benchmark_sector_write(ULONG sector)
+{
+
+ULONG   i;
+
+
+    /* Build the data of the sector from its number and version.  */
+    benchmark_write_buffer[0] =  (sector << 16) | benchmark_version[sector];
+    for (i = 1; i < BENCHMARK_SECTOR_WORDS; i++)
+        benchmark_write_buffer[i] =  benchmark_write_buffer[0] ^ i;
+
+    if (benchmark_nand)
+        return(lx_nand_flash_sector_write(&nand_benchmark_flash, sector, benchmark_write_buffer));
+    else
+        return(lx_nor_flash_sector_write(&nor_benchmark_flash, sector, benchmark_write_buffer));
+}
+
+
+UINT  benchmark_sector_check(ULONG sector, ULONG *sector_buffer)
+{
+
+ULONG   i;
+
+
+    /* The data must be one complete version of the sector.  */
+    if ((sector_buffer[0] >> 16) != sector)
+        return(LX_ERROR);
+    for (i = 1; i < BENCHMARK_SECTOR_WORDS; i++)
+    {
+        if (sector_buffer[i] != (sector_buffer[0] ^ i))
+            return(LX_ERROR);
+    }
+    return(LX_SUCCESS);
+}
+
+
+void  benchmark_failed(void)
+{
+
+    printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+    while(1)
+    {
+    }
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nor_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words)
+#else
+UINT  benchmark_nor_read(ULONG *flash_address, ULONG *destination, ULONG words)
+#endif
+{
+
+#ifdef BENCHMARK_THREADS
+
+    /* Model the read time of sector data, reads of single words are metadata reads.  */
+    if ((words > 1) && (benchmark_read_ticks))
+        benchmark_sleep(benchmark_read_ticks);
+#endif
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nor_driver_read)(nor_flash, flash_address, destination, words));
+#else
+    return((benchmark_nor_driver_read)(flash_address, destination, words));
+#endif
+}
+
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nand_pages_read(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages)
+#else
+UINT  benchmark_nand_pages_read(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages)
+#endif
+{
+
+#ifdef BENCHMARK_THREADS
+
+    /* Model the read time of the pages.  */
+    if ((main_buffer) && (benchmark_read_ticks))
+        benchmark_sleep(benchmark_read_ticks * pages);
+#endif
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nand_driver_pages_read)(nand_flash, block, page, main_buffer, spare_buffer, pages));
+#else
+    return((benchmark_nand_driver_pages_read)(block, page, main_buffer, spare_buffer, pages));
+#endif
+}
@@ -0,0 +1,880 @@
+/* NOR and NAND flash trace replay. Replays a trace of the sector requests a FileX media made to its
+   LevelX driver against the NOR or NAND flash simulator, as fx_nor_flash_simulator_driver.c and
+   fx_nand_flash_simulated_driver.c issue them: NOR reads and writes go to the multiple sector APIs, NAND
+   requests to the sector APIs one sector at a time. Releases are one sector at a time on both.
+
+   The trace is a text file with one request per line, a '#' starts a comment:
+
+        P <name>                    Start a new phase of the trace, e.g. format, copy or churn.
+        R <sector> [<sectors>]      FX_DRIVER_READ of <sectors> sectors (default 1) from <sector>.
+        W <sector> [<sectors>]      FX_DRIVER_WRITE.
+        D <sector> [<sectors>]      FX_DRIVER_RELEASE_SECTORS.
+
+   For every phase the replay prints a CSV line with the requests, the host time, the device time of
+   the timing model of the simulator and the throughput at that device time, the block erases, the GC
+   stalls and the erase counts of the blocks so far. A GC stall is a request that erased a block, its
+   device time includes the reclaim. At the end the erase counts of all blocks are summarized and
+   printed as a histogram, for the wear distribution. Every read is checked against the last write of
+   its sector.
+
+   Usage: levelx_replay [-nand] [-blocks <blocks>] [-block_size <sectors or pages>] [-image <file>]
+                        [-fast_forward] [-repeat <times>] [-wear_interval <sectors>] <trace>
+
+   -block_size is the number of physical sectors (NOR) or pages (NAND) per block. -image keeps the flash
+   in a device image file, it needs LX_NOR_SIMULATOR_ENABLE_FILE (LX_NAND_SIMULATOR_ENABLE_FILE).
+
+   To project the lifetime of a device, -repeat replays the trace many times and -fast_forward runs the
+   simulator in its fast forward mode, where only the first word of the sector data is kept, which
+   holds the write it came from. -wear_interval samples the erase counts of the blocks every so many
+   sectors written and prints the samples after the phases, to compare wear leveling settings like
+   LX_NOR_FLASH_MAX_ERASE_COUNT_DELTA and LX_NAND_FLASH_MAX_ERASE_COUNT_DELTA.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "lx_api.h"
+
+#define     DEMO_STACK_SIZE         4096
+
+/* Define the default geometry of the replay, an 8MB NOR flash and an 8MB NAND flash. The NOR sectors
+   are 512 bytes, the NAND pages 512 bytes with 16 spare bytes, as in the simulators.  */
+
+#define REPLAY_NOR_BLOCKS                   256
+#define REPLAY_NOR_BLOCK_SIZE               64
+#define REPLAY_NAND_BLOCKS                  256
+#define REPLAY_NAND_BLOCK_SIZE              64
+#define REPLAY_NOR_SECTOR_BYTES             512
+#define REPLAY_NAND_PAGE_BYTES              (512 + 16)
+#define REPLAY_LINE_SIZE                    256
+#define REPLAY_NAME_SIZE                    64
+#define REPLAY_WEAR_BUCKETS                 10
+
+#define REPLAY_NOR                          0
+#define REPLAY_NAND                         1
+
+
+/* Define the ThreadX object control blocks...  */
+#ifndef LX_STANDALONE_ENABLE
+TX_THREAD               thread_0;
+#endif
+UCHAR                   thread_0_stack[DEMO_STACK_SIZE];
+
+/* Define LevelX structures.  */
+
+LX_NOR_FLASH    nor_replay_flash;
+LX_NAND_FLASH   nand_replay_flash;
+ULONG           *nand_replay_memory;
+
+/* Define the arguments and the flash of the replay.  */
+
+int             replay_argc;
+char            **replay_argv;
+ULONG           replay_device;
+ULONG           replay_blocks;
+ULONG           replay_block_size;
+CHAR            *replay_image;
+CHAR            *replay_trace_name;
+FILE            *replay_trace;
+ULONG           *replay_flash_memory;
+ULONG           replay_sector_bytes;
+ULONG           replay_line;
+UINT            replay_fast_forward;
+ULONG           replay_repeat;
+ULONG           replay_wear_interval;
+
+/* Define the replay state. replay_version holds the last version written to each sector, zero if the
+   sector isn't mapped. replay_block_erases holds the erases of each block.  */
+
+ULONG           *replay_version;
+ULONG           replay_version_sectors;
+ULONG           replay_next_version;
+ULONG           *replay_buffer;
+ULONG           replay_buffer_sectors;
+ULONG           *replay_block_erases;
+ULONG           replay_erases;
+
+/* Define the samples of the erase counts, taken every replay_wear_interval sectors written.  */
+
+typedef struct REPLAY_WEAR_SAMPLE_STRUCT
+{
+    ULONG64     sectors_written;
+    ULONG       block_erases;
+    ULONG       erases_min;
+    ULONG       erases_max;
+    double      erases_mean;
+    double      erases_stddev;
+} REPLAY_WEAR_SAMPLE;
+
+REPLAY_WEAR_SAMPLE  *replay_wear_samples;
+ULONG           replay_wear_sample_count;
+ULONG64         replay_total_written;
+ULONG64         replay_next_sample;
+
+/* Define the statistics of the current phase.  */
+
+CHAR            replay_phase_name[REPLAY_NAME_SIZE];
+ULONG           replay_requests;
+ULONG           replay_reads;
+ULONG           replay_writes;
+ULONG           replay_releases;
+ULONG           replay_sectors_read;
+ULONG           replay_sectors_written;
+ULONG           replay_sectors_released;
+ULONG           replay_phase_erases;
+ULONG           replay_stalls;
+ULONG64         replay_stall_time;
+ULONG64         replay_max_request_time;
+ULONG64         replay_phase_time;
+clock_t         replay_phase_start;
+
+
+/* Define the flash simulator prototypes and the original block erase drivers, which the replay
+   drivers call after counting.  */
+
+UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash);
+UINT  _lx_nor_flash_simulator_erase_all(VOID);
+UINT  _lx_nor_flash_simulator_geometry_set(ULONG total_blocks, ULONG physical_sectors_per_block, ULONG *memory, ULONG64 memory_size);
+UINT  _lx_nor_flash_simulator_time_get(ULONG64 *time);
+UINT  _lx_nor_flash_simulator_fast_forward_set(UINT enable);
+UINT  _lx_nand_flash_simulator_initialize(LX_NAND_FLASH *nand_flash);
+UINT  _lx_nand_flash_simulator_erase_all(VOID);
+UINT  _lx_nand_flash_simulator_geometry_set(ULONG total_blocks, ULONG pages_per_block, ULONG *memory, ULONG64 memory_size);
+UINT  _lx_nand_flash_simulator_time_get(ULONG64 *time);
+UINT  _lx_nand_flash_simulator_fast_forward_set(UINT enable);
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+UINT  _lx_nor_flash_simulator_file_open(CHAR *file_name, ULONG total_blocks, ULONG physical_sectors_per_block);
+UINT  _lx_nor_flash_simulator_file_close(VOID);
+#endif
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+UINT  _lx_nand_flash_simulator_file_open(CHAR *file_name, ULONG total_blocks, ULONG pages_per_block);
+UINT  _lx_nand_flash_simulator_file_close(VOID);
+#endif
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  (*replay_nor_driver_block_erase)(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+UINT  replay_nor_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+#else
+UINT  (*replay_nor_driver_block_erase)(ULONG block, ULONG erase_count);
+UINT  replay_nor_block_erase(ULONG block, ULONG erase_count);
+#endif
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  (*replay_nand_driver_block_erase)(LX_NAND_FLASH *nand_flash, ULONG block, ULONG erase_count);
+UINT  replay_nand_block_erase(LX_NAND_FLASH *nand_flash, ULONG block, ULONG erase_count);
+#else
+UINT  (*replay_nand_driver_block_erase)(ULONG block, ULONG erase_count);
+UINT  replay_nand_block_erase(ULONG block, ULONG erase_count);
+#endif
+
+
+/* Define thread prototypes.  */
+
+void    thread_0_entry(ULONG thread_input);
+void    replay_arguments_get(void);
+void    replay_flash_open(void);
+void    replay_flash_close(void);
+void    replay_phase_start_new(CHAR *name);
+void    replay_phase_print(void);
+void    replay_wear_print(void);
+void    replay_wear_sample(void);
+void    replay_request(CHAR type, ULONG sector, ULONG sectors);
+UINT    replay_read(ULONG sector, ULONG sectors);
+UINT    replay_write(ULONG sector, ULONG sectors);
+UINT    replay_release(ULONG sector, ULONG sectors);
+ULONG64 replay_time_get(void);
+void    replay_erase_counts(ULONG *minimum, ULONG *maximum, double *mean, double *stddev);
+void    replay_failed(const char *reason);
+
+
+
+/* Define main entry point.  */
+
+int main(int argc, char **argv)
+{
+
+    /* Save the arguments for the replay thread.  */
+    replay_argc =  argc;
+    replay_argv =  argv;
+
+    /* Enter the ThreadX kernel.  */
+#ifndef LX_STANDALONE_ENABLE
+    tx_kernel_enter();
+#else
+    thread_0_entry(0);
+#endif
+
+}
+
+
+/* Define what the initial system looks like.  */
+#ifndef LX_STANDALONE_ENABLE
+void    tx_application_define(void *first_unused_memory)
+{
+
+
+    /* Create the main thread.  */
+    tx_thread_create(&thread_0, "thread 0", thread_0_entry, 0,
+            thread_0_stack, DEMO_STACK_SIZE,
+            1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+#endif
+
+/* Define the replay thread.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+CHAR            line[REPLAY_LINE_SIZE];
+CHAR            *token;
+CHAR            *end;
+CHAR            type;
+unsigned long   sector;
+unsigned long   sectors;
+ULONG           pass;
+ULONG           i;
+
+
+    /* Pickup the arguments and open the trace.  */
+    replay_arguments_get();
+    replay_trace =  fopen(replay_trace_name, "r");
+    if (replay_trace == NULL)
+        replay_failed("cannot open the trace");
+
+    /* Initialize LevelX and open the flash.  */
+    _lx_nor_flash_initialize();
+    _lx_nand_flash_initialize();
+    replay_flash_open();
+
+    printf("phase,requests,reads,writes,releases,sectors_read,sectors_written,sectors_released,seconds,device_seconds,"
+           "requests_per_second,mb_per_second,block_erases,gc_stalls,gc_stall_seconds,max_request_ms,erases_min,erases_max,erases_mean\n");
+
+    /* Replay the requests of the trace, the requests before the first phase are in a phase of their own.  */
+    replay_phase_start_new("replay");
+    for (pass = 0; pass < replay_repeat; pass++)
+    {
+
+        rewind(replay_trace);
+        replay_line =  0;
+        while (fgets(line, sizeof(line), replay_trace) != NULL)
+        {
+
+            replay_line++;
+
+            /* Skip the white space, the empty lines and the comments.  */
+            token =  line;
+            while ((*token == ' ') || (*token == '\t'))
+                token++;
+            if ((*token == '#') || (*token == '\n') || (*token == '\r') || (*token == 0))
+                continue;
+
+            /* A phase ends the current phase.  */
+            type =  *token++;
+            if (type == 'P')
+            {
+
+                while ((*token == ' ') || (*token == '\t'))
+                    token++;
+                end =  token + strlen(token);
+                while ((end > token) && ((end[-1] == '\n') || (end[-1] == '\r') || (end[-1] == ' ') || (end[-1] == '\t')))
+                    *--end =  0;
+                if (replay_requests)
+                    replay_phase_print();
+                replay_phase_start_new(token);
+                continue;
+            }
+
+            /* Pickup the sector and the number of sectors of the request.  */
+            sectors =  1;
+            if (((type != 'R') && (type != 'W') && (type != 'D')) || (sscanf(token, "%lu %lu", &sector, &sectors) < 1) ||
+                (sectors == 0) || (sector > 0xFFFFFFFFUL) || (sectors > 0xFFFFUL))
+                replay_failed("invalid request");
+            replay_request(type, (ULONG) sector, (ULONG) sectors);
+        }
+    }
+    if (replay_requests)
+        replay_phase_print();
+    fclose(replay_trace);
+
+    /* Print the samples of the erase counts.  */
+    if (replay_wear_interval)
+    {
+        printf("\nsectors_written,block_erases,erases_min,erases_max,erases_mean,erases_stddev\n");
+        for (i = 0; i < replay_wear_sample_count; i++)
+            printf("%llu,%lu,%lu,%lu,%.2f,%.2f\n", (unsigned long long) replay_wear_samples[i].sectors_written,
+                   (unsigned long) replay_wear_samples[i].block_erases, (unsigned long) replay_wear_samples[i].erases_min,
+                   (unsigned long) replay_wear_samples[i].erases_max, replay_wear_samples[i].erases_mean, replay_wear_samples[i].erases_stddev);
+    }
+
+    /* Print the wear distribution and close the flash.  */
+    replay_wear_print();
+    replay_flash_close();
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+/* Pickup the device, the geometry, the image and the trace from the arguments.  */
+
+void  replay_arguments_get(void)
+{
+
+int     i;
+
+
+    replay_device =      REPLAY_NOR;
+    replay_blocks =      0;
+    replay_block_size =  0;
+    replay_image =       LX_NULL;
+    replay_trace_name =  LX_NULL;
+    replay_fast_forward =   LX_FALSE;
+    replay_repeat =         1;
+    replay_wear_interval =  0;
+    for (i = 1; i < replay_argc; i++)
+    {
+
+        if (strcmp(replay_argv[i], "-nand") == 0)
+            replay_device =  REPLAY_NAND;
+        else if ((strcmp(replay_argv[i], "-blocks") == 0) && ((i + 1) < replay_argc))
+            replay_blocks =  (ULONG) strtoul(replay_argv[++i], NULL, 0);
+        else if ((strcmp(replay_argv[i], "-block_size") == 0) && ((i + 1) < replay_argc))
+            replay_block_size =  (ULONG) strtoul(replay_argv[++i], NULL, 0);
+        else if ((strcmp(replay_argv[i], "-image") == 0) && ((i + 1) < replay_argc))
+            replay_image =  replay_argv[++i];
+        else if (strcmp(replay_argv[i], "-fast_forward") == 0)
+            replay_fast_forward =  LX_TRUE;
+        else if ((strcmp(replay_argv[i], "-repeat") == 0) && ((i + 1) < replay_argc))
+            replay_repeat =  (ULONG) strtoul(replay_argv[++i], NULL, 0);
+        else if ((strcmp(replay_argv[i], "-wear_interval") == 0) && ((i + 1) < replay_argc))
+            replay_wear_interval =  (ULONG) strtoul(replay_argv[++i], NULL, 0);
+        else if ((replay_argv[i][0] != '-') && (replay_trace_name == LX_NULL))
+            replay_trace_name =  replay_argv[i];
+        else
+            replay_trace_name =  LX_NULL, i =  replay_argc;
+    }
+    /* The fast forward mode erases the flash, so it can't keep it in a device image.  */
+    if ((replay_trace_name == LX_NULL) || (replay_repeat == 0) || (replay_fast_forward && (replay_image != LX_NULL)))
+    {
+        fprintf(stderr, "usage: %s [-nand] [-blocks <blocks>] [-block_size <sectors or pages>] [-image <file>]\n"
+                        "       [-fast_forward] [-repeat <times>] [-wear_interval <sectors>] <trace>\n",
+                (replay_argc > 0) ? replay_argv[0] : "levelx_replay");
+        replay_failed("invalid arguments");
+    }
+
+    /* Use the default geometry of the device for what isn't given.  */
+    if (replay_blocks == 0)
+        replay_blocks =  (replay_device == REPLAY_NAND) ? REPLAY_NAND_BLOCKS : REPLAY_NOR_BLOCKS;
+    if (replay_block_size == 0)
+        replay_block_size =  (replay_device == REPLAY_NAND) ? REPLAY_NAND_BLOCK_SIZE : REPLAY_NOR_BLOCK_SIZE;
+}
+
+
+/* Setup the geometry and the memory of the simulator, open the flash and put the counting erase driver
+   in place.  */
+
+void  replay_flash_open(void)
+{
+
+ULONG64 memory_size;
+UINT    status;
+
+
+    memory_size =  (ULONG64) replay_blocks * replay_block_size * ((replay_device == REPLAY_NAND) ? REPLAY_NAND_PAGE_BYTES : REPLAY_NOR_SECTOR_BYTES);
+    status =  LX_ERROR;
+    if (replay_image != LX_NULL)
+    {
+
+        /* Map the device image, a new image is erased.  */
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+        if (replay_device == REPLAY_NOR)
+            status =  _lx_nor_flash_simulator_file_open(replay_image, replay_blocks, replay_block_size);
+#endif
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+        if (replay_device == REPLAY_NAND)
+            status =  _lx_nand_flash_simulator_file_open(replay_image, replay_blocks, replay_block_size);
+#endif
+        if (status != LX_SUCCESS)
+            replay_failed("cannot open the device image");
+    }
+    else
+    {
+
+        /* Keep the flash in memory.  */
+        replay_flash_memory =  malloc((size_t) memory_size);
+        if (replay_flash_memory == LX_NULL)
+            replay_failed("no memory for the flash");
+        if (replay_device == REPLAY_NAND)
+            status =  _lx_nand_flash_simulator_geometry_set(replay_blocks, replay_block_size, replay_flash_memory, memory_size);
+        else
+            status =  _lx_nor_flash_simulator_geometry_set(replay_blocks, replay_block_size, replay_flash_memory, memory_size);
+        if (status != LX_SUCCESS)
+            replay_failed("invalid geometry");
+    }
+
+    /* Select the fast forward mode of the simulator.  */
+    if (replay_fast_forward)
+    {
+        if (replay_device == REPLAY_NAND)
+            _lx_nand_flash_simulator_fast_forward_set(LX_TRUE);
+        else
+            _lx_nor_flash_simulator_fast_forward_set(LX_TRUE);
+    }
+
+    if (replay_device == REPLAY_NAND)
+    {
+
+        /* The NAND memory holds the block tables and the page buffers.  */
+        nand_replay_memory =  malloc((replay_blocks * 16) + (64 * REPLAY_NAND_PAGE_BYTES));
+        if (nand_replay_memory == LX_NULL)
+            replay_failed("no memory for the NAND flash");
+
+        /* A flash in memory is formatted, an image only if it can't be opened.  */
+        if (replay_image == LX_NULL)
+        {
+            _lx_nand_flash_simulator_erase_all();
+            status =  LX_ERROR;
+        }
+        else
+            status =  lx_nand_flash_open(&nand_replay_flash, "replay nand flash", _lx_nand_flash_simulator_initialize,
+                                         nand_replay_memory, (replay_blocks * 16) + (64 * REPLAY_NAND_PAGE_BYTES));
+        if (status != LX_SUCCESS)
+        {
+            status =  lx_nand_flash_format(&nand_replay_flash, "replay nand flash", _lx_nand_flash_simulator_initialize,
+                                           nand_replay_memory, (replay_blocks * 16) + (64 * REPLAY_NAND_PAGE_BYTES));
+            if (status == LX_SUCCESS)
+                status =  lx_nand_flash_open(&nand_replay_flash, "replay nand flash", _lx_nand_flash_simulator_initialize,
+                                             nand_replay_memory, (replay_blocks * 16) + (64 * REPLAY_NAND_PAGE_BYTES));
+        }
+        if (status != LX_SUCCESS)
+            replay_failed("cannot open the NAND flash");
+        replay_sector_bytes =  nand_replay_flash.lx_nand_flash_bytes_per_page;
+
+        replay_nand_driver_block_erase =  nand_replay_flash.lx_nand_flash_driver_block_erase;
+        nand_replay_flash.lx_nand_flash_driver_block_erase =  replay_nand_block_erase;
+    }
+    else
+    {
+
+        /* A flash in memory is erased, LevelX formats it when it is opened.  */
+        if (replay_image == LX_NULL)
+            _lx_nor_flash_simulator_erase_all();
+        status =  lx_nor_flash_open(&nor_replay_flash, "replay nor flash", _lx_nor_flash_simulator_initialize);
+        if (status != LX_SUCCESS)
+            replay_failed("cannot open the NOR flash");
+        replay_sector_bytes =  nor_replay_flash.lx_nor_flash_words_per_sector * sizeof(ULONG);
+
+        replay_nor_driver_block_erase =  nor_replay_flash.lx_nor_flash_driver_block_erase;
+        nor_replay_flash.lx_nor_flash_driver_block_erase =  replay_nor_block_erase;
+    }
+
+    /* Count the erases of each block from here on.  */
+    replay_block_erases =  calloc(replay_blocks, sizeof(ULONG));
+    if (replay_block_erases == LX_NULL)
+        replay_failed("no memory for the erase counts");
+    replay_next_sample =  replay_wear_interval;
+}
+
+
+void  replay_flash_close(void)
+{
+
+UINT    status;
+
+
+    if (replay_device == REPLAY_NAND)
+        status =  lx_nand_flash_close(&nand_replay_flash);
+    else
+        status =  lx_nor_flash_close(&nor_replay_flash);
+    if (status != LX_SUCCESS)
+        replay_failed("cannot close the flash");
+
+    /* Write the device image back.  */
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+    if ((replay_image != LX_NULL) && (replay_device == REPLAY_NOR) && (_lx_nor_flash_simulator_file_close() != LX_SUCCESS))
+        replay_failed("cannot write the device image");
+#endif
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+    if ((replay_image != LX_NULL) && (replay_device == REPLAY_NAND) && (_lx_nand_flash_simulator_file_close() != LX_SUCCESS))
+        replay_failed("cannot write the device image");
+#endif
+}
+
+
+/* Start a phase, the statistics of the phase start from zero.  */
+
+void  replay_phase_start_new(CHAR *name)
+{
+
+    strncpy(replay_phase_name, name, REPLAY_NAME_SIZE - 1);
+    replay_phase_name[REPLAY_NAME_SIZE - 1] =  0;
+    replay_requests =          0;
+    replay_reads =             0;
+    replay_writes =            0;
+    replay_releases =          0;
+    replay_sectors_read =      0;
+    replay_sectors_written =   0;
+    replay_sectors_released =  0;
+    replay_phase_erases =      0;
+    replay_stalls =            0;
+    replay_stall_time =        0;
+    replay_max_request_time =  0;
+    replay_phase_time =        0;
+    replay_phase_start =       clock();
+}
+
+
+/* Print the statistics of the phase, the throughput is at the device time.  */
+
+void  replay_phase_print(void)
+{
+
+double  seconds;
+double  device_seconds;
+double  bytes;
+ULONG   minimum;
+ULONG   maximum;
+double  mean;
+double  stddev;
+
+
+    seconds =         ((double) (clock() - replay_phase_start)) / CLOCKS_PER_SEC;
+    device_seconds =  ((double) replay_phase_time) / 1000000000.0;
+    bytes =           ((double) replay_sectors_read + (double) replay_sectors_written) * replay_sector_bytes;
+    replay_erase_counts(&minimum, &maximum, &mean, &stddev);
+
+    printf("%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%.6f,%.6f,%.1f,%.3f,%lu,%lu,%.6f,%.3f,%lu,%lu,%.2f\n", replay_phase_name,
+           (unsigned long) replay_requests, (unsigned long) replay_reads, (unsigned long) replay_writes, (unsigned long) replay_releases,
+           (unsigned long) replay_sectors_read, (unsigned long) replay_sectors_written, (unsigned long) replay_sectors_released,
+           seconds, device_seconds, (device_seconds > 0.0) ? ((double) replay_requests / device_seconds) : 0.0,
+           (device_seconds > 0.0) ? ((bytes / device_seconds) / 1000000.0) : 0.0,
+           (unsigned long) replay_phase_erases, (unsigned long) replay_stalls, ((double) replay_stall_time) / 1000000000.0,
+           ((double) replay_max_request_time) / 1000000.0, (unsigned long) minimum, (unsigned long) maximum, mean);
+}
+
+
+/* Print the erase counts of the blocks: their summary and a histogram from the lowest to the highest
+   count.  */
+
+void  replay_wear_print(void)
+{
+
+ULONG   minimum;
+ULONG   maximum;
+double  mean;
+double  stddev;
+ULONG   bucket_size;
+ULONG   bucket_blocks[REPLAY_WEAR_BUCKETS];
+ULONG   i;
+
+
+    replay_erase_counts(&minimum, &maximum, &mean, &stddev);
+
+    printf("\nblocks,block_erases,erases_min,erases_max,erases_mean,erases_stddev\n");
+    printf("%lu,%lu,%lu,%lu,%.2f,%.2f\n", (unsigned long) replay_blocks, (unsigned long) replay_erases,
+           (unsigned long) minimum, (unsigned long) maximum, mean, stddev);
+
+    bucket_size =  ((maximum - minimum) / REPLAY_WEAR_BUCKETS) + 1;
+    for (i = 0; i < REPLAY_WEAR_BUCKETS; i++)
+        bucket_blocks[i] =  0;
+    for (i = 0; i < replay_blocks; i++)
+        bucket_blocks[(replay_block_erases[i] - minimum) / bucket_size]++;
+
+    printf("\nerases_from,erases_to,blocks\n");
+    for (i = 0; (i < REPLAY_WEAR_BUCKETS) && ((minimum + (i * bucket_size)) <= maximum); i++)
+        printf("%lu,%lu,%lu\n", (unsigned long) (minimum + (i * bucket_size)), (unsigned long) (minimum + ((i + 1) * bucket_size) - 1),
+               (unsigned long) bucket_blocks[i]);
+}
+
+
+/* Take a sample of the erase counts of the blocks.  */
+
+void  replay_wear_sample(void)
+{
+
+REPLAY_WEAR_SAMPLE  *sample;
+
+
+    replay_wear_samples =  realloc(replay_wear_samples, (replay_wear_sample_count + 1) * sizeof(REPLAY_WEAR_SAMPLE));
+    if (replay_wear_samples == LX_NULL)
+        replay_failed("no memory for the wear samples");
+    sample =  &replay_wear_samples[replay_wear_sample_count++];
+    sample -> sectors_written =  replay_total_written;
+    sample -> block_erases =     replay_erases;
+    replay_erase_counts(&sample -> erases_min, &sample -> erases_max, &sample -> erases_mean, &sample -> erases_stddev);
+}
+
+
+/* Replay one request and account for its device time. A request that erased a block is a GC stall.  */
+
+void  replay_request(CHAR type, ULONG sector, ULONG sectors)
+{
+
+ULONG64 start;
+ULONG64 time;
+ULONG   erases;
+UINT    status;
+
+
+    /* Make room for the versions of the sectors and for the data of the request.  */
+    if ((sector + sectors) > replay_version_sectors)
+    {
+        replay_version =  realloc(replay_version, (sector + sectors) * sizeof(ULONG));
+        if (replay_version == LX_NULL)
+            replay_failed("no memory for the sector versions");
+        memset(replay_version + replay_version_sectors, 0, (sector + sectors - replay_version_sectors) * sizeof(ULONG));
+        replay_version_sectors =  sector + sectors;
+    }
+    if (sectors > replay_buffer_sectors)
+    {
+        free(replay_buffer);
+        replay_buffer =  malloc(sectors * replay_sector_bytes);
+        if (replay_buffer == LX_NULL)
+            replay_failed("no memory for the request");
+        replay_buffer_sectors =  sectors;
+    }
+
+    start =   replay_time_get();
+    erases =  replay_erases;
+    if (type == 'R')
+    {
+        status =  replay_read(sector, sectors);
+        replay_reads++;
+        replay_sectors_read +=  sectors;
+    }
+    else if (type == 'W')
+    {
+        status =  replay_write(sector, sectors);
+        replay_writes++;
+        replay_sectors_written +=  sectors;
+        replay_total_written +=  sectors;
+    }
+    else
+    {
+        status =  replay_release(sector, sectors);
+        replay_releases++;
+        replay_sectors_released +=  sectors;
+    }
+    if (status != LX_SUCCESS)
+    {
+        fprintf(stderr, "%s:%lu: request failed with status 0x%x\n", replay_trace_name, (unsigned long) replay_line, status);
+        replay_failed("request failed");
+    }
+
+    /* Account for the request.  */
+    time =  replay_time_get() - start;
+    replay_requests++;
+    replay_phase_time +=  time;
+    if (time > replay_max_request_time)
+        replay_max_request_time =  time;
+    if (replay_erases != erases)
+    {
+        replay_phase_erases +=  replay_erases - erases;
+        replay_stalls++;
+        replay_stall_time +=  time;
+    }
+
+    /* Sample the erase counts when the next interval of sectors is written.  */
+    while ((replay_wear_interval) && (replay_total_written >= replay_next_sample))
+    {
+        replay_wear_sample();
+        replay_next_sample +=  replay_wear_interval;
+    }
+}
+
+
+/* Read the sectors and check them against their last write, in fast forward mode only their tokens.
+   Sectors that were never written may not be found, a NOR read stops at the first of them.  */
+
+UINT  replay_read(ULONG sector, ULONG sectors)
+{
+
+ULONG   *data;
+ULONG   i;
+UINT    status;
+
+
+    if (replay_device == REPLAY_NAND)
+    {
+        status =  LX_SUCCESS;
+        for (i = 0; (i < sectors) && (status == LX_SUCCESS); i++)
+        {
+            status =  lx_nand_flash_sector_read(&nand_replay_flash, sector + i, ((UCHAR *) replay_buffer) + (i * replay_sector_bytes));
+            if (status == LX_SECTOR_NOT_FOUND)
+                status =  LX_SUCCESS;
+        }
+    }
+    else
+        status =  lx_nor_flash_sectors_read(&nor_replay_flash, sector, replay_buffer, sectors);
+
+    for (i = 0; (i < sectors) && ((status == LX_SUCCESS) || (status == LX_SECTOR_NOT_FOUND)); i++)
+    {
+        if (replay_version[sector + i] == 0)
+        {
+            if (status == LX_SECTOR_NOT_FOUND)
+                status =  LX_SUCCESS, i =  sectors;
+            continue;
+        }
+        data =  (ULONG *) (((UCHAR *) replay_buffer) + (i * replay_sector_bytes));
+        if ((data[0] != replay_version[sector + i]) || ((replay_fast_forward == LX_FALSE) && (data[1] != (sector + i))))
+            status =  LX_ERROR;
+    }
+    return(status);
+}
+
+
+/* Write the sectors, each with a new version in its first word, the token that the fast forward mode
+   keeps, and its sector number.  */
+
+UINT  replay_write(ULONG sector, ULONG sectors)
+{
+
+ULONG   *data;
+ULONG   i;
+UINT    status;
+
+
+    for (i = 0; i < sectors; i++)
+    {
+        replay_next_version++;
+        replay_version[sector + i] =  replay_next_version;
+        data =  (ULONG *) (((UCHAR *) replay_buffer) + (i * replay_sector_bytes));
+        memset(data, 0x5A, replay_sector_bytes);
+        data[0] =  replay_next_version;
+        data[1] =  sector + i;
+    }
+
+    if (replay_device == REPLAY_NAND)
+    {
+        status =  LX_SUCCESS;
+        for (i = 0; (i < sectors) && (status == LX_SUCCESS); i++)
+            status =  lx_nand_flash_sector_write(&nand_replay_flash, sector + i, ((UCHAR *) replay_buffer) + (i * replay_sector_bytes));
+        return(status);
+    }
+    return(lx_nor_flash_sectors_write(&nor_replay_flash, sector, replay_buffer, sectors));
+}
+
+
+UINT  replay_release(ULONG sector, ULONG sectors)
+{
+
+ULONG   i;
+UINT    status;
+
+
+    /* Release the sectors one at a time, the trace may release sectors written before it was captured.  */
+    status =  LX_SUCCESS;
+    for (i = 0; (i < sectors) && (status == LX_SUCCESS); i++)
+    {
+        replay_version[sector + i] =  0;
+        if (replay_device == REPLAY_NAND)
+            status =  lx_nand_flash_sector_release(&nand_replay_flash, sector + i);
+        else
+            status =  lx_nor_flash_sector_release(&nor_replay_flash, sector + i);
+        if (status == LX_SECTOR_NOT_FOUND)
+            status =  LX_SUCCESS;
+    }
+    return(status);
+}
+
+
+/* Return the device time of the simulator, in nanoseconds.  */
+
+ULONG64  replay_time_get(void)
+{
+
+ULONG64 time;
+
+
+    if (replay_device == REPLAY_NAND)
+        _lx_nand_flash_simulator_time_get(&time);
+    else
+        _lx_nor_flash_simulator_time_get(&time);
+    return(time);
+}
+
+
+/* Return the lowest, the highest and the mean erase count of the blocks and its standard deviation.  */
+
+void  replay_erase_counts(ULONG *minimum, ULONG *maximum, double *mean, double *stddev)
+{
+
+ULONG   i;
+double  variance;
+
+
+    *minimum =  replay_block_erases[0];
+    *maximum =  replay_block_erases[0];
+    for (i = 1; i < replay_blocks; i++)
+    {
+        if (replay_block_erases[i] < *minimum)
+            *minimum =  replay_block_erases[i];
+        if (replay_block_erases[i] > *maximum)
+            *maximum =  replay_block_erases[i];
+    }
+    *mean =  (double) replay_erases / (double) replay_blocks;
+
+    variance =  0.0;
+    for (i = 0; i < replay_blocks; i++)
+        variance +=  ((double) replay_block_erases[i] - *mean) * ((double) replay_block_erases[i] - *mean);
+    *stddev =  sqrt(variance / (double) replay_blocks);
+}
+
+
+void  replay_failed(const char *reason)
+{
+
+    if (replay_line != 0)
+        printf("FAILED! %s at line %lu of the trace\n", reason, (unsigned long) replay_line);
+    else
+        printf("FAILED! %s\n", reason);
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+    while(1)
+    {
+    }
+}
+
+
+/* Define the counting block erase drivers.  */
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  replay_nor_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count)
+#else
+UINT  replay_nor_block_erase(ULONG block, ULONG erase_count)
+#endif
+{
+
+    replay_erases++;
+    if (block < replay_blocks)
+        replay_block_erases[block]++;
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((replay_nor_driver_block_erase)(nor_flash, block, erase_count));
+#else
+    return((replay_nor_driver_block_erase)(block, erase_count));
+#endif
+}
+
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  replay_nand_block_erase(LX_NAND_FLASH *nand_flash, ULONG block, ULONG erase_count)
+#else
+UINT  replay_nand_block_erase(ULONG block, ULONG erase_count)
+#endif
+{
+
+    replay_erases++;
+    if (block < replay_blocks)
+        replay_block_erases[block]++;
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((replay_nand_driver_block_erase)(nand_flash, block, erase_count));
+#else
+    return((replay_nand_driver_block_erase)(block, erase_count));
+#endif
+}
@@ -0,0 +1,842 @@
+/* NOR and NAND flash workload benchmark. Runs the standard workloads against the flash simulators:
+   sequential, uniform random, Zipfian, FAT-like metadata churn and fill to full then overwrite. Every
+   workload starts on an erased flash. The benchmark drivers count the driver calls, the erased blocks
+   and the bytes programmed, which give the write amplification against the bytes written by the
+   workload. Every read is checked against the last write of its sector. The device time is the time
+   the timing model of the simulator projects for the driver calls. The results are printed as CSV,
+   one line per device and workload, so the build configurations can be compared.  */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "lx_api.h"
+
+#define     DEMO_STACK_SIZE         4096
+
+/* Define the benchmark parameters. BENCHMARK_BUILD names the build configuration in the results,
+   BENCHMARK_NOR_OPERATIONS and BENCHMARK_NAND_OPERATIONS are the number of sector requests of each
+   workload, after the fill of the fill and overwrite workload. The capacity of the benchmark leaves
+   BENCHMARK_NOR_SPARE_BLOCKS (BENCHMARK_NAND_SPARE_BLOCKS) blocks free for the garbage collection.  */
+
+#ifndef BENCHMARK_BUILD
+#define BENCHMARK_BUILD                     "default"
+#endif
+#ifndef BENCHMARK_NOR_OPERATIONS
+#define BENCHMARK_NOR_OPERATIONS            20000
+#endif
+#ifndef BENCHMARK_NAND_OPERATIONS
+#define BENCHMARK_NAND_OPERATIONS           5000
+#endif
+#define BENCHMARK_SECTOR_WORDS              128
+#define BENCHMARK_READ_PERCENT              30
+#define BENCHMARK_NAND_MEMORY_SIZE          4096
+#define BENCHMARK_NOR_SPARE_BLOCKS          2
+#define BENCHMARK_NAND_SPARE_BLOCKS         8
+
+/* Define the layout of the FAT-like workload: the FAT and the directory are at the start of the
+   working set, files of BENCHMARK_FILE_SECTORS sectors are written to the data area behind them and
+   the oldest file is deleted once half of the data area, at most BENCHMARK_FILES files, is in use.  */
+
+#define BENCHMARK_FAT_SECTORS               4
+#define BENCHMARK_DIRECTORY_SECTORS         2
+#define BENCHMARK_FILE_SECTORS              8
+#define BENCHMARK_FILES                     64
+#define BENCHMARK_FAT_ENTRIES_PER_SECTOR    128
+#define BENCHMARK_QUEUE_SIZE                ((BENCHMARK_FILE_SECTORS * 3) + 4)
+
+/* Define the devices, workloads and requests.  */
+
+#define BENCHMARK_NOR                       0
+#define BENCHMARK_NAND                      1
+#define BENCHMARK_DEVICES                   2
+
+#define BENCHMARK_SEQUENTIAL                0
+#define BENCHMARK_UNIFORM                   1
+#define BENCHMARK_ZIPFIAN                   2
+#define BENCHMARK_FAT_CHURN                 3
+#define BENCHMARK_FILL_OVERWRITE            4
+#define BENCHMARK_WORKLOADS                 5
+
+#define BENCHMARK_READ                      0
+#define BENCHMARK_WRITE                     1
+#define BENCHMARK_RELEASE                   2
+
+
+/* Define the ThreadX object control blocks...  */
+#ifndef LX_STANDALONE_ENABLE
+TX_THREAD               thread_0;
+#endif
+UCHAR                   thread_0_stack[DEMO_STACK_SIZE];
+
+/* Define LevelX structures.  */
+
+LX_NOR_FLASH    nor_benchmark_flash;
+LX_NAND_FLASH   nand_benchmark_flash;
+ULONG           nand_benchmark_memory[BENCHMARK_NAND_MEMORY_SIZE];
+ULONG           benchmark_write_buffer[BENCHMARK_SECTOR_WORDS];
+ULONG           benchmark_read_buffer[BENCHMARK_SECTOR_WORDS];
+
+CHAR            *benchmark_device_name[BENCHMARK_DEVICES] =    {"nor", "nand"};
+CHAR            *benchmark_workload_name[BENCHMARK_WORKLOADS] = {"sequential", "uniform_random", "zipfian", "fat_churn", "fill_overwrite"};
+
+/* Define the workload state. benchmark_version holds the last version written to each sector of the
+   working set, zero if the sector isn't mapped.  */
+
+ULONG           benchmark_workload;
+ULONG           benchmark_sectors;
+ULONG           benchmark_capacity;
+ULONG           benchmark_device_operations;
+ULONG           benchmark_operations;
+ULONG           benchmark_operation;
+ULONG           benchmark_random;
+ULONG           *benchmark_version;
+ULONG           *benchmark_zipf_cdf;
+ULONG           benchmark_queue_type[BENCHMARK_QUEUE_SIZE];
+ULONG           benchmark_queue_sector[BENCHMARK_QUEUE_SIZE];
+ULONG           benchmark_queue_head;
+ULONG           benchmark_queue_tail;
+ULONG           benchmark_files;
+ULONG           benchmark_data_files;
+ULONG           benchmark_kept_files;
+
+/* Define the counters of the benchmark drivers. NOR writes are counted in words, NAND writes in pages.  */
+
+ULONG           benchmark_driver_calls;
+ULONG           benchmark_block_erases;
+ULONG           benchmark_units_programmed;
+
+
+/* Define the flash simulator prototypes and the original driver functions, which the benchmark
+   drivers call after counting.  */
+
+UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash);
+UINT  _lx_nor_flash_simulator_erase_all(VOID);
+UINT  _lx_nand_flash_simulator_initialize(LX_NAND_FLASH *nand_flash);
+UINT  _lx_nand_flash_simulator_erase_all(VOID);
+UINT  _lx_nor_flash_simulator_time_get(ULONG64 *time);
+UINT  _lx_nor_flash_simulator_time_reset(VOID);
+UINT  _lx_nand_flash_simulator_time_get(ULONG64 *time);
+UINT  _lx_nand_flash_simulator_time_reset(VOID);
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  (*benchmark_nor_driver_read)(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  (*benchmark_nor_driver_write)(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
+UINT  (*benchmark_nor_driver_block_erase)(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+UINT  (*benchmark_nor_driver_block_erased_verify)(LX_NOR_FLASH *nor_flash, ULONG block);
+UINT  benchmark_nor_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  benchmark_nor_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
+UINT  benchmark_nor_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+UINT  benchmark_nor_block_erased_verify(LX_NOR_FLASH *nor_flash, ULONG block);
+#else
+UINT  (*benchmark_nor_driver_read)(ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  (*benchmark_nor_driver_write)(ULONG *flash_address, ULONG *source, ULONG words);
+UINT  (*benchmark_nor_driver_block_erase)(ULONG block, ULONG erase_count);
+UINT  (*benchmark_nor_driver_block_erased_verify)(ULONG block);
+UINT  benchmark_nor_read(ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  benchmark_nor_write(ULONG *flash_address, ULONG *source, ULONG words);
+UINT  benchmark_nor_block_erase(ULONG block, ULONG erase_count);
+UINT  benchmark_nor_block_erased_verify(ULONG block);
+#endif
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  (*benchmark_nand_driver_pages_read)(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  (*benchmark_nand_driver_pages_write)(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  (*benchmark_nand_driver_pages_copy)(LX_NAND_FLASH *nand_flash, ULONG source_block, ULONG source_page, ULONG destination_block, ULONG destination_page, ULONG pages, UCHAR* data_buffer);
+UINT  (*benchmark_nand_driver_block_erase)(LX_NAND_FLASH *nand_flash, ULONG block, ULONG erase_count);
+UINT  (*benchmark_nand_driver_block_erased_verify)(LX_NAND_FLASH *nand_flash, ULONG block);
+UINT  (*benchmark_nand_driver_page_erased_verify)(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page);
+UINT  benchmark_nand_pages_read(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  benchmark_nand_pages_write(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  benchmark_nand_pages_copy(LX_NAND_FLASH *nand_flash, ULONG source_block, ULONG source_page, ULONG destination_block, ULONG destination_page, ULONG pages, UCHAR* data_buffer);
+UINT  benchmark_nand_block_erase(LX_NAND_FLASH *nand_flash, ULONG block, ULONG erase_count);
+UINT  benchmark_nand_block_erased_verify(LX_NAND_FLASH *nand_flash, ULONG block);
+UINT  benchmark_nand_page_erased_verify(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page);
+#else
+UINT  (*benchmark_nand_driver_pages_read)(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  (*benchmark_nand_driver_pages_write)(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  (*benchmark_nand_driver_pages_copy)(ULONG source_block, ULONG source_page, ULONG destination_block, ULONG destination_page, ULONG pages, UCHAR* data_buffer);
+UINT  (*benchmark_nand_driver_block_erase)(ULONG block, ULONG erase_count);
+UINT  (*benchmark_nand_driver_block_erased_verify)(ULONG block);
+UINT  (*benchmark_nand_driver_page_erased_verify)(ULONG block, ULONG page);
+UINT  benchmark_nand_pages_read(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  benchmark_nand_pages_write(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages);
+UINT  benchmark_nand_pages_copy(ULONG source_block, ULONG source_page, ULONG destination_block, ULONG destination_page, ULONG pages, UCHAR* data_buffer);
+UINT  benchmark_nand_block_erase(ULONG block, ULONG erase_count);
+UINT  benchmark_nand_block_erased_verify(ULONG block);
+UINT  benchmark_nand_page_erased_verify(ULONG block, ULONG page);
+#endif
+
+
+/* Define thread prototypes.  */
+
+void    thread_0_entry(ULONG thread_input);
+void    benchmark_flash_open(ULONG device);
+void    benchmark_flash_close(ULONG device);
+void    benchmark_workload_start(ULONG workload);
+void    benchmark_workload_end(void);
+ULONG   benchmark_request_next(ULONG *sector);
+void    benchmark_file_queue(void);
+void    benchmark_queue_put(ULONG type, ULONG sector);
+ULONG   benchmark_random_get(ULONG range);
+UINT    benchmark_sector_write(ULONG device, ULONG sector);
+UINT    benchmark_sector_read(ULONG device, ULONG sector);
+UINT    benchmark_sector_release(ULONG device, ULONG sector);
+void    benchmark_failed(void);
+
+
+
+/* Define main entry point.  */
+
+int main()
+{
+
+    /* Enter the ThreadX kernel.  */
+#ifndef LX_STANDALONE_ENABLE
+    tx_kernel_enter();
+#else
+    thread_0_entry(0);
+#endif
+
+}
+
+
+/* Define what the initial system looks like.  */
+#ifndef LX_STANDALONE_ENABLE
+void    tx_application_define(void *first_unused_memory)
+{
+
+
+    /* Create the main thread.  */
+    tx_thread_create(&thread_0, "thread 0", thread_0_entry, 0,
+            thread_0_stack, DEMO_STACK_SIZE,
+            1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+#endif
+
+/* Define the benchmark thread.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   device;
+ULONG   workload;
+ULONG   request;
+ULONG   sector;
+ULONG   reads;
+ULONG   writes;
+ULONG   releases;
+ULONG   sector_bytes;
+ULONG   unit_bytes;
+double  bytes_written;
+double  bytes_programmed;
+double  seconds;
+double  device_seconds;
+ULONG64 device_time;
+clock_t start;
+UINT    status;
+
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+    _lx_nand_flash_initialize();
+
+    printf("build,device,workload,operations,reads,writes,releases,seconds,operations_per_second,driver_calls,"
+           "driver_calls_per_operation,block_erases,bytes_written,bytes_programmed,write_amplification,device_seconds\n");
+
+    for (device = 0; device < BENCHMARK_DEVICES; device++)
+    {
+
+        for (workload = 0; workload < BENCHMARK_WORKLOADS; workload++)
+        {
+
+            /* Start every workload on an erased flash.  */
+            benchmark_flash_open(device);
+            benchmark_workload_start(workload);
+
+            /* Issue the requests of the workload.  */
+            reads =     0;
+            writes =    0;
+            releases =  0;
+            benchmark_driver_calls =      0;
+            benchmark_block_erases =      0;
+            benchmark_units_programmed =  0;
+            if (device == BENCHMARK_NAND)
+                _lx_nand_flash_simulator_time_reset();
+            else
+                _lx_nor_flash_simulator_time_reset();
+            start =  clock();
+            while (benchmark_operation < benchmark_operations)
+            {
+
+                request =  benchmark_request_next(&sector);
+                if (request == BENCHMARK_WRITE)
+                {
+                    status =  benchmark_sector_write(device, sector);
+                    writes++;
+                }
+                else if (request == BENCHMARK_READ)
+                {
+                    status =  benchmark_sector_read(device, sector);
+                    reads++;
+                }
+                else
+                {
+                    status =  benchmark_sector_release(device, sector);
+                    releases++;
+                }
+                if (status != LX_SUCCESS)
+                    benchmark_failed();
+            }
+            seconds =  ((double) (clock() - start)) / CLOCKS_PER_SEC;
+
+            /* Pickup the device time of the workload, in nanoseconds.  */
+            if (device == BENCHMARK_NAND)
+                _lx_nand_flash_simulator_time_get(&device_time);
+            else
+                _lx_nor_flash_simulator_time_get(&device_time);
+            device_seconds =  ((double) device_time) / 1000000000.0;
+
+            /* Determine the bytes written by the workload and the bytes programmed by the flash.  */
+            if (device == BENCHMARK_NAND)
+            {
+                sector_bytes =  nand_benchmark_flash.lx_nand_flash_bytes_per_page;
+                unit_bytes =    nand_benchmark_flash.lx_nand_flash_bytes_per_page;
+            }
+            else
+            {
+                sector_bytes =  nor_benchmark_flash.lx_nor_flash_words_per_sector * sizeof(ULONG);
+                unit_bytes =    sizeof(ULONG);
+            }
+            bytes_written =     (double) writes * sector_bytes;
+            bytes_programmed =  (double) benchmark_units_programmed * unit_bytes;
+
+            benchmark_workload_end();
+            benchmark_flash_close(device);
+
+            printf("%s,%s,%s,%lu,%lu,%lu,%lu,%.6f,%.1f,%lu,%.3f,%lu,%.0f,%.0f,%.3f,%.6f\n", BENCHMARK_BUILD, benchmark_device_name[device],
+                   benchmark_workload_name[workload], (unsigned long) benchmark_operations, (unsigned long) reads, (unsigned long) writes,
+                   (unsigned long) releases, seconds, (seconds > 0.0) ? ((double) benchmark_operations / seconds) : 0.0,
+                   (unsigned long) benchmark_driver_calls, (double) benchmark_driver_calls / (double) benchmark_operations,
+                   (unsigned long) benchmark_block_erases, bytes_written, bytes_programmed,
+                   (bytes_written > 0.0) ? (bytes_programmed / bytes_written) : 0.0, device_seconds);
+        }
+    }
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+/* Erase the simulated flash, open it and put the counting drivers in place.  */
+
+void  benchmark_flash_open(ULONG device)
+{
+
+UINT    status;
+
+
+    if (device == BENCHMARK_NAND)
+    {
+
+        _lx_nand_flash_simulator_erase_all();
+        status =  lx_nand_flash_format(&nand_benchmark_flash, "benchmark nand flash", _lx_nand_flash_simulator_initialize, nand_benchmark_memory, sizeof(nand_benchmark_memory));
+        if (status == LX_SUCCESS)
+            status =  lx_nand_flash_open(&nand_benchmark_flash, "benchmark nand flash", _lx_nand_flash_simulator_initialize, nand_benchmark_memory, sizeof(nand_benchmark_memory));
+        if ((status != LX_SUCCESS) || (nand_benchmark_flash.lx_nand_flash_words_per_page > BENCHMARK_SECTOR_WORDS) ||
+            (nand_benchmark_flash.lx_nand_flash_free_block_list_tail <= BENCHMARK_NAND_SPARE_BLOCKS))
+            benchmark_failed();
+        benchmark_capacity =  (nand_benchmark_flash.lx_nand_flash_free_block_list_tail - BENCHMARK_NAND_SPARE_BLOCKS) * nand_benchmark_flash.lx_nand_flash_pages_per_block;
+        benchmark_device_operations =  BENCHMARK_NAND_OPERATIONS;
+
+        benchmark_nand_driver_pages_read =           nand_benchmark_flash.lx_nand_flash_driver_pages_read;
+        benchmark_nand_driver_pages_write =          nand_benchmark_flash.lx_nand_flash_driver_pages_write;
+        benchmark_nand_driver_pages_copy =           nand_benchmark_flash.lx_nand_flash_driver_pages_copy;
+        benchmark_nand_driver_block_erase =          nand_benchmark_flash.lx_nand_flash_driver_block_erase;
+        benchmark_nand_driver_block_erased_verify =  nand_benchmark_flash.lx_nand_flash_driver_block_erased_verify;
+        benchmark_nand_driver_page_erased_verify =   nand_benchmark_flash.lx_nand_flash_driver_page_erased_verify;
+        nand_benchmark_flash.lx_nand_flash_driver_pages_read =           benchmark_nand_pages_read;
+        nand_benchmark_flash.lx_nand_flash_driver_pages_write =          benchmark_nand_pages_write;
+        nand_benchmark_flash.lx_nand_flash_driver_pages_copy =           benchmark_nand_pages_copy;
+        nand_benchmark_flash.lx_nand_flash_driver_block_erase =          benchmark_nand_block_erase;
+        nand_benchmark_flash.lx_nand_flash_driver_block_erased_verify =  benchmark_nand_block_erased_verify;
+        nand_benchmark_flash.lx_nand_flash_driver_page_erased_verify =   benchmark_nand_page_erased_verify;
+    }
+    else
+    {
+
+        _lx_nor_flash_simulator_erase_all();
+        status =  lx_nor_flash_open(&nor_benchmark_flash, "benchmark nor flash", _lx_nor_flash_simulator_initialize);
+        if ((status != LX_SUCCESS) || (nor_benchmark_flash.lx_nor_flash_words_per_sector > BENCHMARK_SECTOR_WORDS) ||
+            (nor_benchmark_flash.lx_nor_flash_total_blocks <= BENCHMARK_NOR_SPARE_BLOCKS))
+            benchmark_failed();
+        benchmark_capacity =  (nor_benchmark_flash.lx_nor_flash_total_blocks - BENCHMARK_NOR_SPARE_BLOCKS) * nor_benchmark_flash.lx_nor_flash_physical_sectors_per_block;
+        benchmark_device_operations =  BENCHMARK_NOR_OPERATIONS;
+
+        benchmark_nor_driver_read =                 nor_benchmark_flash.lx_nor_flash_driver_read;
+        benchmark_nor_driver_write =                nor_benchmark_flash.lx_nor_flash_driver_write;
+        benchmark_nor_driver_block_erase =          nor_benchmark_flash.lx_nor_flash_driver_block_erase;
+        benchmark_nor_driver_block_erased_verify =  nor_benchmark_flash.lx_nor_flash_driver_block_erased_verify;
+        nor_benchmark_flash.lx_nor_flash_driver_read =                 benchmark_nor_read;
+        nor_benchmark_flash.lx_nor_flash_driver_write =                benchmark_nor_write;
+        nor_benchmark_flash.lx_nor_flash_driver_block_erase =          benchmark_nor_block_erase;
+        nor_benchmark_flash.lx_nor_flash_driver_block_erased_verify =  benchmark_nor_block_erased_verify;
+    }
+}
+
+
+void  benchmark_flash_close(ULONG device)
+{
+
+UINT    status;
+
+
+    if (device == BENCHMARK_NAND)
+        status =  lx_nand_flash_close(&nand_benchmark_flash);
+    else
+        status =  lx_nor_flash_close(&nor_benchmark_flash);
+    if (status != LX_SUCCESS)
+        benchmark_failed();
+}
+
+
+/* Setup a workload. The fill and overwrite workload uses the whole capacity, the other workloads
+   three quarters of it.  */
+
+void  benchmark_workload_start(ULONG workload)
+{
+
+ULONG   i;
+double  sum;
+double  total;
+
+
+    benchmark_workload =    workload;
+    benchmark_operation =   0;
+    benchmark_operations =  benchmark_device_operations;
+    benchmark_random =      0x2545F491;
+    benchmark_queue_head =  0;
+    benchmark_queue_tail =  0;
+    benchmark_files =       0;
+    benchmark_zipf_cdf =    LX_NULL;
+    if (workload == BENCHMARK_FILL_OVERWRITE)
+    {
+        benchmark_sectors =     benchmark_capacity;
+        benchmark_operations =  benchmark_capacity + benchmark_device_operations;
+    }
+    else
+        benchmark_sectors =  (benchmark_capacity * 3) / 4;
+
+    benchmark_version =  calloc(benchmark_sectors, sizeof(ULONG));
+    if (benchmark_version == LX_NULL)
+        benchmark_failed();
+
+    /* Build the cumulative distribution of the Zipfian workload, the probability of the sector of rank k
+       is proportional to 1/k. The distribution is scaled to 31 bits for the random number.  */
+    if (workload == BENCHMARK_ZIPFIAN)
+    {
+
+        benchmark_zipf_cdf =  malloc(benchmark_sectors * sizeof(ULONG));
+        if (benchmark_zipf_cdf == LX_NULL)
+            benchmark_failed();
+        total =  0.0;
+        for (i = 0; i < benchmark_sectors; i++)
+            total +=  1.0 / (double) (i + 1);
+        sum =  0.0;
+        for (i = 0; i < benchmark_sectors; i++)
+        {
+            sum +=  1.0 / (double) (i + 1);
+            benchmark_zipf_cdf[i] =  (ULONG) ((sum / total) * 2147483647.0);
+        }
+        benchmark_zipf_cdf[benchmark_sectors - 1] =  0x7FFFFFFF;
+    }
+
+    /* The FAT-like workload keeps half of the files that fit in the data area.  */
+    benchmark_data_files =  (benchmark_sectors - (BENCHMARK_FAT_SECTORS + BENCHMARK_DIRECTORY_SECTORS)) / BENCHMARK_FILE_SECTORS;
+    if (benchmark_data_files > (BENCHMARK_FILES * 2))
+        benchmark_data_files =  BENCHMARK_FILES * 2;
+    benchmark_kept_files =  benchmark_data_files / 2;
+    if ((workload == BENCHMARK_FAT_CHURN) && (benchmark_kept_files == 0))
+        benchmark_failed();
+}
+
+
+void  benchmark_workload_end(void)
+{
+
+    free(benchmark_version);
+    if (benchmark_zipf_cdf)
+        free(benchmark_zipf_cdf);
+}
+
+
+/* Return the next request of the workload and its sector.  */
+
+ULONG  benchmark_request_next(ULONG *sector)
+{
+
+ULONG   operation;
+ULONG   request;
+ULONG   random;
+ULONG   low;
+ULONG   high;
+ULONG   middle;
+
+
+    operation =  benchmark_operation++;
+    request =    BENCHMARK_WRITE;
+    switch (benchmark_workload)
+    {
+
+    case BENCHMARK_SEQUENTIAL:
+
+        /* Write the working set in order, then read it in order.  */
+        if (operation >= (benchmark_operations / 2))
+        {
+            request =  BENCHMARK_READ;
+            operation =  operation - (benchmark_operations / 2);
+        }
+        *sector =  operation % benchmark_sectors;
+        break;
+
+    case BENCHMARK_UNIFORM:
+
+        if (benchmark_random_get(100) < BENCHMARK_READ_PERCENT)
+            request =  BENCHMARK_READ;
+        *sector =  benchmark_random_get(benchmark_sectors);
+        break;
+
+    case BENCHMARK_ZIPFIAN:
+
+        if (benchmark_random_get(100) < BENCHMARK_READ_PERCENT)
+            request =  BENCHMARK_READ;
+
+        /* Find the first sector whose cumulative probability is above the random number.  */
+        random =  benchmark_random_get(0x7FFFFFFF);
+        low =   0;
+        high =  benchmark_sectors - 1;
+        while (low < high)
+        {
+            middle =  (low + high) / 2;
+            if (benchmark_zipf_cdf[middle] > random)
+                high =  middle;
+            else
+                low =  middle + 1;
+        }
+        *sector =  low;
+        break;
+
+    case BENCHMARK_FAT_CHURN:
+
+        if (benchmark_queue_head == benchmark_queue_tail)
+            benchmark_file_queue();
+        request =  benchmark_queue_type[benchmark_queue_head];
+        *sector =  benchmark_queue_sector[benchmark_queue_head];
+        benchmark_queue_head =  (benchmark_queue_head + 1) % BENCHMARK_QUEUE_SIZE;
+        break;
+
+    default:
+
+        /* Fill the whole capacity in order, then overwrite random sectors.  */
+        if (operation < benchmark_sectors)
+            *sector =  operation;
+        else
+            *sector =  benchmark_random_get(benchmark_sectors);
+        break;
+    }
+
+    return(request);
+}
+
+
+/* Queue the requests of the next file of the FAT-like workload. Every data sector written updates the
+   FAT, the directory is updated when the file is closed. Once half of the data area is used, the oldest
+   file is deleted, its sectors are released and the FAT and directory are updated again.  */
+
+void  benchmark_file_queue(void)
+{
+
+ULONG   file;
+ULONG   data_sector;
+ULONG   i;
+
+
+    file =  benchmark_files % benchmark_data_files;
+    for (i = 0; i < BENCHMARK_FILE_SECTORS; i++)
+    {
+        data_sector =  (file * BENCHMARK_FILE_SECTORS) + i;
+        benchmark_queue_put(BENCHMARK_WRITE, BENCHMARK_FAT_SECTORS + BENCHMARK_DIRECTORY_SECTORS + data_sector);
+        benchmark_queue_put(BENCHMARK_WRITE, (data_sector / BENCHMARK_FAT_ENTRIES_PER_SECTOR) % BENCHMARK_FAT_SECTORS);
+    }
+    benchmark_queue_put(BENCHMARK_READ, BENCHMARK_FAT_SECTORS + (benchmark_files % BENCHMARK_DIRECTORY_SECTORS));
+    benchmark_queue_put(BENCHMARK_WRITE, BENCHMARK_FAT_SECTORS + (benchmark_files % BENCHMARK_DIRECTORY_SECTORS));
+
+    if (benchmark_files >= benchmark_kept_files)
+    {
+
+        file =  (benchmark_files - benchmark_kept_files) % benchmark_data_files;
+        for (i = 0; i < BENCHMARK_FILE_SECTORS; i++)
+            benchmark_queue_put(BENCHMARK_RELEASE, BENCHMARK_FAT_SECTORS + BENCHMARK_DIRECTORY_SECTORS + (file * BENCHMARK_FILE_SECTORS) + i);
+        benchmark_queue_put(BENCHMARK_WRITE, ((file * BENCHMARK_FILE_SECTORS) / BENCHMARK_FAT_ENTRIES_PER_SECTOR) % BENCHMARK_FAT_SECTORS);
+        benchmark_queue_put(BENCHMARK_WRITE, BENCHMARK_FAT_SECTORS + (file % BENCHMARK_DIRECTORY_SECTORS));
+    }
+    benchmark_files++;
+}
+
+
+void  benchmark_queue_put(ULONG type, ULONG sector)
+{
+
+    benchmark_queue_type[benchmark_queue_tail] =    type;
+    benchmark_queue_sector[benchmark_queue_tail] =  sector;
+    benchmark_queue_tail =  (benchmark_queue_tail + 1) % BENCHMARK_QUEUE_SIZE;
+}
+
+
+/* Return a pseudo random number below range, the sequence is the same in every run.  */
+
+ULONG  benchmark_random_get(ULONG range)
+{
+
+    benchmark_random ^=  (benchmark_random << 13) & 0xFFFFFFFF;
+    benchmark_random ^=  benchmark_random >> 17;
+    benchmark_random ^=  (benchmark_random << 5) & 0xFFFFFFFF;
+    return((benchmark_random & 0x7FFFFFFF) % range);
+}
+
+
+/* Write a new version of a sector. The first words hold the sector and the version.  */
+
+UINT  benchmark_sector_write(ULONG device, ULONG sector)
+{
+
+ULONG   i;
+
+
+    benchmark_version[sector] =  benchmark_operation;
+    benchmark_write_buffer[0] =  sector;
+    benchmark_write_buffer[1] =  benchmark_operation;
+    for (i = 2; i < BENCHMARK_SECTOR_WORDS; i++)
+        benchmark_write_buffer[i] =  benchmark_operation + i;
+
+    if (device == BENCHMARK_NAND)
+        return(lx_nand_flash_sector_write(&nand_benchmark_flash, sector, benchmark_write_buffer));
+    return(lx_nor_flash_sector_write(&nor_benchmark_flash, sector, benchmark_write_buffer));
+}
+
+
+/* Read a sector and check it holds the last version written. Sectors that aren't mapped aren't checked.  */
+
+UINT  benchmark_sector_read(ULONG device, ULONG sector)
+{
+
+UINT    status;
+
+
+    if (device == BENCHMARK_NAND)
+        status =  lx_nand_flash_sector_read(&nand_benchmark_flash, sector, benchmark_read_buffer);
+    else
+        status =  lx_nor_flash_sector_read(&nor_benchmark_flash, sector, benchmark_read_buffer);
+
+    if (benchmark_version[sector] == 0)
+        return((status == LX_SECTOR_NOT_FOUND) ? LX_SUCCESS : status);
+    if ((status == LX_SUCCESS) &&
+        ((benchmark_read_buffer[0] != sector) || (benchmark_read_buffer[1] != benchmark_version[sector])))
+        status =  LX_ERROR;
+    return(status);
+}
+
+
+UINT  benchmark_sector_release(ULONG device, ULONG sector)
+{
+
+    benchmark_version[sector] =  0;
+    if (device == BENCHMARK_NAND)
+        return(lx_nand_flash_sector_release(&nand_benchmark_flash, sector));
+    return(lx_nor_flash_sector_release(&nor_benchmark_flash, sector));
+}
+
+
+void  benchmark_failed(void)
+{
+
+    printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+    while(1)
+    {
+    }
+}
+
+
+/* Define the counting NOR drivers.  */
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nor_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words)
+#else
+UINT  benchmark_nor_read(ULONG *flash_address, ULONG *destination, ULONG words)
+#endif
+{
+
+    benchmark_driver_calls++;
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nor_driver_read)(nor_flash, flash_address, destination, words));
+#else
+    return((benchmark_nor_driver_read)(flash_address, destination, words));
+#endif
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nor_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words)
+#else
+UINT  benchmark_nor_write(ULONG *flash_address, ULONG *source, ULONG words)
+#endif
+{
+
+    benchmark_driver_calls++;
+    benchmark_units_programmed +=  words;
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nor_driver_write)(nor_flash, flash_address, source, words));
+#else
+    return((benchmark_nor_driver_write)(flash_address, source, words));
+#endif
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nor_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count)
+#else
+UINT  benchmark_nor_block_erase(ULONG block, ULONG erase_count)
+#endif
+{
+
+    benchmark_driver_calls++;
+    benchmark_block_erases++;
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nor_driver_block_erase)(nor_flash, block, erase_count));
+#else
+    return((benchmark_nor_driver_block_erase)(block, erase_count));
+#endif
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nor_block_erased_verify(LX_NOR_FLASH *nor_flash, ULONG block)
+#else
+UINT  benchmark_nor_block_erased_verify(ULONG block)
+#endif
+{
+
+    benchmark_driver_calls++;
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nor_driver_block_erased_verify)(nor_flash, block));
+#else
+    return((benchmark_nor_driver_block_erased_verify)(block));
+#endif
+}
+
+
+/* Define the counting NAND drivers. Copies program the destination pages.  */
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nand_pages_read(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages)
+#else
+UINT  benchmark_nand_pages_read(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages)
+#endif
+{
+
+    benchmark_driver_calls++;
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nand_driver_pages_read)(nand_flash, block, page, main_buffer, spare_buffer, pages));
+#else
+    return((benchmark_nand_driver_pages_read)(block, page, main_buffer, spare_buffer, pages));
+#endif
+}
+
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nand_pages_write(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages)
+#else
+UINT  benchmark_nand_pages_write(ULONG block, ULONG page, UCHAR* main_buffer, UCHAR* spare_buffer, ULONG pages)
+#endif
+{
+
+    benchmark_driver_calls++;
+    benchmark_units_programmed +=  pages;
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nand_driver_pages_write)(nand_flash, block, page, main_buffer, spare_buffer, pages));
+#else
+    return((benchmark_nand_driver_pages_write)(block, page, main_buffer, spare_buffer, pages));
+#endif
+}
+
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nand_pages_copy(LX_NAND_FLASH *nand_flash, ULONG source_block, ULONG source_page, ULONG destination_block, ULONG destination_page, ULONG pages, UCHAR* data_buffer)
+#else
+UINT  benchmark_nand_pages_copy(ULONG source_block, ULONG source_page, ULONG destination_block, ULONG destination_page, ULONG pages, UCHAR* data_buffer)
+#endif
+{
+
+    benchmark_driver_calls++;
+    benchmark_units_programmed +=  pages;
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nand_driver_pages_copy)(nand_flash, source_block, source_page, destination_block, destination_page, pages, data_buffer));
+#else
+    return((benchmark_nand_driver_pages_copy)(source_block, source_page, destination_block, destination_page, pages, data_buffer));
+#endif
+}
+
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nand_block_erase(LX_NAND_FLASH *nand_flash, ULONG block, ULONG erase_count)
+#else
+UINT  benchmark_nand_block_erase(ULONG block, ULONG erase_count)
+#endif
+{
+
+    benchmark_driver_calls++;
+    benchmark_block_erases++;
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nand_driver_block_erase)(nand_flash, block, erase_count));
+#else
+    return((benchmark_nand_driver_block_erase)(block, erase_count));
+#endif
+}
+
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nand_block_erased_verify(LX_NAND_FLASH *nand_flash, ULONG block)
+#else
+UINT  benchmark_nand_block_erased_verify(ULONG block)
+#endif
+{
+
+    benchmark_driver_calls++;
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nand_driver_block_erased_verify)(nand_flash, block));
+#else
+    return((benchmark_nand_driver_block_erased_verify)(block));
+#endif
+}
+
+
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  benchmark_nand_page_erased_verify(LX_NAND_FLASH *nand_flash, ULONG block, ULONG page)
+#else
+UINT  benchmark_nand_page_erased_verify(ULONG block, ULONG page)
+#endif
+{
+
+    benchmark_driver_calls++;
+#ifdef LX_NAND_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return((benchmark_nand_driver_page_erased_verify)(nand_flash, block, page));
+#else
+    return((benchmark_nand_driver_page_erased_verify)(block, page));
+#endif
+}
@@ -22,6 +22,15 @@ UCHAR                   cache_memory[50000];
 LX_NAND_FLASH   nand_sim_flash;
 ULONG           buffer[2048];
 ULONG           readbuffer[2048];
+ULONG64         nand_sim_time;
+ULONG           nand_geometry_memory[64 * 64 * ((512 + 16) / sizeof(ULONG))];
+#ifdef LX_NAND_ENABLE_STATS
+LX_FLASH_STATS  nand_stats;
+#endif
+#ifdef LX_NAND_ENABLE_TRACE
+ULONG           nand_trace_memory[(sizeof(LX_TRACE_HEADER) + (8192 * sizeof(LX_TRACE_EVENT))) / sizeof(ULONG)];
+ULONG           nand_trace_events[LX_TRACE_CACHE_MISS + 1];
+#endif
 
 extern ULONG    *nand_flash_memory;
 
@@ -29,6 +38,15 @@ extern ULONG    *nand_flash_memory;
 
 UINT  _lx_nand_flash_simulator_erase_all(VOID);
 UINT  _lx_nand_flash_simulator_initialize(LX_NAND_FLASH *nand_flash);
+UINT  _lx_nand_flash_simulator_timing_set(ULONG page_read_time, ULONG page_program_time, ULONG block_erase_time, ULONG copyback_time, ULONG bus_byte_time);
+UINT  _lx_nand_flash_simulator_time_get(ULONG64 *time);
+UINT  _lx_nand_flash_simulator_time_reset(VOID);
+UINT  _lx_nand_flash_simulator_geometry_set(ULONG total_blocks, ULONG pages_per_block, ULONG *memory, ULONG64 memory_size);
+UINT  _lx_nand_flash_simulator_fast_forward_set(UINT enable);
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+UINT  _lx_nand_flash_simulator_file_open(CHAR *file_name, ULONG total_blocks, ULONG pages_per_block);
+UINT  _lx_nand_flash_simulator_file_close(VOID);
+#endif
 
 VOID  _fx_nand_flash_read_sectors(ULONG logical_sector, ULONG sectors, UCHAR *destination_buffer);
 VOID  _fx_nand_flash_write_sectors(ULONG logical_sector, ULONG sectors, UCHAR *source_buffer);
@@ -89,7 +107,11 @@ void    tx_application_define(void *first_unused_memory)
 #endif
 
 
+#ifdef LX_NAND_ENABLE_SHARED_READ
+#define NAND_MEMORY_SIZE (2056 + ((LX_NAND_SHARED_READERS * 16) / sizeof(ULONG)))
+#else
 #define NAND_MEMORY_SIZE 2056
+#endif
 ULONG nand_memory_space[NAND_MEMORY_SIZE];
 
 /* For random read/write test */
@@ -108,6 +130,10 @@ UINT    status;
 
 ULONG   *word_ptr;
 UCHAR   *byte_ptr;
+#ifdef LX_NAND_ENABLE_TRACE
+LX_TRACE_HEADER *trace_header;
+LX_TRACE_EVENT  *trace_event;
+#endif
 
   
     /* Erase the simulated NOR flash.  */
@@ -813,6 +839,525 @@ UCHAR   *byte_ptr;
 
     printf("SUCCESS!\n");
 
+#ifdef LX_NAND_ENABLE_WRITE_IF_CHANGED
+    printf("Test 5: Write if changed........................");
+
+    /* Reinitialize...  */
+    status =  lx_nand_flash_close(&nand_sim_flash);
+    _lx_nand_flash_simulator_erase_all();
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+
+    /* Write sector 0, which is recorded sequentially, and sector 7, which is not.  */
+    for (j = 0; j < nand_sim_flash.lx_nand_flash_words_per_page; j++)
+        buffer[j] =  j;
+    status += lx_nand_flash_sector_write(&nand_sim_flash, 0, buffer);
+    status += lx_nand_flash_sector_write(&nand_sim_flash, 7, buffer);
+    i =  nand_sim_flash.lx_nand_flash_block_status_table[nand_sim_flash.lx_nand_flash_block_mapping_table[0]];
+
+    if ((status != LX_SUCCESS) || (nand_sim_flash.lx_nand_flash_diagnostic_elided_writes != 0))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* Writing the same data again doesn't change the flash.  */
+    status =  lx_nand_flash_sector_write(&nand_sim_flash, 0, buffer);
+    status += lx_nand_flash_sector_write(&nand_sim_flash, 7, buffer);
+
+    if ((status != LX_SUCCESS) || (nand_sim_flash.lx_nand_flash_diagnostic_elided_writes != 2) ||
+        (nand_sim_flash.lx_nand_flash_block_status_table[nand_sim_flash.lx_nand_flash_block_mapping_table[0]] != i))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* Different data and released sectors are written.  */
+    buffer[5] =  0;
+    status =  lx_nand_flash_sector_write(&nand_sim_flash, 7, buffer);
+    status += lx_nand_flash_sector_read(&nand_sim_flash, 7, readbuffer);
+
+    if ((status != LX_SUCCESS) || (readbuffer[5] != 0) || (readbuffer[6] != 6) || (nand_sim_flash.lx_nand_flash_diagnostic_elided_writes != 2))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    for (j = 0; j < nand_sim_flash.lx_nand_flash_words_per_page; j++)
+        buffer[j] =  0xFFFFFFFF;
+    status =  lx_nand_flash_sector_release(&nand_sim_flash, 7);
+    status += lx_nand_flash_sector_write(&nand_sim_flash, 7, buffer);
+    status += lx_nand_flash_sectors_write(&nand_sim_flash, 7, buffer, 1);
+
+    if ((status != LX_SUCCESS) || (nand_sim_flash.lx_nand_flash_diagnostic_elided_writes != 3))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* The skipped sectors must still read back after the NAND flash is opened again.  */
+    status =  lx_nand_flash_close(&nand_sim_flash);
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_sector_read(&nand_sim_flash, 0, readbuffer);
+    status += lx_nand_flash_sector_read(&nand_sim_flash, 7, buffer);
+
+    if ((status != LX_SUCCESS) || (readbuffer[5] != 5) || (readbuffer[nand_sim_flash.lx_nand_flash_words_per_page - 1] != (nand_sim_flash.lx_nand_flash_words_per_page - 1)) ||
+        (buffer[5] != 0xFFFFFFFF))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef LX_NAND_ENABLE_STATS
+    printf("Test 6: Statistics..............................");
+
+    /* Reinitialize and clear the statistics of the open.  */
+    status =  lx_nand_flash_close(&nand_sim_flash);
+    _lx_nand_flash_simulator_erase_all();
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_stats_reset(&nand_sim_flash);
+
+    /* Write, read and release.  */
+    for (i = 0; i < 8; i++)
+    {
+        for (j = 0; j < nand_sim_flash.lx_nand_flash_words_per_page; j++)
+            buffer[j] =  i + j;
+        status += lx_nand_flash_sector_write(&nand_sim_flash, i, buffer);
+    }
+    for (i = 0; i < 8; i++)
+        status += lx_nand_flash_sector_read(&nand_sim_flash, i, readbuffer);
+    status += lx_nand_flash_sector_release(&nand_sim_flash, 3);
+    status += lx_nand_flash_stats_get(&nand_sim_flash, &nand_stats);
+
+    if ((status != LX_SUCCESS) ||
+        (nand_stats.lx_flash_stats_api_calls[LX_STATS_SECTOR_WRITE] != 8) ||
+        (nand_stats.lx_flash_stats_api_calls[LX_STATS_SECTOR_READ] != 8) ||
+        (nand_stats.lx_flash_stats_api_calls[LX_STATS_SECTOR_RELEASE] != 1) ||
+        (nand_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_WRITE] < 8) ||
+        (nand_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_READ] < 8) ||
+        (nand_stats.lx_flash_stats_bytes_requested != (8 * nand_sim_flash.lx_nand_flash_bytes_per_page)) ||
+        (nand_stats.lx_flash_stats_bytes_programmed < nand_stats.lx_flash_stats_bytes_requested))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* Every call is in one histogram bucket, and the whole histogram is below the longest call.  */
+    for (i = 0; i < LX_STATS_APIS; i++)
+    {
+        for (j = 0, sector = 0; j < LX_STATS_HISTOGRAM_BUCKETS; j++)
+            sector += nand_stats.lx_flash_stats_api_latency_histogram[i][j];
+        if ((sector != nand_stats.lx_flash_stats_api_calls[i]) ||
+            (lx_stats_latency_percentile(&nand_stats, (UINT) i, 100) != nand_stats.lx_flash_stats_api_latency_max[i]))
+        {
+            printf("FAILED!\n");
+#ifdef BATCH_TEST
+            exit(1);
+#endif
+            while (1)
+            {
+            }
+        }
+    }
+
+    /* Reset the statistics, the driver counts start again from zero.  */
+    status =  lx_nand_flash_stats_reset(&nand_sim_flash);
+    status += lx_nand_flash_stats_get(&nand_sim_flash, &nand_stats);
+
+    if ((status != LX_SUCCESS) || (nand_stats.lx_flash_stats_api_calls[LX_STATS_SECTOR_WRITE] != 0) ||
+        (nand_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_READ] != 0) || (nand_stats.lx_flash_stats_bytes_programmed != 0))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef LX_NAND_ENABLE_TRACE
+    printf("Test 7: Trace...................................");
+
+    /* Reinitialize and start the trace, memory for less than one event is rejected.  */
+    status =  lx_nand_flash_close(&nand_sim_flash);
+    _lx_nand_flash_simulator_erase_all();
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    if (lx_nand_flash_trace_enable(&nand_sim_flash, nand_trace_memory, sizeof(LX_TRACE_HEADER)) != LX_ERROR)
+        status =  LX_ERROR;
+    status += lx_nand_flash_trace_enable(&nand_sim_flash, nand_trace_memory, sizeof(nand_trace_memory));
+
+    /* Rewrite a few sectors until blocks are reclaimed, then release one of them.  */
+    for (i = 0; i < 1000; i++)
+    {
+        for (j = 0; j < nand_sim_flash.lx_nand_flash_words_per_page; j++)
+            buffer[j] =  i + j;
+        status += lx_nand_flash_sector_write(&nand_sim_flash, i % 8, buffer);
+    }
+    status += lx_nand_flash_sector_release(&nand_sim_flash, 3);
+
+    /* Count the events of the trace.  */
+    trace_header =  (LX_TRACE_HEADER *) nand_trace_memory;
+    trace_event =   (LX_TRACE_EVENT *) (trace_header + 1);
+    for (j = 0; j <= LX_TRACE_CACHE_MISS; j++)
+        nand_trace_events[j] =  0;
+    for (j = 0; j < trace_header -> lx_trace_header_total; j++)
+    {
+        if (trace_event[j].lx_trace_event_id <= LX_TRACE_CACHE_MISS)
+            nand_trace_events[trace_event[j].lx_trace_event_id]++;
+    }
+
+    /* The first event is the start of the first write, the last event the end of the release.  */
+    if ((status != LX_SUCCESS) || (trace_header -> lx_trace_header_id != LX_TRACE_ID) || (trace_header -> lx_trace_header_device != LX_TRACE_NAND) ||
+        (trace_header -> lx_trace_header_total >= trace_header -> lx_trace_header_events) ||
+        (trace_event[0].lx_trace_event_id != LX_TRACE_API_ENTRY) || (trace_event[0].lx_trace_event_info1 != LX_STATS_SECTOR_WRITE) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_id != LX_TRACE_API_EXIT) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_info1 != LX_STATS_SECTOR_RELEASE) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_info2 != LX_SUCCESS) ||
+        (nand_trace_events[LX_TRACE_API_ENTRY] != 1001) || (nand_trace_events[LX_TRACE_API_EXIT] != 1001) ||
+        (nand_trace_events[LX_TRACE_RELOCATE] == 0) || (nand_trace_events[LX_TRACE_BLOCK_ERASE] == 0) ||
+        (nand_trace_events[LX_TRACE_METADATA_WRITE] == 0) || (nand_trace_events[LX_TRACE_METADATA_ALLOCATE] == 0))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* Nothing is recorded once the trace is disabled.  */
+    sector =  trace_header -> lx_trace_header_total;
+    status =  lx_nand_flash_trace_enable(&nand_sim_flash, LX_NULL, 0);
+    status += lx_nand_flash_sector_read(&nand_sim_flash, 0, readbuffer);
+
+    if ((status != LX_SUCCESS) || (trace_header -> lx_trace_header_total != sector))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    printf("SUCCESS!\n");
+#endif
+
+    printf("Test 8: Simulator timing........................");
+
+    /* Reinitialize and count only the programmed pages. Once the first write has allocated the block
+       of the sectors, a sector write programs its page and a few metadata pages.  */
+    status =  lx_nand_flash_close(&nand_sim_flash);
+    _lx_nand_flash_simulator_erase_all();
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    for (i = 0; i < 128; i++)
+        buffer[i] =  0x88880000 + i;
+    status += lx_nand_flash_sector_write(&nand_sim_flash, 7, buffer);
+    status += _lx_nand_flash_simulator_timing_set(0, 1, 0, 0, 0);
+    status += _lx_nand_flash_simulator_time_reset();
+    status += lx_nand_flash_sector_write(&nand_sim_flash, 8, buffer);
+    status += _lx_nand_flash_simulator_time_get(&nand_sim_time);
+
+    if ((status != LX_SUCCESS) || (nand_sim_time == 0) || (nand_sim_time > 8))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* Count only the read pages.  */
+    status =  _lx_nand_flash_simulator_timing_set(1, 0, 0, 0, 0);
+    status += _lx_nand_flash_simulator_time_reset();
+    status += lx_nand_flash_sector_read(&nand_sim_flash, 8, readbuffer);
+    status += _lx_nand_flash_simulator_time_get(&nand_sim_time);
+
+    if ((status != LX_SUCCESS) || (nand_sim_time != 1) || (readbuffer[0] != 0x88880000) || (readbuffer[127] != (0x88880000 + 127)))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* Count only the bus transfers, the programmed page moves its data and its spare bytes.  */
+    status =  _lx_nand_flash_simulator_timing_set(0, 0, 0, 0, 1);
+    status += _lx_nand_flash_simulator_time_reset();
+    status += lx_nand_flash_sector_write(&nand_sim_flash, 9, buffer);
+    status += _lx_nand_flash_simulator_time_get(&nand_sim_time);
+
+    sector =  nand_sim_flash.lx_nand_flash_bytes_per_page + nand_sim_flash.lx_nand_flash_spare_total_length;
+    if ((status != LX_SUCCESS) || (nand_sim_time < sector))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* Count only the erases and then only the copied pages, rewriting the sectors with new data moves and erases blocks.  */
+    status =  _lx_nand_flash_simulator_timing_set(0, 0, 1000, 0, 0);
+    status += _lx_nand_flash_simulator_time_reset();
+    for (i = 0; i < 1000; i++)
+    {
+        buffer[0] =  i;
+        status += lx_nand_flash_sector_write(&nand_sim_flash, i % 8, buffer);
+    }
+    status += _lx_nand_flash_simulator_time_get(&nand_sim_time);
+
+    if ((status != LX_SUCCESS) || (nand_sim_time == 0) || ((nand_sim_time % 1000) != 0))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    status =  _lx_nand_flash_simulator_timing_set(0, 0, 0, 1, 0);
+    status += _lx_nand_flash_simulator_time_reset();
+    for (i = 0; i < 1000; i++)
+    {
+        buffer[0] =  i;
+        status += lx_nand_flash_sector_write(&nand_sim_flash, i % 8, buffer);
+    }
+    status += _lx_nand_flash_simulator_time_get(&nand_sim_time);
+
+    if ((status != LX_SUCCESS) || (nand_sim_time == 0))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    /* Without any time set, nothing is counted.  */
+    status =  _lx_nand_flash_simulator_timing_set(0, 0, 0, 0, 0);
+    status += _lx_nand_flash_simulator_time_reset();
+    status += lx_nand_flash_sector_write(&nand_sim_flash, 8, buffer);
+    status += lx_nand_flash_sector_read(&nand_sim_flash, 8, readbuffer);
+    status += _lx_nand_flash_simulator_time_get(&nand_sim_time);
+
+    if ((status != LX_SUCCESS) || (nand_sim_time != 0))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    printf("SUCCESS!\n");
+
+    printf("Test 9: Simulator geometry......................");
+
+    /* A geometry that doesn't fit in the memory is rejected.  */
+    status =  lx_nand_flash_close(&nand_sim_flash);
+    if ((_lx_nand_flash_simulator_geometry_set(128, 64, nand_geometry_memory, sizeof(nand_geometry_memory)) != LX_ERROR) ||
+        (_lx_nand_flash_simulator_geometry_set(64, 1, nand_geometry_memory, sizeof(nand_geometry_memory)) != LX_ERROR))
+        status =  LX_ERROR;
+
+    /* Format and open a flash of 64 blocks with 64 pages each.  */
+    status += _lx_nand_flash_simulator_geometry_set(64, 64, nand_geometry_memory, sizeof(nand_geometry_memory));
+    _lx_nand_flash_simulator_erase_all();
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    for (i = 0; i < 2000; i++)
+    {
+        buffer[0] =    i;
+        buffer[127] =  ~i;
+        status += lx_nand_flash_sector_write(&nand_sim_flash, i % 1000, buffer);
+    }
+    for (i = 1000; i < 2000; i++)
+    {
+        status += lx_nand_flash_sector_read(&nand_sim_flash, i % 1000, readbuffer);
+        if ((readbuffer[0] != i) || (readbuffer[127] != ~i))
+            status =  LX_ERROR;
+    }
+    status += lx_nand_flash_close(&nand_sim_flash);
+
+    if ((status != LX_SUCCESS) || (nand_sim_flash.lx_nand_flash_total_blocks != 64) ||
+        (nand_sim_flash.lx_nand_flash_pages_per_block != 64) || (nand_geometry_memory[0] == 0xFFFFFFFF))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+#ifdef LX_NAND_SIMULATOR_ENABLE_FILE
+
+    /* Write sectors to a new device image, they are still there when the image is opened again.  */
+    remove("nand_simulator_test.img");
+    status =  _lx_nand_flash_simulator_file_open("nand_simulator_test.img", 32, 64);
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    for (i = 0; i < 200; i++)
+    {
+        buffer[0] =    0x99990000 + i;
+        buffer[127] =  i;
+        status += lx_nand_flash_sector_write(&nand_sim_flash, i, buffer);
+    }
+    status += lx_nand_flash_close(&nand_sim_flash);
+    status += _lx_nand_flash_simulator_file_close();
+
+    /* Opening the image with another geometry fails.  */
+    if (_lx_nand_flash_simulator_file_open("nand_simulator_test.img", 64, 64) != LX_ERROR)
+        status =  LX_ERROR;
+
+    status += _lx_nand_flash_simulator_file_open("nand_simulator_test.img", 32, 64);
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    for (i = 0; i < 200; i++)
+    {
+        status += lx_nand_flash_sector_read(&nand_sim_flash, i, readbuffer);
+        if ((readbuffer[0] != (0x99990000 + i)) || (readbuffer[127] != i))
+            status =  LX_ERROR;
+    }
+    status += lx_nand_flash_close(&nand_sim_flash);
+    if ((status == LX_SUCCESS) && (nand_sim_flash.lx_nand_flash_total_blocks != 32))
+        status =  LX_ERROR;
+    status += _lx_nand_flash_simulator_file_close();
+    remove("nand_simulator_test.img");
+
+    if (status != LX_SUCCESS)
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+#endif
+
+    /* A null memory returns to the default geometry.  */
+    status =  _lx_nand_flash_simulator_geometry_set(1024, 256, LX_NULL, 0);
+    _lx_nand_flash_simulator_erase_all();
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+
+    if ((status != LX_SUCCESS) || (nand_sim_flash.lx_nand_flash_total_blocks != 1024) ||
+        (nand_sim_flash.lx_nand_flash_pages_per_block != 256))
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    printf("SUCCESS!\n");
+
+    printf("Test 10: Simulator fast forward.................");
+
+    /* In fast forward mode only the first word of each user data page is kept.  */
+    status =  lx_nand_flash_close(&nand_sim_flash);
+    status += _lx_nand_flash_simulator_geometry_set(64, 64, nand_geometry_memory, sizeof(nand_geometry_memory));
+    status += _lx_nand_flash_simulator_fast_forward_set(LX_TRUE);
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    for (i = 0; i < 3000; i++)
+    {
+        buffer[0] =  i;
+        status += lx_nand_flash_sector_write(&nand_sim_flash, i % 1000, buffer);
+    }
+    if ((status == LX_SUCCESS) && (nand_sim_flash.lx_nand_flash_diagnostic_block_erases == 0))
+        status =  LX_ERROR;
+    status += lx_nand_flash_close(&nand_sim_flash);
+
+    /* The metadata is complete, so the flash opens again with the latest tokens.  */
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    for (i = 2000; i < 3000; i++)
+    {
+        status += lx_nand_flash_sector_read(&nand_sim_flash, i % 1000, readbuffer);
+        if (readbuffer[0] != i)
+            status =  LX_ERROR;
+    }
+    status += lx_nand_flash_close(&nand_sim_flash);
+    status += _lx_nand_flash_simulator_fast_forward_set(LX_FALSE);
+
+    status += _lx_nand_flash_simulator_geometry_set(1024, 256, LX_NULL, 0);
+    _lx_nand_flash_simulator_erase_all();
+    status += lx_nand_flash_format(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+    status += lx_nand_flash_open(&nand_sim_flash, "sim nand flash", _lx_nand_flash_simulator_initialize, nand_memory_space, sizeof(nand_memory_space));
+
+    if (status != LX_SUCCESS)
+    {
+        printf("FAILED!\n");
+#ifdef BATCH_TEST
+        exit(1);
+#endif
+        while (1)
+        {
+        }
+    }
+
+    printf("SUCCESS!\n");
+
 #if 0
     /* Point at the simulated NOR flash memory.  */
     word_ptr =  nand_flash_memory;
@@ -17,12 +17,35 @@ UCHAR                   thread_0_stack[DEMO_STACK_SIZE];
 LX_NOR_FLASH    nor_sim_flash;
 ULONG           buffer[128];
 ULONG           readbuffer[128];
+ULONG           multi_buffer[16 * 128];
+ULONG           multi_readbuffer[16 * 128];
+ULONG           multi_stamp[100];
+
+/* Define the state of the power loss driver, which drops all the writes and erases after a number of writes.  */
+ULONG           nor_power_loss_writes;
+ULONG           nor_power_loss_limit;
+ULONG           nor_power_loss_buffer[8 * 128];
 
 
 /* Define LevelX NOR flash simulator prototoypes.  */
 
 UINT  _lx_nor_flash_simulator_erase_all(VOID);
 UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash);
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  _lx_nor_flash_simulator_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
+UINT  _lx_nor_flash_simulator_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+#else
+UINT  _lx_nor_flash_simulator_write(ULONG *flash_address, ULONG *source, ULONG words);
+UINT  _lx_nor_flash_simulator_block_erase(ULONG block, ULONG erase_count);
+#endif
+UINT  nor_power_loss_driver_initialize(LX_NOR_FLASH *nor_flash);
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  nor_power_loss_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
+UINT  nor_power_loss_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+#else
+UINT  nor_power_loss_driver_write(ULONG *flash_address, ULONG *source, ULONG words);
+UINT  nor_power_loss_driver_block_erase(ULONG block, ULONG erase_count);
+#endif
 
 
 
@@ -64,7 +87,7 @@ void    tx_application_define(void *first_unused_memory)
 void    thread_0_entry(ULONG thread_input)
 {
 
-ULONG   i, j, sector;
+ULONG   i, j, k, sector, count, reclaim_writes;
 UINT    status;
 
 ULONG   *word_ptr;
@@ -1419,6 +1442,292 @@ ULONG   *word_ptr;
           printf("FAILED!\n");
 #ifdef BATCH_TEST
     exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+
+    printf("Test 6: Multi-sector write/read/release.........");
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Open the flash.  */
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write 100 sectors with multi-sector writes of varying length.  */
+    sector =  0;
+    count =   1;
+    while (sector < 100)
+    {
+        if ((sector + count) > 100)
+            count =  100 - sector;
+
+        for (k = 0; k < count; k++)
+        {
+            multi_stamp[sector + k] =  0;
+            for (j = 0; j < 128; j++)
+                multi_buffer[(k * 128) + j] =  ((sector + k) << 8) | j;
+        }
+
+        status =  lx_nor_flash_sectors_write(&nor_sim_flash, sector, multi_buffer, count);
+
+        if (status != LX_SUCCESS)
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+
+        sector =  sector + count;
+        count =   (count % 16) + 1;
+    }
+
+    /* Now, perform 300 multi-sector writes to randomly selected ranges, checking
+       each range with a multi-sector read and single sector reads first.  */
+    for (i = 0; i < 300; i++)
+    {
+
+        /* Pickup random range.  */
+        sector =  (ULONG) (rand() % 100);
+        count =   (ULONG) (rand() % 16) + 1;
+        if ((sector + count) > 100)
+            count =  100 - sector;
+
+        status =  lx_nor_flash_sectors_read(&nor_sim_flash, sector, multi_readbuffer, count);
+
+        if (status != LX_SUCCESS)
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+
+        for (k = 0; k < count; k++)
+        {
+
+            status =  lx_nor_flash_sector_read(&nor_sim_flash, sector + k, readbuffer);
+
+            if (status != LX_SUCCESS)
+            {
+                  printf("FAILED!\n");
+#ifdef BATCH_TEST
+                  exit(1);
+#endif
+                  while(1)
+                  {
+                  }
+            }
+
+            for (j = 0; j < 128; j++)
+            {
+
+                if ((multi_readbuffer[(k * 128) + j] != ((multi_stamp[sector + k] << 16) | ((sector + k) << 8) | j)) ||
+                    (readbuffer[j] != multi_readbuffer[(k * 128) + j]))
+                {
+                      printf("FAILED!\n");
+#ifdef BATCH_TEST
+                      exit(1);
+#endif
+                      while(1)
+                      {
+                      }
+                }
+            }
+
+            /* Include the iteration in the buffer to generate a new write.  */
+            multi_stamp[sector + k] =  i + 1;
+            for (j = 0; j < 128; j++)
+                multi_buffer[(k * 128) + j] =  ((i + 1) << 16) | ((sector + k) << 8) | j;
+        }
+
+        status =  lx_nor_flash_sectors_write(&nor_sim_flash, sector, multi_buffer, count);
+
+        if (status != LX_SUCCESS)
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* Release sectors 40-49 and make sure they are no longer mapped.  */
+    status =  lx_nor_flash_sectors_release(&nor_sim_flash, 40, 10);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_sector_release(&nor_sim_flash, 45);
+
+    if (status != LX_SECTOR_NOT_FOUND)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Read across the released range and make sure the surrounding sectors are intact.  */
+    status =  lx_nor_flash_sectors_read(&nor_sim_flash, 34, multi_readbuffer, 16);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    for (k = 0; k < 16; k++)
+    {
+
+        if ((34 + k) >= 40)
+            break;
+
+        for (j = 0; j < 128; j++)
+        {
+
+            if (multi_readbuffer[(k * 128) + j] != ((multi_stamp[34 + k] << 16) | ((34 + k) << 8) | j))
+            {
+                  printf("FAILED!\n");
+#ifdef BATCH_TEST
+                  exit(1);
+#endif
+                  while(1)
+                  {
+                  }
+            }
+        }
+    }
+
+    status =  lx_nor_flash_sectors_read(&nor_sim_flash, 50, multi_readbuffer, 2);
+
+    if ((status != LX_SUCCESS) || (multi_readbuffer[0] != ((multi_stamp[50] << 16) | (50 << 8))) ||
+        (multi_readbuffer[128 + 5] != ((multi_stamp[51] << 16) | (51 << 8) | 5)))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+
+    printf("Test 7: Multi-sector write power loss...........");
+
+    /* Cut the power after each write of a multi-sector write that reclaims blocks, the flash must open
+       again with the old or the new data of each sector.  */
+    status =          LX_SUCCESS;
+    reclaim_writes =  0;
+    for (i = 1; (status == LX_SUCCESS) && (reclaim_writes == 0); i++)
+    {
+
+        /* Write sectors 0 through 29 twice, so there are obsolete sectors to reclaim.  */
+        _lx_nor_flash_simulator_erase_all();
+        status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+        for (j = 0; j < 60; j++)
+        {
+            buffer[0] =    j;
+            buffer[127] =  ~j;
+            status += lx_nor_flash_sector_write(&nor_sim_flash, j % 30, buffer);
+        }
+        status += lx_nor_flash_close(&nor_sim_flash);
+
+        /* Write sectors 26 through 33 with a single request and cut the power after write i.  */
+        nor_power_loss_limit =  0xFFFFFFFF;
+        status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_power_loss_driver_initialize);
+        nor_power_loss_writes =  0;
+        nor_power_loss_limit =   i;
+        for (j = 0; j < 8; j++)
+        {
+            nor_power_loss_buffer[j * 128] =          0x10000 + 26 + j;
+            nor_power_loss_buffer[(j * 128) + 127] =  ~(0x10000 + 26 + j);
+        }
+        lx_nor_flash_sectors_write(&nor_sim_flash, 26, nor_power_loss_buffer, 8);
+        lx_nor_flash_close(&nor_sim_flash);
+
+        /* Determine if the whole request was written before the power was cut.  */
+        if (nor_power_loss_writes < nor_power_loss_limit)
+            reclaim_writes =  nor_power_loss_writes;
+
+        /* The flash must open again, sectors 26 through 33 have either their old or their new data. Sectors
+           that were never written read as erased.  */
+        status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+        for (sector = 0; (status == LX_SUCCESS) && (sector < 34); sector++)
+        {
+            j =  lx_nor_flash_sector_read(&nor_sim_flash, sector, readbuffer);
+            if ((j == LX_SUCCESS) && (sector >= 26) && (readbuffer[0] == (0x10000 + sector)) && (readbuffer[127] == ~(0x10000 + sector)))
+                continue;
+            if ((j == LX_SUCCESS) && (sector < 30) && (readbuffer[0] == (sector + 30)) && (readbuffer[127] == ~(sector + 30)))
+                continue;
+            if ((j == LX_SUCCESS) && (sector >= 30) && (readbuffer[0] == LX_ALL_ONES) && (readbuffer[127] == LX_ALL_ONES))
+                continue;
+            status =  LX_ERROR;
+        }
+        if (status == LX_SUCCESS)
+            status =  lx_nor_flash_close(&nor_sim_flash);
+    }
+
+    /* The request must have taken enough writes to reclaim a block.  */
+    if ((status != LX_SUCCESS) || (reclaim_writes < 16))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
 #endif
           while(1)
           {
@@ -1436,3 +1745,57 @@ ULONG   *word_ptr;
 }
 
 
+/* Define the driver that cuts the power after nor_power_loss_limit writes. The writes and the erases after
+   that are dropped, as if the flash lost power.  */
+
+UINT  nor_power_loss_driver_initialize(LX_NOR_FLASH *nor_flash)
+{
+
+UINT    status;
+
+
+    status =  _lx_nor_flash_simulator_initialize(nor_flash);
+    nor_flash -> lx_nor_flash_driver_write =        nor_power_loss_driver_write;
+    nor_flash -> lx_nor_flash_driver_block_erase =  nor_power_loss_driver_block_erase;
+    return(status);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  nor_power_loss_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words)
+#else
+UINT  nor_power_loss_driver_write(ULONG *flash_address, ULONG *source, ULONG words)
+#endif
+{
+
+    /* Drop the write once the power is cut.  */
+    if (nor_power_loss_writes >= nor_power_loss_limit)
+        return(LX_SUCCESS);
+    nor_power_loss_writes++;
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return(_lx_nor_flash_simulator_write(nor_flash, flash_address, source, words));
+#else
+    return(_lx_nor_flash_simulator_write(flash_address, source, words));
+#endif
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  nor_power_loss_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count)
+#else
+UINT  nor_power_loss_driver_block_erase(ULONG block, ULONG erase_count)
+#endif
+{
+
+    /* Drop the erase once the power is cut.  */
+    if (nor_power_loss_writes >= nor_power_loss_limit)
+        return(LX_SUCCESS);
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    return(_lx_nor_flash_simulator_block_erase(nor_flash, block, erase_count));
+#else
+    return(_lx_nor_flash_simulator_block_erase(block, erase_count));
+#endif
+}
+
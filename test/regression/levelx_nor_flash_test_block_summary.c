@@ -0,0 +1,261 @@
+/* NOR flash block summary tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the test helpers.  */
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+UINT  nor_summary_driver_initialize(LX_NOR_FLASH *nor_flash);
+UINT  nor_allocate_check(LX_NOR_FLASH *nor_flash);
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+ULONG   i, j, sector;
+UINT    status;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+    printf("Test 1: Block summary...........................");
+
+    /* Open the flash with the block summary memory supplied by the driver initialization.  */
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_summary_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_block_summary_enabled != LX_TRUE) ||
+        (nor_summary_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write 100 sectors, then rewrite the first 50 several times to force block reclaims.  */
+    for (sector = 0; sector < 400; sector++)
+    {
+
+        i =  (sector < 100) ? sector : ((sector - 100) % 50);
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i + sector;
+
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+
+        if (status != LX_SUCCESS)
+        {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+        }
+
+        /* Check the summary periodically.  */
+        if (((sector % 25) == 0) && (nor_summary_check(&nor_sim_flash) != LX_SUCCESS))
+        {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+        }
+    }
+
+    /* Release the last 10 sectors.  */
+    for (i = 90; i < 100; i++)
+    {
+        status =  lx_nor_flash_sector_release(&nor_sim_flash, i);
+        if (status != LX_SUCCESS)
+        {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+        }
+    }
+
+    /* Read a sector that was never written, this maps a new sector.  */
+    status =  lx_nor_flash_sector_read(&nor_sim_flash, 100, readbuffer);
+
+    if ((status != LX_SUCCESS) || (nor_summary_check(&nor_sim_flash) != LX_SUCCESS) ||
+        (nor_sim_flash.lx_nor_flash_maximum_erase_count < 2))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Close and reopen, the summary is rebuilt while the flash is opened.  */
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_summary_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_summary_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Close and reopen without the summary, then enable the summary after the open.  */
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+
+    /* Memory too small for every block should be rejected.  */
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_block_summary_enabled != LX_FALSE) ||
+        (lx_nor_flash_block_summary_enable(&nor_sim_flash, nor_summary_memory, sizeof(nor_summary_memory) - 1) != LX_ERROR))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_block_summary_enable(&nor_sim_flash, nor_summary_memory, sizeof(nor_summary_memory));
+
+    if ((status != LX_SUCCESS) || (nor_summary_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Disable the summary.  */
+    status =  lx_nor_flash_block_summary_enable(&nor_sim_flash, LX_NULL, 0);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_block_summary_enabled != LX_FALSE))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    /* Every free sector of an erased flash must be allocated in order, with the next free sector kept in
+       the summary and with the free sector bit map scan.  */
+    _lx_nor_flash_simulator_erase_all();
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_summary_driver_initialize);
+    if ((status == LX_SUCCESS) && (nor_sim_flash.lx_nor_flash_block_summary_enabled == LX_TRUE))
+        status =  nor_allocate_check(&nor_sim_flash);
+    status += lx_nor_flash_close(&nor_sim_flash);
+    _lx_nor_flash_simulator_erase_all();
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    if ((status == LX_SUCCESS) && (nor_sim_flash.lx_nor_flash_block_summary_enabled == LX_FALSE))
+        status =  nor_allocate_check(&nor_sim_flash);
+    status += lx_nor_flash_close(&nor_sim_flash);
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+/* Define the driver initialization that supplies the block summary memory.  */
+
+UINT  nor_summary_driver_initialize(LX_NOR_FLASH *nor_flash)
+{
+
+UINT    status;
+
+
+    status =  _lx_nor_flash_simulator_initialize(nor_flash);
+    if (status == LX_SUCCESS)
+        status =  lx_nor_flash_block_summary_enable(nor_flash, nor_summary_memory, sizeof(nor_summary_memory));
+    return(status);
+}
+
+
+/* Allocate every free physical sector of an erased flash and check that the sectors are allocated in
+   order, starting with the first sector of the free block search.  */
+
+UINT  nor_allocate_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   block;
+ULONG   sector;
+ULONG   expected_sector;
+ULONG   logical_sector;
+ULONG   *map_entry;
+ULONG   *sector_address;
+
+
+    expected_sector =  nor_flash -> lx_nor_flash_free_block_search * nor_flash -> lx_nor_flash_physical_sectors_per_block;
+    for (logical_sector = 0; nor_flash -> lx_nor_flash_free_physical_sectors; logical_sector++)
+    {
+
+        if ((_lx_nor_flash_physical_sector_allocate(nor_flash, logical_sector, &map_entry, &sector_address) != LX_SUCCESS) ||
+            (map_entry == LX_NULL))
+            return(LX_ERROR);
+        nor_flash -> lx_nor_flash_free_physical_sectors--;
+
+        /* Convert the mapping entry to the physical sector number.  */
+        block =   (ULONG) (map_entry - nor_flash -> lx_nor_flash_base_address) / nor_flash -> lx_nor_flash_words_per_block;
+        sector =  (ULONG) (map_entry - nor_flash -> lx_nor_flash_base_address) - (block * nor_flash -> lx_nor_flash_words_per_block) -
+                                                                nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset;
+        if (((block * nor_flash -> lx_nor_flash_physical_sectors_per_block) + sector) != expected_sector)
+            return(LX_ERROR);
+        expected_sector =  (expected_sector + 1) % nor_flash -> lx_nor_flash_total_physical_sectors;
+    }
+
+    return(LX_SUCCESS);
+}
+#endif
@@ -1,68 +1,14 @@
 /* Basic NOR flash tests...  */
 
-#include <stdio.h>
-#include "lx_api.h"
+#include "levelx_nor_flash_test_common.h"
 
-#define     DEMO_STACK_SIZE         4096
-
-
-/* Define the ThreadX object control blocks...  */
-#ifndef LX_STANDALONE_ENABLE
-TX_THREAD               thread_0;
-#endif
-UCHAR                   thread_0_stack[DEMO_STACK_SIZE];
 
 /* Define LevelX structures.  */
 
-LX_NOR_FLASH    nor_sim_flash;
-ULONG           buffer[128];
-ULONG           readbuffer[128];
-
 UCHAR   nor_cache_memory[2048+16+8];
 UCHAR   nor_cache_memory2[8192];
 
 
-/* Define LevelX NOR flash simulator prototoypes.  */
-
-UINT  _lx_nor_flash_simulator_erase_all(VOID);
-UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash);
-
-
-
-/* Define thread prototypes.  */
-
-void    thread_0_entry(ULONG thread_input);
-
-
-
-/* Define main entry point.  */
-
-int main()
-{
-  
-    /* Enter the ThreadX kernel.  */
-#ifndef LX_STANDALONE_ENABLE
-    tx_kernel_enter();
-#else
-    thread_0_entry(0);
-#endif
-
-}
-
-
-/* Define what the initial system looks like.  */
-#ifndef LX_STANDALONE_ENABLE
-void    tx_application_define(void *first_unused_memory)
-{
-
-
-    /* Create the main thread.  */
-    tx_thread_create(&thread_0, "thread 0", thread_0_entry, 0,  
-            thread_0_stack, DEMO_STACK_SIZE, 
-            1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
-}
-#endif
-
 /* Define the test threads.  */
 
 void    thread_0_entry(ULONG thread_input)
@@ -1651,6 +1597,19 @@ status += lx_nor_flash_extended_cache_enable(&nor_sim_flash, nor_cache_memory2,
           }
         }
     }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
     
 #ifdef BATCH_TEST
     exit(0);
@@ -1660,5 +1619,3 @@ status += lx_nor_flash_extended_cache_enable(&nor_sim_flash, nor_cache_memory2,
      {
      }
 }
-
-
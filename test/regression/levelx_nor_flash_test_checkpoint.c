@@ -0,0 +1,294 @@
+/* NOR flash mount checkpoint tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+ULONG                               nor_checkpoint_counts[5];
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+LX_NOR_LOGICAL_SECTOR_INDEX_TYPE    nor_checkpoint_index[128];
+#endif
+#endif
+
+
+/* Define the test helpers.  */
+
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+UINT  nor_checkpoint_driver_initialize(LX_NOR_FLASH *nor_flash);
+UINT  nor_checkpoint_check(LX_NOR_FLASH *nor_flash);
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+ULONG   i, j, sector;
+UINT    status;
+
+ULONG   *word_ptr;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+    printf("Test 1: Mount checkpoint........................");
+
+    /* Erase the simulated NOR flash and open it with the last block reserved for the checkpoint. There is
+       no checkpoint yet, so the blocks are walked.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_checkpoint_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_checkpoint_restored != LX_FALSE))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write 60 sectors, then overwrite the first 30 to create obsolete sectors.  */
+    for (sector = 0; (status == LX_SUCCESS) && (sector < 90); sector++)
+    {
+
+        i =  (sector < 60) ? sector : (sector - 60);
+        for (j = 0; j < 128; j++)
+          buffer[j] =  (sector < 60) ? i : (i + 1000);
+
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    }
+
+    /* Remember the counts, then close the flash, which writes the checkpoint.  */
+    nor_checkpoint_counts[0] =  nor_sim_flash.lx_nor_flash_free_physical_sectors;
+    nor_checkpoint_counts[1] =  nor_sim_flash.lx_nor_flash_mapped_physical_sectors;
+    nor_checkpoint_counts[2] =  nor_sim_flash.lx_nor_flash_obsolete_physical_sectors;
+    nor_checkpoint_counts[3] =  nor_sim_flash.lx_nor_flash_minimum_erase_count;
+    nor_checkpoint_counts[4] =  nor_sim_flash.lx_nor_flash_maximum_erase_count;
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+    for (i = 0; i < 128; i++)
+        nor_checkpoint_index[i] =  nor_index_memory[i];
+#endif
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    /* Reopen the flash, the state must be restored from the checkpoint.  */
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_checkpoint_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_checkpoint_restored != LX_TRUE) ||
+        (nor_sim_flash.lx_nor_flash_checkpoint_valid != LX_TRUE) || (nor_checkpoint_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write another sector, which invalidates the checkpoint. Then simulate a power loss by closing the flash
+       without writing the checkpoint. The next open must walk the blocks.  */
+    for (j = 0; j < 128; j++)
+      buffer[j] =  60;
+    status =  lx_nor_flash_sector_write(&nor_sim_flash, 60, buffer);
+    word_ptr =  nor_sim_flash.lx_nor_flash_base_address + (nor_sim_flash.lx_nor_flash_total_blocks * nor_sim_flash.lx_nor_flash_words_per_block);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_checkpoint_valid != LX_FALSE) || (word_ptr[1] != 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    nor_sim_flash.lx_nor_flash_checkpoint_blocks =  0;
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    nor_checkpoint_counts[0] =  nor_sim_flash.lx_nor_flash_free_physical_sectors;
+    nor_checkpoint_counts[1] =  nor_sim_flash.lx_nor_flash_mapped_physical_sectors;
+    nor_checkpoint_counts[2] =  nor_sim_flash.lx_nor_flash_obsolete_physical_sectors;
+    nor_checkpoint_counts[3] =  nor_sim_flash.lx_nor_flash_minimum_erase_count;
+    nor_checkpoint_counts[4] =  nor_sim_flash.lx_nor_flash_maximum_erase_count;
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+    for (i = 0; i < 128; i++)
+        nor_checkpoint_index[i] =  nor_index_memory[i];
+#endif
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_checkpoint_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_checkpoint_restored != LX_FALSE) ||
+        (nor_checkpoint_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write the checkpoint on demand, then simulate a power loss. The checkpoint still matches the flash,
+       so it must be used.  */
+    status =  lx_nor_flash_checkpoint_write(&nor_sim_flash);
+    nor_sim_flash.lx_nor_flash_checkpoint_blocks =  0;
+    status += lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_checkpoint_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_checkpoint_restored != LX_TRUE) ||
+        (nor_checkpoint_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Close the flash without changes, then corrupt the last word of the checkpoint. The CRC no longer
+       matches, so the blocks must be walked and the checkpoint invalidated.  */
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    word_ptr =  nor_sim_flash.lx_nor_flash_base_address + (nor_sim_flash.lx_nor_flash_total_blocks * nor_sim_flash.lx_nor_flash_words_per_block);
+    word_ptr[word_ptr[3] - 2] =  word_ptr[word_ptr[3] - 2] ^ 1;
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_checkpoint_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_checkpoint_restored != LX_FALSE) || (word_ptr[1] != 0) ||
+        (nor_checkpoint_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Close the flash, which writes a new checkpoint with the next sequence number, and reopen it.  */
+    j =  word_ptr[2];
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_checkpoint_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_checkpoint_restored != LX_TRUE) || (word_ptr[2] != (j + 1)) ||
+        (nor_checkpoint_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+#ifdef LX_NOR_ENABLE_CHECKPOINT
+
+/* Define the driver initialization that reserves the last block of the simulated NOR flash for the
+   mount checkpoint.  */
+
+UINT  nor_checkpoint_driver_initialize(LX_NOR_FLASH *nor_flash)
+{
+
+UINT    status;
+
+
+    status =  _lx_nor_flash_simulator_initialize(nor_flash);
+    nor_flash -> lx_nor_flash_total_blocks =       nor_flash -> lx_nor_flash_total_blocks - 1;
+    nor_flash -> lx_nor_flash_checkpoint_blocks =  1;
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+    if (status == LX_SUCCESS)
+        status =  lx_nor_flash_logical_sector_index_enable(nor_flash, nor_index_memory, sizeof(nor_index_memory));
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+    if (status == LX_SUCCESS)
+        status =  lx_nor_flash_block_summary_enable(nor_flash, nor_summary_memory, sizeof(nor_summary_memory));
+#endif
+    return(status);
+}
+
+
+/* Compare the sector counts and the logical sector index with the ones before the flash was closed,
+   and read back the data written in Test 1.  */
+
+UINT  nor_checkpoint_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   i, j;
+
+
+    if ((nor_flash -> lx_nor_flash_free_physical_sectors != nor_checkpoint_counts[0]) ||
+        (nor_flash -> lx_nor_flash_mapped_physical_sectors != nor_checkpoint_counts[1]) ||
+        (nor_flash -> lx_nor_flash_obsolete_physical_sectors != nor_checkpoint_counts[2]) ||
+        (nor_flash -> lx_nor_flash_minimum_erase_count != nor_checkpoint_counts[3]) ||
+        (nor_flash -> lx_nor_flash_maximum_erase_count != nor_checkpoint_counts[4]))
+        return(LX_ERROR);
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+    for (i = 0; i < 128; i++)
+    {
+        if (nor_index_memory[i] != nor_checkpoint_index[i])
+            return(LX_ERROR);
+    }
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+    if (nor_summary_check(nor_flash) != LX_SUCCESS)
+        return(LX_ERROR);
+#endif
+
+    for (i = 0; i < 60; i++)
+    {
+
+        if (lx_nor_flash_sector_read(nor_flash, i, readbuffer) != LX_SUCCESS)
+            return(LX_ERROR);
+
+        for (j = 0; j < 128; j++)
+        {
+
+            /* The first 30 sectors were overwritten.  */
+            if (readbuffer[j] != ((i < 30) ? (i + 1000) : i))
+                return(LX_ERROR);
+        }
+    }
+
+    return(LX_SUCCESS);
+}
+#endif
@@ -0,0 +1,182 @@
+/* Common data, entry point and test helpers of the NOR flash cache and feature tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the ThreadX object control blocks...  */
+#ifndef LX_STANDALONE_ENABLE
+TX_THREAD               thread_0;
+#endif
+UCHAR                   thread_0_stack[DEMO_STACK_SIZE];
+
+/* Define LevelX structures.  */
+
+LX_NOR_FLASH    nor_sim_flash;
+ULONG           buffer[128];
+ULONG           readbuffer[128];
+ULONG           nor_geometry_memory[16 * 32 * 128];
+ULONG           nor_cache_stamp[NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS];
+ULONG           nor_multiple_buffer[4 * 128];
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+LX_NOR_LOGICAL_SECTOR_INDEX_TYPE    nor_index_memory[128];
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+ULONG                               nor_summary_memory[LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(8) / sizeof(ULONG)];
+#endif
+
+
+/* Define main entry point.  */
+
+int main()
+{
+
+    /* Enter the ThreadX kernel.  */
+#ifndef LX_STANDALONE_ENABLE
+    tx_kernel_enter();
+#else
+    thread_0_entry(0);
+#endif
+
+}
+
+
+/* Define what the initial system looks like.  */
+#ifndef LX_STANDALONE_ENABLE
+void    tx_application_define(void *first_unused_memory)
+{
+
+
+    /* Create the main thread.  */
+    tx_thread_create(&thread_0, "thread 0", thread_0_entry, 0,
+            thread_0_stack, DEMO_STACK_SIZE,
+            1, 1, TX_NO_TIME_SLICE, TX_AUTO_START);
+}
+#endif
+
+
+/* Define the check of the garbage collection tests, every sector must read back its last data.  */
+
+UINT  nor_gc_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   i;
+UINT    status;
+
+
+    for (i = 0; i < (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS); i++)
+    {
+
+        status =  lx_nor_flash_sector_read(nor_flash, i, readbuffer);
+
+        /* Determine if the sector was released.  */
+        if (nor_cache_stamp[i] == LX_ALL_ONES)
+        {
+            if ((status == LX_SUCCESS) && (readbuffer[0] != LX_ALL_ONES))
+                return(LX_ERROR);
+        }
+        else if ((status != LX_SUCCESS) || (readbuffer[0] != nor_cache_stamp[i]) || (readbuffer[127] != nor_cache_stamp[i]))
+            return(LX_ERROR);
+    }
+
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+
+/* Compare each block summary entry with the counts found in the flash, and check that the
+   next block to erase is the same with and without the summary.  */
+
+UINT  nor_summary_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   i, j;
+ULONG   *block_word_ptr;
+ULONG   block_word;
+ULONG   free_sectors;
+ULONG   next_free_sector;
+ULONG   mapped_sectors;
+ULONG   obsolete_sectors;
+ULONG   total_free_sectors;
+ULONG   total_mapped_sectors;
+ULONG   total_obsolete_sectors;
+ULONG   summary_block, summary_erase_count, summary_mapped_sectors, summary_obsolete_sectors;
+ULONG   block, block_erase_count, block_mapped_sectors, block_obsolete_sectors;
+LX_NOR_FLASH_BLOCK_SUMMARY  *block_summary;
+
+
+    total_free_sectors =      0;
+    total_mapped_sectors =    0;
+    total_obsolete_sectors =  0;
+    for (i = 0; i < nor_flash -> lx_nor_flash_total_blocks; i++)
+    {
+
+        block_word_ptr =  nor_flash -> lx_nor_flash_base_address + (i * nor_flash -> lx_nor_flash_words_per_block);
+
+        /* Count the free sectors in the free sector bit map and find the first free sector.  */
+        free_sectors =  0;
+        next_free_sector =  nor_flash -> lx_nor_flash_physical_sectors_per_block;
+        for (j = 0; j < nor_flash -> lx_nor_flash_physical_sectors_per_block; j++)
+        {
+            if (block_word_ptr[nor_flash -> lx_nor_flash_block_free_bit_map_offset + (j / 32)] & (((ULONG) 1) << (j % 32)))
+            {
+                if (free_sectors == 0)
+                    next_free_sector =  j;
+                free_sectors++;
+            }
+        }
+
+        /* Free sectors are allocated in order, so all the sectors after the first free sector must be free.  */
+        if (next_free_sector != (nor_flash -> lx_nor_flash_physical_sectors_per_block - free_sectors))
+            return(LX_ERROR);
+
+        /* Count the mapped and obsolete sectors in the mapping list.  */
+        mapped_sectors =    0;
+        obsolete_sectors =  0;
+        for (j = 0; j < nor_flash -> lx_nor_flash_physical_sectors_per_block; j++)
+        {
+            block_word =  block_word_ptr[nor_flash -> lx_nor_flash_block_physical_sector_mapping_offset + j];
+            if (block_word == LX_NOR_PHYSICAL_SECTOR_FREE)
+                break;
+            if (block_word & LX_NOR_PHYSICAL_SECTOR_VALID)
+                mapped_sectors++;
+            else
+                obsolete_sectors++;
+        }
+
+        block_summary =  &nor_flash -> lx_nor_flash_block_summary[i];
+        if ((block_summary -> lx_nor_flash_block_summary_erase_count != block_word_ptr[0]) ||
+            (block_summary -> lx_nor_flash_block_summary_free_sectors != free_sectors) ||
+            (block_summary -> lx_nor_flash_block_summary_mapped_sectors != mapped_sectors) ||
+            (block_summary -> lx_nor_flash_block_summary_obsolete_sectors != obsolete_sectors) ||
+            (block_summary -> lx_nor_flash_block_summary_next_free_sector != next_free_sector))
+            return(LX_ERROR);
+
+        total_free_sectors +=      free_sectors;
+        total_mapped_sectors +=    mapped_sectors;
+        total_obsolete_sectors +=  obsolete_sectors;
+    }
+
+    /* The summary must agree with the totals kept by the NOR flash instance.  */
+    if ((total_free_sectors != nor_flash -> lx_nor_flash_free_physical_sectors) ||
+        (total_mapped_sectors != nor_flash -> lx_nor_flash_mapped_physical_sectors) ||
+        (total_obsolete_sectors != nor_flash -> lx_nor_flash_obsolete_physical_sectors))
+        return(LX_ERROR);
+
+    /* Select the next block to erase with the summary.  */
+    if (_lx_nor_flash_next_block_to_erase_find(nor_flash, &summary_block, &summary_erase_count, &summary_mapped_sectors, &summary_obsolete_sectors) != LX_SUCCESS)
+        return(LX_ERROR);
+
+    /* Select the next block to erase by reading the flash.  */
+    nor_flash -> lx_nor_flash_block_summary_enabled =  LX_FALSE;
+    if (_lx_nor_flash_next_block_to_erase_find(nor_flash, &block, &block_erase_count, &block_mapped_sectors, &block_obsolete_sectors) != LX_SUCCESS)
+        return(LX_ERROR);
+    nor_flash -> lx_nor_flash_block_summary_enabled =  LX_TRUE;
+
+    if ((summary_block != block) || (summary_erase_count != block_erase_count) ||
+        (summary_mapped_sectors != block_mapped_sectors) || (summary_obsolete_sectors != block_obsolete_sectors))
+        return(LX_ERROR);
+
+    return(LX_SUCCESS);
+}
+#endif
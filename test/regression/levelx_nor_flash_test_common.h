@@ -0,0 +1,62 @@
+/* Common definitions of the NOR flash cache and feature tests...  */
+
+#ifndef LEVELX_NOR_FLASH_TEST_COMMON_H
+#define LEVELX_NOR_FLASH_TEST_COMMON_H
+
+#include <stdio.h>
+#include "lx_api.h"
+
+#define     DEMO_STACK_SIZE         4096
+
+
+/* Define the FAT-like workload of the sector mapping cache tests: a few FAT sectors that are used 
+   between the reads of the data sectors.  */
+
+#define NOR_CACHE_FAT_SECTORS               8
+#define NOR_CACHE_DATA_SECTORS              60
+
+
+/* Define the LevelX structures shared by the tests.  */
+
+extern LX_NOR_FLASH    nor_sim_flash;
+extern ULONG           buffer[128];
+extern ULONG           readbuffer[128];
+extern ULONG           nor_geometry_memory[16 * 32 * 128];
+extern ULONG           nor_cache_stamp[NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS];
+extern ULONG           nor_multiple_buffer[4 * 128];
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+extern LX_NOR_LOGICAL_SECTOR_INDEX_TYPE    nor_index_memory[128];
+#endif
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+extern ULONG                               nor_summary_memory[LX_NOR_BLOCK_SUMMARY_MEMORY_SIZE(8) / sizeof(ULONG)];
+#endif
+
+
+/* Define LevelX NOR flash simulator prototypes.  */
+
+UINT  _lx_nor_flash_simulator_erase_all(VOID);
+UINT  _lx_nor_flash_simulator_initialize(LX_NOR_FLASH *nor_flash);
+UINT  _lx_nor_flash_simulator_timing_set(ULONG word_read_time, ULONG word_program_time, ULONG block_erase_time, ULONG bus_byte_time);
+UINT  _lx_nor_flash_simulator_time_get(ULONG64 *time);
+UINT  _lx_nor_flash_simulator_time_reset(VOID);
+UINT  _lx_nor_flash_simulator_geometry_set(ULONG total_blocks, ULONG physical_sectors_per_block, ULONG *memory, ULONG64 memory_size);
+UINT  _lx_nor_flash_simulator_fast_forward_set(UINT enable);
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+UINT  _lx_nor_flash_simulator_file_open(CHAR *file_name, ULONG total_blocks, ULONG physical_sectors_per_block);
+UINT  _lx_nor_flash_simulator_file_close(VOID);
+#endif
+
+
+/* Define the test helpers shared by the tests.  */
+
+UINT  nor_gc_check(LX_NOR_FLASH *nor_flash);
+#ifdef LX_NOR_ENABLE_BLOCK_SUMMARY
+UINT  nor_summary_check(LX_NOR_FLASH *nor_flash);
+#endif
+
+
+/* Define the test thread, each test defines its own.  */
+
+void    thread_0_entry(ULONG thread_input);
+
+#endif
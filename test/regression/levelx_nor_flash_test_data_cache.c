@@ -0,0 +1,253 @@
+/* NOR flash data cache tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+ULONG           nor_data_cache_memory[LX_NOR_DATA_CACHE_MEMORY_SIZE(16, LX_NOR_SECTOR_SIZE) / sizeof(ULONG)];
+#endif
+
+
+/* Define the test helpers.  */
+
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+UINT  nor_data_cache_check(LX_NOR_FLASH *nor_flash);
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+ULONG   i, j, sector;
+UINT    status;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+    printf("Test 1: Data cache..............................");
+
+    /* Erase the simulated NOR flash and open it.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+
+    /* Memory for fewer sectors than one set must be rejected.  */
+    if ((status != LX_SUCCESS) ||
+        (lx_nor_flash_data_cache_enable(&nor_sim_flash, nor_data_cache_memory, LX_NOR_DATA_CACHE_MEMORY_SIZE(LX_NOR_DATA_CACHE_WAYS, LX_NOR_SECTOR_SIZE) - 1) != LX_ERROR))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Enable the data cache and write the FAT sectors and the data sectors.  */
+    status =  lx_nor_flash_data_cache_enable(&nor_sim_flash, nor_data_cache_memory, sizeof(nor_data_cache_memory));
+    for (i = 0; (status == LX_SUCCESS) && (i < (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS)); i++)
+    {
+
+        nor_cache_stamp[i] =  i;
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i;
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    }
+
+    if ((status != LX_SUCCESS) || (nor_data_cache_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Read a FAT sector before every four data sectors and update a FAT sector every eighth time.  */
+    nor_sim_flash.lx_nor_flash_data_cache_hits =    0;
+    nor_sim_flash.lx_nor_flash_data_cache_misses =  0;
+    for (sector = 0; sector < 400; sector++)
+    {
+
+        /* Read the FAT sector and then the data sectors.  */
+        for (j = 0; j < 5; j++)
+        {
+
+            i =  (j == 0) ? (sector % NOR_CACHE_FAT_SECTORS) : (NOR_CACHE_FAT_SECTORS + (((sector * 4) + j) % NOR_CACHE_DATA_SECTORS));
+            status =  lx_nor_flash_sector_read(&nor_sim_flash, i, readbuffer);
+            if ((status != LX_SUCCESS) || (readbuffer[0] != nor_cache_stamp[i]) || (readbuffer[127] != nor_cache_stamp[i]))
+            {
+                  printf("FAILED!\n");
+#ifdef BATCH_TEST
+                  exit(1);
+#endif
+                  while(1)
+                  {
+                  }
+            }
+        }
+
+        /* Update a FAT sector.  */
+        if ((sector % 8) == 7)
+        {
+
+            i =  (sector / 8) % NOR_CACHE_FAT_SECTORS;
+            nor_cache_stamp[i] =  nor_cache_stamp[i] + 1000;
+            for (j = 0; j < 128; j++)
+              buffer[j] =  nor_cache_stamp[i];
+            status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+        }
+
+        /* Check the data cache periodically.  */
+        if ((status != LX_SUCCESS) || (((sector % 50) == 0) && (nor_data_cache_check(&nor_sim_flash) != LX_SUCCESS)))
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* The FAT sectors must have been read from the data cache, the data sectors that are read once must
+       not have pushed them out of their sets.  */
+    if ((nor_sim_flash.lx_nor_flash_data_cache_hits == 0) ||
+        ((LX_NOR_DATA_CACHE_WAYS >= 4) && (nor_sim_flash.lx_nor_flash_data_cache_hits < (400 / 2))))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Overwrite cached FAT sectors with a multiple sector write, the new data must be read back.  */
+    for (i = 0; i < 4; i++)
+    {
+        nor_cache_stamp[i] =  nor_cache_stamp[i] + 5000;
+        for (j = 0; j < 128; j++)
+          nor_multiple_buffer[(i * 128) + j] =  nor_cache_stamp[i];
+    }
+    status =  lx_nor_flash_sectors_write(&nor_sim_flash, 0, nor_multiple_buffer, 4);
+    for (i = 0; (status == LX_SUCCESS) && (i < 4); i++)
+    {
+        status =  lx_nor_flash_sector_read(&nor_sim_flash, i, readbuffer);
+        if ((status == LX_SUCCESS) && ((readbuffer[0] != nor_cache_stamp[i]) || (readbuffer[127] != nor_cache_stamp[i])))
+            status =  LX_ERROR;
+    }
+
+    /* Release a cached sector, it must read back erased.  */
+    if (status == LX_SUCCESS)
+        status =  lx_nor_flash_sector_release(&nor_sim_flash, 1);
+    if (status == LX_SUCCESS)
+        status =  lx_nor_flash_sector_read(&nor_sim_flash, 1, readbuffer);
+
+    if ((status != LX_SUCCESS) || (readbuffer[0] != LX_ALL_ONES) || (nor_data_cache_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Disable the data cache, reads must still return the sector data.  */
+    status =  lx_nor_flash_data_cache_enable(&nor_sim_flash, LX_NULL, 0);
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 2, readbuffer);
+    if ((status != LX_SUCCESS) || (readbuffer[0] != nor_cache_stamp[2]) || (nor_sim_flash.lx_nor_flash_data_cache != LX_NULL))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+#ifdef LX_NOR_ENABLE_DATA_CACHE
+
+/* Check that every sector in the data cache matches the sector in flash.  */
+
+UINT  nor_data_cache_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG                           i, j;
+ULONG                           logical_sector;
+LX_NOR_FLASH_DATA_CACHE_ENTRY   *data_cache;
+UINT                            status;
+
+
+    data_cache =  nor_flash -> lx_nor_flash_data_cache;
+    for (i = 0; i < ((nor_flash -> lx_nor_flash_data_cache_set_mask + 1) * LX_NOR_DATA_CACHE_WAYS); i++)
+    {
+
+        if (data_cache[i].lx_nor_flash_data_cache_entry_logical_sector == 0)
+            continue;
+
+        /* The sector must be in its own set.  */
+        logical_sector =  data_cache[i].lx_nor_flash_data_cache_entry_logical_sector & ~((ULONG) LX_NOR_DATA_CACHE_ENTRY_VALID);
+        if (((logical_sector & nor_flash -> lx_nor_flash_data_cache_set_mask) * LX_NOR_DATA_CACHE_WAYS) != (i - (i % LX_NOR_DATA_CACHE_WAYS)))
+            return(LX_ERROR);
+
+        /* Read the sector from flash with the data cache disabled.  */
+        nor_flash -> lx_nor_flash_data_cache =  LX_NULL;
+        status =  lx_nor_flash_sector_read(nor_flash, logical_sector, readbuffer);
+        nor_flash -> lx_nor_flash_data_cache =  data_cache;
+        if (status != LX_SUCCESS)
+            return(LX_ERROR);
+
+        for (j = 0; j < nor_flash -> lx_nor_flash_words_per_sector; j++)
+        {
+            if (data_cache[i].lx_nor_flash_data_cache_entry_sector_memory[j] != readbuffer[j])
+                return(LX_ERROR);
+        }
+    }
+
+    return(LX_SUCCESS);
+}
+#endif
@@ -0,0 +1,203 @@
+/* NOR flash hashed extended cache tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+ULONG           nor_extended_cache_memory[8192];
+#endif
+
+
+/* Define the test helpers.  */
+
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+UINT  nor_extended_cache_check(LX_NOR_FLASH *nor_flash);
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+ULONG   i, j, sector;
+UINT    status;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+    printf("Test 1: Hashed extended cache...................");
+
+    /* Erase the simulated NOR flash, open it and give the extended cache more memory than the previous 8 sector limit.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += lx_nor_flash_extended_cache_enable(&nor_sim_flash, nor_extended_cache_memory, sizeof(nor_extended_cache_memory));
+
+    if ((status != LX_SUCCESS) ||
+#ifndef LX_NOR_EXTENDED_CACHE_SIZE
+        (nor_sim_flash.lx_nor_flash_extended_cache_entries <= 8) ||
+#endif
+        (nor_extended_cache_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write and read back sectors in a pattern that forces blocks to be reclaimed and erased.  */
+    for (i = 0; i < (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS); i++)
+        nor_cache_stamp[i] =  LX_ALL_ONES;
+    for (sector = 0; sector < 2000; sector++)
+    {
+
+        i =  (sector * 7) % (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS);
+        nor_cache_stamp[i] =  sector;
+        for (j = 0; j < 128; j++)
+          buffer[j] =  sector;
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+
+        i =  (sector * 3) % (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS);
+        status += lx_nor_flash_sector_read(&nor_sim_flash, i, readbuffer);
+        if ((status != LX_SUCCESS) || (readbuffer[0] != nor_cache_stamp[i]) || (readbuffer[127] != nor_cache_stamp[i]) ||
+            (((sector % 100) == 0) && (nor_extended_cache_check(&nor_sim_flash) != LX_SUCCESS)))
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* All the metadata sectors fit in the cache, so most reads must be hits. Direct reads bypass the cache.  */
+    if (
+#ifndef LX_DIRECT_READ
+        (nor_sim_flash.lx_nor_flash_extended_cache_hits <= nor_sim_flash.lx_nor_flash_extended_cache_misses) ||
+#endif
+        (nor_extended_cache_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Shrink the cache to a single sector, every metadata read now replaces the entry.  */
+    status =  lx_nor_flash_extended_cache_enable(&nor_sim_flash, nor_extended_cache_memory, (128 * sizeof(ULONG)) + 64);
+    for (i = 0; (status == LX_SUCCESS) && (i < (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS)); i++)
+    {
+
+        status =  lx_nor_flash_sector_read(&nor_sim_flash, i, readbuffer);
+        if ((status == LX_SUCCESS) && ((readbuffer[0] != nor_cache_stamp[i]) || (nor_extended_cache_check(&nor_sim_flash) != LX_SUCCESS)))
+            status =  LX_ERROR;
+    }
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_extended_cache_entries != 1))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+
+/* Check that every cached sector is in its hash chain and matches the flash.  */
+
+UINT  nor_extended_cache_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   i, j;
+ULONG   cached_sectors;
+ULONG   chained_sectors;
+LX_NOR_FLASH_EXTENDED_CACHE_ENTRY   *cache_entry;
+
+
+    cached_sectors =  0;
+    for (i = 0; i < nor_flash -> lx_nor_flash_extended_cache_entries; i++)
+    {
+
+        cache_entry =  &nor_flash -> lx_nor_flash_extended_cache[i];
+        if (cache_entry -> lx_nor_flash_extended_cache_entry_sector_address == LX_NULL)
+            continue;
+        cached_sectors++;
+
+        /* Any address in the sector must find this entry.  */
+        if (_lx_nor_flash_extended_cache_entry_find(nor_flash, cache_entry -> lx_nor_flash_extended_cache_entry_sector_address + nor_flash -> lx_nor_flash_words_per_sector - 1) != cache_entry)
+            return(LX_ERROR);
+
+        /* The simulated flash is in RAM, so the cached copy can be compared directly.  */
+        for (j = 0; j < nor_flash -> lx_nor_flash_words_per_sector; j++)
+        {
+            if (cache_entry -> lx_nor_flash_extended_cache_entry_sector_memory[j] != cache_entry -> lx_nor_flash_extended_cache_entry_sector_address[j])
+                return(LX_ERROR);
+        }
+    }
+
+    /* The hash chains must hold exactly the cached sectors.  */
+    chained_sectors =  0;
+    for (i = 0; (nor_flash -> lx_nor_flash_extended_cache_entries) && (i <= nor_flash -> lx_nor_flash_extended_cache_hash_mask); i++)
+    {
+
+        cache_entry =  nor_flash -> lx_nor_flash_extended_cache_hash_table[i];
+        while (cache_entry)
+        {
+            if ((cache_entry -> lx_nor_flash_extended_cache_entry_sector_address == LX_NULL) || (chained_sectors >= cached_sectors))
+                return(LX_ERROR);
+            chained_sectors++;
+            cache_entry =  cache_entry -> lx_nor_flash_extended_cache_entry_next;
+        }
+    }
+
+    if (chained_sectors != cached_sectors)
+        return(LX_ERROR);
+
+    return(LX_SUCCESS);
+}
+#endif
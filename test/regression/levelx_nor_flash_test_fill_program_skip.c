@@ -0,0 +1,217 @@
+/* NOR flash fill program skip tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+ULONG                               nor_fill_buffer[4 * 128];
+ULONG                               nor_fill_readbuffer[4 * 128];
+#endif
+
+
+/* Define the test helpers.  */
+
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+UINT  nor_fill_check(LX_NOR_FLASH *nor_flash);
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+ULONG   j;
+UINT    status;
+
+ULONG   *word_ptr;
+ULONG   *map_entry;
+ULONG   *sector_address;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+    printf("Test 1: Fill sectors............................");
+
+    /* Erase the simulated NOR flash and write a zeroed and an erased sector.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (j = 0; j < 128; j++)
+      buffer[j] =  0;
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 1, buffer);
+    for (j = 0; j < 128; j++)
+      buffer[j] =  0xFFFFFFFF;
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 2, buffer);
+
+    /* Write two fill sectors and two data sectors with one multiple sector write.  */
+    for (j = 0; j < (4 * 128); j++)
+      nor_fill_buffer[j] =  ((j / 128) & 1) ? j : (0x12345678 + (j / 128));
+    status += lx_nor_flash_sectors_write(&nor_sim_flash, 10, nor_fill_buffer, 4);
+    status += nor_fill_check(&nor_sim_flash);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_fill_sector_writes != 4))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write a fill sector, and then data that only clears bits of it. With in-place overwrite, the data
+       after the fill word is programmed and the sector becomes a regular sector.  */
+    for (j = 0; j < 128; j++)
+      buffer[j] =  0x5A5A5A5A;
+    status =  lx_nor_flash_sector_write(&nor_sim_flash, 3, buffer);
+    for (j = 0; j < 128; j++)
+      buffer[j] =  0x5A5A5A5A & j;
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 3, buffer);
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 3, readbuffer);
+    for (j = 0; j < 128; j++)
+    {
+      if (readbuffer[j] != (0x5A5A5A5A & j))
+          status =  LX_ERROR;
+    }
+    _lx_nor_flash_logical_sector_find(&nor_sim_flash, 3, LX_FALSE, &map_entry, &sector_address);
+    if ((map_entry == LX_NULL) || (*map_entry & LX_NOR_PHYSICAL_SECTOR_FILL))
+        status =  LX_ERROR;
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_fill_sector_writes != 5))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Change sectors 11 and 13, which leaves obsolete sectors next to the fill sectors, and defragment
+       the NOR flash so the fill sectors are relocated.  */
+    _lx_nor_flash_logical_sector_find(&nor_sim_flash, 2, LX_FALSE, &word_ptr, &sector_address);
+    for (j = 128; j < 256; j++)
+      nor_fill_buffer[j]++;
+    for (j = 384; j < 512; j++)
+      nor_fill_buffer[j]++;
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 11, &nor_fill_buffer[128]);
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 13, &nor_fill_buffer[384]);
+    status += lx_nor_flash_defragment(&nor_sim_flash);
+    _lx_nor_flash_logical_sector_find(&nor_sim_flash, 2, LX_FALSE, &map_entry, &sector_address);
+    status += nor_fill_check(&nor_sim_flash);
+
+    if ((status != LX_SUCCESS) || (map_entry == word_ptr) || (nor_sim_flash.lx_nor_flash_obsolete_physical_sectors != 0) ||
+        (nor_sim_flash.lx_nor_flash_fill_sector_writes != 5))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* The fill sectors must be intact after the NOR flash is opened again.  */
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += nor_fill_check(&nor_sim_flash);
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+#ifdef LX_NOR_ENABLE_FILL_PROGRAM_SKIP
+
+/* Read back the fill sectors 1 and 2 and the sectors 10 through 13 written in Test 1, and check
+   that only the sectors with uniform data are mapped as fill sectors.  */
+
+UINT  nor_fill_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   i, j;
+ULONG   expected;
+ULONG   *map_entry;
+ULONG   *sector_address;
+
+
+    for (i = 1; i < 14; i++)
+    {
+
+        /* Skip the sectors not written by the test.  */
+        if ((i > 2) && (i < 10))
+            continue;
+
+        _lx_nor_flash_logical_sector_find(nor_flash, i, LX_FALSE, &map_entry, &sector_address);
+        if (map_entry == LX_NULL)
+            return(LX_ERROR);
+
+        /* Only sectors 11 and 13 hold data, the data of the others beyond the fill word is left erased.  */
+        if (((i == 11) || (i == 13)) == ((*map_entry & LX_NOR_PHYSICAL_SECTOR_FILL) != 0))
+            return(LX_ERROR);
+        if ((*map_entry & LX_NOR_PHYSICAL_SECTOR_FILL) && (sector_address[1] != LX_ALL_ONES))
+            return(LX_ERROR);
+
+        if (lx_nor_flash_sector_read(nor_flash, i, readbuffer) != LX_SUCCESS)
+            return(LX_ERROR);
+
+        for (j = 0; j < 128; j++)
+        {
+
+            if (i == 1)
+                expected =  0;
+            else if (i == 2)
+                expected =  LX_ALL_ONES;
+            else
+                expected =  nor_fill_buffer[((i - 10) * 128) + j];
+
+            if (readbuffer[j] != expected)
+                return(LX_ERROR);
+        }
+    }
+
+    /* Read sectors 10 through 13 with a multiple sector read as well.  */
+    if (lx_nor_flash_sectors_read(nor_flash, 10, nor_fill_readbuffer, 4) != LX_SUCCESS)
+        return(LX_ERROR);
+
+    for (j = 0; j < (4 * 128); j++)
+    {
+
+        if (nor_fill_readbuffer[j] != nor_fill_buffer[j])
+            return(LX_ERROR);
+    }
+
+    return(LX_SUCCESS);
+}
+#endif
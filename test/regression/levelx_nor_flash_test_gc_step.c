@@ -0,0 +1,224 @@
+/* NOR flash garbage collection step tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   i, j, sector;
+UINT    status;
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("Test 1: Garbage collection step.................");
+
+    /* Erase the simulated NOR flash, open it and write the sectors.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (i = 0; (status == LX_SUCCESS) && (i < (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS)); i++)
+    {
+
+        nor_cache_stamp[i] =  i;
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i;
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    }
+
+    /* Collect the garbage until there is nothing left to do.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < 1000); i++)
+    {
+        status =  lx_nor_flash_gc_step(&nor_sim_flash, 4);
+    }
+
+    if ((status != LX_NO_BLOCKS) || (nor_sim_flash.lx_nor_flash_gc_state != LX_NOR_GC_STATE_IDLE))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Overwrite sectors with a small garbage collection budget after each write, the writes must not
+       have to reclaim blocks themselves.  */
+    nor_sim_flash.lx_nor_flash_foreground_reclaims =  0;
+    nor_sim_flash.lx_nor_flash_gc_operations =        0;
+    for (sector = 0; sector < 2000; sector++)
+    {
+
+        i =  (sector * 7) % (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS);
+        nor_cache_stamp[i] =  sector;
+        for (j = 0; j < 128; j++)
+          buffer[j] =  sector;
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+        if (status == LX_SUCCESS)
+        {
+            status =  lx_nor_flash_gc_step(&nor_sim_flash, 16);
+            if (status == LX_NO_BLOCKS)
+                status =  LX_SUCCESS;
+        }
+
+        if ((status != LX_SUCCESS) || (((sector % 100) == 0) && (nor_gc_check(&nor_sim_flash) != LX_SUCCESS)))
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    if ((nor_sim_flash.lx_nor_flash_foreground_reclaims != 0) || (nor_sim_flash.lx_nor_flash_gc_operations == 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write sectors in an irregular order, so the blocks keep valid sectors, and step one operation at a time
+       until a sector has been copied. Then overwrite that sector, the relocation must be abandoned and the
+       new data kept.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < 1000) && (nor_sim_flash.lx_nor_flash_gc_state != LX_NOR_GC_STATE_SUPERCEDE); i++)
+    {
+        if (nor_sim_flash.lx_nor_flash_gc_state == LX_NOR_GC_STATE_IDLE)
+        {
+            nor_cache_stamp[(sector * sector) % (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS)] =  sector;
+            for (j = 0; j < 128; j++)
+              buffer[j] =  sector;
+            status =  lx_nor_flash_sector_write(&nor_sim_flash, (sector * sector) % (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS), buffer);
+            sector++;
+        }
+        if (status == LX_SUCCESS)
+            status =  lx_nor_flash_gc_step(&nor_sim_flash, 1);
+        if (status == LX_NO_BLOCKS)
+            status =  LX_SUCCESS;
+    }
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_gc_state != LX_NOR_GC_STATE_SUPERCEDE))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    i =  nor_sim_flash.lx_nor_flash_gc_mapping_entry & LX_NOR_LOGICAL_SECTOR_MASK;
+    nor_cache_stamp[i] =  sector;
+    for (j = 0; j < 128; j++)
+      buffer[j] =  sector;
+    status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    if ((status != LX_SUCCESS) || (nor_gc_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Step until the next relocation is about to be committed, then release that sector.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < 1000) && (nor_sim_flash.lx_nor_flash_gc_state != LX_NOR_GC_STATE_COMMIT); i++)
+    {
+        if (nor_sim_flash.lx_nor_flash_gc_state == LX_NOR_GC_STATE_IDLE)
+        {
+            nor_cache_stamp[(sector * sector) % (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS)] =  sector;
+            for (j = 0; j < 128; j++)
+              buffer[j] =  sector;
+            status =  lx_nor_flash_sector_write(&nor_sim_flash, (sector * sector) % (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS), buffer);
+            sector++;
+        }
+        if (status == LX_SUCCESS)
+            status =  lx_nor_flash_gc_step(&nor_sim_flash, 1);
+        if (status == LX_NO_BLOCKS)
+            status =  LX_SUCCESS;
+    }
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_gc_state != LX_NOR_GC_STATE_COMMIT))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    i =  nor_sim_flash.lx_nor_flash_gc_mapping_entry & LX_NOR_LOGICAL_SECTOR_MASK;
+    nor_cache_stamp[i] =  LX_ALL_ONES;
+    status =  lx_nor_flash_sector_release(&nor_sim_flash, i);
+    if ((status != LX_SUCCESS) || (nor_gc_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Finish the garbage collection, then check the sectors after opening the flash again.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < 1000); i++)
+    {
+        status =  lx_nor_flash_gc_step(&nor_sim_flash, 1);
+    }
+    if (status == LX_NO_BLOCKS)
+        status =  lx_nor_flash_close(&nor_sim_flash);
+    if (status == LX_SUCCESS)
+        status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_gc_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
@@ -0,0 +1,149 @@
+/* NOR flash in-place overwrite tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+ULONG   i, j, sector;
+UINT    status;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+    printf("Test 1: In-place overwrite......................");
+
+    /* Erase the simulated NOR flash and write an erased log sector.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (j = 0; j < 128; j++)
+      buffer[j] =  0xFFFFFFFF;
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 5, buffer);
+    i =  nor_sim_flash.lx_nor_flash_free_physical_sectors;
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_in_place_overwrites != 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Append one record per write. Each write only clears bits, so it is done in place.  */
+    for (j = 0; j < 128; j++)
+    {
+
+        buffer[j] =  j;
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, 5, buffer);
+        status += lx_nor_flash_sector_read(&nor_sim_flash, 5, readbuffer);
+
+        if ((status != LX_SUCCESS) || (readbuffer[j] != j) || (readbuffer[127] != ((j == 127) ? 127 : 0xFFFFFFFF)) ||
+            (nor_sim_flash.lx_nor_flash_free_physical_sectors != i) ||
+            (nor_sim_flash.lx_nor_flash_in_place_overwrites != (j + 1)))
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* Clear the bits of another record, and write the same data again. Writing the same data again is
+       skipped with write if changed.  */
+    buffer[64] =  0;
+    status =  lx_nor_flash_sector_write(&nor_sim_flash, 5, buffer);
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 5, buffer);
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 5, readbuffer);
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
+    sector =  129;
+#else
+    sector =  130;
+#endif
+
+    if ((status != LX_SUCCESS) || (readbuffer[64] != 0) || (readbuffer[65] != 65) ||
+        (nor_sim_flash.lx_nor_flash_free_physical_sectors != i) || (nor_sim_flash.lx_nor_flash_in_place_overwrites != sector))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Setting a bit requires a new physical sector.  */
+    buffer[0] =  0xFFFFFFFF;
+    status =  lx_nor_flash_sector_write(&nor_sim_flash, 5, buffer);
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 5, readbuffer);
+
+    if ((status != LX_SUCCESS) || (readbuffer[0] != 0xFFFFFFFF) || (readbuffer[1] != 1) || (readbuffer[64] != 0) ||
+        (nor_sim_flash.lx_nor_flash_free_physical_sectors != (i - 1)) || (nor_sim_flash.lx_nor_flash_in_place_overwrites != sector))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* The sector written in place must be intact after the NOR flash is opened again.  */
+    buffer[0] =  0x7FFFFFFF;
+    status =  lx_nor_flash_sector_write(&nor_sim_flash, 5, buffer);
+    status += lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 5, readbuffer);
+
+    if ((status != LX_SUCCESS) || (readbuffer[0] != 0x7FFFFFFF) || (readbuffer[1] != 1) || (readbuffer[64] != 0) ||
+        (readbuffer[127] != 127) || (nor_sim_flash.lx_nor_flash_mapped_physical_sectors != 1))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
@@ -0,0 +1,239 @@
+/* NOR flash logical sector index tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the test helpers.  */
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+UINT  nor_index_driver_initialize(LX_NOR_FLASH *nor_flash);
+UINT  nor_index_check(LX_NOR_FLASH *nor_flash);
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+ULONG   i, j, sector;
+UINT    status;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+    printf("Test 1: Logical sector index....................");
+
+    /* Open the flash with the index memory supplied by the driver initialization.  */
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_index_driver_initialize);
+
+    if ((status != LX_SUCCESS) ||
+        (nor_sim_flash.lx_nor_flash_logical_sector_index_max_logical_sector != nor_sim_flash.lx_nor_flash_total_physical_sectors))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write 100 sectors, then rewrite the first 50 several times to force block reclaims.  */
+    for (sector = 0; sector < 250; sector++)
+    {
+
+        i =  (sector < 100) ? sector : ((sector - 100) % 50);
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i + sector;
+
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+
+        if (status != LX_SUCCESS)
+        {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+        }
+    }
+
+    /* Release the last 10 sectors.  */
+    for (i = 90; i < 100; i++)
+    {
+        status =  lx_nor_flash_sector_release(&nor_sim_flash, i);
+        if (status != LX_SUCCESS)
+        {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+        }
+    }
+
+    /* Check the index against the mapping lists and read back the data.  */
+    if ((nor_index_check(&nor_sim_flash) != LX_SUCCESS) ||
+        (nor_sim_flash.lx_nor_flash_logical_sector_index_hits == 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Close and reopen, the index is rebuilt while the flash is opened.  */
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", nor_index_driver_initialize);
+
+    if ((status != LX_SUCCESS) || (nor_index_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Close and reopen without index, then enable the index after the open.  */
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += lx_nor_flash_logical_sector_index_enable(&nor_sim_flash, nor_index_memory, sizeof(nor_index_memory));
+
+    if ((status != LX_SUCCESS) || (nor_index_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Disable the index.  */
+    status =  lx_nor_flash_logical_sector_index_enable(&nor_sim_flash, LX_NULL, 0);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_logical_sector_index_max_logical_sector != 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+    exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+
+/* Define the driver initialization that supplies the logical sector index memory.  */
+
+UINT  nor_index_driver_initialize(LX_NOR_FLASH *nor_flash)
+{
+
+UINT    status;
+
+
+    status =  _lx_nor_flash_simulator_initialize(nor_flash);
+    if (status == LX_SUCCESS)
+        status =  lx_nor_flash_logical_sector_index_enable(nor_flash, nor_index_memory, sizeof(nor_index_memory));
+    return(status);
+}
+
+
+/* Compare each index entry with the result of searching the mapping lists, and read back
+   the data written in Test 1.  */
+
+UINT  nor_index_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   i, j;
+ULONG   max_logical_sector;
+ULONG   *index_map_entry;
+ULONG   *index_sector_address;
+ULONG   *map_entry;
+ULONG   *sector_address;
+
+
+    max_logical_sector =  nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector;
+    for (i = 0; i < max_logical_sector; i++)
+    {
+
+        /* Lookup with the index.  */
+        _lx_nor_flash_logical_sector_find(nor_flash, i, LX_FALSE, &index_map_entry, &index_sector_address);
+
+        /* Lookup by searching the mapping lists.  */
+        nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  0;
+        nor_flash -> lx_nor_flash_sector_mapping_cache_enabled =  LX_FALSE;
+        _lx_nor_flash_logical_sector_find(nor_flash, i, LX_FALSE, &map_entry, &sector_address);
+        nor_flash -> lx_nor_flash_sector_mapping_cache_enabled =  LX_TRUE;
+        nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  max_logical_sector;
+
+        if ((index_map_entry != map_entry) || (index_sector_address != sector_address))
+            return(LX_ERROR);
+
+        /* Only sectors 0 through 89 should still be mapped.  */
+        if ((i < 90) != (map_entry != LX_NULL))
+            return(LX_ERROR);
+    }
+
+    for (i = 0; i < 90; i++)
+    {
+
+        if (lx_nor_flash_sector_read(nor_flash, i, readbuffer) != LX_SUCCESS)
+            return(LX_ERROR);
+
+        for (j = 0; j < 128; j++)
+        {
+
+            /* The last write of sectors below 50 happened at write number 200 + i.  */
+            if (readbuffer[j] != ((i < 50) ? (i + 200 + i) : (i + i)))
+                return(LX_ERROR);
+        }
+    }
+
+    return(LX_SUCCESS);
+}
+#endif
@@ -0,0 +1,240 @@
+/* NOR flash sector mapping cache tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the test helpers.  */
+
+UINT  nor_mapping_cache_check(LX_NOR_FLASH *nor_flash);
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   i, j, sector;
+UINT    status;
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("Test 1: Sector mapping cache....................");
+
+    /* Erase the simulated NOR flash and open it.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+
+    /* Write the FAT sectors and the data sectors.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS)); i++)
+    {
+
+        nor_cache_stamp[i] =  i;
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i;
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    }
+
+    if ((status != LX_SUCCESS) || (nor_mapping_cache_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Read a FAT sector before every four data sectors and update a FAT sector every eighth time.  */
+    nor_sim_flash.lx_nor_flash_sector_mapping_cache_hits =    0;
+    nor_sim_flash.lx_nor_flash_sector_mapping_cache_misses =  0;
+    for (sector = 0; sector < 800; sector++)
+    {
+
+        /* Read the FAT sector and then the data sectors.  */
+        for (j = 0; j < 5; j++)
+        {
+
+            i =  (j == 0) ? (sector % NOR_CACHE_FAT_SECTORS) : (NOR_CACHE_FAT_SECTORS + (((sector * 4) + j) % NOR_CACHE_DATA_SECTORS));
+            status =  lx_nor_flash_sector_read(&nor_sim_flash, i, readbuffer);
+            if ((status != LX_SUCCESS) || (readbuffer[0] != nor_cache_stamp[i]) || (readbuffer[127] != nor_cache_stamp[i]))
+            {
+                  printf("FAILED!\n");
+#ifdef BATCH_TEST
+                  exit(1);
+#endif
+                  while(1)
+                  {
+                  }
+            }
+        }
+
+        /* Update a FAT sector.  */
+        if ((sector % 8) == 7)
+        {
+
+            i =  (sector / 8) % NOR_CACHE_FAT_SECTORS;
+            nor_cache_stamp[i] =  nor_cache_stamp[i] + 1000;
+            for (j = 0; j < 128; j++)
+              buffer[j] =  nor_cache_stamp[i];
+            status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+        }
+
+        /* Check the sector mapping cache periodically.  */
+        if ((status != LX_SUCCESS) || (((sector % 50) == 0) && (nor_mapping_cache_check(&nor_sim_flash) != LX_SUCCESS)))
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* The FAT sectors must have been found in the sector mapping cache.  */
+    if ((nor_sim_flash.lx_nor_flash_sector_mapping_cache_hits == 0) ||
+        (nor_mapping_cache_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Release a FAT sector, it must no longer be in the sector mapping cache.  */
+    status =  lx_nor_flash_sector_release(&nor_sim_flash, 0);
+    if ((status != LX_SUCCESS) || (lx_nor_flash_sector_read(&nor_sim_flash, 0, readbuffer) != LX_SUCCESS) ||
+        (readbuffer[0] != LX_ALL_ONES) || (nor_mapping_cache_check(&nor_sim_flash) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+/* Check every used way of the sector mapping cache against the mapping lists, and check the
+   replacement state of each set.  */
+
+UINT  nor_mapping_cache_check(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   i, j, k;
+ULONG   tag;
+ULONG   used_ways;
+ULONG   protected_ways;
+ULONG   *map_entry;
+ULONG   *sector_address;
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+ULONG   max_logical_sector;
+#endif
+
+
+    for (i = 0; i < LX_NOR_SECTOR_MAPPING_CACHE_SIZE; i += LX_NOR_SECTOR_MAPPING_CACHE_DEPTH)
+    {
+
+        used_ways =       0;
+        protected_ways =  0;
+        for (j = 0; j < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; j++)
+        {
+
+            tag =  nor_flash -> lx_nor_flash_sector_mapping_cache_tags[i + j];
+            if (tag == 0)
+                continue;
+            used_ways++;
+
+            /* The sector must be in its own set, and only once.  */
+            if ((((tag & LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_MASK) & LX_NOR_SECTOR_MAPPING_CACHE_HASH_MASK) * LX_NOR_SECTOR_MAPPING_CACHE_DEPTH) != i)
+                return(LX_ERROR);
+            for (k = j + 1; k < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; k++)
+            {
+                if (nor_flash -> lx_nor_flash_sector_mapping_cache_tags[i + k] == tag)
+                    return(LX_ERROR);
+            }
+
+            /* The cached mapping must match the mapping lists.  */
+            nor_flash -> lx_nor_flash_sector_mapping_cache_enabled =  LX_FALSE;
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+            max_logical_sector =  nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector;
+            nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  0;
+#endif
+            if (_lx_nor_flash_logical_sector_find(nor_flash, tag & LX_NOR_SECTOR_MAPPING_CACHE_ENTRY_MASK, LX_FALSE, &map_entry, &sector_address) != LX_SUCCESS)
+                map_entry =  LX_NULL;
+#ifdef LX_NOR_ENABLE_LOGICAL_SECTOR_INDEX
+            nor_flash -> lx_nor_flash_logical_sector_index_max_logical_sector =  max_logical_sector;
+#endif
+            nor_flash -> lx_nor_flash_sector_mapping_cache_enabled =  LX_TRUE;
+            if ((map_entry != nor_flash -> lx_nor_flash_sector_mapping_cache[i + j].lx_nor_sector_mapping_cache_physical_sector_map_entry) ||
+                (sector_address != nor_flash -> lx_nor_flash_sector_mapping_cache[i + j].lx_nor_sector_mapping_cache_physical_sector_address))
+                return(LX_ERROR);
+
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY != LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK
+
+            /* The used ways must have different ranks.  */
+            if (nor_flash -> lx_nor_flash_sector_mapping_cache_state[i + j] & LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED)
+                protected_ways++;
+            for (k = j + 1; k < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; k++)
+            {
+                if ((nor_flash -> lx_nor_flash_sector_mapping_cache_tags[i + k]) &&
+                    ((nor_flash -> lx_nor_flash_sector_mapping_cache_state[i + k] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK) ==
+                     (nor_flash -> lx_nor_flash_sector_mapping_cache_state[i + j] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK)))
+                    return(LX_ERROR);
+            }
+#endif
+        }
+
+#if LX_NOR_SECTOR_MAPPING_CACHE_POLICY != LX_NOR_SECTOR_MAPPING_CACHE_POLICY_CLOCK
+
+        /* The ranks of the used ways must be 0 to the number of used ways - 1.  */
+        for (j = 0; j < LX_NOR_SECTOR_MAPPING_CACHE_DEPTH; j++)
+        {
+            if ((nor_flash -> lx_nor_flash_sector_mapping_cache_tags[i + j]) &&
+                ((ULONG) (nor_flash -> lx_nor_flash_sector_mapping_cache_state[i + j] & LX_NOR_SECTOR_MAPPING_CACHE_RANK_MASK) >= used_ways))
+                return(LX_ERROR);
+        }
+        if (protected_ways > LX_NOR_SECTOR_MAPPING_CACHE_PROTECTED_WAYS)
+            return(LX_ERROR);
+#else
+        if (nor_flash -> lx_nor_flash_sector_mapping_cache_clock_hand[i / LX_NOR_SECTOR_MAPPING_CACHE_DEPTH] >= LX_NOR_SECTOR_MAPPING_CACHE_DEPTH)
+            return(LX_ERROR);
+#endif
+    }
+
+    return(LX_SUCCESS);
+}
@@ -0,0 +1,371 @@
+/* NOR flash runtime sector size tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define a second NOR flash with 4KB sectors, used alongside the simulated NOR flash.  */
+
+#define NOR_LARGE_TOTAL_BLOCKS              8
+#define NOR_LARGE_SECTORS_PER_BLOCK         16
+#define NOR_LARGE_WORDS_PER_SECTOR          (4096/sizeof(ULONG))
+#define NOR_LARGE_WORDS_PER_BLOCK           (NOR_LARGE_SECTORS_PER_BLOCK * NOR_LARGE_WORDS_PER_SECTOR)
+#define NOR_LARGE_LOGICAL_SECTORS           60
+
+LX_NOR_FLASH    nor_large_flash;
+ULONG           nor_large_memory[NOR_LARGE_TOTAL_BLOCKS * NOR_LARGE_WORDS_PER_BLOCK];
+ULONG           nor_large_sector_memory[NOR_LARGE_WORDS_PER_SECTOR];
+ULONG           nor_large_cache_memory[3 * NOR_LARGE_WORDS_PER_SECTOR];
+ULONG           nor_large_buffer[NOR_LARGE_WORDS_PER_SECTOR];
+ULONG           nor_large_stamp[NOR_LARGE_LOGICAL_SECTORS];
+ULONG           nor_large_words_per_sector;
+
+
+/* Define the test helpers.  */
+
+UINT  nor_large_driver_initialize(LX_NOR_FLASH *nor_flash);
+UINT  nor_large_check(ULONG logical_sector);
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  nor_large_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  nor_large_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words);
+UINT  nor_large_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count);
+UINT  nor_large_driver_block_erased_verify(LX_NOR_FLASH *nor_flash, ULONG block);
+#else
+UINT  nor_large_driver_read(ULONG *flash_address, ULONG *destination, ULONG words);
+UINT  nor_large_driver_write(ULONG *flash_address, ULONG *source, ULONG words);
+UINT  nor_large_driver_block_erase(ULONG block, ULONG erase_count);
+UINT  nor_large_driver_block_erased_verify(ULONG block);
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   i, j, sector;
+UINT    status;
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("Test 1: Runtime sector size.....................");
+
+    /* Erase both flashes.  */
+    _lx_nor_flash_simulator_erase_all();
+    for (i = 0; i < (NOR_LARGE_TOTAL_BLOCKS * NOR_LARGE_WORDS_PER_BLOCK); i++)
+        nor_large_memory[i] =  LX_ALL_ONES;
+
+    /* A sector size that is not a power of 2 should be rejected.  */
+    nor_large_words_per_sector =  NOR_LARGE_WORDS_PER_SECTOR - 1;
+    status =  lx_nor_flash_open(&nor_large_flash, "large nor flash", nor_large_driver_initialize);
+
+    if (status != LX_ERROR)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* A sector size smaller than the minimum sector size should be rejected.  */
+    nor_large_words_per_sector =  LX_NOR_SECTOR_SIZE_MIN / 2;
+    status =  lx_nor_flash_open(&nor_large_flash, "large nor flash", nor_large_driver_initialize);
+
+    if (status != LX_ERROR)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Open the simulated NOR flash with the default sector size and the large NOR flash with 4KB sectors.  */
+    nor_large_words_per_sector =  NOR_LARGE_WORDS_PER_SECTOR;
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += lx_nor_flash_open(&nor_large_flash, "large nor flash", nor_large_driver_initialize);
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+    status += lx_nor_flash_extended_cache_enable(&nor_large_flash, nor_large_cache_memory, sizeof(nor_large_cache_memory));
+#endif
+
+    if ((status != LX_SUCCESS) ||
+        (nor_sim_flash.lx_nor_flash_words_per_sector != LX_NOR_SECTOR_SIZE) ||
+        (nor_large_flash.lx_nor_flash_words_per_sector != NOR_LARGE_WORDS_PER_SECTOR) ||
+        (nor_large_flash.lx_nor_flash_physical_sectors_per_block != (NOR_LARGE_SECTORS_PER_BLOCK - 1))
+#ifndef LX_NOR_DISABLE_EXTENDED_CACHE
+        || (nor_large_flash.lx_nor_flash_extended_cache_entries < 2)
+#endif
+        )
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write every logical sector of both flashes.  */
+    for (i = 0; i < NOR_LARGE_LOGICAL_SECTORS; i++)
+    {
+        nor_large_stamp[i] =  0;
+        for (j = 0; j < NOR_LARGE_WORDS_PER_SECTOR; j++)
+            nor_large_buffer[j] =  (i << 16) | j;
+        for (j = 0; j < 128; j++)
+            buffer[j] =  i;
+
+        status =  lx_nor_flash_sector_write(&nor_large_flash, i, nor_large_buffer);
+        status += lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+
+        if (status != LX_SUCCESS)
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* Overwrite random sectors of both flashes, checking the previous contents first.  */
+    for (i = 1; i <= 400; i++)
+    {
+
+        sector =  (ULONG) (rand() % NOR_LARGE_LOGICAL_SECTORS);
+
+        status =  nor_large_check(sector);
+        status += lx_nor_flash_sector_read(&nor_sim_flash, sector, readbuffer);
+
+        if ((status != LX_SUCCESS) || (readbuffer[0] != sector) || (readbuffer[127] != sector))
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+
+        nor_large_stamp[sector] =  i;
+        for (j = 0; j < NOR_LARGE_WORDS_PER_SECTOR; j++)
+            nor_large_buffer[j] =  (i << 16) | (sector << 12) | j;
+
+        status =  lx_nor_flash_sector_write(&nor_large_flash, sector, nor_large_buffer);
+        status += lx_nor_flash_sector_write(&nor_sim_flash, sector, readbuffer);
+
+        if (status != LX_SUCCESS)
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* Both flashes must have reclaimed blocks.  */
+    if ((nor_large_flash.lx_nor_flash_maximum_erase_count == 0) || (nor_sim_flash.lx_nor_flash_maximum_erase_count == 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Reopen the large NOR flash and check every sector.  */
+    status =  lx_nor_flash_close(&nor_large_flash);
+    status += lx_nor_flash_open(&nor_large_flash, "large nor flash", nor_large_driver_initialize);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    for (i = 0; i < NOR_LARGE_LOGICAL_SECTORS; i++)
+    {
+
+        if (nor_large_check(i) != LX_SUCCESS)
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    status =  lx_nor_flash_close(&nor_large_flash);
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+/* Define the driver for the NOR flash with 4KB sectors.  */
+
+UINT  nor_large_driver_initialize(LX_NOR_FLASH *nor_flash)
+{
+
+    /* Setup the base address and geometry of the flash.  */
+    nor_flash -> lx_nor_flash_base_address =     nor_large_memory;
+    nor_flash -> lx_nor_flash_total_blocks =     NOR_LARGE_TOTAL_BLOCKS;
+    nor_flash -> lx_nor_flash_words_per_block =  NOR_LARGE_WORDS_PER_BLOCK;
+    nor_flash -> lx_nor_flash_words_per_sector = nor_large_words_per_sector;
+
+    /* Setup function pointers for the NOR flash services.  */
+    nor_flash -> lx_nor_flash_driver_read =                 nor_large_driver_read;
+    nor_flash -> lx_nor_flash_driver_write =                nor_large_driver_write;
+    nor_flash -> lx_nor_flash_driver_block_erase =          nor_large_driver_block_erase;
+    nor_flash -> lx_nor_flash_driver_block_erased_verify =  nor_large_driver_block_erased_verify;
+    nor_flash -> lx_nor_flash_sector_buffer =               nor_large_sector_memory;
+
+    return(LX_SUCCESS);
+}
+
+
+/* Read a logical sector of the NOR flash with 4KB sectors and compare it with the last data written.  */
+
+UINT  nor_large_check(ULONG logical_sector)
+{
+
+ULONG   j;
+ULONG   expected;
+
+
+    if (lx_nor_flash_sector_read(&nor_large_flash, logical_sector, nor_large_buffer) != LX_SUCCESS)
+        return(LX_ERROR);
+
+    for (j = 0; j < NOR_LARGE_WORDS_PER_SECTOR; j++)
+    {
+
+        if (nor_large_stamp[logical_sector])
+            expected =  (nor_large_stamp[logical_sector] << 16) | (logical_sector << 12) | j;
+        else
+            expected =  (logical_sector << 16) | j;
+
+        if (nor_large_buffer[j] != expected)
+            return(LX_ERROR);
+    }
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  nor_large_driver_read(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *destination, ULONG words)
+#else
+UINT  nor_large_driver_read(ULONG *flash_address, ULONG *destination, ULONG words)
+#endif
+{
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    while (words--)
+        *destination++ =  *flash_address++;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  nor_large_driver_write(LX_NOR_FLASH *nor_flash, ULONG *flash_address, ULONG *source, ULONG words)
+#else
+UINT  nor_large_driver_write(ULONG *flash_address, ULONG *source, ULONG words)
+#endif
+{
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    /* NOR flash can only clear bits.  */
+    while (words--)
+        *flash_address++ &=  *source++;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  nor_large_driver_block_erase(LX_NOR_FLASH *nor_flash, ULONG block, ULONG erase_count)
+#else
+UINT  nor_large_driver_block_erase(ULONG block, ULONG erase_count)
+#endif
+{
+
+ULONG   i;
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+    LX_PARAMETER_NOT_USED(erase_count);
+
+    for (i = 0; i < NOR_LARGE_WORDS_PER_BLOCK; i++)
+        nor_large_memory[(block * NOR_LARGE_WORDS_PER_BLOCK) + i] =  LX_ALL_ONES;
+    return(LX_SUCCESS);
+}
+
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+UINT  nor_large_driver_block_erased_verify(LX_NOR_FLASH *nor_flash, ULONG block)
+#else
+UINT  nor_large_driver_block_erased_verify(ULONG block)
+#endif
+{
+
+ULONG   i;
+
+#ifdef LX_NOR_ENABLE_CONTROL_BLOCK_FOR_DRIVER_INTERFACE
+    LX_PARAMETER_NOT_USED(nor_flash);
+#endif
+
+    for (i = 0; i < NOR_LARGE_WORDS_PER_BLOCK; i++)
+    {
+        if (nor_large_memory[(block * NOR_LARGE_WORDS_PER_BLOCK) + i] != LX_ALL_ONES)
+            return(LX_ERROR);
+    }
+    return(LX_SUCCESS);
+}
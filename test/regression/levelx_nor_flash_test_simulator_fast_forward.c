@@ -0,0 +1,66 @@
+/* NOR flash simulator fast forward tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   i;
+UINT    status;
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("Test 1: Simulator fast forward..................");
+
+    /* In fast forward mode only the first word of each sector is kept, rewrite enough sectors to reclaim blocks.  */
+    status =  _lx_nor_flash_simulator_geometry_set(16, 32, nor_geometry_memory, sizeof(nor_geometry_memory));
+    status += _lx_nor_flash_simulator_fast_forward_set(LX_TRUE);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (i = 0; i < 3000; i++)
+    {
+        buffer[0] =  i;
+        status += lx_nor_flash_sector_write(&nor_sim_flash, i % 200, buffer);
+    }
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    /* The metadata is complete, so the flash opens again with the latest tokens.  */
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (i = 2800; i < 3000; i++)
+    {
+        status += lx_nor_flash_sector_read(&nor_sim_flash, i % 200, readbuffer);
+        if (readbuffer[0] != i)
+            status =  LX_ERROR;
+    }
+    status += lx_nor_flash_close(&nor_sim_flash);
+    status += _lx_nor_flash_simulator_fast_forward_set(LX_FALSE);
+    status += _lx_nor_flash_simulator_geometry_set(8, 16, LX_NULL, 0);
+    _lx_nor_flash_simulator_erase_all();
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
@@ -0,0 +1,139 @@
+/* NOR flash simulator geometry tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   i;
+UINT    status;
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("Test 1: Simulator geometry......................");
+
+    /* Geometries that don't fit in the memory or in one sector of block metadata are rejected.  */
+    if ((_lx_nor_flash_simulator_geometry_set(32, 32, nor_geometry_memory, sizeof(nor_geometry_memory)) != LX_ERROR) ||
+        (_lx_nor_flash_simulator_geometry_set(2, 121, nor_geometry_memory, sizeof(nor_geometry_memory)) != LX_ERROR) ||
+        (_lx_nor_flash_simulator_geometry_set(1, 16, nor_geometry_memory, sizeof(nor_geometry_memory)) != LX_ERROR))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Open a flash of 16 blocks with 32 sectors each, which holds more sectors than the default geometry.  */
+    status =  _lx_nor_flash_simulator_geometry_set(16, 32, nor_geometry_memory, sizeof(nor_geometry_memory));
+    _lx_nor_flash_simulator_erase_all();
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (i = 0; i < 300; i++)
+    {
+        buffer[0] =    i;
+        buffer[127] =  ~i;
+        status += lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    }
+    for (i = 0; i < 300; i++)
+    {
+        status += lx_nor_flash_sector_read(&nor_sim_flash, i, readbuffer);
+        if ((readbuffer[0] != i) || (readbuffer[127] != ~i))
+            status =  LX_ERROR;
+    }
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_total_blocks != 16) ||
+        (nor_sim_flash.lx_nor_flash_physical_sectors_per_block != 31) || (nor_geometry_memory[0] == 0xFFFFFFFF))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* A null memory returns to the default geometry.  */
+    status =  _lx_nor_flash_simulator_geometry_set(8, 16, LX_NULL, 0);
+    _lx_nor_flash_simulator_erase_all();
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 0, buffer);
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_total_blocks != 8) ||
+        (nor_sim_flash.lx_nor_flash_physical_sectors_per_block != 15))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+#ifdef LX_NOR_SIMULATOR_ENABLE_FILE
+
+    /* Write sectors to a new device image, they are still there when the image is opened again.  */
+    remove("nor_simulator_test.img");
+    status =  _lx_nor_flash_simulator_file_open("nor_simulator_test.img", 12, 16);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (i = 0; i < 100; i++)
+    {
+        buffer[0] =    0x23230000 + i;
+        buffer[127] =  i;
+        status += lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    }
+    status += lx_nor_flash_close(&nor_sim_flash);
+    status += _lx_nor_flash_simulator_file_close();
+
+    /* Opening the image with another geometry fails.  */
+    if (_lx_nor_flash_simulator_file_open("nor_simulator_test.img", 12, 32) != LX_ERROR)
+        status =  LX_ERROR;
+
+    status += _lx_nor_flash_simulator_file_open("nor_simulator_test.img", 12, 16);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (i = 0; i < 100; i++)
+    {
+        status += lx_nor_flash_sector_read(&nor_sim_flash, i, readbuffer);
+        if ((readbuffer[0] != (0x23230000 + i)) || (readbuffer[127] != i))
+            status =  LX_ERROR;
+    }
+    status += lx_nor_flash_close(&nor_sim_flash);
+    if ((status == LX_SUCCESS) && (nor_sim_flash.lx_nor_flash_total_blocks != 12))
+        status =  LX_ERROR;
+    status += _lx_nor_flash_simulator_file_close();
+    remove("nor_simulator_test.img");
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+#endif
+    printf("SUCCESS!\n");
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
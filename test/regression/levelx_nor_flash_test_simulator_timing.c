@@ -0,0 +1,135 @@
+/* NOR flash simulator timing tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+ULONG64         nor_sim_time;
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   i;
+UINT    status;
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("Test 1: Simulator timing........................");
+
+    /* Count only the programmed words, writing a new sector programs its data and its mapping.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += _lx_nor_flash_simulator_timing_set(0, 1, 0, 0);
+    status += _lx_nor_flash_simulator_time_reset();
+    for (i = 0; i < 128; i++)
+        buffer[i] =  0x22220000 + i;
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 22, buffer);
+    status += _lx_nor_flash_simulator_time_get(&nor_sim_time);
+
+    if ((status != LX_SUCCESS) || (nor_sim_time < 128) || (nor_sim_time >= 256))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+#ifndef LX_DIRECT_READ
+
+    /* Count only the read words, the sector is read from the flash after the open.  */
+    status =  lx_nor_flash_close(&nor_sim_flash);
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += _lx_nor_flash_simulator_timing_set(1, 0, 0, 0);
+    status += _lx_nor_flash_simulator_time_reset();
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 22, readbuffer);
+    status += _lx_nor_flash_simulator_time_get(&nor_sim_time);
+
+    if ((status != LX_SUCCESS) || (nor_sim_time < 128) || (readbuffer[0] != 0x22220000) || (readbuffer[127] != (0x22220000 + 127)))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+#endif
+
+    /* Count only the bus transfers, every word moves four bytes.  */
+    status =  _lx_nor_flash_simulator_timing_set(0, 0, 0, 1);
+    status += _lx_nor_flash_simulator_time_reset();
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 23, buffer);
+    status += _lx_nor_flash_simulator_time_get(&nor_sim_time);
+
+    if ((status != LX_SUCCESS) || (nor_sim_time < (128 * sizeof(ULONG))) || ((nor_sim_time % sizeof(ULONG)) != 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Count only the erases, rewriting one sector with new data makes the flash reclaim blocks.  */
+    status =  _lx_nor_flash_simulator_timing_set(0, 0, 1000, 0);
+    status += _lx_nor_flash_simulator_time_reset();
+    for (i = 0; i < 400; i++)
+    {
+        buffer[0] =  i;
+        status += lx_nor_flash_sector_write(&nor_sim_flash, 24, buffer);
+    }
+    status += _lx_nor_flash_simulator_time_get(&nor_sim_time);
+
+    if ((status != LX_SUCCESS) || (nor_sim_time == 0) || ((nor_sim_time % 1000) != 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Without any time set, nothing is counted.  */
+    status =  _lx_nor_flash_simulator_timing_set(0, 0, 0, 0);
+    status += _lx_nor_flash_simulator_time_reset();
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 24, buffer);
+    status += _lx_nor_flash_simulator_time_get(&nor_sim_time);
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    if ((status != LX_SUCCESS) || (nor_sim_time != 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
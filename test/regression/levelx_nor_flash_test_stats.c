@@ -0,0 +1,124 @@
+/* NOR flash statistics tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+#ifdef LX_NOR_ENABLE_STATS
+LX_FLASH_STATS                      nor_stats;
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_STATS
+ULONG   i, j, sector;
+UINT    status;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_STATS
+    printf("Test 1: Statistics..............................");
+
+    /* Erase the simulated NOR flash and clear the statistics of the open.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += lx_nor_flash_stats_reset(&nor_sim_flash);
+
+    /* Write, read, release and defragment.  */
+    for (i = 0; i < 8; i++)
+    {
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i + j;
+        status += lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    }
+    for (i = 0; i < 8; i++)
+        status += lx_nor_flash_sector_read(&nor_sim_flash, i, readbuffer);
+    status += lx_nor_flash_sector_release(&nor_sim_flash, 3);
+    status += lx_nor_flash_defragment(&nor_sim_flash);
+
+    /* Write, read and release multiple sectors. The multiple sector release releases each sector with the
+       single sector release.  */
+    for (i = 0; i < (4 * 128); i++)
+        nor_multiple_buffer[i] =  i;
+    status += lx_nor_flash_sectors_write(&nor_sim_flash, 8, nor_multiple_buffer, 4);
+    status += lx_nor_flash_sectors_read(&nor_sim_flash, 8, nor_multiple_buffer, 4);
+    status += lx_nor_flash_sectors_release(&nor_sim_flash, 8, 2);
+    status += lx_nor_flash_stats_get(&nor_sim_flash, &nor_stats);
+
+    if ((status != LX_SUCCESS) ||
+        (nor_stats.lx_flash_stats_api_calls[LX_STATS_SECTOR_WRITE] != 8) ||
+        (nor_stats.lx_flash_stats_api_calls[LX_STATS_SECTOR_READ] != 8) ||
+        (nor_stats.lx_flash_stats_api_calls[LX_STATS_SECTOR_RELEASE] != 3) ||
+        (nor_stats.lx_flash_stats_api_calls[LX_STATS_DEFRAGMENT] != 1) ||
+        (nor_stats.lx_flash_stats_api_calls[LX_STATS_SECTORS_WRITE] != 1) ||
+        (nor_stats.lx_flash_stats_api_calls[LX_STATS_SECTORS_READ] != 1) ||
+        (nor_stats.lx_flash_stats_api_calls[LX_STATS_SECTORS_RELEASE] != 1) ||
+        (nor_stats.lx_flash_stats_driver_calls[LX_STATS_DRIVER_WRITE] == 0) ||
+        (nor_stats.lx_flash_stats_bytes_requested != (12 * 128 * sizeof(ULONG))) ||
+        (nor_stats.lx_flash_stats_bytes_programmed < nor_stats.lx_flash_stats_bytes_requested))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Every call is in one histogram bucket, and the whole histogram is below the longest call.  */
+    for (i = 0; i < LX_STATS_APIS; i++)
+    {
+        for (j = 0, sector = 0; j < LX_STATS_HISTOGRAM_BUCKETS; j++)
+          sector += nor_stats.lx_flash_stats_api_latency_histogram[i][j];
+        if ((sector != nor_stats.lx_flash_stats_api_calls[i]) ||
+            (lx_stats_latency_percentile(&nor_stats, (UINT) i, 100) != nor_stats.lx_flash_stats_api_latency_max[i]))
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* Reset the statistics.  */
+    status =  lx_nor_flash_stats_reset(&nor_sim_flash);
+    status += lx_nor_flash_stats_get(&nor_sim_flash, &nor_stats);
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    if ((status != LX_SUCCESS) || (nor_stats.lx_flash_stats_api_calls[LX_STATS_SECTOR_WRITE] != 0) ||
+        (nor_stats.lx_flash_stats_bytes_programmed != 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
@@ -0,0 +1,163 @@
+/* NOR flash trace tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+#ifdef LX_NOR_ENABLE_TRACE
+ULONG                               nor_trace_memory[(sizeof(LX_TRACE_HEADER) + (4096 * sizeof(LX_TRACE_EVENT))) / sizeof(ULONG)];
+ULONG                               nor_trace_events[LX_TRACE_CACHE_MISS + 1];
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_TRACE
+ULONG   i, j;
+UINT    status;
+
+LX_TRACE_HEADER *trace_header;
+LX_TRACE_EVENT  *trace_event;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_TRACE
+    printf("Test 1: Trace...................................");
+
+    /* Erase the simulated NOR flash and start the trace, memory for less than one event is rejected.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    if (lx_nor_flash_trace_enable(&nor_sim_flash, nor_trace_memory, sizeof(LX_TRACE_HEADER)) != LX_ERROR)
+        status =  LX_ERROR;
+    status += lx_nor_flash_trace_enable(&nor_sim_flash, nor_trace_memory, sizeof(nor_trace_memory));
+
+    /* Rewrite a few sectors, mixed with static sectors, until blocks holding static sectors are reclaimed.  */
+    for (i = 0; i < 400; i++)
+    {
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i + j;
+        status += lx_nor_flash_sector_write(&nor_sim_flash, i % 24, buffer);
+        if ((i % 10) == 0)
+          status += lx_nor_flash_sector_write(&nor_sim_flash, 100 + (i / 10), buffer);
+    }
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 3, readbuffer);
+
+    /* Count the events of the trace, which hasn't wrapped.  */
+    trace_header =  (LX_TRACE_HEADER *) nor_trace_memory;
+    trace_event =   (LX_TRACE_EVENT *) (trace_header + 1);
+    for (j = 0; j <= LX_TRACE_CACHE_MISS; j++)
+      nor_trace_events[j] =  0;
+    for (j = 0; j < trace_header -> lx_trace_header_total; j++)
+    {
+        if (trace_event[j].lx_trace_event_id <= LX_TRACE_CACHE_MISS)
+          nor_trace_events[trace_event[j].lx_trace_event_id]++;
+    }
+
+    /* The first event is the start of the first write, the last event the end of the read.  */
+    if ((status != LX_SUCCESS) || (trace_header -> lx_trace_header_id != LX_TRACE_ID) || (trace_header -> lx_trace_header_device != LX_TRACE_NOR) ||
+        (trace_header -> lx_trace_header_total >= trace_header -> lx_trace_header_events) ||
+        (trace_header -> lx_trace_header_next != trace_header -> lx_trace_header_total) ||
+        (trace_event[0].lx_trace_event_id != LX_TRACE_API_ENTRY) || (trace_event[0].lx_trace_event_info1 != LX_STATS_SECTOR_WRITE) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_id != LX_TRACE_API_EXIT) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_info1 != LX_STATS_SECTOR_READ) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_info2 != LX_SUCCESS) ||
+        (nor_trace_events[LX_TRACE_API_ENTRY] != 441) || (nor_trace_events[LX_TRACE_API_EXIT] != 441) ||
+        (nor_trace_events[LX_TRACE_RECLAIM] == 0) || (nor_trace_events[LX_TRACE_RELOCATE] == 0) ||
+        (nor_trace_events[LX_TRACE_BLOCK_ERASE] != nor_trace_events[LX_TRACE_RECLAIM]))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* A trace of four events keeps the last four events.  */
+    status =  lx_nor_flash_trace_enable(&nor_sim_flash, nor_trace_memory, sizeof(LX_TRACE_HEADER) + (4 * sizeof(LX_TRACE_EVENT)));
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 3, readbuffer);
+    status += lx_nor_flash_sector_release(&nor_sim_flash, 3);
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 3, readbuffer);
+
+    if ((status != LX_SUCCESS) || (trace_header -> lx_trace_header_events != 4) || (trace_header -> lx_trace_header_total < 6) ||
+        (trace_event[(trace_header -> lx_trace_header_next + 3) % 4].lx_trace_event_id != LX_TRACE_API_EXIT) ||
+        (trace_event[(trace_header -> lx_trace_header_next + 3) % 4].lx_trace_event_info1 != LX_STATS_SECTOR_READ))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* The multiple sector APIs are traced around the single sector APIs they call.  */
+    status =  lx_nor_flash_trace_enable(&nor_sim_flash, nor_trace_memory, sizeof(nor_trace_memory));
+    for (i = 0; i < (4 * 128); i++)
+        nor_multiple_buffer[i] =  i;
+    status += lx_nor_flash_sectors_write(&nor_sim_flash, 40, nor_multiple_buffer, 4);
+    status += lx_nor_flash_sectors_read(&nor_sim_flash, 40, nor_multiple_buffer, 4);
+    status += lx_nor_flash_sectors_release(&nor_sim_flash, 40, 4);
+    for (j = 0; j <= LX_TRACE_CACHE_MISS; j++)
+      nor_trace_events[j] =  0;
+    for (j = 0; j < trace_header -> lx_trace_header_total; j++)
+    {
+        if ((trace_event[j].lx_trace_event_id == LX_TRACE_API_ENTRY) && (trace_event[j].lx_trace_event_info1 == LX_STATS_SECTORS_READ))
+          nor_trace_events[LX_TRACE_API_ENTRY]++;
+    }
+
+    if ((status != LX_SUCCESS) || (trace_header -> lx_trace_header_total < 6) ||
+        (trace_event[0].lx_trace_event_id != LX_TRACE_API_ENTRY) || (trace_event[0].lx_trace_event_info1 != LX_STATS_SECTORS_WRITE) ||
+        (trace_event[0].lx_trace_event_info2 != 40) || (nor_trace_events[LX_TRACE_API_ENTRY] != 1) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_id != LX_TRACE_API_EXIT) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_info1 != LX_STATS_SECTORS_RELEASE) ||
+        (trace_event[trace_header -> lx_trace_header_total - 1].lx_trace_event_info2 != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Nothing is recorded once the trace is disabled.  */
+    j =  trace_header -> lx_trace_header_total;
+    status =  lx_nor_flash_trace_enable(&nor_sim_flash, LX_NULL, 0);
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 3, readbuffer);
+    status += lx_nor_flash_close(&nor_sim_flash);
+
+    if ((status != LX_SUCCESS) || (trace_header -> lx_trace_header_total != j))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
@@ -0,0 +1,174 @@
+/* NOR flash free sector watermark tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+ULONG   i, j, sector;
+UINT    status;
+
+ULONG   reclaim_writes;
+ULONG   free_sectors;
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+    printf("Test 1: Free sector watermarks..................");
+
+    /* Erase the simulated NOR flash and open it, the default watermarks must be set.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    if ((status != LX_SUCCESS) ||
+        (nor_sim_flash.lx_nor_flash_free_sectors_low_watermark != (nor_sim_flash.lx_nor_flash_physical_sectors_per_block * LX_NOR_FLASH_LOW_WATERMARK_BLOCKS)) ||
+        (nor_sim_flash.lx_nor_flash_free_sectors_high_watermark != (nor_sim_flash.lx_nor_flash_physical_sectors_per_block * LX_NOR_FLASH_HIGH_WATERMARK_BLOCKS)))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* A low watermark below one block and a high watermark below the low watermark must be rejected.  */
+    if ((lx_nor_flash_watermarks_set(&nor_sim_flash, nor_sim_flash.lx_nor_flash_physical_sectors_per_block - 1, 3 * nor_sim_flash.lx_nor_flash_physical_sectors_per_block) != LX_ERROR) ||
+        (lx_nor_flash_watermarks_set(&nor_sim_flash, 2 * nor_sim_flash.lx_nor_flash_physical_sectors_per_block, nor_sim_flash.lx_nor_flash_physical_sectors_per_block) != LX_ERROR) ||
+        (lx_nor_flash_watermarks_set(&nor_sim_flash, 2 * nor_sim_flash.lx_nor_flash_physical_sectors_per_block, 3 * nor_sim_flash.lx_nor_flash_physical_sectors_per_block) != LX_SUCCESS))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Write the sectors, then overwrite them. A write that reclaims blocks must stop at the low watermark, and
+       while a block's worth of sectors is free it must reclaim no more than LX_NOR_FLASH_FOREGROUND_RECLAIM_BLOCKS
+       blocks. The free sectors must never drop below the block's worth of sectors needed to reclaim a block.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS)); i++)
+    {
+
+        nor_cache_stamp[i] =  i;
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i;
+        status =  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+    }
+    nor_sim_flash.lx_nor_flash_foreground_reclaims =  0;
+    reclaim_writes =  0;
+    for (sector = 0; sector < 1000; sector++)
+    {
+
+        i =  (sector * 7) % (NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS);
+        nor_cache_stamp[i] =  sector;
+        for (j = 0; j < 128; j++)
+          buffer[j] =  sector;
+        j =  nor_sim_flash.lx_nor_flash_foreground_reclaims;
+        free_sectors =  nor_sim_flash.lx_nor_flash_free_physical_sectors;
+        status +=  lx_nor_flash_sector_write(&nor_sim_flash, i, buffer);
+        if (j != nor_sim_flash.lx_nor_flash_foreground_reclaims)
+            reclaim_writes++;
+
+        if ((status != LX_SUCCESS) ||
+            (nor_sim_flash.lx_nor_flash_free_physical_sectors < nor_sim_flash.lx_nor_flash_physical_sectors_per_block) ||
+            ((j != nor_sim_flash.lx_nor_flash_foreground_reclaims) &&
+             (nor_sim_flash.lx_nor_flash_free_physical_sectors > (nor_sim_flash.lx_nor_flash_free_sectors_low_watermark + nor_sim_flash.lx_nor_flash_physical_sectors_per_block))) ||
+            ((free_sectors > nor_sim_flash.lx_nor_flash_physical_sectors_per_block) &&
+             ((nor_sim_flash.lx_nor_flash_foreground_reclaims - j) > LX_NOR_FLASH_FOREGROUND_RECLAIM_BLOCKS)) ||
+            (((sector % 100) == 0) && (nor_gc_check(&nor_sim_flash) != LX_SUCCESS)))
+        {
+              printf("FAILED!\n");
+#ifdef BATCH_TEST
+              exit(1);
+#endif
+              while(1)
+              {
+              }
+        }
+    }
+
+    /* The writes must have reclaimed blocks in the foreground.  */
+    if (reclaim_writes == 0)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Reading sectors that are not mapped maps them, which must reclaim blocks like a write. Release them
+       again afterwards.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < 30); i++)
+    {
+
+        status =  lx_nor_flash_sector_read(&nor_sim_flash, NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS + i, readbuffer);
+        if (nor_sim_flash.lx_nor_flash_free_physical_sectors < nor_sim_flash.lx_nor_flash_physical_sectors_per_block)
+            status =  LX_ERROR;
+    }
+    status +=  lx_nor_flash_sectors_release(&nor_sim_flash, NOR_CACHE_FAT_SECTORS + NOR_CACHE_DATA_SECTORS, 30);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Collect the garbage, the free sectors must end above the high watermark.  */
+    for (i = 0; (status == LX_SUCCESS) && (i < 1000); i++)
+    {
+        status =  lx_nor_flash_gc_step(&nor_sim_flash, 16);
+    }
+
+    if ((status != LX_NO_BLOCKS) || (nor_gc_check(&nor_sim_flash) != LX_SUCCESS) ||
+        ((nor_sim_flash.lx_nor_flash_free_physical_sectors <= nor_sim_flash.lx_nor_flash_free_sectors_high_watermark) &&
+         (nor_sim_flash.lx_nor_flash_obsolete_physical_sectors != 0)))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
@@ -0,0 +1,133 @@
+/* NOR flash write if changed tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
+ULONG                               nor_unchanged_buffer[4 * 128];
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
+ULONG   i, j;
+UINT    status;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_WRITE_IF_CHANGED
+    printf("Test 1: Write if changed........................");
+
+    /* Erase the simulated NOR flash and write sector 3.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    for (j = 0; j < (4 * 128); j++)
+      nor_unchanged_buffer[j] =  j;
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 3, &nor_unchanged_buffer[128]);
+    i =  nor_sim_flash.lx_nor_flash_free_physical_sectors;
+
+    /* Writing the same data again doesn't change the flash.  */
+    status += lx_nor_flash_sector_write(&nor_sim_flash, 3, &nor_unchanged_buffer[128]);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_elided_writes != 1) || (nor_sim_flash.lx_nor_flash_free_physical_sectors != i))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* A multiple sector write skips sector 3 and writes the others.  */
+    status =  lx_nor_flash_sectors_write(&nor_sim_flash, 2, nor_unchanged_buffer, 4);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_elided_writes != 2) || (nor_sim_flash.lx_nor_flash_free_physical_sectors != (i - 3)))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Writing all of them again doesn't change the flash.  */
+    status =  lx_nor_flash_sectors_write(&nor_sim_flash, 2, nor_unchanged_buffer, 4);
+    for (j = 2; j < 6; j++)
+      status += lx_nor_flash_sector_write(&nor_sim_flash, j, &nor_unchanged_buffer[(j - 2) * 128]);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_elided_writes != 10) || (nor_sim_flash.lx_nor_flash_free_physical_sectors != (i - 3)))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* Changed data is written, and all sectors read back. The change only clears bits, so it is written in place
+       when in-place overwrites are enabled.  */
+    nor_unchanged_buffer[256 + 100] =  0;
+    status =  lx_nor_flash_sectors_write(&nor_sim_flash, 2, nor_unchanged_buffer, 4);
+    for (j = 2; j < 6; j++)
+    {
+      status += lx_nor_flash_sector_read(&nor_sim_flash, j, readbuffer);
+      if ((readbuffer[0] != ((j - 2) * 128)) || (readbuffer[100] != ((j == 4) ? 0 : (((j - 2) * 128) + 100))))
+          status =  LX_ERROR;
+    }
+
+#ifdef LX_NOR_ENABLE_IN_PLACE_OVERWRITE
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_elided_writes != 13) || (nor_sim_flash.lx_nor_flash_free_physical_sectors != (i - 3)))
+#else
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_elided_writes != 13) || (nor_sim_flash.lx_nor_flash_free_physical_sectors != (i - 4)))
+#endif
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
@@ -0,0 +1,188 @@
+/* NOR flash write stream tests...  */
+
+#include "levelx_nor_flash_test_common.h"
+
+
+/* Define LevelX structures.  */
+
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+ULONG                               nor_hot_sector_memory[16];
+#endif
+
+
+/* Define the test helpers.  */
+
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+UINT  nor_write_streams_workload(LX_NOR_FLASH *nor_flash);
+#endif
+
+
+/* Define the test threads.  */
+
+void    thread_0_entry(ULONG thread_input)
+{
+
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+ULONG   i, j;
+UINT    status;
+#endif
+
+
+    /* Erase the simulated NOR flash.  */
+    _lx_nor_flash_simulator_erase_all();
+
+    /* Initialize LevelX.  */
+    _lx_nor_flash_initialize();
+
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+    printf("Test 1: Write streams...........................");
+
+    /* Erase the simulated NOR flash and run the workload with a single write stream, without the hot
+       sector table.  */
+    _lx_nor_flash_simulator_erase_all();
+    status =  lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += nor_write_streams_workload(&nor_sim_flash);
+    j =  nor_sim_flash.lx_nor_flash_relocated_sector_writes;
+
+    if ((status != LX_SUCCESS) || (j == 0) || (nor_sim_flash.lx_nor_flash_write_stream_sectors[LX_NOR_WRITE_STREAM_HOT] != 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    /* Run the same workload with the hot sector table. The FAT sectors are written to their own blocks,
+       so fewer data sectors are relocated and more blocks are erased without relocating any sector.  */
+    _lx_nor_flash_simulator_erase_all();
+    status += lx_nor_flash_open(&nor_sim_flash, "sim nor flash", _lx_nor_flash_simulator_initialize);
+    status += lx_nor_flash_hot_sectors_enable(&nor_sim_flash, nor_hot_sector_memory, sizeof(nor_hot_sector_memory));
+    status += nor_write_streams_workload(&nor_sim_flash);
+
+    if ((status != LX_SUCCESS) || (nor_sim_flash.lx_nor_flash_relocated_sector_writes >= j) ||
+        (nor_sim_flash.lx_nor_flash_write_stream_sectors[LX_NOR_WRITE_STREAM_HOT] == 0) ||
+        (nor_sim_flash.lx_nor_flash_obsolete_block_erases == 0))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    /* The write stream given by the caller must be valid, and is used instead of the hot sector table.  */
+    for (j = 0; j < 128; j++)
+      buffer[j] =  200;
+    i =  nor_sim_flash.lx_nor_flash_write_stream_sectors[LX_NOR_WRITE_STREAM_COLD];
+    status =  lx_nor_flash_sector_write_stream(&nor_sim_flash, 200, buffer, LX_NOR_WRITE_STREAMS);
+
+    if (status != LX_ERROR)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_sector_write_stream(&nor_sim_flash, 0, buffer, LX_NOR_WRITE_STREAM_COLD);
+    status += lx_nor_flash_sector_read(&nor_sim_flash, 0, readbuffer);
+
+    if ((status != LX_SUCCESS) || (readbuffer[0] != 200) ||
+        (nor_sim_flash.lx_nor_flash_write_stream_sectors[LX_NOR_WRITE_STREAM_COLD] != (i + 1)))
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+
+    status =  lx_nor_flash_close(&nor_sim_flash);
+
+    if (status != LX_SUCCESS)
+    {
+          printf("FAILED!\n");
+#ifdef BATCH_TEST
+          exit(1);
+#endif
+          while(1)
+          {
+          }
+    }
+    printf("SUCCESS!\n");
+#endif
+
+#ifdef BATCH_TEST
+    exit(0);
+#endif
+     /* All done!  */
+     while(1)
+     {
+     }
+}
+
+
+#ifdef LX_NOR_ENABLE_WRITE_STREAMS
+
+/* Write 60 data sectors once, each followed by an update of one of 4 FAT sectors, then keep updating the
+   FAT sectors. Check the data and the write amplification counters.  */
+
+UINT  nor_write_streams_workload(LX_NOR_FLASH *nor_flash)
+{
+
+ULONG   i, j;
+UINT    status;
+
+
+    status =  LX_SUCCESS;
+    for (i = 0; (status == LX_SUCCESS) && (i < 600); i++)
+    {
+
+        /* Write the next data sector.  */
+        if (i < 60)
+        {
+            for (j = 0; j < 128; j++)
+              buffer[j] =  10 + i;
+            status =  lx_nor_flash_sector_write(nor_flash, 10 + i, buffer);
+        }
+
+        /* Update a FAT sector.  */
+        for (j = 0; j < 128; j++)
+          buffer[j] =  i;
+        if (status == LX_SUCCESS)
+            status =  lx_nor_flash_sector_write(nor_flash, i % 4, buffer);
+    }
+
+    /* Each write must be counted once.  */
+    if ((status != LX_SUCCESS) || (nor_flash -> lx_nor_flash_host_sector_writes != 660))
+        return(LX_ERROR);
+
+    /* Read back the data and FAT sectors.  */
+    for (i = 0; i < 64; i++)
+    {
+
+        if (lx_nor_flash_sector_read(nor_flash, (i < 4) ? i : (6 + i), readbuffer) != LX_SUCCESS)
+            return(LX_ERROR);
+
+        for (j = 0; j < 128; j++)
+        {
+            if (readbuffer[j] != ((i < 4) ? (596 + i) : (6 + i)))
+                return(LX_ERROR);
+        }
+    }
+
+    return(LX_SUCCESS);
+}
+#endif
@@ -0,0 +1,347 @@
+/* LevelX trace decoder. Reads a dump of the memory given to lx_nor_flash_trace_enable or
+   lx_nand_flash_trace_enable and prints the recorded events as a timeline, oldest first. The
+   events of the LevelX APIs are indented between their start and end, and the end shows the
+   time spent in the API. The dump may come from a target with 32-bit or 64-bit ULONGs of
+   either byte order. This is a host tool, it doesn't include lx_api.h, so the event numbers
+   below must match the LX_TRACE_ definitions.
+
+   Build: cc -o lx_trace_decode lx_trace_decode.c
+   Usage: lx_trace_decode <trace dump file>  */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/* Define the trace identification and devices, as in lx_api.h.  */
+
+#define TRACE_ID                    0x5254584CUL
+#define TRACE_NOR                   1
+#define TRACE_NAND                  2
+
+
+/* Define the trace events, as in lx_api.h.  */
+
+#define TRACE_API_ENTRY             1
+#define TRACE_API_EXIT              2
+#define TRACE_RECLAIM               3
+#define TRACE_RELOCATE              4
+#define TRACE_BLOCK_ERASE           5
+#define TRACE_METADATA_WRITE        6
+#define TRACE_METADATA_ALLOCATE     7
+#define TRACE_CACHE_MISS            8
+#define TRACE_EVENTS                9
+
+#define TRACE_HEADER_WORDS          6
+#define TRACE_EVENT_WORDS           4
+#define TRACE_API_DEPTH             8
+
+
+/* Define the ticks between two time stamps, the 32-bit clock may wrap.  */
+
+#define TRACE_TICKS(later, earlier) (((later) - (earlier)) & 0xFFFFFFFFUL)
+
+
+/* Define the names of the APIs (LX_STATS_ numbers), caches and events.  */
+
+static const char  *api_names[] =   {"sector read", "sector write", "sector release", "defragment",
+                                     "sectors read", "sectors write", "sectors release"};
+static const char  *cache_names[] = {"sector mapping", "data"};
+static const char  *event_names[TRACE_EVENTS] = {"unknown", "api start", "api end", "reclaim", "relocate",
+                                                 "block erase", "metadata write", "metadata allocate", "cache miss"};
+
+
+/* Define the layout of the dump.  */
+
+static unsigned char   *dump;
+static unsigned long    dump_size;
+static unsigned int     word_size;
+static int              big_endian;
+
+
+/* Read a ULONG of the dump.  */
+
+static unsigned long  dump_word(unsigned long index)
+{
+
+unsigned long   value;
+unsigned int    i;
+unsigned char   *byte_ptr;
+
+
+    /* Setup a pointer to the word.  */
+    byte_ptr =  dump + (index * word_size);
+
+    /* Assemble the word in the byte order of the target. Only the lower 32 bits are meaningful.  */
+    value =  0;
+    for (i = 0; i < 4; i++)
+    {
+
+        if (big_endian)
+            value =  (value << 8) | byte_ptr[word_size - 4 + i];
+        else
+            value =  (value << 8) | byte_ptr[3 - i];
+    }
+
+    /* Return the word.  */
+    return(value);
+}
+
+
+/* Determine the word size and byte order of the dump from its header.  */
+
+static int  dump_layout_find(void)
+{
+
+    for (word_size = 4; word_size <= 8; word_size = word_size + 4)
+    {
+
+        for (big_endian = 0; big_endian <= 1; big_endian++)
+        {
+
+            /* Is the header complete, with the identification and the event size of this layout?  */
+            if ((dump_size >= (TRACE_HEADER_WORDS * word_size)) && (dump_word(0) == TRACE_ID) &&
+                (dump_word(1) == (TRACE_EVENT_WORDS * word_size)))
+            {
+
+                /* Yes, the layout is found.  */
+                return(0);
+            }
+        }
+    }
+
+    /* Not a trace dump.  */
+    return(1);
+}
+
+
+/* Return the name of an API.  */
+
+static const char  *api_name(unsigned long api)
+{
+
+    return((api < (sizeof(api_names) / sizeof(api_names[0]))) ? api_names[api] : "unknown api");
+}
+
+
+/* Print an event, returns the new API nesting depth.  */
+
+static unsigned int  event_print(unsigned int device, unsigned long time, unsigned long event, unsigned long info1, unsigned long info2,
+                                 unsigned long previous_time, unsigned int depth, unsigned long *api_start)
+{
+
+unsigned int    i;
+
+
+    /* The end of an API is printed at the depth of its start.  */
+    if ((event == TRACE_API_EXIT) && (depth > 0))
+        depth--;
+
+    /* Print the time, the time since the previous event and the indentation.  */
+    printf("%10lu %8lu  ", time, TRACE_TICKS(time, previous_time));
+    for (i = 0; i < depth; i++)
+        printf("  ");
+
+    switch (event)
+    {
+
+    case TRACE_API_ENTRY:
+
+        printf("%s start, sector %lu\n", api_name(info1), info2);
+        if (depth < TRACE_API_DEPTH)
+            api_start[depth] =  time;
+        depth++;
+        break;
+
+    case TRACE_API_EXIT:
+
+        printf("%s end, status 0x%02lX", api_name(info1), info2);
+        if (depth < TRACE_API_DEPTH)
+            printf(", %lu ticks", TRACE_TICKS(time, api_start[depth]));
+        printf("\n");
+        break;
+
+    case TRACE_RECLAIM:
+
+        if (device == TRACE_NOR)
+            printf("reclaim block %lu, %lu sectors to move\n", info1, info2);
+        else
+            printf("reclaim block %lu to block %lu\n", info1, info2);
+        break;
+
+    case TRACE_RELOCATE:
+
+        if (device == TRACE_NOR)
+            printf("relocate sector %lu to block %lu\n", info1, info2);
+        else
+            printf("move pages of block %lu to block %lu\n", info1, info2);
+        break;
+
+    case TRACE_BLOCK_ERASE:
+
+        printf("erase block %lu, erase count %lu\n", info1, info2);
+        break;
+
+    case TRACE_METADATA_WRITE:
+
+        printf("metadata write, block %lu, page type 0x%08lX\n", info1, info2);
+        break;
+
+    case TRACE_METADATA_ALLOCATE:
+
+        printf("metadata allocate, block %lu, backup block %lu\n", info1, info2);
+        break;
+
+    case TRACE_CACHE_MISS:
+
+        printf("%s cache miss, sector %lu\n", (info1 < 2) ? cache_names[info1] : "unknown", info2);
+        break;
+
+    default:
+
+        printf("unknown event %lu, 0x%08lX 0x%08lX\n", event, info1, info2);
+        break;
+    }
+
+    /* Return the new depth.  */
+    return(depth);
+}
+
+
+int  main(int argc, char **argv)
+{
+
+FILE            *file;
+long            length;
+unsigned int    device;
+unsigned long   events;
+unsigned long   next;
+unsigned long   total;
+unsigned long   count;
+unsigned long   first;
+unsigned long   i;
+unsigned long   index;
+unsigned long   word;
+unsigned long   time;
+unsigned long   previous_time;
+unsigned long   event;
+unsigned int    depth;
+unsigned long   api_start[TRACE_API_DEPTH];
+unsigned long   event_counts[TRACE_EVENTS];
+
+
+    /* Check the arguments.  */
+    if (argc != 2)
+    {
+
+        fprintf(stderr, "usage: %s <trace dump file>\n", argv[0]);
+        return(2);
+    }
+
+    /* Read the whole dump.  */
+    file =  fopen(argv[1], "rb");
+    if (file == NULL)
+    {
+
+        fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+        return(1);
+    }
+    fseek(file, 0, SEEK_END);
+    length =  ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (length <= 0)
+    {
+
+        fprintf(stderr, "%s: %s is empty\n", argv[0], argv[1]);
+        fclose(file);
+        return(1);
+    }
+    dump_size =  (unsigned long) length;
+    dump =  (unsigned char *) malloc(dump_size);
+    if ((dump == NULL) || (fread(dump, 1, dump_size, file) != dump_size))
+    {
+
+        fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+        fclose(file);
+        return(1);
+    }
+    fclose(file);
+
+    /* Find the layout from the header.  */
+    if (dump_layout_find())
+    {
+
+        fprintf(stderr, "%s: %s is not a LevelX trace\n", argv[0], argv[1]);
+        return(1);
+    }
+
+    /* Pickup the header.  */
+    device =  (unsigned int) dump_word(2);
+    events =  dump_word(3);
+    next =    dump_word(4);
+    total =   dump_word(5);
+
+    /* Only the events that are in the dump can be decoded.  */
+    if (events > ((dump_size / word_size) - TRACE_HEADER_WORDS) / TRACE_EVENT_WORDS)
+        events =  ((dump_size / word_size) - TRACE_HEADER_WORDS) / TRACE_EVENT_WORDS;
+    if ((events == 0) || (next >= events))
+    {
+
+        fprintf(stderr, "%s: %s has an invalid header\n", argv[0], argv[1]);
+        return(1);
+    }
+
+    /* Determine the oldest event. Once the buffer has wrapped, it is the event written next.  */
+    if (total > events)
+    {
+        count =  events;
+        first =  next;
+    }
+    else
+    {
+        count =  total;
+        first =  0;
+    }
+
+    printf("LevelX %s trace, %lu events recorded, %lu in the buffer, %u-bit %s endian\n\n",
+           (device == TRACE_NOR) ? "NOR" : ((device == TRACE_NAND) ? "NAND" : "unknown"), total, count,
+           word_size * 8, big_endian ? "big" : "little");
+    printf("      time    delta  event\n");
+
+    /* Print the events, oldest first.  */
+    for (i = 0; i < TRACE_EVENTS; i++)
+        event_counts[i] =  0;
+    depth =  0;
+    previous_time =  0;
+    for (i = 0; i < count; i++)
+    {
+
+        /* Pickup the event.  */
+        index =  TRACE_HEADER_WORDS + (((first + i) % events) * TRACE_EVENT_WORDS);
+        time =   dump_word(index);
+        event =  dump_word(index + 1);
+        if (i == 0)
+            previous_time =  time;
+
+        /* Print the event.  */
+        depth =  event_print(device, time, event, dump_word(index + 2), dump_word(index + 3), previous_time, depth, api_start);
+        previous_time =  time;
+
+        /* Count the event.  */
+        word =  (event < TRACE_EVENTS) ? event : 0;
+        event_counts[word]++;
+    }
+
+    /* Print the number of events of each kind.  */
+    printf("\n");
+    for (i = 1; i < TRACE_EVENTS; i++)
+    {
+
+        if (event_counts[i])
+            printf("%-20s %lu\n", event_names[i], event_counts[i]);
+    }
+    if (event_counts[0])
+        printf("%-20s %lu\n", event_names[0], event_counts[0]);
+
+    free(dump);
+    return(0);
+}